@@ -6,86 +6,93 @@
 
 void AssemblyEmitter::GenerateAssembly() {
   unsigned FunctionCounter = 0;
-  for (auto &Func : MIRM->GetFunctions()) {
-    std::cout << ".globl\t" << Func.GetName() << std::endl;
-    std::cout << Func.GetName() << ":" << std::endl;
+  for (auto &Func : MIRM->GetFunctions())
+    EmitFunction(Func, FunctionCounter++, std::cout);
+  EmitGlobalData();
+}
 
-    bool IsFirstBB = true;
-    for (auto &BB : Func.GetBasicBlocks()) {
-      if (!IsFirstBB) {
-        std::cout << ".L" << FunctionCounter << "_" << BB.GetName() << ":" << std::endl;
-      } else
-        IsFirstBB = false;
+void AssemblyEmitter::EmitFunction(MachineFunction &Func,
+                                   unsigned FunctionIndex, std::ostream &OS) {
+  OS << ".globl\t" << Func.GetName() << std::endl;
+  OS << Func.GetName() << ":" << std::endl;
 
-      for (auto &Instr : BB.GetInstructions()) {
-        std::cout << "\t";
+  bool IsFirstBB = true;
+  for (auto &BB : Func.GetBasicBlocks()) {
+    if (!IsFirstBB) {
+      OS << ".L" << FunctionIndex << "_" << BB.GetName() << ":" << std::endl;
+    } else
+      IsFirstBB = false;
 
-        auto TargetInstr =
-            TM->GetInstrDefs()->GetTargetInstr(Instr.GetOpcode());
-        assert(TargetInstr != nullptr && "Something went wrong here");
+    for (auto &Instr : BB.GetInstructions()) {
+      OS << "\t";
 
-        std::string AssemblyTemplateStr = TargetInstr->GetAsmString();
-        const auto OperandNumber = TargetInstr->GetOperandNumber();
+      auto TargetInstr =
+          TM->GetInstrDefs()->GetTargetInstr(Instr.GetOpcode());
+      assert(TargetInstr != nullptr && "Something went wrong here");
 
-        // If the target instruction has no operands, then just print it and
-        // continue
-        if (OperandNumber == 0) {
-          std::cout << AssemblyTemplateStr << std::endl;
-          continue;
-        }
+      std::string AssemblyTemplateStr = TargetInstr->GetAsmString();
+      const auto OperandNumber = TargetInstr->GetOperandNumber();
 
-        // Substitute the stringified operands to their appropriate places
-        // example:
-        // add $1, $2, $3 -> add a0, a1, a2
-        for (size_t i = 0; i < OperandNumber; i++) {
-          std::size_t DollarPos = AssemblyTemplateStr.find('$');
+      // If the target instruction has no operands, then just print it and
+      // continue
+      if (OperandNumber == 0) {
+        OS << AssemblyTemplateStr << std::endl;
+        continue;
+      }
 
-          if (DollarPos == std::string::npos)
-            assert(!"The number of template operands are not match the"
-                    "number of operands");
+      // Substitute the stringified operands to their appropriate places
+      // example:
+      // add $1, $2, $3 -> add a0, a1, a2
+      for (size_t i = 0; i < OperandNumber; i++) {
+        std::size_t DollarPos = AssemblyTemplateStr.find('$');
 
-          unsigned NthOperand = AssemblyTemplateStr[DollarPos + 1] - '0';
-          auto CurrentOperand = Instr.GetOperand(NthOperand - 1);
+        if (DollarPos == std::string::npos)
+          assert(!"The number of template operands are not match the"
+                  "number of operands");
 
-          // Register case
-          if (CurrentOperand->IsRegister()) {
-            TargetRegister *Reg =
-                TM->GetRegInfo()->GetRegisterByID(CurrentOperand->GetReg());
-            std::string RegStr;
-            if (Reg->GetAlias() != "")
-              RegStr = Reg->GetAlias();
-            else
-              RegStr = Reg->GetName();
+        unsigned NthOperand = AssemblyTemplateStr[DollarPos + 1] - '0';
+        auto CurrentOperand = Instr.GetOperand(NthOperand - 1);
 
-            AssemblyTemplateStr.replace(DollarPos, 2, RegStr);
-          }
-          // Immediate case
-          else if (CurrentOperand->IsImmediate()) {
-            std::string ImmStr = std::to_string(CurrentOperand->GetImmediate());
-            AssemblyTemplateStr.replace(DollarPos, 2, ImmStr);
-          }
-          // Label and FunctionName (function call) case
-          else if (CurrentOperand->IsLabel() || CurrentOperand->IsFunctionName()
-                   || CurrentOperand->IsGlobalSymbol()) {
-            std::string Str = "";
-            if (CurrentOperand->IsLabel())
-              Str += ".L" + std::to_string(FunctionCounter) + "_";
+        // Register case
+        if (CurrentOperand->IsRegister()) {
+          TargetRegister *Reg =
+              TM->GetRegInfo()->GetRegisterByID(CurrentOperand->GetReg());
+          std::string RegStr;
+          if (Reg->GetAlias() != "")
+            RegStr = Reg->GetAlias();
+          else
+            RegStr = Reg->GetName();
 
-            if (!CurrentOperand->IsGlobalSymbol())
-              Str.append(CurrentOperand->GetLabel());
-            else
-              Str.append(CurrentOperand->GetGlobalSymbol());
-            AssemblyTemplateStr.replace(DollarPos, 2, Str);
-          } else
-            assert(!"Invalid Machine Operand type");
+          AssemblyTemplateStr.replace(DollarPos, 2, RegStr);
+        }
+        // Immediate case
+        else if (CurrentOperand->IsImmediate()) {
+          std::string ImmStr = std::to_string(CurrentOperand->GetImmediate());
+          AssemblyTemplateStr.replace(DollarPos, 2, ImmStr);
         }
-        // Emit the final assembly string
-        std::cout << AssemblyTemplateStr << std::endl;
+        // Label and FunctionName (function call) case
+        else if (CurrentOperand->IsLabel() || CurrentOperand->IsFunctionName()
+                 || CurrentOperand->IsGlobalSymbol()) {
+          std::string Str = "";
+          if (CurrentOperand->IsLabel())
+            Str += ".L" + std::to_string(FunctionIndex) + "_";
+
+          if (!CurrentOperand->IsGlobalSymbol())
+            Str.append(CurrentOperand->GetLabel());
+          else
+            Str.append(CurrentOperand->GetGlobalSymbol().GetString());
+          AssemblyTemplateStr.replace(DollarPos, 2, Str);
+        } else
+          assert(!"Invalid Machine Operand type");
       }
+      // Emit the final assembly string
+      OS << AssemblyTemplateStr << std::endl;
     }
-    std::cout << std::endl;
-    FunctionCounter++;
   }
+  OS << std::endl;
+}
+
+void AssemblyEmitter::EmitGlobalData() {
   for (auto &GlobalData : MIRM->GetGlobalDatas())
     GlobalData.Print();
 }
@@ -3,6 +3,7 @@
 
 #include "MachineIRModule.hpp"
 #include "TargetMachine.hpp"
+#include <ostream>
 
 class AssemblyEmitter {
 public:
@@ -11,6 +12,13 @@ public:
 
   void GenerateAssembly();
 
+  /// Emit @Func to @OS, @FunctionIndex is used to make its local labels
+  /// unique in the module.
+  void EmitFunction(MachineFunction &Func, unsigned FunctionIndex,
+                    std::ostream &OS);
+
+  void EmitGlobalData();
+
 private:
   TargetMachine *TM;
   MachineIRModule *MIRM;
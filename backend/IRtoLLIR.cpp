@@ -192,6 +192,16 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
           BB->InsertInstr(Store);
         }
       }
+    } else if (I->GetSavedValue()->IsConstant()) {
+      // immediates are 32 bit by default, but the store has to write exactly
+      // the size of the location, like a byte for a char
+      auto Immediate = GetMachineOperandFromValue(I->GetSavedValue(), BB);
+      auto &LocationType = I->GetMemoryLocation()->GetTypeRef();
+      if (LocationType.GetPointerLevel() > 1)
+        Immediate.SetType(LowLevelType::CreateINT(TM->GetPointerSize()));
+      else if (LocationType.IsINT())
+        Immediate.SetType(LowLevelType::CreateINT(LocationType.GetBitSize()));
+      ResultMI.AddOperand(Immediate);
     } else
       ResultMI.AddOperand(GetMachineOperandFromValue(I->GetSavedValue(), BB));
   }
@@ -459,8 +469,8 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
           Instr.AddRegister(TargetArgRegs[ParamCounter]->GetID(),
                             TargetArgRegs[ParamCounter]->GetBitWidth());
 
-          auto Symbol = ((GlobalVariable*)Param)->GetName();
-          Instr.AddGlobalSymbol(Symbol);
+          auto GlobalName = ((GlobalVariable*)Param)->GetName();
+          Instr.AddGlobalSymbol(GlobalName);
           BB->InsertInstr(Instr);
           ParamCounter++;
         } else {
@@ -712,7 +722,7 @@ void IRtoLLIR::GenerateLLIRFromIR() {
     auto Name = ((GlobalVariable*)GlobalVar.get())->GetName();
     auto Size = GlobalVar->GetTypeRef().GetByteSize();
 
-    auto GD = GlobalData(Name, Size);
+    auto GD = GlobalData(Name.GetString(), Size);
     auto &InitList = ((GlobalVariable*)GlobalVar.get())->GetInitList();
 
     if (GlobalVar->GetTypeRef().IsStruct() || GlobalVar->GetTypeRef().IsArray()) {
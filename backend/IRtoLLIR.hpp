@@ -5,6 +5,7 @@
 #include "MachineIRModule.hpp"
 #include "TargetMachine.hpp"
 #include "../middle_end/IR/Instructions.hpp"
+#include <unordered_map>
 
 /// This class responsible to translate the middle end's IR to a lower level IR
 /// which used in the backend.
@@ -40,7 +41,7 @@ private:
   MachineIRModule *TU;
   TargetMachine *TM;
 
-  std::map<std::string, std::vector<unsigned>> StructToRegMap;
+  std::unordered_map<Symbol, std::vector<unsigned>> StructToRegMap;
 
   /// to keep track in which registers the struct is currently living
   std::map<unsigned, std::vector<unsigned>> StructByIDToRegMap;
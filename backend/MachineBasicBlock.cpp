@@ -1,6 +1,7 @@
 #include "MachineBasicBlock.hpp"
 #include "MachineInstruction.hpp"
 #include <cassert>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -28,11 +29,7 @@ MachineBasicBlock::InsertInstrToFront(MachineInstruction MI) {
 MachineBasicBlock::InstructionList::iterator
 MachineBasicBlock::InsertBefore(MachineInstruction MI,
                                 MachineInstruction *BeforeMI) {
-  size_t i = 0;
-  for (; i < Instructions.size(); i++)
-    if (&Instructions[i] == BeforeMI)
-      break;
-
+  auto i = GetPosition(BeforeMI);
   assert(i < Instructions.size() && "Instruction not found in the list");
 
   return InsertInstr(MI, i);
@@ -41,11 +38,7 @@ MachineBasicBlock::InsertBefore(MachineInstruction MI,
 MachineBasicBlock::InstructionList::iterator
 MachineBasicBlock::InsertAfter(MachineInstruction MI,
                                MachineInstruction *AfterMI) {
-  size_t i = 0;
-  for (; i < Instructions.size(); i++)
-    if (&Instructions[i] == AfterMI)
-      break;
-
+  auto i = GetPosition(AfterMI);
   assert(i < Instructions.size() && "Instruction not found in the list");
 
   return InsertInstr(MI, i + 1);
@@ -54,38 +47,35 @@ MachineBasicBlock::InsertAfter(MachineInstruction MI,
 MachineBasicBlock::InstructionList::iterator
 MachineBasicBlock::ReplaceInstr(MachineInstruction MI,
                                 MachineInstruction *Replacable) {
-  size_t i = 0;
-  for (; i < Instructions.size(); i++) {
-    auto Ptr = &Instructions[i];
-    if (Ptr == Replacable) {
-      Instructions[i] = std::move(MI);
-      return Instructions.begin() + i;
-      break;
-    }
+  auto i = GetPosition(Replacable);
+  if (i < Instructions.size()) {
+    Instructions[i] = std::move(MI);
+    return Instructions.begin() + i;
   }
   assert(!"Replacable instruction was not found");
   return Instructions.end();
 }
 
 MachineInstruction *MachineBasicBlock::GetPrecedingInstr(MachineInstruction *MI) {
-  size_t Counter = 0;
-  for (; Counter < Instructions.size(); Counter++) {
-    auto Ptr = &Instructions[Counter];
-    if (Ptr == MI) {
-      if (Counter == 0) break;
-      return &Instructions[Counter - 1];
-    }
-  }
-  return nullptr;
+  auto Counter = GetPosition(MI);
+  if (Counter == 0 || Counter >= Instructions.size())
+    return nullptr;
+  return &Instructions[Counter - 1];
 }
 
 void MachineBasicBlock::Erase(MachineInstruction *MI) {
-  size_t i = 0;
-  for (; i < Instructions.size(); i++)
-    if (&Instructions[i] == MI) {
-      Instructions.erase(Instructions.begin() + i);
-      break;;
-    }
+  auto i = GetPosition(MI);
+  if (i < Instructions.size())
+    Instructions.erase(Instructions.begin() + i);
+}
+
+size_t MachineBasicBlock::GetPosition(const MachineInstruction *MI) const {
+  auto Begin = Instructions.data();
+  auto End = Begin + Instructions.size();
+  if (std::less<const MachineInstruction *>()(MI, Begin) ||
+      !std::less<const MachineInstruction *>()(MI, End))
+    return Instructions.size();
+  return MI - Begin;
 }
 
 void MachineBasicBlock::Print(TargetMachine *TM) const {
@@ -49,6 +49,10 @@ public:
   void Print(TargetMachine *TM) const;
 
 private:
+  /// The position of MI in the InstructionList, or its size if MI is not in
+  /// it. It is computed from the address, so long blocks are not searched.
+  size_t GetPosition(const MachineInstruction *MI) const;
+
   std::string Name;
   InstructionList Instructions;
   MachineFunction *Parent = nullptr;
@@ -5,21 +5,17 @@
 class TargetMachine;
 
 unsigned MachineFunction::GetNextAvailableVReg() {
-  // If this function was called the first time then here the highest virtual
-  // register ID is searched and NextVReg is set to that.
+  // The IDs of the parameters are given by the IR, so they are skipped here.
+  // The virtual registers of the instructions are either parameters or were
+  // given out by this function, so those are below NextVReg already and the
+  // instructions do not have to be searched, which would make generating
+  // long functions quadratic.
   for (auto &[ParamID, ParamLLT] : Parameters)
     if (ParamID == NextVReg)
       NextVReg++;
     else if (ParamID > NextVReg)
       NextVReg = ParamID;
 
-  for (auto &BB : BasicBlocks)
-    for (auto &Instr : BB.GetInstructions())
-      for (auto &Operand : Instr.GetOperands())
-        if (Operand.IsVirtualReg() && Operand.GetReg() >= NextVReg)
-          NextVReg =
-              Operand.GetReg() == NextVReg ? NextVReg + 1 : Operand.GetReg();
-
   // The next one is 1 more then the found highest
   return NextVReg++;
 }
@@ -158,8 +158,8 @@ public:
     AddOperand(MachineOperand::CreateFunctionName(Name));
   }
 
-  void AddGlobalSymbol(std::string Symbol) {
-    AddOperand(MachineOperand::CreateGlobalSymbol(Symbol));
+  void AddGlobalSymbol(Symbol GlobalSymbol) {
+    AddOperand(MachineOperand::CreateGlobalSymbol(GlobalSymbol));
   }
 
   void AddAttribute(unsigned AttributeFlag) {
@@ -11,26 +11,38 @@ void MachineInstructionLegalizer::Run() {
     return;
 
   for (auto &Func : MIRM->GetFunctions()) {
-    for (size_t BBIndex = 0; BBIndex < Func.GetBasicBlocks().size(); BBIndex++)
-      for (size_t InstrIndex = 0;
-           InstrIndex < Func.GetBasicBlocks()[BBIndex].GetInstructions().size();
-           InstrIndex++) {
-        auto *MI =
-            &Func.GetBasicBlocks()[BBIndex].GetInstructions()[InstrIndex];
+    for (size_t BBIndex = 0; BBIndex < Func.GetBasicBlocks().size(); BBIndex++) {
+      auto &Instructions = Func.GetBasicBlocks()[BBIndex].GetInstructions();
 
-        // If the instruction is not legal on the target
-        if (!Legalizer->Check(MI)) {
-          // but if it is expandable to hopefully legal ones, then do it
-          if (Legalizer->IsExpandable(MI)) {
-            if (Legalizer->Expand(MI)) {
-              InstrIndex--;
-            } else
-              assert(!"Expandable instruction should be expandable");
-            continue;
-          } else {
-            assert(!"Machine Instruction is not legal neither expandable");
+      // The instructions are put back into the block one by one, so the
+      // expansions insert at the end of it instead of moving the rest of a
+      // long block each time. An expansion only looks at the instructions
+      // before the expanded one.
+      auto Unlegalized = std::move(Instructions);
+      Instructions.clear();
+
+      for (auto &Instr : Unlegalized) {
+        Instructions.push_back(std::move(Instr));
+
+        for (size_t InstrIndex = Instructions.size() - 1;
+             InstrIndex < Instructions.size(); InstrIndex++) {
+          auto *MI = &Instructions[InstrIndex];
+
+          // If the instruction is not legal on the target
+          if (!Legalizer->Check(MI)) {
+            // but if it is expandable to hopefully legal ones, then do it
+            if (Legalizer->IsExpandable(MI)) {
+              if (Legalizer->Expand(MI)) {
+                InstrIndex--;
+              } else
+                assert(!"Expandable instruction should be expandable");
+              continue;
+            } else {
+              assert(!"Machine Instruction is not legal neither expandable");
+            }
           }
         }
       }
+    }
   }
 }
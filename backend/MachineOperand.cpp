@@ -42,7 +42,7 @@ void MachineOperand::Print(TargetMachine *TM) const {
     std::cout << "@" << Label;
     break;
   case GLOBAL_SYMBOL:
-    std::cout << "@" << GlobalSymbol;
+    std::cout << "@" << GlobalSymbol.GetString();
     break;
   default:
     break;
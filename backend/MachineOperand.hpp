@@ -1,6 +1,7 @@
 #ifndef MACHINE_OPERAND_HPP
 #define MACHINE_OPERAND_HPP
 
+#include "../support/Symbol.hpp"
 #include "LowLevelType.hpp"
 #include "TargetRegister.hpp"
 #include <cstdint>
@@ -49,9 +50,9 @@ public:
 
   const char *GetLabel() { return Label; }
   const char *GetFunctionName() { return Label; }
-  std::string &GetGlobalSymbol() { return GlobalSymbol; }
+  Symbol GetGlobalSymbol() const { return GlobalSymbol; }
   void SetLabel(const char *L) { Label = L; }
-  void SetGlobalSymbol(const std::string &GS) { GlobalSymbol = GS; }
+  void SetGlobalSymbol(Symbol GS) { GlobalSymbol = GS; }
 
   bool IsVirtual() const { return Virtual; }
   void SetVirtual(bool v) { Virtual = v; }
@@ -121,10 +122,10 @@ public:
     return MO;
   }
 
-  static MachineOperand CreateGlobalSymbol(std::string &Symbol) {
+  static MachineOperand CreateGlobalSymbol(Symbol GlobalSymbol) {
     MachineOperand MO;
     MO.SetToGlobalSymbol();
-    MO.SetGlobalSymbol(Symbol);
+    MO.SetGlobalSymbol(GlobalSymbol);
     return MO;
   }
 
@@ -150,7 +151,7 @@ private:
   int Offset = 0;
   LowLevelType LLT;
   const char *Label = nullptr;
-  std::string GlobalSymbol;
+  Symbol GlobalSymbol;
   bool Virtual = false;
 };
 
@@ -7,10 +7,10 @@ AArch64InstructionDefinitions::AArch64InstructionDefinitions() {
                       "LSL_rri",  "LSR_rrr", "LSR_rri", "SUB_rrr",  "SUB_rri",
                       "SUBS",     "MUL_rri", "MUL_rrr", "SDIV_rri", "SDIV_rrr",
                       "UDIV_rrr", "CMP_ri",  "CMP_rr",  "CSET",     "SXTB",
-                      "SXTW",     "MOV_rc",  "MOV_rr",  "ADRP",     "LDR",
-                      "LDRB",     "STR",     "STRB",    "BEQ",      "BNE",
-                      "BGE",      "BGT",     "BLE",     "BLT",      "B",
-                      "BL",       "RET"};
+                      "SXTW",     "MOV_rc",  "MOV_rr",  "MOVK",     "ADRP",
+                      "LDR",      "LDRB",    "STR",     "STRB",     "BEQ",
+                      "BNE",      "BGE",     "BGT",     "BLE",      "BLT",
+                      "B",        "BL",      "RET"};
 }
 
 AArch64InstructionDefinitions::IRToTargetInstrMap
@@ -40,6 +40,7 @@ AArch64InstructionDefinitions::IRToTargetInstrMap
       ret[SXTW] = {SXTW, 32, "sxtw\t$1, $2", {GPR, GPR}};
       ret[MOV_rc] = {MOV_rc, 32, "mov\t$1, #$2", {GPR, UIMM16}};
       ret[MOV_rr] = {MOV_rr, 32, "mov\t$1, $2", {GPR, GPR}};
+      ret[MOVK] = {MOVK, 32, "movk\t$1, #$2, lsl #$3", {GPR, UIMM16, UIMM12}};
       ret[ADRP] = {ADRP, 32, "adrp\t$1, $2", {GPR, GPR}};
       ret[LDR] = {LDR,
                   32,
@@ -32,6 +32,7 @@ enum Opcodes : unsigned {
   SXTW,
   MOV_rc,
   MOV_rr,
+  MOVK,
   ADRP,
   LDR,
   LDRB,
@@ -2,11 +2,40 @@
 #include "AArch64InstructionDefinitions.hpp"
 #include "../../MachineBasicBlock.hpp"
 #include "../../MachineFunction.hpp"
+#include "../../Support.hpp"
 #include "../../TargetMachine.hpp"
+#include <algorithm>
 #include <cassert>
 
 using namespace AArch64;
 
+/// True if the @Index-th operand of @MI is an immediate which does not fit
+/// into the 12 bit of the arithmetic instructions. If @AllowNegative, then
+/// its negation is fine too, since the instruction can be changed to its
+/// opposite.
+static bool IsWideImmediate(MachineInstruction *MI, size_t Index,
+                            bool AllowNegative) {
+  auto Operand = MI->GetOperand(Index);
+  if (!Operand->IsImmediate())
+    return false;
+
+  auto Imm = (int64_t)Operand->GetImmediate();
+  return !IsUInt<12>(Imm) && !(AllowNegative && IsUInt<12>(-Imm));
+}
+
+/// True if the immediate moved by @MI cannot be set by a single mov.
+static bool IsWideMove(MachineInstruction *MI) {
+  auto Operand = MI->GetOperand(1);
+  if (!Operand->IsImmediate())
+    return false;
+
+  // only the bits of the destination matter
+  auto Imm = Operand->GetImmediate();
+  if (MI->GetOperand(0)->GetSize() <= 32)
+    Imm = (uint64_t)(int64_t)(int32_t)Imm;
+  return !IsInt<16>(Imm);
+}
+
 // Modulo operation is not legal on ARM, has to be expanded
 bool AArch64InstructionLegalizer::Check(MachineInstruction *MI) {
   switch (MI->GetOpcode()) {
@@ -17,8 +46,18 @@ bool AArch64InstructionLegalizer::Check(MachineInstruction *MI) {
     if (MI->GetOperands().back().IsImmediate())
       return false;
     break;
+  case MachineInstruction::ADD:
+  case MachineInstruction::CMP:
+    if (IsWideImmediate(MI, 2, true))
+      return false;
+    break;
   case MachineInstruction::SUB:
-    if (MI->GetOperand(1)->IsImmediate())
+    if (MI->GetOperand(1)->IsImmediate() || IsWideImmediate(MI, 2, false))
+      return false;
+    break;
+  case MachineInstruction::LOAD_IMM:
+  case MachineInstruction::MOV:
+    if (IsWideMove(MI))
       return false;
     break;
   case MachineInstruction::MUL:
@@ -49,7 +88,11 @@ bool AArch64InstructionLegalizer::IsExpandable(const MachineInstruction *MI) {
   case MachineInstruction::MOD:
   case MachineInstruction::MODU:
   case MachineInstruction::STORE:
+  case MachineInstruction::ADD:
   case MachineInstruction::SUB:
+  case MachineInstruction::CMP:
+  case MachineInstruction::LOAD_IMM:
+  case MachineInstruction::MOV:
   case MachineInstruction::MUL:
   case MachineInstruction::DIV:
   case MachineInstruction::DIVU:
@@ -73,21 +116,27 @@ bool AArch64InstructionLegalizer::ExpandSTORE(MachineInstruction *MI) {
 
   assert(Immediate.IsImmediate() && "Operand #2 must be an immediate");
 
-  if (Immediate.GetImmediate() == 0) {
+  // wzr only covers the lower half of a 64 bit location
+  if (Immediate.GetImmediate() == 0 && Immediate.GetSize() <= 32) {
     MI->RemoveOperand(1);
     auto WZR = TM->GetRegInfo()->GetZeroRegister();
-    MI->AddRegister(WZR, TM->GetRegInfo()->GetRegisterByID(WZR)->GetBitWidth());
+    // a byte store is selected by the size of the stored register
+    auto WZRSize = TM->GetRegInfo()->GetRegisterByID(WZR)->GetBitWidth();
+    MI->AddRegister(WZR, Immediate.GetSize() == 8 ? 8 : WZRSize);
     return true;
   }
 
-  // Create the result register where the immediate will be loaded
+  // Create the result register where the immediate will be loaded, at least
+  // a 32 bit one, but the store keeps the size of the immediate, which
+  // selects the byte store for a char
   auto LOAD_IMMResult = ParentFunc->GetNextAvailableVReg();
-  auto LOAD_IMMResultVReg =
-      MachineOperand::CreateVirtualRegister(LOAD_IMMResult);
+  auto LOAD_IMMResultVReg = MachineOperand::CreateVirtualRegister(
+      LOAD_IMMResult, std::max(32u, Immediate.GetSize()));
 
   // Replace the immediate operand with the result register
   MI->RemoveOperand(1);
-  MI->AddOperand(LOAD_IMMResultVReg);
+  MI->AddOperand(MachineOperand::CreateVirtualRegister(LOAD_IMMResult,
+                                                       Immediate.GetSize()));
 
   MachineInstruction LOAD_IMM;
   LOAD_IMM.SetOpcode(MachineInstruction::LOAD_IMM);
@@ -98,20 +147,24 @@ bool AArch64InstructionLegalizer::ExpandSTORE(MachineInstruction *MI) {
   return true;
 }
 
-bool ExpandArithmeticInstWithImm(MachineInstruction *MI, size_t Index) {
+/// Materialize the @Index-th operand of @MI into a register which has the
+/// size of the @SizeIndex-th operand.
+bool ExpandArithmeticInstWithImm(MachineInstruction *MI, size_t Index,
+                                 size_t SizeIndex = 0) {
   assert(MI->GetOperandsNumber() == 3 && "SUB must have exactly 3 operands");
   assert(Index < MI->GetOperandsNumber());
   auto ParentBB = MI->GetParent();
+  auto BitWidth = MI->GetOperand(SizeIndex)->GetSize();
 
   auto MOV = MachineInstruction(MachineInstruction::LOAD_IMM, nullptr);
   auto DestReg = ParentBB->GetParent()->GetNextAvailableVReg();
-  MOV.AddVirtualRegister(DestReg, MI->GetOperand(Index)->GetSize());
+  MOV.AddVirtualRegister(DestReg, BitWidth);
   MOV.AddOperand(*MI->GetOperand(Index));
 
   // replace the immediate operand with the destination of the immediate load
   MI->RemoveOperand(Index);
-  MI->InsertOperand(Index,MachineOperand::CreateVirtualRegister(
-      DestReg,MI->GetOperand(0)->GetSize()));
+  MI->InsertOperand(Index,
+                    MachineOperand::CreateVirtualRegister(DestReg, BitWidth));
 
   // insert after modifying SUB, otherwise MI would became invalid
   ParentBB->InsertBefore(std::move(MOV), MI);
@@ -121,7 +174,19 @@ bool ExpandArithmeticInstWithImm(MachineInstruction *MI, size_t Index) {
 
 bool AArch64InstructionLegalizer::ExpandSUB(MachineInstruction *MI) {
   assert(MI->GetOperandsNumber() == 3 && "SUB must have exactly 3 operands");
-  return ExpandArithmeticInstWithImm(MI, 1);
+  return ExpandArithmeticInstWithImm(MI,
+                                     MI->GetOperand(1)->IsImmediate() ? 1 : 2);
+}
+
+bool AArch64InstructionLegalizer::ExpandADD(MachineInstruction *MI) {
+  assert(MI->GetOperandsNumber() == 3 && "ADD must have exactly 3 operands");
+  return ExpandArithmeticInstWithImm(MI, 2);
+}
+
+bool AArch64InstructionLegalizer::ExpandCMP(MachineInstruction *MI) {
+  assert(MI->GetOperandsNumber() == 3 && "CMP must have exactly 3 operands");
+  // the destination is only a flag, the compared register gives the size
+  return ExpandArithmeticInstWithImm(MI, 2, 1);
 }
 
 bool AArch64InstructionLegalizer::ExpandMUL(MachineInstruction *MI) {
@@ -139,6 +204,43 @@ bool AArch64InstructionLegalizer::ExpandDIVU(MachineInstruction *MI) {
   return ExpandArithmeticInstWithImm(MI, 2);
 }
 
+/// Keep the lowest 16 bits of the immediate in the mov @MI and set the rest
+/// of the destination with movk instructions after it.
+static bool ExpandWideMove(MachineInstruction *MI) {
+  assert(MI->GetOperandsNumber() == 2 && "MOV must have exactly 2 operands");
+  auto ParentBB = MI->GetParent();
+  auto Dest = *MI->GetOperand(0);
+  const unsigned BitWidth = Dest.GetSize() <= 32 ? 32 : 64;
+  const uint64_t Imm = MI->GetOperand(1)->GetImmediate();
+
+  // the mov clears the bits above the lowest 16, so only the non zero parts
+  // need a movk
+  MI->GetOperand(1)->SetValue(Imm & 0xffff);
+
+  auto Previous = MI;
+  for (unsigned Shift = 16; Shift < BitWidth; Shift += 16) {
+    const uint64_t Part = (Imm >> Shift) & 0xffff;
+    if (Part == 0)
+      continue;
+
+    MachineInstruction MOVKInstr(MOVK, ParentBB);
+    MOVKInstr.AddOperand(Dest);
+    MOVKInstr.AddImmediate(Part);
+    MOVKInstr.AddImmediate(Shift);
+    Previous = &*ParentBB->InsertAfter(std::move(MOVKInstr), Previous);
+  }
+
+  return true;
+}
+
+bool AArch64InstructionLegalizer::ExpandLOAD_IMM(MachineInstruction *MI) {
+  return ExpandWideMove(MI);
+}
+
+bool AArch64InstructionLegalizer::ExpandMOV(MachineInstruction *MI) {
+  return ExpandWideMove(MI);
+}
+
 bool AArch64InstructionLegalizer::ExpandZEXT(MachineInstruction *MI) {
   assert(MI->GetOperandsNumber() == 2 && "ZEXT must have exactly 2 operands");
   auto ParentBB = MI->GetParent();
@@ -163,7 +265,8 @@ bool AArch64InstructionLegalizer::ExpandGLOBAL_ADDRESS(MachineInstruction *MI) {
 
   auto GlobalVar = *MI->GetOperand(1);
   assert(GlobalVar.IsGlobalSymbol() && "Operand #2 must be a symbol");
-  auto GlobalVarName = ":lo12:" + GlobalVar.GetGlobalSymbol();
+  auto GlobalVarName =
+      Symbol(":lo12:" + GlobalVar.GetGlobalSymbol().GetString());
 
   MI->SetOpcode(ADRP);
 
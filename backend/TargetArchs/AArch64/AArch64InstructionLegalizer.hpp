@@ -19,8 +19,11 @@ public:
 
   /// Since AArch64 does not support for immediate operand as first source
   /// operand for SUB (and for other arithmetic instruction as well), therefore
-  /// it has to be materialized first into a register
+  /// it has to be materialized first into a register. The same goes for an
+  /// immediate last operand which does not fit into 12 bits.
   bool ExpandSUB(MachineInstruction *MI) override;
+  bool ExpandADD(MachineInstruction *MI) override;
+  bool ExpandCMP(MachineInstruction *MI) override;
 
   /// Since AArch64 does not support for immediate operand as last source
   /// operand for some arithmetic instruction, therefore it has to be
@@ -34,6 +37,13 @@ public:
   /// previous load into a ZEXT_LOAD.
   bool ExpandZEXT(MachineInstruction *MI) override;
 
+  /// A mov can only set 16 bits of a register, the rest of a wider immediate
+  /// is set by movk instructions, 16 bits by each. Example:
+  ///   mov  w0, #57920
+  ///   movk w0, #1, lsl #16
+  bool ExpandLOAD_IMM(MachineInstruction *MI) override;
+  bool ExpandMOV(MachineInstruction *MI) override;
+
   /// The global address materialization happens in two steps on arm. Example:
   ///   adrp x0, global_var
   ///   add  x0, x0, :lo12:global_var
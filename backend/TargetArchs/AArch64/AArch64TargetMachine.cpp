@@ -310,11 +310,20 @@ bool AArch64TargetMachine::SelectZEXT_LOAD(MachineInstruction *MI) {
   return true;
 }
 
+/// Only the bits of a 32 bit destination matter, so the immediate moved into
+/// it is sign extended from 32 bit, eg.: "mov w0, #-1" sets all of its bits.
+static void TruncateImmediate(MachineInstruction *MI) {
+  auto ImmMO = MI->GetOperand(1);
+  if (MI->GetOperand(0)->GetSize() <= 32)
+    ImmMO->SetValue((uint64_t)(int64_t)(int32_t)ImmMO->GetImmediate());
+}
+
 bool AArch64TargetMachine::SelectLOAD_IMM(MachineInstruction *MI) {
   assert(MI->GetOperandsNumber() == 2 &&
          "LOAD_IMM must have exactly 2 operands");
 
   assert(MI->GetOperand(1)->IsImmediate() && "Operand #2 must be an immediate");
+  TruncateImmediate(MI);
   assert(IsInt<16>(MI->GetOperand(1)->GetImmediate()) &&
          "Ivalid immediate value");
 
@@ -326,6 +335,7 @@ bool AArch64TargetMachine::SelectMOV(MachineInstruction *MI) {
   assert(MI->GetOperandsNumber() == 2 && "MOV must have exactly 2 operands");
 
   if (MI->GetOperand(1)->IsImmediate()) {
+    TruncateImmediate(MI);
     assert(IsInt<16>(MI->GetOperand(1)->GetImmediate()) &&
            "Invalid immediate value");
     MI->SetOpcode(MOV_rc);
@@ -70,8 +70,8 @@ bool TargetInstructionLegalizer::ExpandSTORE(MachineInstruction *MI) {
 
   // Create the result register where the immediate will be loaded
   auto LOAD_IMMResult = ParentFunc->GetNextAvailableVReg();
-  auto LOAD_IMMResultVReg =
-      MachineOperand::CreateVirtualRegister(LOAD_IMMResult);
+  auto LOAD_IMMResultVReg = MachineOperand::CreateVirtualRegister(
+      LOAD_IMMResult, Immediate.GetSize());
 
   // Replace the immediate operand with the result register
   MI->RemoveOperand(1);
@@ -93,6 +93,8 @@ bool TargetInstructionLegalizer::Expand(MachineInstruction *MI) {
     return ExpandMOD(MI, MI->GetOpcode() == MachineInstruction::MODU);
   case MachineInstruction::STORE:
     return ExpandSTORE(MI);
+  case MachineInstruction::ADD:
+    return ExpandADD(MI);
   case MachineInstruction::SUB:
     return ExpandSUB(MI);
   case MachineInstruction::MUL:
@@ -101,8 +103,14 @@ bool TargetInstructionLegalizer::Expand(MachineInstruction *MI) {
     return ExpandDIV(MI);
   case MachineInstruction::DIVU:
     return ExpandDIVU(MI);
+  case MachineInstruction::CMP:
+    return ExpandCMP(MI);
   case MachineInstruction::ZEXT:
     return ExpandZEXT(MI);
+  case MachineInstruction::LOAD_IMM:
+    return ExpandLOAD_IMM(MI);
+  case MachineInstruction::MOV:
+    return ExpandMOV(MI);
   case MachineInstruction::GLOBAL_ADDRESS:
     return ExpandGLOBAL_ADDRESS(MI);
   default:
@@ -20,11 +20,15 @@ public:
 
   virtual bool ExpandMOD(MachineInstruction *MI, bool IsUnsigned);
   virtual bool ExpandSTORE(MachineInstruction *MI);
+  virtual bool ExpandADD(MachineInstruction *MI) { return false; }
   virtual bool ExpandSUB(MachineInstruction *MI) { return false; }
   virtual bool ExpandMUL(MachineInstruction *MI) { return false; }
   virtual bool ExpandDIV(MachineInstruction *MI) { return false; }
   virtual bool ExpandDIVU(MachineInstruction *MI) { return false; }
+  virtual bool ExpandCMP(MachineInstruction *MI) { return false; }
   virtual bool ExpandZEXT(MachineInstruction *MI) { return false; }
+  virtual bool ExpandLOAD_IMM(MachineInstruction *MI) { return false; }
+  virtual bool ExpandMOV(MachineInstruction *MI) { return false; }
   virtual bool ExpandGLOBAL_ADDRESS(MachineInstruction *MI) { return false; }
 
   /// Expanding the instruction into other ones which are compute the same
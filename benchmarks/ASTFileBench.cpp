@@ -0,0 +1,73 @@
+// Compares preprocessing and parsing a translation unit with reading back its
+// AST file. Both leave the same AST in the context, ready for the IR
+// generation.
+
+#include "../frontend/ast/ASTFile.hpp"
+#include "../frontend/parser/Parser.hpp"
+#include "../frontend/preprocessor/PreProcessor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+static std::string GenerateSource(unsigned Functions) {
+  std::string Src = "struct Point {\n  int x;\n  int y;\n};\n";
+  Src += "typedef int i32;\n";
+  for (unsigned i = 0; i < Functions; i++) {
+    auto Id = std::to_string(i);
+    Src += "int function_" + Id + "(int a, int b) {\n";
+    Src += "  struct Point p;\n  i32 sum = 0;\n";
+    Src += "  p.x = a;\n  p.y = b * " + Id + ";\n";
+    Src += "  for (int i = 0; i < a; i = i + 1) {\n";
+    Src += "    if (i > b)\n      sum = sum + i * p.x;\n";
+    Src += "    else\n      sum = sum - p.y;\n  }\n";
+    Src += "  return sum;\n}\n";
+  }
+  return Src;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned Functions = argc > 1 ? std::stoul(argv[1]) : 5000;
+  unsigned Runs = 5;
+  auto Src = GenerateSource(Functions);
+
+  std::string Content;
+  size_t Nodes = 0;
+  double ParseSeconds = 0, ReadSeconds = 0;
+  for (unsigned Run = 0; Run < Runs; Run++) {
+    SourceManager SM;
+    auto Start = std::chrono::steady_clock::now();
+    auto ID = SM.AddBuffer(Src, "ast-file-bench.c");
+    PreProcessor PP(SM, ID, "ast-file-bench.c");
+    ASTContext Ctx;
+    Parser P(SM, PP, Ctx, nullptr);
+    auto AST = P.Parse();
+    auto End = std::chrono::steady_clock::now();
+
+    if (Run == 0) {
+      Content = ASTFile::Write(static_cast<TranslationUnit *>(AST));
+      Nodes = Ctx.GetNumNodes();
+    }
+
+    double Seconds = std::chrono::duration<double>(End - Start).count();
+    ParseSeconds = Run == 0 ? Seconds : std::min(ParseSeconds, Seconds);
+  }
+
+  for (unsigned Run = 0; Run < Runs; Run++) {
+    auto Start = std::chrono::steady_clock::now();
+    ASTContext Ctx;
+    if (!ASTFile::Read(Content, Ctx) || Ctx.GetNumNodes() != Nodes)
+      return 1;
+    auto End = std::chrono::steady_clock::now();
+
+    double Seconds = std::chrono::duration<double>(End - Start).count();
+    ReadSeconds = Run == 0 ? Seconds : std::min(ReadSeconds, Seconds);
+  }
+
+  std::printf("%u functions, %zu nodes\n", Functions, Nodes);
+  std::printf("source:   %8zu bytes\n", Src.size());
+  std::printf("ast file: %8zu bytes\n", Content.size());
+  std::printf("parse:    %8.2f ms\n", ParseSeconds * 1000);
+  std::printf("read ast: %8.2f ms\n", ReadSeconds * 1000);
+  return 0;
+}
@@ -0,0 +1,85 @@
+// Times the IR generation and the structural hashing of a large translation
+// unit, the two traversals which visit every node of the AST.
+
+#include "../backend/TargetArchs/AArch64/AArch64TargetMachine.hpp"
+#include "../frontend/ast/ASTProfile.hpp"
+#include "../frontend/ast/IRCodegen.hpp"
+#include "../frontend/parser/Parser.hpp"
+#include "../frontend/preprocessor/PreProcessor.hpp"
+#include "../middle_end/IR/IRFactory.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+static std::string GenerateSource(unsigned Functions) {
+  std::string Src = "int global_counter;\n";
+  for (unsigned i = 0; i < Functions; i++) {
+    auto Id = std::to_string(i);
+    Src += "int function_" + Id + "(int a, int b) {\n";
+    Src += "  int sum = 0;\n  int arr[8];\n";
+    Src += "  for (int i = 0; i < 8; i = i + 1)\n    arr[i] = a * i + b;\n";
+    Src += "  while (a > 0 && b != " + Id + ") {\n";
+    Src += "    if (a % 3 == 0)\n      sum = sum + arr[a % 8] * 2 - b;\n";
+    Src += "    else\n      sum = sum - (a << 1) + (b >> 2);\n";
+    Src += "    a = a - 1;\n  }\n";
+    Src += "  switch (sum) {\n  case 0:\n    sum = b;\n    break;\n";
+    Src += "  default:\n    sum = sum + global_counter;\n  }\n";
+    if (i > 0)
+      Src += "  sum = sum + function_" + std::to_string(i - 1) + "(b, a);\n";
+    Src += "  return sum > 100 ? sum : -sum;\n}\n";
+  }
+  return Src;
+}
+
+struct Times {
+  double Codegen = 0;
+  double Profile = 0;
+};
+
+static Times Run(const std::string &Src, size_t &Nodes) {
+  SourceManager SM;
+  auto ID = SM.AddBuffer(Src, "traversal-bench.c");
+  PreProcessor PP(SM, ID, "traversal-bench.c");
+  ASTContext Ctx;
+  AArch64::AArch64TargetMachine TM;
+  Module IRModule;
+  IRFactory IRF(IRModule, &TM);
+  Parser P(SM, PP, Ctx, &IRF);
+  auto AST = static_cast<TranslationUnit *>(P.Parse());
+  Nodes = Ctx.GetNumNodes();
+
+  Times T;
+  auto Start = std::chrono::steady_clock::now();
+  ASTProfile Profile;
+  Profile.Visit(AST);
+  Profile.Final();
+  auto End = std::chrono::steady_clock::now();
+  T.Profile = std::chrono::duration<double>(End - Start).count();
+
+  Start = std::chrono::steady_clock::now();
+  IRCodegen(&IRF).Visit(AST);
+  End = std::chrono::steady_clock::now();
+  T.Codegen = std::chrono::duration<double>(End - Start).count();
+  return T;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned Functions = argc > 1 ? std::stoul(argv[1]) : 2000;
+  unsigned Runs = 5;
+  auto Src = GenerateSource(Functions);
+
+  Times Best;
+  size_t Nodes = 0;
+  for (unsigned i = 0; i < Runs; i++) {
+    auto T = Run(Src, Nodes);
+    Best.Codegen = i == 0 ? T.Codegen : std::min(Best.Codegen, T.Codegen);
+    Best.Profile = i == 0 ? T.Profile : std::min(Best.Profile, T.Profile);
+  }
+
+  std::printf("%u functions, %zu bytes, %zu nodes\n", Functions, Src.size(),
+              Nodes);
+  std::printf("IR codegen: %8.3f ms\n", Best.Codegen * 1e3);
+  std::printf("profile:    %8.3f ms\n", Best.Profile * 1e3);
+  return 0;
+}
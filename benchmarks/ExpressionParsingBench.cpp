@@ -0,0 +1,113 @@
+// Stress test of the expression parser with machine generated expressions of
+// 100k terms: an unrolled polynomial, a chain of assignments and a chain of
+// ternary operators. The last two nest to the right, so a recursive parser
+// would need a stack frame per term. The shape of every tree is checked.
+
+#include "../frontend/parser/Parser.hpp"
+#include "../frontend/preprocessor/PreProcessor.hpp"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+static std::string GeneratePolynomial(unsigned Terms) {
+  std::string Expr = "1";
+  for (unsigned i = 1; i < Terms; i++)
+    Expr += std::string(i % 2 ? " + " : " - ") + "x * " + std::to_string(i);
+  return Expr;
+}
+
+static std::string GenerateAssignments(unsigned Terms) {
+  std::string Expr;
+  for (unsigned i = 0; i < Terms; i++)
+    Expr += "a = ";
+  return Expr + "x";
+}
+
+static std::string GenerateTernaries(unsigned Terms) {
+  std::string Expr;
+  for (unsigned i = 0; i < Terms; i++) {
+    auto Id = std::to_string(i);
+    Expr += "x < " + Id + " ? " + Id + " : ";
+  }
+  return Expr + "0";
+}
+
+/// Returns the number of times @Next could step from @E to a child.
+static unsigned
+GetChainLength(Expression *E, std::function<Expression *(Expression *)> Next) {
+  unsigned Length = 0;
+  while ((E = Next(E)))
+    Length++;
+  return Length;
+}
+
+static Expression *LeftOperand(Expression *E) {
+  auto Binary = DynCast<BinaryExpression>(E);
+  if (!Binary || Binary->GetOperation().GetKind() == Token::Astrix)
+    return nullptr;
+  return Binary->GetLeftExpr();
+}
+
+static Expression *RightOperand(Expression *E) {
+  auto Binary = DynCast<BinaryExpression>(E);
+  return Binary ? Binary->GetRightExpr() : nullptr;
+}
+
+static Expression *FalseOperand(Expression *E) {
+  auto Ternary = DynCast<TernaryExpression>(E);
+  return Ternary ? Ternary->GetExprIfFalse() : nullptr;
+}
+
+/// Parse "a = Expr;" and return the length of the chain of @Next from Expr.
+static unsigned Parse(const std::string &Expr,
+                      std::function<Expression *(Expression *)> Next,
+                      double &Seconds) {
+  auto Src = "int test(int x) {\n  int a;\n  a = " + Expr +
+             ";\n  return a;\n}\n";
+
+  SourceManager SM;
+  auto ID = SM.AddBuffer(Src, "expression-bench.c");
+  PreProcessor PP(SM, ID, "expression-bench.c");
+  ASTContext Ctx;
+  Parser P(SM, PP, Ctx, nullptr);
+
+  auto Start = std::chrono::steady_clock::now();
+  auto AST = static_cast<TranslationUnit *>(P.Parse());
+  auto End = std::chrono::steady_clock::now();
+  Seconds = std::chrono::duration<double>(End - Start).count();
+
+  auto Function =
+      static_cast<FunctionDeclaration *>(AST->GetDeclarations()[0]);
+  auto Statement =
+      static_cast<ExpressionStatement *>(Function->GetBody()->GetStatements()[1]);
+  auto Assignment = static_cast<BinaryExpression *>(Statement->GetExpression());
+  return GetChainLength(Assignment->GetRightExpr(), Next);
+}
+
+int main(int argc, char *argv[]) {
+  unsigned Terms = argc > 1 ? std::stoul(argv[1]) : 100000;
+
+  struct {
+    const char *Name;
+    std::string Expr;
+    std::function<Expression *(Expression *)> Next;
+    unsigned ExpectedLength;
+  } Cases[] = {
+      {"polynomial", GeneratePolynomial(Terms), LeftOperand, Terms - 1},
+      {"assignments", GenerateAssignments(Terms), RightOperand, Terms},
+      {"ternaries", GenerateTernaries(Terms), FalseOperand, Terms},
+  };
+
+  bool Failed = false;
+  for (auto &Case : Cases) {
+    double Seconds;
+    auto Length = Parse(Case.Expr, Case.Next, Seconds);
+    std::printf("%-12s %u terms, %8zu bytes: %8.3f ms  %s\n", Case.Name,
+                Terms, Case.Expr.size(), Seconds * 1e3,
+                Length == Case.ExpectedLength ? "ok" : "WRONG TREE");
+    Failed |= Length != Case.ExpectedLength;
+  }
+
+  return Failed ? 1 : 0;
+}
@@ -0,0 +1,71 @@
+// Compares parsing a translation unit with many static helper functions,
+// only a few of them called, eagerly and lazily. The lazy parser only brace
+// matches the bodies of the helpers which are never called.
+
+#include "../frontend/parser/Parser.hpp"
+#include "../frontend/preprocessor/PreProcessor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+static std::string GenerateSource(unsigned Helpers, unsigned Called) {
+  std::string Src;
+  for (unsigned i = 0; i < Helpers; i++) {
+    auto Id = std::to_string(i);
+    Src += "static int helper_" + Id + "(int a, int b) {\n";
+    Src += "  int sum = 0;\n";
+    Src += "  for (int i = 0; i < a; i = i + 1) {\n";
+    Src += "    if (i > b)\n      sum = sum + i * " + Id + ";\n";
+    Src += "    else\n      sum = sum - b;\n  }\n";
+    Src += "  return sum;\n}\n";
+  }
+
+  Src += "int test(int a) {\n  int r = 0;\n";
+  for (unsigned i = 0; i < Called; i++)
+    Src += "  r = r + helper_" + std::to_string(i * (Helpers / Called)) +
+           "(a, 2);\n";
+  Src += "  return r;\n}\n";
+  return Src;
+}
+
+static double Parse(const std::string &Src, bool Lazy, size_t &Functions) {
+  SourceManager SM;
+  auto Start = std::chrono::steady_clock::now();
+  auto ID = SM.AddBuffer(Src, "lazy-bench.c");
+  PreProcessor PP(SM, ID, "lazy-bench.c");
+  ASTContext Ctx;
+  Parser P(SM, PP, Ctx, nullptr);
+  if (Lazy)
+    P.EnableLazyParsing();
+  auto AST = static_cast<TranslationUnit *>(P.Parse());
+  auto End = std::chrono::steady_clock::now();
+
+  Functions = AST->GetDeclarations().size();
+  return std::chrono::duration<double>(End - Start).count();
+}
+
+int main(int argc, char *argv[]) {
+  unsigned Helpers = argc > 1 ? std::stoul(argv[1]) : 5000;
+  unsigned Called = argc > 2 ? std::stoul(argv[2]) : 10;
+  unsigned Runs = 5;
+  auto Src = GenerateSource(Helpers, std::max(1u, Called));
+
+  double EagerSeconds = 0, LazySeconds = 0;
+  size_t EagerFunctions = 0, LazyFunctions = 0;
+  for (unsigned Run = 0; Run < Runs; Run++) {
+    auto Eager = Parse(Src, false, EagerFunctions);
+    auto Lazy = Parse(Src, true, LazyFunctions);
+    EagerSeconds = Run == 0 ? Eager : std::min(EagerSeconds, Eager);
+    LazySeconds = Run == 0 ? Lazy : std::min(LazySeconds, Lazy);
+  }
+
+  std::printf("%u helpers, %u called, %zu bytes\n", Helpers, Called,
+              Src.size());
+  std::printf("eager: %8.3f ms  %zu functions\n", EagerSeconds * 1e3,
+              EagerFunctions);
+  std::printf("lazy:  %8.3f ms  %zu functions\n", LazySeconds * 1e3,
+              LazyFunctions);
+  std::printf("speedup: %.2fx\n", EagerSeconds / LazySeconds);
+  return 0;
+}
@@ -0,0 +1,56 @@
+// Measures the parser's Lex()/GetCurrentToken() hot loop while keeping a
+// given number of tokens looked ahead. The cost per token should not depend
+// on the lookahead depth.
+
+#include "../frontend/lexer/Lexer.hpp"
+#include "../frontend/lexer/SourceManager.hpp"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+static std::string GenerateSource(unsigned Functions) {
+  std::string Src;
+  for (unsigned i = 0; i < Functions; i++) {
+    auto Id = std::to_string(i);
+    Src += "int func" + Id + "(int a, int b) {\n";
+    Src += "  int c = a * " + Id + " + b;\n";
+    Src += "  while (c > 0) { c -= 3; a += c << 1; }\n";
+    Src += "  return a >= b ? a : b;\n";
+    Src += "}\n";
+  }
+  return Src;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned Functions = argc > 1 ? std::stoul(argv[1]) : 20000;
+
+  SourceManager SM;
+  auto ID = SM.AddBuffer(GenerateSource(Functions), "bench.c");
+
+  std::printf("%10s %12s %12s\n", "lookahead", "tokens", "ns/token");
+
+  for (unsigned Depth = 1; Depth <= Lexer::MaxLookAhead; Depth *= 2) {
+    Lexer L(SM, ID);
+    unsigned long Tokens = 0;
+    unsigned long Kinds = 0;
+
+    // fill the buffer once, then every step consumes the current token and
+    // keeps Depth tokens looked ahead by lexing one more
+    L.LookAhead(Depth);
+
+    auto Start = std::chrono::steady_clock::now();
+    while (L.GetCurrentToken().GetKind() != Token::EndOfFile) {
+      Kinds += L.Lex().GetKind();
+      Kinds += L.LookAhead(Depth).GetKind();
+      Tokens++;
+    }
+    auto End = std::chrono::steady_clock::now();
+
+    double Ns = std::chrono::duration<double, std::nano>(End - Start).count();
+    std::printf("%10u %12lu %12.2f\n", Depth, Tokens, Ns / Tokens);
+    if (Kinds == 0)
+      std::printf("unexpected empty token stream\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,70 @@
+// Measures lexing throughput of machine generated looking C code, with deep
+// indentation and large comment banners, for every character scanning
+// instruction set supported by the host.
+
+#include "../frontend/lexer/CharScan.hpp"
+#include "../frontend/lexer/Lexer.hpp"
+#include "../frontend/lexer/SourceManager.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+static std::string GenerateSource(unsigned Functions) {
+  std::string Banner = "//" + std::string(118, '=') + "\n";
+  std::string Src;
+  for (unsigned i = 0; i < Functions; i++) {
+    auto Id = std::to_string(i);
+    Src += Banner;
+    Src += "// Generated function " + Id + ". " + std::string(80, '-') + "\n";
+    Src += Banner;
+    Src += "int generated_function_with_a_long_name_" + Id + "(int a) {\n";
+    for (unsigned Depth = 1; Depth <= 8; Depth++) {
+      std::string Indent(Depth * 8, ' ');
+      Src += Indent + "if (a > " + std::to_string(Depth * 1000000) + ") {\n";
+      Src += Indent + "    a = a - generated_constant_value_" + Id + ";\n";
+    }
+    for (unsigned Depth = 8; Depth >= 1; Depth--)
+      Src += std::string(Depth * 8, ' ') + "}\n";
+    Src += "    return a;\n}\n\n";
+  }
+  return Src;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned Functions = argc > 1 ? std::stoul(argv[1]) : 10000;
+  unsigned Runs = 5;
+
+  SourceManager SM;
+  auto ID = SM.AddBuffer(GenerateSource(Functions), "bench.c");
+  double MegaBytes = SM.GetBuffer(ID).size() / (1024.0 * 1024.0);
+
+  std::printf("input: %.2f MB\n", MegaBytes);
+  std::printf("%8s %12s %12s %12s\n", "isa", "tokens", "ms", "MB/s");
+
+  for (auto ISA : {CharScanISA::Scalar, CharScanISA::SSE2, CharScanISA::AVX2}) {
+    if (!SelectCharScanKernels(ISA))
+      continue;
+
+    unsigned long Tokens = 0;
+    double BestSeconds = 0;
+
+    for (unsigned Run = 0; Run < Runs; Run++) {
+      Lexer L(SM, ID);
+      Tokens = 0;
+
+      auto Start = std::chrono::steady_clock::now();
+      while (L.Lex().GetKind() != Token::EndOfFile)
+        Tokens++;
+      auto End = std::chrono::steady_clock::now();
+
+      double Seconds = std::chrono::duration<double>(End - Start).count();
+      BestSeconds = Run == 0 ? Seconds : std::min(BestSeconds, Seconds);
+    }
+
+    std::printf("%8s %12lu %12.2f %12.2f\n", GetCharScanKernels().Name, Tokens,
+                BestSeconds * 1000, MegaBytes / BestSeconds);
+  }
+
+  return 0;
+}
@@ -0,0 +1,61 @@
+// Measures the raw lexing throughput on a large synthetic translation unit
+// which contains every token kind. Reports the best of several runs.
+
+#include "../frontend/lexer/Lexer.hpp"
+#include "../frontend/lexer/SourceManager.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+static std::string GenerateSource(unsigned Functions) {
+  std::string Src;
+  for (unsigned i = 0; i < Functions; i++) {
+    auto Id = std::to_string(i);
+    Src += "// function number " + Id + "\n";
+    Src += "unsigned long compute_" + Id + "(int *values, double scale) {\n";
+    Src += "  unsigned long result = " + Id + ";\n";
+    Src += "  for (int idx = 0; idx < 16; idx++) {\n";
+    Src += "    if (values[idx] >= 3 && values[idx] != 7)\n";
+    Src += "      result += values[idx] << 2;\n";
+    Src += "    else\n";
+    Src += "      result -= (result >> 1) % 5;\n";
+    Src += "  }\n";
+    Src += "  scale *= 3.14159;\n";
+    Src += "  return result == 0 ? 1 : result;\n";
+    Src += "}\n\n";
+  }
+  return Src;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned Functions = argc > 1 ? std::stoul(argv[1]) : 50000;
+  unsigned Runs = 5;
+
+  SourceManager SM;
+  auto ID = SM.AddBuffer(GenerateSource(Functions), "bench.c");
+  double MegaBytes = SM.GetBuffer(ID).size() / (1024.0 * 1024.0);
+
+  unsigned long Tokens = 0;
+  double BestSeconds = 0;
+
+  for (unsigned Run = 0; Run < Runs; Run++) {
+    Lexer L(SM, ID);
+    Tokens = 0;
+
+    auto Start = std::chrono::steady_clock::now();
+    while (L.Lex().GetKind() != Token::EndOfFile)
+      Tokens++;
+    auto End = std::chrono::steady_clock::now();
+
+    double Seconds = std::chrono::duration<double>(End - Start).count();
+    BestSeconds = Run == 0 ? Seconds : std::min(BestSeconds, Seconds);
+  }
+
+  std::printf("input:    %.2f MB, %lu tokens\n", MegaBytes, Tokens);
+  std::printf("time:     %.2f ms\n", BestSeconds * 1000);
+  std::printf("tokens/s: %.2f M\n", Tokens / BestSeconds / 1e6);
+  std::printf("MB/s:     %.2f\n", MegaBytes / BestSeconds);
+
+  return 0;
+}
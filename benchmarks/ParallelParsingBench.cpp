@@ -0,0 +1,73 @@
+// Parses a translation unit with many independent functions, like the
+// generated ones, serially and with the bodies parsed in parallel on an
+// increasing number of threads.
+
+#include "../frontend/parser/Parser.hpp"
+#include "../frontend/preprocessor/PreProcessor.hpp"
+#include "../support/ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+static std::string GenerateSource(unsigned Functions) {
+  std::string Src = "struct Point {\n  int x;\n  int y;\n};\n";
+  Src += "typedef int i32;\n";
+  for (unsigned i = 0; i < Functions; i++) {
+    auto Id = std::to_string(i);
+    Src += "int function_" + Id + "(int a, int b) {\n";
+    Src += "  struct Point p;\n  i32 sum = 0;\n";
+    Src += "  p.x = a;\n  p.y = b * " + Id + ";\n";
+    Src += "  for (int i = 0; i < a; i = i + 1) {\n";
+    Src += "    if (i > b)\n      sum = sum + i * p.x;\n";
+    Src += "    else\n      sum = sum - p.y;\n  }\n";
+    Src += "  return sum;\n}\n";
+  }
+  return Src;
+}
+
+/// Parse with the bodies parsed on @Threads threads, serially if 0.
+static double Parse(const std::string &Src, unsigned Threads,
+                    size_t &Nodes) {
+  SourceManager SM;
+  auto Start = std::chrono::steady_clock::now();
+  auto ID = SM.AddBuffer(Src, "parallel-bench.c");
+  PreProcessor PP(SM, ID, "parallel-bench.c");
+  ASTContext Ctx;
+  Parser P(SM, PP, Ctx, nullptr);
+  if (Threads)
+    P.EnableParallelParsing(Threads);
+  P.Parse();
+  auto End = std::chrono::steady_clock::now();
+
+  Nodes = Ctx.GetNumNodes();
+  return std::chrono::duration<double>(End - Start).count();
+}
+
+int main(int argc, char *argv[]) {
+  unsigned Functions = argc > 1 ? std::stoul(argv[1]) : 5000;
+  unsigned MaxThreads =
+      argc > 2 ? std::stoul(argv[2]) : ThreadPool::GetHardwareConcurrency();
+  unsigned Runs = 5;
+  auto Src = GenerateSource(Functions);
+
+  std::printf("%u functions, %zu bytes\n", Functions, Src.size());
+
+  double SerialSeconds = 0;
+  for (unsigned Threads = 0; Threads <= MaxThreads;
+       Threads = Threads ? Threads * 2 : 1) {
+    double Seconds = 0;
+    size_t Nodes = 0;
+    for (unsigned Run = 0; Run < Runs; Run++) {
+      auto Time = Parse(Src, Threads, Nodes);
+      Seconds = Run == 0 ? Time : std::min(Seconds, Time);
+    }
+    if (Threads == 0) {
+      SerialSeconds = Seconds;
+      std::printf("serial:     %8.3f ms  %zu nodes\n", Seconds * 1e3, Nodes);
+    } else
+      std::printf("%2u threads: %8.3f ms  %zu nodes  %.2fx\n", Threads,
+                  Seconds * 1e3, Nodes, SerialSeconds / Seconds);
+  }
+  return 0;
+}
@@ -0,0 +1,67 @@
+// Compares preprocessing, lexing and parsing a big translation unit one
+// after the other, with the parser pulling the preprocessor output, and
+// pipelined, with the preprocessor and the lexer on threads of their own.
+
+#include "../frontend/lexer/PipelinedLexer.hpp"
+#include "../frontend/parser/Parser.hpp"
+#include "../frontend/preprocessor/PreProcessor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+static std::string GenerateSource(unsigned Functions) {
+  std::string Src = "#define SCALE(x) ((x) * 3 + 1)\n#define LIMIT 100\n";
+  for (unsigned i = 0; i < Functions; i++) {
+    auto Id = std::to_string(i);
+    Src += "int function_" + Id + "(int a, int b) {\n";
+    Src += "  int sum = 0;\n";
+    Src += "  for (int i = 0; i < LIMIT; i = i + 1) {\n";
+    Src += "    if (i > b)\n      sum = sum + SCALE(i) * " + Id + ";\n";
+    Src += "    else\n      sum = sum - SCALE(b);\n  }\n";
+    Src += "  return sum;\n}\n";
+  }
+  return Src;
+}
+
+static double Parse(const std::string &Src, bool Pipelined, size_t &Nodes) {
+  SourceManager SM;
+  auto Start = std::chrono::steady_clock::now();
+  auto ID = SM.AddBuffer(Src, "pipeline-bench.c");
+  PreProcessor PP(SM, ID, "pipeline-bench.c");
+  ASTContext Ctx;
+  if (Pipelined) {
+    PipelinedLexer Pipeline(SM, PP);
+    Parser(SM, Pipeline, Ctx, nullptr).Parse();
+  } else
+    Parser(SM, PP, Ctx, nullptr).Parse();
+  auto End = std::chrono::steady_clock::now();
+
+  Nodes = Ctx.GetNumNodes();
+  return std::chrono::duration<double>(End - Start).count();
+}
+
+int main(int argc, char *argv[]) {
+  unsigned Functions = argc > 1 ? std::stoul(argv[1]) : 5000;
+  unsigned Runs = 5;
+  auto Src = GenerateSource(Functions);
+
+  double SequentialSeconds = 0, PipelinedSeconds = 0;
+  size_t SequentialNodes = 0, PipelinedNodes = 0;
+  for (unsigned Run = 0; Run < Runs; Run++) {
+    auto Sequential = Parse(Src, false, SequentialNodes);
+    auto Pipelined = Parse(Src, true, PipelinedNodes);
+    SequentialSeconds =
+        Run == 0 ? Sequential : std::min(SequentialSeconds, Sequential);
+    PipelinedSeconds =
+        Run == 0 ? Pipelined : std::min(PipelinedSeconds, Pipelined);
+  }
+
+  std::printf("%u functions, %zu bytes\n", Functions, Src.size());
+  std::printf("sequential: %8.3f ms  %zu nodes\n", SequentialSeconds * 1e3,
+              SequentialNodes);
+  std::printf("pipelined:  %8.3f ms  %zu nodes\n", PipelinedSeconds * 1e3,
+              PipelinedNodes);
+  std::printf("speedup: %.2fx\n", SequentialSeconds / PipelinedSeconds);
+  return 0;
+}
@@ -0,0 +1,73 @@
+// Measures the preprocessor on a file which defines many macros but uses only
+// a few of them on every fourth line, so the time should not depend on the
+// number of defined macros. The other lines have no macro invocation.
+//
+// The given percentage of the blocks of 16 lines can be put into disabled
+// #ifdef regions, like in a configuration header. Skipping them should cost
+// much less than preprocessing the same lines.
+
+#include "../frontend/lexer/SourceManager.hpp"
+#include "../frontend/preprocessor/PreProcessor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+static std::string GenerateSource(unsigned Macros, unsigned Lines,
+                                  unsigned DisabledPercent) {
+  std::string Src;
+  for (unsigned i = 0; i < Macros; i++)
+    Src += "#define VALUE_" + std::to_string(i) + "_END " + std::to_string(i) +
+           "\n";
+  Src += "#define MAX(a, b) (((a) > (b)) ? (a) : (b))\n\n";
+
+  Src += "int test(int a, int b) {\n";
+  for (unsigned i = 0; i < Lines; i++) {
+    bool Disabled = (i / 16) % 100 < DisabledPercent;
+    if (Disabled && i % 16 == 0)
+      Src += "#ifdef CONFIG_UNSET\n";
+
+    auto Id = std::to_string(i % Macros);
+    if (i % 4 == 0)
+      Src += "  a = MAX(a, b) + VALUE_" + Id + "_END * (b - a) % 7;\n";
+    else
+      Src += "  b = b + a * (b - " + Id + ") % 7;\n";
+
+    if (Disabled && (i % 16 == 15 || i + 1 == Lines))
+      Src += "#endif\n";
+  }
+  Src += "  return a;\n}\n";
+  return Src;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned Macros = argc > 1 ? std::stoul(argv[1]) : 1000;
+  unsigned Lines = argc > 2 ? std::stoul(argv[2]) : 20000;
+  unsigned DisabledPercent = argc > 3 ? std::stoul(argv[3]) : 0;
+  unsigned Runs = 5;
+
+  auto Source = GenerateSource(Macros, Lines, DisabledPercent);
+  double BestSeconds = 0;
+  size_t OutputSize = 0;
+
+  for (unsigned Run = 0; Run < Runs; Run++) {
+    SourceManager SM;
+    auto ID = SM.AddBuffer(Source, "bench.c");
+
+    auto Start = std::chrono::steady_clock::now();
+    auto Output = PreProcessor(SM, ID, "bench.c").Run();
+    auto End = std::chrono::steady_clock::now();
+
+    OutputSize = Output.GetSize();
+    double Seconds = std::chrono::duration<double>(End - Start).count();
+    BestSeconds = Run == 0 ? Seconds : std::min(BestSeconds, Seconds);
+  }
+
+  std::printf("macros:   %u\n", Macros);
+  std::printf("lines:    %u\n", Lines);
+  std::printf("disabled: %u%%\n", DisabledPercent);
+  std::printf("output:   %zu bytes\n", OutputSize);
+  std::printf("time:     %.2f ms\n", BestSeconds * 1000);
+
+  return 0;
+}
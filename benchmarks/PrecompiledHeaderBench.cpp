@@ -0,0 +1,79 @@
+// Compares preprocessing and parsing a large header of declarations with
+// loading its precompiled header. Both leave the parser in the same state,
+// ready to parse the translation unit.
+
+#include "../frontend/pch/PrecompiledHeader.hpp"
+#include "../frontend/parser/Parser.hpp"
+#include "../frontend/preprocessor/PreProcessor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static std::string GenerateHeader(unsigned Decls) {
+  std::string Src;
+  for (unsigned i = 0; i < Decls; i++) {
+    auto Id = std::to_string(i);
+    Src += "#define LIMIT_" + Id + " " + Id + "\n";
+    Src += "typedef struct s" + Id + " {\n  int x;\n  unsigned y[4];\n} S" +
+           Id + ";\n";
+    Src += "enum { A_" + Id + ", B_" + Id + " };\n";
+    Src += "S" + Id + " make_" + Id + "(S" + Id + " *p, int n);\n";
+  }
+  return Src;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned Decls = argc > 1 ? std::stoul(argv[1]) : 2000;
+  unsigned Runs = 5;
+  std::string HeaderPath = "pch-bench.h";
+  std::string PCHPath = "pch-bench.pch";
+
+  std::ofstream(HeaderPath) << GenerateHeader(Decls);
+
+  double ParseSeconds = 0, LoadSeconds = 0;
+  for (unsigned Run = 0; Run < Runs; Run++) {
+    SourceManager SM;
+    auto Start = std::chrono::steady_clock::now();
+    auto ID = SM.AddFile(HeaderPath);
+    PreProcessor PP(SM, *ID, HeaderPath);
+    ASTContext Ctx;
+    Parser P(SM, PP, Ctx, nullptr);
+    auto AST = P.Parse();
+    auto End = std::chrono::steady_clock::now();
+
+    if (Run == 0 && !PrecompiledHeader::Emit(PCHPath, PP, P, AST, std::cerr))
+      return 1;
+
+    double Seconds = std::chrono::duration<double>(End - Start).count();
+    ParseSeconds = Run == 0 ? Seconds : std::min(ParseSeconds, Seconds);
+  }
+
+  for (unsigned Run = 0; Run < Runs; Run++) {
+    SourceManager SM;
+    auto Start = std::chrono::steady_clock::now();
+    auto ID = SM.AddBuffer("", "empty.c");
+    PreProcessor PP(SM, ID, "empty.c");
+    PrecompiledHeader PCH;
+    if (!PCH.Open(SM, PCHPath) || !PCH.LoadPreProcessorState(PP))
+      return 1;
+    ASTContext Ctx;
+    Parser P(SM, PP, Ctx, nullptr);
+    if (!PCH.LoadParserState(P))
+      return 1;
+    auto End = std::chrono::steady_clock::now();
+
+    double Seconds = std::chrono::duration<double>(End - Start).count();
+    LoadSeconds = Run == 0 ? Seconds : std::min(LoadSeconds, Seconds);
+  }
+
+  std::printf("declarations: %u\n", Decls);
+  std::printf("parse:        %.2f ms\n", ParseSeconds * 1000);
+  std::printf("load pch:     %.2f ms\n", LoadSeconds * 1000);
+
+  std::remove(HeaderPath.c_str());
+  std::remove(PCHPath.c_str());
+  return 0;
+}
@@ -0,0 +1,59 @@
+// Measures name resolution in the parser on a function with many locals
+// declared in nested blocks. Every statement refers to an early and a recent
+// local, and inner blocks shadow the outer declarations. The blocks are for
+// loop bodies, since those open a new scope in the parser.
+
+#include "../frontend/lexer/SourceManager.hpp"
+#include "../frontend/parser/Parser.hpp"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+static std::string GenerateSource(unsigned Locals, unsigned LocalsPerBlock) {
+  std::string Src = "int global;\n\nint test(int a) {\n";
+  unsigned Depth = 1;
+
+  for (unsigned i = 0; i < Locals; i++) {
+    auto Recent = std::to_string(i > 0 ? i - 1 : 0);
+
+    // open a new nested block after every LocalsPerBlock declarations, and
+    // shadow the last variable of the enclosing block
+    if (i % LocalsPerBlock == 0 && i != 0) {
+      auto Loop = "b" + std::to_string(Depth);
+      Src += "for (int " + Loop + " = 0; " + Loop + " < 1; " + Loop + "++) {\n";
+      Src += "  int v" + Recent + " = a;\n";
+      Depth++;
+    }
+
+    auto Id = std::to_string(i);
+    auto Early = std::to_string(i / 2);
+    Src += "  int v" + Id + " = a + global;\n";
+    Src += "  v" + Id + " = v" + Recent + " + v" + Early + ";\n";
+  }
+
+  for (; Depth > 1; Depth--)
+    Src += "}\n";
+
+  Src += "  return a;\n}\n";
+  return Src;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned Locals = argc > 1 ? std::stoul(argv[1]) : 10000;
+  unsigned LocalsPerBlock = 100;
+
+  SourceManager SM;
+  auto ID = SM.AddBuffer(GenerateSource(Locals, LocalsPerBlock), "bench.c");
+
+  auto Start = std::chrono::steady_clock::now();
+  ASTContext Ctx;
+  Parser P(SM, ID, Ctx, nullptr);
+  auto AST = P.Parse();
+  auto End = std::chrono::steady_clock::now();
+
+  double Ms = std::chrono::duration<double, std::milli>(End - Start).count();
+  std::printf("locals: %u (%u per block), parse time: %.2f ms\n", Locals,
+              LocalsPerBlock, Ms);
+
+  return AST ? 0 : 1;
+}
@@ -1,41 +1,81 @@
 #ifndef AST_HPP
 #define AST_HPP
 
-#include "../../middle_end/IR/IRFactory.hpp"
-#include "../../middle_end/IR/Value.hpp"
+#include "../../support/Symbol.hpp"
 #include "../lexer/Token.hpp"
+#include "ASTContext.hpp"
 #include "Type.hpp"
+#include "TypeContext.hpp"
 #include <cassert>
-#include <iostream>
-#include <memory>
-#include <optional>
+#include <cstdint>
 #include <string>
 #include <vector>
 
-static void PrintImpl(const char *str, unsigned tab = 0, bool newline = false) {
-  for (size_t i = 0; i < tab; i++)
-    std::cout << " ";
-  std::cout << str;
-  if (newline)
-    std::cout << std::endl;
-}
+/// The concrete node classes, for the code listing all of them, like the node
+/// kinds and ASTVisitor. The statements and the expressions are contiguous.
+#define AST_STATEMENT_NODES(X)                                                 \
+  X(VariableDeclaration)                                                       \
+  X(MemberDeclaration)                                                         \
+  X(StructDeclaration)                                                         \
+  X(EnumDeclaration)                                                           \
+  X(CompoundStatement)                                                         \
+  X(ExpressionStatement)                                                       \
+  X(IfStatement)                                                               \
+  X(SwitchStatement)                                                           \
+  X(WhileStatement)                                                            \
+  X(ForStatement)                                                              \
+  X(ReturnStatement)                                                           \
+  X(BreakStatement)                                                            \
+  X(ContinueStatement)                                                         \
+  X(FunctionParameterDeclaration)                                              \
+  X(FunctionDeclaration)                                                       \
+  X(TranslationUnit)
+
+#define AST_EXPRESSION_NODES(X)                                                \
+  X(BinaryExpression)                                                          \
+  X(TernaryExpression)                                                         \
+  X(StructMemberReference)                                                     \
+  X(StructInitExpression)                                                      \
+  X(UnaryExpression)                                                           \
+  X(CallExpression)                                                            \
+  X(ReferenceExpression)                                                       \
+  X(IntegerLiteralExpression)                                                  \
+  X(FloatLiteralExpression)                                                    \
+  X(ArrayExpression)                                                           \
+  X(ImplicitCastExpression)                                                    \
+  X(InitializerListExpression)
+
+#define AST_NODES(X) AST_STATEMENT_NODES(X) AST_EXPRESSION_NODES(X)
+
+/// Nodes are created by and live in an ASTContext, which never deletes them
+/// through a base pointer. They have no virtual functions, the traversals are
+/// ASTVisitors switching over the kind of the node and the casts are done
+/// with Isa and DynCast instead of RTTI.
+class Node {
+public:
+  enum NodeKind : uint8_t {
+#define AST_NODE_KIND(Class) Class##Kind,
+    AST_NODES(AST_NODE_KIND)
+#undef AST_NODE_KIND
+  };
 
-static void Print(const char *str, unsigned tab = 0) { PrintImpl(str, tab); }
+  NodeKind GetKind() const { return Kind; }
 
-static void PrintLn(const char *str, unsigned tab = 0) {
-  PrintImpl(str, tab, true);
-}
+protected:
+  Node(NodeKind Kind) : Kind(Kind) {}
 
-class Node {
-public:
-  virtual ~Node(){};
-  virtual void ASTDump(unsigned tab = 0) { PrintLn("Node"); }
-  virtual Value *IRCodegen(IRFactory *IRF) {
-    assert(!"Must be a child node type");
-    return nullptr;
-  }
+private:
+  NodeKind Kind;
 };
 
+/// True if @N is a @T, which might be an abstract class like Statement.
+template <typename T> bool Isa(const Node *N) { return T::classof(N); }
+
+/// @N as a @T, or nullptr if it is not one or @N is nullptr.
+template <typename T> T *DynCast(Node *N) {
+  return N && Isa<T>(N) ? static_cast<T *>(N) : nullptr;
+}
+
 class Statement : public Node {
 public:
   enum StmtInfo {
@@ -45,179 +85,147 @@ public:
 
   void AddInfo(unsigned Bit) { InfoBits |= Bit;}
 
-  void ASTDump(unsigned tab = 0) override { PrintLn("Statement", tab); }
-
   bool IsRet() { return !!(InfoBits & RETURN); }
 
+  static bool classof(const Node *N) {
+    return N->GetKind() >= VariableDeclarationKind &&
+           N->GetKind() <= TranslationUnitKind;
+  }
+
+protected:
+  Statement(NodeKind Kind) : Node(Kind) {}
+
 private:
   unsigned InfoBits = 0;
 };
 
 class Expression : public Node {
 public:
-  Expression() = default;
-  Expression(Type t) : ResultType(std::move(t)) {}
-  Expression(Type::VariantKind vk) : ResultType(vk) {}
-  Type &GetResultType() { return ResultType; }
-  void SetType(Type t) { ResultType = t; }
+  const Type *GetResultType() const { return ResultType; }
+  void SetType(const Type *t) { ResultType = t; }
 
   void SetLValueness(bool p) { IsLValue = p; }
   bool GetLValueness() { return IsLValue; }
 
-  void ASTDump(unsigned tab = 0) override { PrintLn("Expression", tab); }
+  static bool classof(const Node *N) {
+    return N->GetKind() >= BinaryExpressionKind &&
+           N->GetKind() <= InitializerListExpressionKind;
+  }
 
 protected:
+  Expression(NodeKind Kind) : Node(Kind) {}
+  Expression(NodeKind Kind, const Type *t) : Node(Kind), ResultType(t) {}
+
   bool IsLValue = false;
-  Type ResultType;
+  const Type *ResultType = TypeContext::GetInvalid();
 };
 
 class VariableDeclaration : public Statement {
 public:
-  std::string &GetName() { return Name; }
-  void SetName(std::string &s) { Name = s; }
+  Symbol GetName() const { return Name; }
+  void SetName(Symbol s) { Name = s; }
 
-  Type GetType() { return AType; }
-  void SetType(Type t) { AType = t; }
+  const Type *GetType() const { return AType; }
+  void SetType(const Type *t) { AType = t; }
 
-  std::unique_ptr<Expression> &GetInitExpr() { return Init; }
-  void SetInitExpr(std::unique_ptr<Expression> e) { Init = std::move(e); }
+  Expression *GetInitExpr() { return Init; }
+  void SetInitExpr(Expression *e) { Init = e; }
 
-  VariableDeclaration(std::string &Name, Type Ty, std::vector<unsigned> Dim)
-      : Name(Name), AType(Ty, std::move(Dim)) {}
+  VariableDeclaration(Symbol Name, const Type *Ty)
+      : Statement(VariableDeclarationKind), Name(Name), AType(Ty) {}
+  VariableDeclaration(Symbol Name, const Type *Ty, Expression *E)
+      : Statement(VariableDeclarationKind), Name(Name), AType(Ty), Init(E) {}
 
-  VariableDeclaration(std::string &Name, Type Ty) : Name(Name), AType(Ty) {}
-  VariableDeclaration(std::string &Name, Type Ty, std::unique_ptr<Expression> E)
-      : Name(Name), AType(Ty), Init(std::move(E)) {}
+  VariableDeclaration() : Statement(VariableDeclarationKind) {}
 
-  VariableDeclaration() = default;
-
-  void ASTDump(unsigned tab = 0) override {
-    Print("VariableDeclaration ", tab);
-    auto TypeStr = "'" + AType.ToString() + "' ";
-    Print(TypeStr.c_str());
-    auto NameStr = "'" + Name + "'";
-    PrintLn(NameStr.c_str());
-    if (Init)
-      Init->ASTDump(tab + 2);
+  static bool classof(const Node *N) {
+    return N->GetKind() == VariableDeclarationKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
-  std::string Name;
-  Type AType;
-  std::unique_ptr<Expression> Init = nullptr;
+  Symbol Name;
+  const Type *AType;
+  Expression *Init = nullptr;
 };
 
 class MemberDeclaration : public Statement {
 public:
-  std::string &GetName() { return Name; }
-  void SetName(std::string &s) { Name = s; }
+  Symbol GetName() const { return Name; }
+  void SetName(Symbol s) { Name = s; }
 
-  Type GetType() { return AType; }
-  void SetType(Type t) { AType = t; }
+  const Type *GetType() const { return AType; }
+  void SetType(const Type *t) { AType = t; }
 
-  MemberDeclaration(std::string &Name, Type Ty, std::vector<unsigned> Dim)
-      : Name(Name), AType(Ty, std::move(Dim)) {}
+  MemberDeclaration(Symbol Name, const Type *Ty)
+      : Statement(MemberDeclarationKind), Name(Name), AType(Ty) {}
 
-  MemberDeclaration(std::string &Name, Type Ty) : Name(Name), AType(Ty) {}
+  MemberDeclaration() : Statement(MemberDeclarationKind) {}
 
-  MemberDeclaration() = default;
-
-  void ASTDump(unsigned tab = 0) override {
-    Print("MemberDeclaration ", tab);
-    auto TypeStr = "'" + AType.ToString() + "' ";
-    Print(TypeStr.c_str());
-    auto NameStr = "'" + Name + "'";
-    PrintLn(NameStr.c_str());
+  static bool classof(const Node *N) {
+    return N->GetKind() == MemberDeclarationKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
-  std::string Name;
-  Type AType;
+  Symbol Name;
+  const Type *AType;
 };
 
 class StructDeclaration : public Statement {
 public:
-  std::string &GetName() { return Name; }
-  void SetName(std::string &s) { Name = s; }
+  Symbol GetName() const { return Name; }
+  void SetName(Symbol s) { Name = s; }
 
-  std::vector<std::unique_ptr<MemberDeclaration>> &GetMembers() {
-    return Members;
-  }
-  void SetType(std::vector<std::unique_ptr<MemberDeclaration>> m) {
-    Members = std::move(m);
-  }
+  ASTList<MemberDeclaration *> &GetMembers() { return Members; }
+  void SetType(ASTList<MemberDeclaration *> m) { Members = m; }
 
-  StructDeclaration(std::string &Name,
-                    std::vector<std::unique_ptr<MemberDeclaration>> &M,
-                    Type &StructType)
-      : Name(Name), Members(std::move(M)), SType(StructType) {}
+  const Type *GetType() const { return SType; }
 
-  StructDeclaration() = default;
+  StructDeclaration(Symbol Name, ASTList<MemberDeclaration *> M,
+                    const Type *StructType)
+      : Statement(StructDeclarationKind), Name(Name), Members(M),
+        SType(StructType) {}
 
-  void ASTDump(unsigned tab = 0) override {
-    Print("StructDeclaration '", tab);
-    Print(Name.c_str());
-    PrintLn("' ");
-    for (auto &M : Members)
-      M->ASTDump(tab + 2);
-  }
+  StructDeclaration() : Statement(StructDeclarationKind) {}
 
-  Value *IRCodegen(IRFactory *IRF) override;
+  static bool classof(const Node *N) {
+    return N->GetKind() == StructDeclarationKind;
+  }
 
 private:
-  Type SType;
-  std::string Name;
-  std::vector<std::unique_ptr<MemberDeclaration>> Members;
+  const Type *SType;
+  Symbol Name;
+  ASTList<MemberDeclaration *> Members;
 };
 
 class EnumDeclaration : public Statement {
 public:
-  using EnumList = std::vector<std::pair<std::string, int>>;
-
-  EnumDeclaration(Type &BaseType, EnumList Enumerators)
-      : BaseType(BaseType), Enumerators(std::move(Enumerators)) {}
-
-  EnumDeclaration(EnumList Enumerators)
-      : Enumerators(std::move(Enumerators)) {}
-
-  void ASTDump(unsigned tab = 0) override {
-    std::string Str = "EnumDeclaration '";
-    Str += BaseType.ToString() + "'";
-    PrintLn(Str.c_str(), tab);
-    Str.clear();
-    Str = "Enumerators ";
-    unsigned LoopCounter = 0;
-    for (auto &[Enum, Val] : Enumerators) {
-      Str += "'" + Enum + "'";
-      Str += " = " + std::to_string(Val);
-      if (++LoopCounter < Enumerators.size())
-        Str += ", ";
-    }
-    PrintLn(Str.c_str(), tab + 2);
-  }
+  using EnumList = ASTList<std::pair<Symbol, int>>;
+
+  EnumDeclaration(const Type *BaseType, EnumList Enumerators)
+      : Statement(EnumDeclarationKind), BaseType(BaseType),
+        Enumerators(Enumerators) {}
 
-  Value *IRCodegen(IRFactory *IRF) override;
+  const Type *GetBaseType() const { return BaseType; }
+  const EnumList &GetEnumerators() const { return Enumerators; }
+
+  static bool classof(const Node *N) {
+    return N->GetKind() == EnumDeclarationKind;
+  }
 
 private:
-  Type BaseType = Type(Type::Int);
+  const Type *BaseType;
   EnumList Enumerators;
 };
 
 class CompoundStatement : public Statement {
-  using StmtVec = std::vector<std::unique_ptr<Statement>>;
+  using StmtVec = ASTList<Statement *>;
 
 public:
   StmtVec &GetStatements() { return Statements; }
-  void SetStatements(StmtVec &s) { Statements = std::move(s); }
-  void AddStatement(std::unique_ptr<Statement> &s) {
-    Statements.push_back(std::move(s));
-  }
+  void SetStatements(StmtVec s) { Statements = s; }
 
-  CompoundStatement(StmtVec &Stats) : Statements(std::move(Stats)) {}
+  CompoundStatement(StmtVec Stats)
+      : Statement(CompoundStatementKind), Statements(Stats) {}
 
   CompoundStatement() = delete;
 
@@ -226,253 +234,212 @@ public:
 
   CompoundStatement(CompoundStatement &&) = default;
 
-  void ASTDump(unsigned tab = 0) override {
-    PrintLn("CompoundStatement", tab);
-    for (size_t i = 0; i < Statements.size(); i++)
-      Statements[i]->ASTDump(tab + 2);
+  static bool classof(const Node *N) {
+    return N->GetKind() == CompoundStatementKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
   StmtVec Statements;
 };
 
 class ExpressionStatement : public Statement {
 public:
-  std::unique_ptr<Expression> &GetExpression() { return Expr; }
-  void SetExpression(std::unique_ptr<Expression> e) { Expr = std::move(e); }
-  void ASTDump(unsigned tab = 0) override {
-    PrintLn("ExpressionStatement", tab);
-    Expr->ASTDump(tab + 2);
-  }
+  ExpressionStatement() : Statement(ExpressionStatementKind) {}
 
-  Value *IRCodegen(IRFactory *IRF) override;
+  Expression *GetExpression() { return Expr; }
+  void SetExpression(Expression *e) { Expr = e; }
+
+  static bool classof(const Node *N) {
+    return N->GetKind() == ExpressionStatementKind;
+  }
 
 private:
-  std::unique_ptr<Expression> Expr;
+  /// Null for an empty statement.
+  Expression *Expr = nullptr;
 };
 
 class IfStatement : public Statement {
 public:
-  std::unique_ptr<Expression> &GetCondition() { return Condition; }
-  void SetCondition(std::unique_ptr<Expression> c) { Condition = std::move(c); }
+  IfStatement() : Statement(IfStatementKind) {}
 
-  std::unique_ptr<Statement> &GetIfBody() { return IfBody; }
-  void SetIfBody(std::unique_ptr<Statement> ib) { IfBody = std::move(ib); }
+  Expression *GetCondition() { return Condition; }
+  void SetCondition(Expression *c) { Condition = c; }
 
-  std::unique_ptr<Statement> &GetElseBody() { return ElseBody; }
-  void SetElseBody(std::unique_ptr<Statement> eb) { ElseBody = std::move(eb); }
+  Statement *GetIfBody() { return IfBody; }
+  void SetIfBody(Statement *ib) { IfBody = ib; }
 
-  void ASTDump(unsigned tab = 0) override {
-    PrintLn("IfStatement", tab);
-    Condition->ASTDump(tab + 2);
-    IfBody->ASTDump(tab + 2);
-    if (ElseBody)
-      ElseBody->ASTDump(tab + 2);
-  }
+  Statement *GetElseBody() { return ElseBody; }
+  void SetElseBody(Statement *eb) { ElseBody = eb; }
 
-  Value *IRCodegen(IRFactory *IRF) override;
+  static bool classof(const Node *N) { return N->GetKind() == IfStatementKind; }
 
 private:
-  std::unique_ptr<Expression> Condition;
-  std::unique_ptr<Statement> IfBody;
-  std::unique_ptr<Statement> ElseBody = nullptr;
+  Expression *Condition;
+  Statement *IfBody;
+  Statement *ElseBody = nullptr;
 };
 
 class SwitchStatement : public Statement {
 public:
-  using VecOfStmts = std::vector<std::unique_ptr<Statement>>;
-  using VecOfCasesData = std::vector<std::pair<int, VecOfStmts>>;
+  SwitchStatement() : Statement(SwitchStatementKind) {}
+
+  using VecOfStmts = ASTList<Statement *>;
+  using VecOfCasesData = ASTList<std::pair<int, VecOfStmts>>;
 
-  std::unique_ptr<Expression> &GetCondition() { return Condition; }
-  void SetCondition(std::unique_ptr<Expression> c) { Condition = std::move(c); }
+  Expression *GetCondition() { return Condition; }
+  void SetCondition(Expression *c) { Condition = c; }
 
   VecOfCasesData &GetCaseBodies() { return Cases; }
-  void SetCaseBodies(VecOfCasesData c) { Cases = std::move(c); }
+  void SetCaseBodies(VecOfCasesData c) { Cases = c; }
 
   VecOfStmts &GetDefaultBody() { return DefaultBody; }
-  void SetDefaultBody(VecOfStmts db) { DefaultBody = std::move(db); }
-
-  void ASTDump(unsigned tab = 0) override {
-    PrintLn("SwitchStatement", tab);
-    Condition->ASTDump(tab + 2);
-
-    for (auto &[CaseConst, CaseBody] : Cases) {
-      std::string Str = "Case '" + std::to_string(CaseConst) + "'";
-      PrintLn(Str.c_str(), tab + 2);
-      Str.clear();
-      for (auto &CaseStatement : CaseBody)
-        CaseStatement->ASTDump(tab + 4);
-    }
+  void SetDefaultBody(VecOfStmts db) { DefaultBody = db; }
 
-    if (DefaultBody.size() > 0)
-      PrintLn("DefaultCase", tab + 2);
-    for (auto &DefaultStatement : DefaultBody)
-      DefaultStatement->ASTDump(tab + 4);
+  static bool classof(const Node *N) {
+    return N->GetKind() == SwitchStatementKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
-  std::unique_ptr<Expression> Condition;
+  Expression *Condition;
   VecOfCasesData Cases;
   VecOfStmts DefaultBody;
 };
 
 class WhileStatement : public Statement {
 public:
-  std::unique_ptr<Expression> &GetCondition() { return Condition; }
-  void SetCondition(std::unique_ptr<Expression> c) { Condition = std::move(c); }
+  WhileStatement() : Statement(WhileStatementKind) {}
 
-  std::unique_ptr<Statement> &GetBody() { return Body; }
-  void SetBody(std::unique_ptr<Statement> b) { Body = std::move(b); }
+  Expression *GetCondition() { return Condition; }
+  void SetCondition(Expression *c) { Condition = c; }
 
-  void ASTDump(unsigned tab = 0) override {
-    PrintLn("WhileStatement", tab);
-    Condition->ASTDump(tab + 2);
-    Body->ASTDump(tab + 2);
-  }
+  Statement *GetBody() { return Body; }
+  void SetBody(Statement *b) { Body = b; }
 
-  Value *IRCodegen(IRFactory *IRF) override;
+  static bool classof(const Node *N) {
+    return N->GetKind() == WhileStatementKind;
+  }
 
 private:
-  std::unique_ptr<Expression> Condition;
-  std::unique_ptr<Statement> Body;
+  Expression *Condition;
+  Statement *Body;
 };
 
 class ForStatement : public Statement {
 public:
-  std::unique_ptr<Statement> &GetVarDecl() { return VarDecl; }
-  void SetVarDecl(std::unique_ptr<Statement> v) { VarDecl = std::move(v); }
-
-  std::unique_ptr<Expression> &GetInit() { return Init; }
-  void SetInit(std::unique_ptr<Expression> c) { Init = std::move(c); }
-
-  std::unique_ptr<Expression> &GetCondition() { return Condition; }
-  void SetCondition(std::unique_ptr<Expression> c) { Condition = std::move(c); }
-
-  std::unique_ptr<Expression> &GetIncrement() { return Increment; }
-  void SetIncrement(std::unique_ptr<Expression> c) { Increment = std::move(c); }
-
-  std::unique_ptr<Statement> &GetBody() { return Body; }
-  void SetBody(std::unique_ptr<Statement> b) { Body = std::move(b); }
-
-  void ASTDump(unsigned tab = 0) override {
-    PrintLn("ForStatement", tab);
-    if (Init)
-      Init->ASTDump(tab + 2);
-    else
-      VarDecl->ASTDump(tab + 2);
-    Condition->ASTDump(tab + 2);
-    Increment->ASTDump(tab + 2);
-    Body->ASTDump(tab + 2);
-  }
+  ForStatement() : Statement(ForStatementKind) {}
+
+  Statement *GetVarDecl() { return VarDecl; }
+  void SetVarDecl(Statement *v) { VarDecl = v; }
+
+  Expression *GetInit() { return Init; }
+  void SetInit(Expression *c) { Init = c; }
+
+  Expression *GetCondition() { return Condition; }
+  void SetCondition(Expression *c) { Condition = c; }
+
+  Expression *GetIncrement() { return Increment; }
+  void SetIncrement(Expression *c) { Increment = c; }
 
-  Value *IRCodegen(IRFactory *IRF) override;
+  Statement *GetBody() { return Body; }
+  void SetBody(Statement *b) { Body = b; }
+
+  static bool classof(const Node *N) {
+    return N->GetKind() == ForStatementKind;
+  }
 
 private:
-  std::unique_ptr<Statement> VarDecl = nullptr;
-  std::unique_ptr<Expression> Init = nullptr;
-  std::unique_ptr<Expression> Condition;
-  std::unique_ptr<Expression> Increment;
-  std::unique_ptr<Statement> Body;
+  Statement *VarDecl = nullptr;
+  Expression *Init = nullptr;
+  Expression *Condition;
+  Expression *Increment;
+  Statement *Body;
 };
 
 class ReturnStatement : public Statement {
 public:
-  std::unique_ptr<Expression> &GetRetVal() {
+  Expression *GetRetVal() {
     assert(HasValue() && "Must have a value to return it.");
-    return ReturnValue.value();
-  }
-  void SetRetVal(std::unique_ptr<Expression> v) {
-    ReturnValue = std::move(v);
+    return ReturnValue;
   }
-  bool HasValue() { return ReturnValue.has_value(); }
+  void SetRetVal(Expression *v) { ReturnValue = v; }
+  bool HasValue() { return ReturnValue != nullptr; }
 
-  ReturnStatement() {
+  ReturnStatement() : Statement(ReturnStatementKind) {
     AddInfo(Statement::RETURN);
   }
-  ReturnStatement(std::unique_ptr<Expression> e) : ReturnValue(std::move(e)) {
+  ReturnStatement(Expression *e)
+      : Statement(ReturnStatementKind), ReturnValue(e) {
     AddInfo(Statement::RETURN);
   }
 
-  void ASTDump(unsigned tab = 0) override {
-    PrintLn("ReturnStatement", tab);
-    if (ReturnValue)
-      ReturnValue.value()->ASTDump(tab + 2);
+  static bool classof(const Node *N) {
+    return N->GetKind() == ReturnStatementKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
-  std::optional<std::unique_ptr<Expression>> ReturnValue;
+  Expression *ReturnValue = nullptr;
 };
 
 class BreakStatement : public Statement {
 public:
-  BreakStatement() = default;
+  BreakStatement() : Statement(BreakStatementKind) {}
 
-  void ASTDump(unsigned tab = 0) override {
-    PrintLn("BreakStatement", tab);
+  static bool classof(const Node *N) {
+    return N->GetKind() == BreakStatementKind;
   }
-
-  Value *IRCodegen(IRFactory *IRF) override;
 };
 
 class ContinueStatement : public Statement {
 public:
-  ContinueStatement() = default;
+  ContinueStatement() : Statement(ContinueStatementKind) {}
 
-  void ASTDump(unsigned tab = 0) override {
-    PrintLn("ContinueStatement", tab);
+  static bool classof(const Node *N) {
+    return N->GetKind() == ContinueStatementKind;
   }
-
-  Value *IRCodegen(IRFactory *IRF) override;
 };
 
 class FunctionParameterDeclaration : public Statement {
 public:
-  std::string &GetName() { return Name; }
-  void SetName(std::string &s) { Name = s; }
-
-  Type GetType() { return Ty; }
-  void SetType(Type t) { Ty = t; }
-
-  void ASTDump(unsigned tab = 0) override {
-    Print("FunctionParameterDeclaration ", tab);
-    auto TypeStr = "'" + Ty.ToString() + "' ";
-    Print(TypeStr.c_str());
-    auto NameStr = "'" + Name + "'";
-    PrintLn(NameStr.c_str());
-  }
+  FunctionParameterDeclaration()
+      : Statement(FunctionParameterDeclarationKind) {}
+
+  Symbol GetName() const { return Name; }
+  void SetName(Symbol s) { Name = s; }
 
-  Value *IRCodegen(IRFactory *IRF) override;
+  const Type *GetType() const { return Ty; }
+  void SetType(const Type *t) { Ty = t; }
+
+  static bool classof(const Node *N) {
+    return N->GetKind() == FunctionParameterDeclarationKind;
+  }
 
 private:
-  std::string Name;
-  Type Ty;
+  Symbol Name;
+  const Type *Ty = TypeContext::GetInvalid();
 };
 
 class FunctionDeclaration : public Statement {
-  using ParamVec = std::vector<std::unique_ptr<FunctionParameterDeclaration>>;
+  using ParamVec = ASTList<FunctionParameterDeclaration *>;
 
 public:
-  Type GetType() { return T; }
-  void SetType(Type ft) { T = ft; }
+  const Type *GetType() const { return T; }
+  void SetType(const Type *ft) { T = ft; }
 
-  std::string &GetName() { return Name; }
-  void SetName(std::string &s) { Name = s; }
+  Symbol GetName() const { return Name; }
+  void SetName(Symbol s) { Name = s; }
 
   ParamVec &GetArguments() { return Arguments; }
-  void SetArguments(ParamVec &a) { Arguments = std::move(a); }
-  void SetArguments(ParamVec &&a) { Arguments = std::move(a); }
+  void SetArguments(ParamVec a) { Arguments = a; }
+
+  CompoundStatement *GetBody() { return Body; }
+  void SetBody(CompoundStatement *cs) { Body = cs; }
 
-  std::unique_ptr<CompoundStatement> &GetBody() { return Body; }
-  void SetBody(std::unique_ptr<CompoundStatement> &cs) { Body = std::move(cs); }
+  unsigned GetReturnsNumber() const { return ReturnsNumber; }
+  void SetReturnsNumber(unsigned n) { ReturnsNumber = n; }
 
-  static Type CreateType(const Type &t, const ParamVec &params) {
-    Type ResultType(t);
+  static const Type *CreateType(TypeContext &TC, const Type *t,
+                                const ParamVec &params) {
+    Type ResultType(*t);
 
     for (size_t i = 0; i < params.size(); i++) {
       auto t = params[i]->GetType();
@@ -480,42 +447,32 @@ public:
     }
     // if there are no arguments then set it to void
     if (params.size() == 0)
-      ResultType.GetArgTypes().push_back(Type::Void);
+      ResultType.GetArgTypes().push_back(TC.Get(Type::Void));
 
-    return ResultType;
+    return TC.Get(ResultType);
   }
 
   FunctionDeclaration() = delete;
 
-  FunctionDeclaration(Type FT, std::string Name, ParamVec &Args,
-                      std::unique_ptr<CompoundStatement> &Body, unsigned RetNum)
-      : T(FT), Name(Name), Arguments(std::move(Args)), Body(std::move(Body)),
-        ReturnsNumber(RetNum) {}
-
-  void ASTDump(unsigned tab = 0) override {
-    Print("FunctionDeclaration ", tab);
-    auto TypeStr = "'" + T.ToString() + "' ";
-    Print(TypeStr.c_str());
-    auto NameStr = "'" + Name + "'";
-    PrintLn(NameStr.c_str());
-    for (size_t i = 0; i < Arguments.size(); i++)
-      Arguments[i]->ASTDump(tab + 2);
-    if (Body)
-      Body->ASTDump(tab + 2);
-  }
+  FunctionDeclaration(const Type *FT, Symbol Name, ParamVec Args,
+                      CompoundStatement *Body, unsigned RetNum)
+      : Statement(FunctionDeclarationKind), T(FT), Name(Name), Arguments(Args),
+        Body(Body), ReturnsNumber(RetNum) {}
 
-  Value *IRCodegen(IRFactory *IRF) override;
+  static bool classof(const Node *N) {
+    return N->GetKind() == FunctionDeclarationKind;
+  }
 
 private:
-  Type T;
-  std::string Name;
+  const Type *T;
+  Symbol Name;
   ParamVec Arguments;
-  std::unique_ptr<CompoundStatement> Body;
+  CompoundStatement *Body;
   unsigned ReturnsNumber;
 };
 
 class BinaryExpression : public Expression {
-  using ExprPtr = std::unique_ptr<Expression>;
+  using ExprPtr = Expression *;
 
 public:
   enum BinaryOperation {
@@ -567,11 +524,11 @@ public:
     case Token::Astrix:
       return MUL;
     case Token::ForwardSlash:
-      if (GetResultType().IsUnsigned())
+      if (GetResultType()->IsUnsigned())
         return DIVU;
       return DIV;
     case Token::Percent:
-      if (GetResultType().IsUnsigned())
+      if (GetResultType()->IsUnsigned())
         return MODU;
       return MOD;
     case Token::And:
@@ -601,79 +558,67 @@ public:
   Token GetOperation() { return Operation; }
   void SetOperation(Token bo) { Operation = bo; }
 
-  ExprPtr &GetLeftExpr() { return Left; }
-  void SetLeftExpr(ExprPtr &e) { Left = std::move(e); }
+  ExprPtr GetLeftExpr() { return Left; }
+  void SetLeftExpr(ExprPtr e) { Left = e; }
 
-  ExprPtr &GetRightExpr() { return Right; }
-  void SetRightExpr(ExprPtr &e) { Right = std::move(e); }
+  ExprPtr GetRightExpr() { return Right; }
+  void SetRightExpr(ExprPtr e) { Right = e; }
 
   bool IsConditional() { return GetOperationKind() >= Not; }
 
-  BinaryExpression(ExprPtr L, Token Op, ExprPtr R) {
-    Left = std::move(L);
+  BinaryExpression(TypeContext &TC, ExprPtr L, Token Op, ExprPtr R)
+      : Expression(BinaryExpressionKind) {
+    Left = L;
     Operation = Op;
-    Right = std::move(R);
+    Right = R;
     if (IsConditional())
-      ResultType = Type(Type::Int);
+      ResultType = TC.Get(Type::Int);
     else {
-      auto Strongest = Type::GetStrongestType(Left->GetResultType().GetTypeVariant(),
-                                              Right->GetResultType().GetTypeVariant());
-      ResultType =
-          Type(Type::GetStrongestType(Strongest.GetTypeVariant(), Type::Int));
+      auto Strongest =
+          Type::GetStrongestType(Left->GetResultType()->GetTypeVariant(),
+                                 Right->GetResultType()->GetTypeVariant());
+      ResultType = TC.Get(Type::GetStrongestType(Strongest, Type::Int));
     }
   }
 
-  BinaryExpression() = default;
+  BinaryExpression() : Expression(BinaryExpressionKind) {}
 
-  void ASTDump(unsigned tab = 0) override {
-    Print("BinaryExpression ", tab);
-    auto Str = "'" + ResultType.ToString() + "' ";
-    Str += "'" + Operation.GetString() + "'";
-    PrintLn(Str.c_str());
-    Left->ASTDump(tab + 2);
-    Right->ASTDump(tab + 2);
+  static bool classof(const Node *N) {
+    return N->GetKind() == BinaryExpressionKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
+  /// Only the kind is used, the text of the token might be released already.
   Token Operation;
-  std::unique_ptr<Expression> Left;
-  std::unique_ptr<Expression> Right;
+  Expression *Left;
+  Expression *Right;
 };
 
 class TernaryExpression : public Expression {
-  using ExprPtr = std::unique_ptr<Expression>;
+  using ExprPtr = Expression *;
 
 public:
-  ExprPtr &GetCondition() { return Condition; }
-  void SetCondition(ExprPtr &e) { Condition = std::move(e); }
+  ExprPtr GetCondition() { return Condition; }
+  void SetCondition(ExprPtr e) { Condition = e; }
 
-  ExprPtr &GetExprIfTrue() { return ExprIfTrue; }
-  void SetExprIfTrue(ExprPtr &e) { ExprIfTrue = std::move(e); }
+  ExprPtr GetExprIfTrue() { return ExprIfTrue; }
+  void SetExprIfTrue(ExprPtr e) { ExprIfTrue = e; }
 
-  ExprPtr &GetExprIfFalse() { return ExprIfFalse; }
-  void SetExprIfFalse(ExprPtr &e) { ExprIfFalse = std::move(e); }
+  ExprPtr GetExprIfFalse() { return ExprIfFalse; }
+  void SetExprIfFalse(ExprPtr e) { ExprIfFalse = e; }
 
-  TernaryExpression() = default;
+  TernaryExpression() : Expression(TernaryExpressionKind) {}
 
-  TernaryExpression(ExprPtr &Cond, ExprPtr &True, ExprPtr &False)
-  : Condition(std::move(Cond)), ExprIfTrue(std::move(True)),
-        ExprIfFalse(std::move(False)) {
+  TernaryExpression(ExprPtr Cond, ExprPtr True, ExprPtr False)
+  : Expression(TernaryExpressionKind), Condition(Cond), ExprIfTrue(True),
+        ExprIfFalse(False) {
     ResultType = ExprIfTrue->GetResultType();
   }
 
-  void ASTDump(unsigned tab = 0) override {
-    Print("TernaryExpression ", tab);
-    auto Str = "'" + ResultType.ToString() + "' ";
-    PrintLn(Str.c_str());
-    Condition->ASTDump(tab + 2);
-    ExprIfTrue->ASTDump(tab + 2);
-    ExprIfFalse->ASTDump(tab + 2);
+  static bool classof(const Node *N) {
+    return N->GetKind() == TernaryExpressionKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
   ExprPtr Condition;
   ExprPtr ExprIfTrue;
@@ -681,76 +626,68 @@ private:
 };
 
 class StructMemberReference : public Expression {
-  using ExprPtr = std::unique_ptr<Expression>;
+  using ExprPtr = Expression *;
 
 public:
-  std::string GetMemberId() { return MemberIdentifier; }
-  void SetMemberId(std::string id) { MemberIdentifier = id; }
+  Symbol GetMemberId() const { return MemberIdentifier; }
+  void SetMemberId(Symbol id) { MemberIdentifier = id; }
+
+  ExprPtr GetExpr() { return StructTypedExpression; }
+  void SetExpr(ExprPtr e) { StructTypedExpression = e; }
 
-  ExprPtr &GetExpr() { return StructTypedExpression; }
-  void SetExpr(ExprPtr &e) { StructTypedExpression = std::move(e); }
+  size_t GetMemberIndex() const { return MemberIndex; }
 
-  StructMemberReference(ExprPtr Expr, std::string Id, size_t Idx) :
-    StructTypedExpression(std::move(Expr)), MemberIdentifier(Id), MemberIndex(Idx) {
+  StructMemberReference(ExprPtr Expr, Symbol Id, size_t Idx) :
+    Expression(StructMemberReferenceKind), StructTypedExpression(Expr),
+    MemberIdentifier(Id), MemberIndex(Idx) {
     auto STEType = StructTypedExpression->GetResultType();
-    assert(MemberIndex < STEType.GetTypeList().size());
-    this->ResultType = STEType.GetTypeList()[MemberIndex];
+    assert(MemberIndex < STEType->GetTypeList().size());
+    this->ResultType = STEType->GetTypeList()[MemberIndex];
   }
 
-  StructMemberReference() {}
+  StructMemberReference() : Expression(StructMemberReferenceKind) {}
 
-  void ASTDump(unsigned tab = 0) override {
-    Print("StructMemberReference ", tab);
-    auto Str = "'" + ResultType.ToString() + "' ";
-    Str += "'." + MemberIdentifier + "'";
-    PrintLn(Str.c_str());
-    StructTypedExpression->ASTDump(tab + 2);
+  static bool classof(const Node *N) {
+    return N->GetKind() == StructMemberReferenceKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
   ExprPtr StructTypedExpression;
-  std::string MemberIdentifier;
+  Symbol MemberIdentifier;
   size_t MemberIndex;
 };
 
 class StructInitExpression : public Expression {
 public:
-  using StrList = std::vector<std::string>;
-  using ExprPtrList = std::vector<std::unique_ptr<Expression>>;
+  using StrList = ASTList<Symbol>;
+  using ExprPtrList = ASTList<Expression *>;
 
   StrList &GetMemberId() { return MemberIdentifiers; }
   void SetMemberId(StrList l) { MemberIdentifiers = l; }
 
   ExprPtrList &GetInitList() { return InitValues; }
-  void SetInitList(ExprPtrList &e) { InitValues = std::move(e); }
+  void SetInitList(ExprPtrList e) { InitValues = e; }
 
-  StructInitExpression(Type ResultType, ExprPtrList InitList,
+  StructInitExpression(const Type *ResultType, ExprPtrList InitList,
                        StrList MemberNames) :
-  InitValues(std::move(InitList)), MemberIdentifiers(std::move(MemberNames)) {
+  Expression(StructInitExpressionKind), InitValues(InitList),
+  MemberIdentifiers(MemberNames) {
     this->ResultType = ResultType;
   }
 
-  StructInitExpression() {}
+  StructInitExpression() : Expression(StructInitExpressionKind) {}
 
-  void ASTDump(unsigned tab = 0) override {
-    Print("StructInitExpression ", tab);
-    auto Str = "'" + ResultType.ToString() + "' ";
-    PrintLn(Str.c_str());
-    for (auto &InitValue : InitValues)
-      InitValue->ASTDump(tab + 2);
+  static bool classof(const Node *N) {
+    return N->GetKind() == StructInitExpressionKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
   StrList MemberIdentifiers;
   ExprPtrList InitValues;
 };
 
 class UnaryExpression : public Expression {
-  using ExprPtr = std::unique_ptr<Expression>;
+  using ExprPtr = Expression *;
 
 public:
   enum UnaryOperation {
@@ -785,24 +722,23 @@ public:
   Token GetOperation() { return Operation; }
   void SetOperation(Token bo) { Operation = bo; }
 
-  ExprPtr &GetExpr() { return Expr; }
-  void SetExpr(ExprPtr &e) { Expr = std::move(e); }
+  ExprPtr GetExpr() { return Expr; }
+  void SetExpr(ExprPtr e) { Expr = e; }
 
-  UnaryExpression(Token Op, ExprPtr E) {
+  UnaryExpression(TypeContext &TC, Token Op, ExprPtr E)
+      : Expression(UnaryExpressionKind) {
     Operation = Op;
-    Expr = std::move(E);
+    Expr = E;
 
     switch (GetOperationKind()) {
     case ADDRESS:
-      ResultType = Expr->GetResultType();
-      ResultType.IncrementPointerLevel();
+      ResultType = TC.GetPointerTo(Expr->GetResultType());
       break;
     case DEREF:
-      ResultType = Expr->GetResultType();
-      ResultType.DecrementPointerLevel();
+      ResultType = TC.GetPointee(Expr->GetResultType());
       break;
     case NOT:
-      ResultType = Type(Type::Int);
+      ResultType = TC.Get(Type::Int);
       break;
     case MINUS:
     case POST_DECREMENT:
@@ -814,71 +750,54 @@ public:
     }
   }
 
-  UnaryExpression() = default;
+  UnaryExpression() : Expression(UnaryExpressionKind) {}
 
-  void ASTDump(unsigned tab = 0) override {
-    Print("UnaryExpression ", tab);
-    auto Str = "'" + ResultType.ToString() + "' ";
-    Str += "'" + Operation.GetString() + "'";
-    PrintLn(Str.c_str());
-    Expr->ASTDump(tab + 2);
+  static bool classof(const Node *N) {
+    return N->GetKind() == UnaryExpressionKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
+  /// Only the kind is used, the text of the token might be released already.
   Token Operation;
-  std::unique_ptr<Expression> Expr;
+  Expression *Expr;
 };
 
 class CallExpression : public Expression {
-  using ExprVec = std::vector<std::unique_ptr<Expression>>;
+  using ExprVec = ASTList<Expression *>;
 
 public:
-  std::string &GetName() { return Name; }
-  void SetName(std::string &n) { Name = n; }
+  Symbol GetName() const { return Name; }
+  void SetName(Symbol n) { Name = n; }
 
   ExprVec &GetArguments() { return Arguments; }
-  void SetArguments(ExprVec &a) { Arguments = std::move(a); }
-
-  CallExpression(const std::string &Name, ExprVec &Args, Type T)
-      : Name(Name), Arguments(std::move(Args)), Expression(std::move(T)) {}
-
-  void ASTDump(unsigned tab = 0) override {
-    Print("CallExpression ", tab);
-    auto Str = "'" + ResultType.ToString() + "' ";
-    Str += "'" + Name + "'";
-    PrintLn(Str.c_str());
-    for (size_t i = 0; i < Arguments.size(); i++)
-      Arguments[i]->ASTDump(tab + 2);
-  }
+  void SetArguments(ExprVec a) { Arguments = a; }
 
-  Value *IRCodegen(IRFactory *IRF) override;
+  CallExpression(Symbol Name, ExprVec Args, const Type *T)
+      : Expression(CallExpressionKind, T), Name(Name), Arguments(Args) {}
+
+  static bool classof(const Node *N) {
+    return N->GetKind() == CallExpressionKind;
+  }
 
 private:
-  std::string Name;
+  Symbol Name;
   ExprVec Arguments;
 };
 
 class ReferenceExpression : public Expression {
 public:
-  std::string &GetIdentifier() { return Identifier; }
-  void SetIdentifier(std::string &id) { Identifier = id; }
-
-  ReferenceExpression(Token t) { Identifier = t.GetString(); }
+  Symbol GetIdentifier() const { return Identifier; }
+  void SetIdentifier(Symbol id) { Identifier = id; }
 
+  ReferenceExpression(Token t)
+      : Expression(ReferenceExpressionKind), Identifier(t.GetStringView()) {}
 
-  void ASTDump(unsigned tab = 0) override {
-    Print("ReferenceExpression ", tab);
-    auto Str = "'" + ResultType.ToString() + "' ";
-    Str += "'" + Identifier + "'";
-    PrintLn(Str.c_str());
+  static bool classof(const Node *N) {
+    return N->GetKind() == ReferenceExpressionKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
-  std::string Identifier;
+  Symbol Identifier;
 };
 
 class IntegerLiteralExpression : public Expression {
@@ -888,21 +807,16 @@ public:
   uint64_t GetUIntValue() const { return IntValue; }
   void SetValue(uint64_t v) { IntValue = v; }
 
-  IntegerLiteralExpression(uint64_t v) : IntValue(v) {
-    SetType(Type(Type::Int));
+  IntegerLiteralExpression(TypeContext &TC, uint64_t v)
+      : Expression(IntegerLiteralExpressionKind), IntValue(v) {
+    SetType(TC.Get(Type::Int));
   }
   IntegerLiteralExpression() = delete;
 
-  void ASTDump(unsigned tab = 0) override {
-    Print("IntegerLiteralExpression ", tab);
-    auto TyStr = "'" + ResultType.ToString() + "' ";
-    Print(TyStr.c_str());
-    auto ValStr = "'" + std::to_string((int64_t)IntValue) + "'";
-    PrintLn(ValStr.c_str());
+  static bool classof(const Node *N) {
+    return N->GetKind() == IntegerLiteralExpressionKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
   uint64_t IntValue;
 };
@@ -912,48 +826,42 @@ public:
   double GetValue() { return FPValue; }
   void SetValue(double v) { FPValue = v; }
 
-  FloatLiteralExpression(double v) : FPValue(v) { SetType(Type(Type::Double)); }
+  FloatLiteralExpression(TypeContext &TC, double v)
+      : Expression(FloatLiteralExpressionKind), FPValue(v) {
+    SetType(TC.Get(Type::Double));
+  }
   FloatLiteralExpression() = delete;
 
-  void ASTDump(unsigned tab = 0) override {
-    Print("FloatLiteralExpression ", tab);
-    auto TyStr = "'" + ResultType.ToString() + "' ";
-    Print(TyStr.c_str());
-    auto ValStr = "'" + std::to_string(FPValue) + "'";
-    PrintLn(ValStr.c_str());
+  static bool classof(const Node *N) {
+    return N->GetKind() == FloatLiteralExpressionKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
   double FPValue;
 };
 
 class ArrayExpression : public Expression {
-  using ExprPtr = std::unique_ptr<Expression>;
+  using ExprPtr = Expression *;
 
 public:
-  ExprPtr &GetIndexExpression() { return IndexExpression; }
-  void SetIndexExpression(ExprPtr &e) { IndexExpression = std::move(e); }
+  ExprPtr GetBaseExpression() { return BaseExpression; }
+
+  ExprPtr GetIndexExpression() { return IndexExpression; }
+  void SetIndexExpression(ExprPtr e) { IndexExpression = e; }
 
-  ArrayExpression(ExprPtr &Base, ExprPtr &Index, Type Ct = Type())
-      : BaseExpression(std::move(Base)), IndexExpression(std::move(Index)) {
+  ArrayExpression(ExprPtr Base, ExprPtr Index, const Type *Ct)
+      : Expression(ArrayExpressionKind), BaseExpression(Base),
+        IndexExpression(Index) {
     ResultType = Ct;
   }
 
   void SetLValueness(bool p) { IsLValue = p; }
   bool GetLValueness() { return IsLValue; }
 
-  void ASTDump(unsigned tab = 0) override {
-    Print("ArrayExpression ", tab);
-    auto Str = "'" + ResultType.ToString() + "' ";
-    //Str += "'" + Identifier.GetString() + "'";
-    PrintLn(Str.c_str());
-    IndexExpression->ASTDump(tab + 2);
+  static bool classof(const Node *N) {
+    return N->GetKind() == ArrayExpressionKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
   bool IsLValue = false;
   ExprPtr BaseExpression;
@@ -962,76 +870,57 @@ private:
 
 class ImplicitCastExpression : public Expression {
 public:
-  ImplicitCastExpression(std::unique_ptr<Expression> e, Type t)
-      : CastableExpression(std::move(e)), Expression(t) {}
+  ImplicitCastExpression(Expression *e, const Type *t)
+      : Expression(ImplicitCastExpressionKind, t), CastableExpression(e) {}
 
-  Type GetSourceType() { return CastableExpression->GetResultType(); }
-  std::unique_ptr<Expression> &GetCastableExpression() {
-    return CastableExpression;
+  const Type *GetSourceType() const {
+    return CastableExpression->GetResultType();
   }
+  Expression *GetCastableExpression() { return CastableExpression; }
+  void SetCastableExpression(Expression *e) { CastableExpression = e; }
 
-  void ASTDump(unsigned tab = 0) override {
-    Print("ImplicitCastExpression ", tab);
-    auto Str = "'" + ResultType.ToString() + "'";
-    PrintLn(Str.c_str());
-    CastableExpression->ASTDump(tab + 2);
+  static bool classof(const Node *N) {
+    return N->GetKind() == ImplicitCastExpressionKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
-  std::unique_ptr<Expression> CastableExpression;
+  Expression *CastableExpression;
 };
 
 class InitializerListExpression : public Expression {
-  using ExprList = std::vector<std::unique_ptr<Expression>>;
+  using ExprList = ASTList<Expression *>;
 
 public:
   ExprList &GetExprList() { return Expressions; }
-  void SetExprList(ExprList &e) { Expressions = std::move(e); }
+  void SetExprList(ExprList e) { Expressions = e; }
 
-  InitializerListExpression(ExprList EL) : Expressions(std::move(EL)) {}
+  InitializerListExpression(ExprList EL)
+      : Expression(InitializerListExpressionKind), Expressions(EL) {}
 
-  void ASTDump(unsigned tab = 0) override {
-    PrintLn("InitializerListExpression", tab);
-    for (auto &E : Expressions)
-    E->ASTDump(tab + 2);
+  static bool classof(const Node *N) {
+    return N->GetKind() == InitializerListExpressionKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override {return nullptr;}
-
 private:
   ExprList Expressions;
 };
 
 class TranslationUnit : public Statement {
 public:
-  std::vector<std::unique_ptr<Statement>> &GetDeclarations() {
-    return Declarations;
-  }
-  void SetDeclarations(std::vector<std::unique_ptr<Statement>> s) {
-    Declarations = std::move(s);
-  }
-  void AddDeclaration(std::unique_ptr<Statement> s) {
-    Declarations.push_back(std::move(s));
-  }
+  ASTList<Statement *> &GetDeclarations() { return Declarations; }
+  void SetDeclarations(ASTList<Statement *> s) { Declarations = s; }
 
-  TranslationUnit() = default;
+  TranslationUnit() : Statement(TranslationUnitKind) {}
 
-  TranslationUnit(std::vector<std::unique_ptr<Statement>> s)
-      : Declarations(std::move(s)) {}
+  TranslationUnit(ASTList<Statement *> s)
+      : Statement(TranslationUnitKind), Declarations(s) {}
 
-  void ASTDump(unsigned tab = 0) override {
-    PrintLn("TranslationUnit", tab);
-    for (size_t i = 0; i < Declarations.size(); i++)
-      Declarations[i]->ASTDump(tab + 2);
-    PrintLn("");
+  static bool classof(const Node *N) {
+    return N->GetKind() == TranslationUnitKind;
   }
 
-  Value *IRCodegen(IRFactory *IRF) override;
-
 private:
-  std::vector<std::unique_ptr<Statement>> Declarations;
+  ASTList<Statement *> Declarations;
 };
 
 #endif
\ No newline at end of file
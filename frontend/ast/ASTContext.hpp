@@ -0,0 +1,105 @@
+#ifndef ASTCONTEXT_HPP
+#define ASTCONTEXT_HPP
+
+#include "../../support/Arena.hpp"
+#include "TypeContext.hpp"
+#include <cassert>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Immutable array living in the arena of an ASTContext. Used for the child
+/// lists of the AST nodes instead of std::vector, so they do not own any heap
+/// memory and need no destructor.
+template <typename T> class ASTList {
+  static_assert(std::is_trivially_destructible_v<T>,
+                "Elements are never destroyed.");
+
+public:
+  ASTList() = default;
+  ASTList(T *Data, size_t Size) : Data(Data), Size(Size) {}
+
+  size_t size() const { return Size; }
+  bool empty() const { return Size == 0; }
+
+  T *begin() const { return Data; }
+  T *end() const { return Data + Size; }
+
+  T &operator[](size_t Idx) const {
+    assert(Idx < Size && "Out of bounds.");
+    return Data[Idx];
+  }
+
+  T &front() const { return (*this)[0]; }
+  T &back() const { return (*this)[Size - 1]; }
+
+private:
+  T *Data = nullptr;
+  size_t Size = 0;
+};
+
+/// Owns the AST and the types of a translation unit. Nodes are placement
+/// new-ed into a bump pointer arena and refer to each other and to their
+/// types by raw pointers. They are never destroyed one by one, the whole tree
+/// is released at once by Reset or the destructor.
+class ASTContext {
+public:
+  ASTContext() = default;
+  ASTContext(const ASTContext &) = delete;
+  ASTContext &operator=(const ASTContext &) = delete;
+
+  template <typename T, typename... Args> T *Create(Args &&... args) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "AST nodes are never destroyed.");
+    NumNodes++;
+    return new (Allocator.Allocate<T>()) T(std::forward<Args>(args)...);
+  }
+
+  /// Copy @Elements into the arena.
+  template <typename T> ASTList<T> CreateList(const std::vector<T> &Elements) {
+    if (Elements.empty())
+      return ASTList<T>();
+
+    auto Data = Allocator.Allocate<T>(Elements.size());
+    std::uninitialized_copy(Elements.begin(), Elements.end(), Data);
+    return ASTList<T>(Data, Elements.size());
+  }
+
+  TypeContext &GetTypeContext() { return Types; }
+
+  /// Release every node and type created so far.
+  void Reset() {
+    Allocator.Reset();
+    Types.Reset();
+    NumNodes = 0;
+  }
+
+  /// Take over the nodes of @Other, like the ones created by a worker of the
+  /// parallel parsing. Their types must come from this context.
+  void Adopt(ASTContext &Other) {
+    Allocator.Adopt(Other.Allocator);
+    NumNodes += Other.NumNodes;
+    Other.NumNodes = 0;
+  }
+
+  size_t GetNumNodes() const { return NumNodes; }
+  size_t GetBytesUsed() const { return Allocator.GetBytesUsed(); }
+  size_t GetBytesAllocated() const { return Allocator.GetBytesAllocated(); }
+
+  void PrintStats(std::ostream &OS) const {
+    OS << "AST arena: " << NumNodes << " nodes, " << GetBytesUsed()
+       << " bytes used, " << GetBytesAllocated() << " bytes allocated in "
+       << Allocator.GetNumSlabs() << " slabs, " << Types.Size()
+       << " unique types" << std::endl;
+  }
+
+private:
+  Arena Allocator;
+  TypeContext Types;
+  size_t NumNodes = 0;
+};
+
+#endif
@@ -0,0 +1,274 @@
+#include "ASTDumper.hpp"
+#include <iostream>
+#include <utility>
+#include <vector>
+
+static void PrintImpl(const char *str, unsigned tab = 0, bool newline = false) {
+  for (size_t i = 0; i < tab; i++)
+    std::cout << " ";
+  std::cout << str;
+  if (newline)
+    std::cout << std::endl;
+}
+
+static void Print(const char *str, unsigned tab = 0) { PrintImpl(str, tab); }
+
+static void PrintLn(const char *str, unsigned tab = 0) {
+  PrintImpl(str, tab, true);
+}
+
+void ASTDumper::VisitChild(Node *N, unsigned Indent) {
+  Tab += Indent;
+  Visit(N);
+  Tab -= Indent;
+}
+
+void ASTDumper::VisitVariableDeclaration(VariableDeclaration *VD) {
+  Print("VariableDeclaration ", Tab);
+  auto TypeStr = "'" + VD->GetType()->ToString() + "' ";
+  Print(TypeStr.c_str());
+  auto NameStr = "'" + VD->GetName().GetString() + "'";
+  PrintLn(NameStr.c_str());
+  if (VD->GetInitExpr())
+    VisitChild(VD->GetInitExpr());
+}
+
+void ASTDumper::VisitMemberDeclaration(MemberDeclaration *MD) {
+  Print("MemberDeclaration ", Tab);
+  auto TypeStr = "'" + MD->GetType()->ToString() + "' ";
+  Print(TypeStr.c_str());
+  auto NameStr = "'" + MD->GetName().GetString() + "'";
+  PrintLn(NameStr.c_str());
+}
+
+void ASTDumper::VisitStructDeclaration(StructDeclaration *SD) {
+  Print("StructDeclaration '", Tab);
+  Print(SD->GetName().GetCString());
+  PrintLn("' ");
+  for (auto &M : SD->GetMembers())
+    VisitChild(M);
+}
+
+void ASTDumper::VisitEnumDeclaration(EnumDeclaration *ED) {
+  std::string Str = "EnumDeclaration '";
+  Str += ED->GetBaseType()->ToString() + "'";
+  PrintLn(Str.c_str(), Tab);
+  Str.clear();
+  Str = "Enumerators ";
+  unsigned LoopCounter = 0;
+  for (auto &[Enum, Val] : ED->GetEnumerators()) {
+    Str += "'" + Enum.GetString() + "'";
+    Str += " = " + std::to_string(Val);
+    if (++LoopCounter < ED->GetEnumerators().size())
+      Str += ", ";
+  }
+  PrintLn(Str.c_str(), Tab + 2);
+}
+
+void ASTDumper::VisitCompoundStatement(CompoundStatement *CS) {
+  PrintLn("CompoundStatement", Tab);
+  for (auto &S : CS->GetStatements())
+    VisitChild(S);
+}
+
+void ASTDumper::VisitExpressionStatement(ExpressionStatement *ES) {
+  PrintLn("ExpressionStatement", Tab);
+  VisitChild(ES->GetExpression());
+}
+
+void ASTDumper::VisitIfStatement(IfStatement *IS) {
+  PrintLn("IfStatement", Tab);
+  VisitChild(IS->GetCondition());
+  VisitChild(IS->GetIfBody());
+  if (IS->GetElseBody())
+    VisitChild(IS->GetElseBody());
+}
+
+void ASTDumper::VisitSwitchStatement(SwitchStatement *SS) {
+  PrintLn("SwitchStatement", Tab);
+  VisitChild(SS->GetCondition());
+
+  for (auto &[CaseConst, CaseBody] : SS->GetCaseBodies()) {
+    std::string Str = "Case '" + std::to_string(CaseConst) + "'";
+    PrintLn(Str.c_str(), Tab + 2);
+    for (auto &CaseStatement : CaseBody)
+      VisitChild(CaseStatement, 4);
+  }
+
+  if (SS->GetDefaultBody().size() > 0)
+    PrintLn("DefaultCase", Tab + 2);
+  for (auto &DefaultStatement : SS->GetDefaultBody())
+    VisitChild(DefaultStatement, 4);
+}
+
+void ASTDumper::VisitWhileStatement(WhileStatement *WS) {
+  PrintLn("WhileStatement", Tab);
+  VisitChild(WS->GetCondition());
+  VisitChild(WS->GetBody());
+}
+
+void ASTDumper::VisitForStatement(ForStatement *FS) {
+  PrintLn("ForStatement", Tab);
+  if (FS->GetInit())
+    VisitChild(FS->GetInit());
+  else
+    VisitChild(FS->GetVarDecl());
+  VisitChild(FS->GetCondition());
+  VisitChild(FS->GetIncrement());
+  VisitChild(FS->GetBody());
+}
+
+void ASTDumper::VisitReturnStatement(ReturnStatement *RS) {
+  PrintLn("ReturnStatement", Tab);
+  if (RS->HasValue())
+    VisitChild(RS->GetRetVal());
+}
+
+void ASTDumper::VisitBreakStatement(BreakStatement *BS) {
+  PrintLn("BreakStatement", Tab);
+}
+
+void ASTDumper::VisitContinueStatement(ContinueStatement *CS) {
+  PrintLn("ContinueStatement", Tab);
+}
+
+void ASTDumper::VisitFunctionParameterDeclaration(
+    FunctionParameterDeclaration *FPD) {
+  Print("FunctionParameterDeclaration ", Tab);
+  auto TypeStr = "'" + FPD->GetType()->ToString() + "' ";
+  Print(TypeStr.c_str());
+  auto NameStr = "'" + FPD->GetName().GetString() + "'";
+  PrintLn(NameStr.c_str());
+}
+
+void ASTDumper::VisitFunctionDeclaration(FunctionDeclaration *FD) {
+  Print("FunctionDeclaration ", Tab);
+  auto TypeStr = "'" + FD->GetType()->ToString() + "' ";
+  Print(TypeStr.c_str());
+  auto NameStr = "'" + FD->GetName().GetString() + "'";
+  PrintLn(NameStr.c_str());
+  for (auto &Argument : FD->GetArguments())
+    VisitChild(Argument);
+  if (FD->GetBody())
+    VisitChild(FD->GetBody());
+}
+
+void ASTDumper::VisitTranslationUnit(TranslationUnit *TU) {
+  PrintLn("TranslationUnit", Tab);
+  for (auto &Declaration : TU->GetDeclarations())
+    VisitChild(Declaration);
+  PrintLn("");
+}
+
+void ASTDumper::VisitBinaryExpression(BinaryExpression *BE) {
+  // a chain of binary expressions is dumped with an explicit stack of the
+  // operands and their indentation, since it can be deeper than the call
+  // stack
+  const auto ParentTab = Tab;
+  std::vector<std::pair<Expression *, unsigned>> Operands = {{BE, Tab}};
+  while (!Operands.empty()) {
+    auto [E, Indent] = Operands.back();
+    Operands.pop_back();
+    Tab = Indent;
+
+    auto Binary = DynCast<BinaryExpression>(E);
+    if (!Binary) {
+      Visit(E);
+      continue;
+    }
+
+    Print("BinaryExpression ", Tab);
+    auto Str = "'" + Binary->GetResultType()->ToString() + "' ";
+    Str += "'" + Token::ToString(Binary->GetOperation().GetKind()) + "'";
+    PrintLn(Str.c_str());
+    Operands.push_back({Binary->GetRightExpr(), Tab + 2});
+    Operands.push_back({Binary->GetLeftExpr(), Tab + 2});
+  }
+  Tab = ParentTab;
+}
+
+void ASTDumper::VisitTernaryExpression(TernaryExpression *TE) {
+  Print("TernaryExpression ", Tab);
+  auto Str = "'" + TE->GetResultType()->ToString() + "' ";
+  PrintLn(Str.c_str());
+  VisitChild(TE->GetCondition());
+  VisitChild(TE->GetExprIfTrue());
+  VisitChild(TE->GetExprIfFalse());
+}
+
+void ASTDumper::VisitStructMemberReference(StructMemberReference *SMR) {
+  Print("StructMemberReference ", Tab);
+  auto Str = "'" + SMR->GetResultType()->ToString() + "' ";
+  Str += "'." + SMR->GetMemberId().GetString() + "'";
+  PrintLn(Str.c_str());
+  VisitChild(SMR->GetExpr());
+}
+
+void ASTDumper::VisitStructInitExpression(StructInitExpression *SIE) {
+  Print("StructInitExpression ", Tab);
+  auto Str = "'" + SIE->GetResultType()->ToString() + "' ";
+  PrintLn(Str.c_str());
+  for (auto &InitValue : SIE->GetInitList())
+    VisitChild(InitValue);
+}
+
+void ASTDumper::VisitUnaryExpression(UnaryExpression *UE) {
+  Print("UnaryExpression ", Tab);
+  auto Str = "'" + UE->GetResultType()->ToString() + "' ";
+  Str += "'" + Token::ToString(UE->GetOperation().GetKind()) + "'";
+  PrintLn(Str.c_str());
+  VisitChild(UE->GetExpr());
+}
+
+void ASTDumper::VisitCallExpression(CallExpression *CE) {
+  Print("CallExpression ", Tab);
+  auto Str = "'" + CE->GetResultType()->ToString() + "' ";
+  Str += "'" + CE->GetName().GetString() + "'";
+  PrintLn(Str.c_str());
+  for (auto &Argument : CE->GetArguments())
+    VisitChild(Argument);
+}
+
+void ASTDumper::VisitReferenceExpression(ReferenceExpression *RE) {
+  Print("ReferenceExpression ", Tab);
+  auto Str = "'" + RE->GetResultType()->ToString() + "' ";
+  Str += "'" + RE->GetIdentifier().GetString() + "'";
+  PrintLn(Str.c_str());
+}
+
+void ASTDumper::VisitIntegerLiteralExpression(IntegerLiteralExpression *ILE) {
+  Print("IntegerLiteralExpression ", Tab);
+  auto TyStr = "'" + ILE->GetResultType()->ToString() + "' ";
+  Print(TyStr.c_str());
+  auto ValStr = "'" + std::to_string(ILE->GetSIntValue()) + "'";
+  PrintLn(ValStr.c_str());
+}
+
+void ASTDumper::VisitFloatLiteralExpression(FloatLiteralExpression *FLE) {
+  Print("FloatLiteralExpression ", Tab);
+  auto TyStr = "'" + FLE->GetResultType()->ToString() + "' ";
+  Print(TyStr.c_str());
+  auto ValStr = "'" + std::to_string(FLE->GetValue()) + "'";
+  PrintLn(ValStr.c_str());
+}
+
+void ASTDumper::VisitArrayExpression(ArrayExpression *AE) {
+  Print("ArrayExpression ", Tab);
+  auto Str = "'" + AE->GetResultType()->ToString() + "' ";
+  PrintLn(Str.c_str());
+  VisitChild(AE->GetIndexExpression());
+}
+
+void ASTDumper::VisitImplicitCastExpression(ImplicitCastExpression *ICE) {
+  Print("ImplicitCastExpression ", Tab);
+  auto Str = "'" + ICE->GetResultType()->ToString() + "'";
+  PrintLn(Str.c_str());
+  VisitChild(ICE->GetCastableExpression());
+}
+
+void ASTDumper::VisitInitializerListExpression(
+    InitializerListExpression *ILE) {
+  PrintLn("InitializerListExpression", Tab);
+  for (auto &E : ILE->GetExprList())
+    VisitChild(E);
+}
@@ -0,0 +1,48 @@
+#ifndef ASTDUMPER_HPP
+#define ASTDUMPER_HPP
+
+#include "ASTVisitor.hpp"
+
+/// Print the AST to the standard output, one node per line, the children
+/// indented below their parent.
+class ASTDumper : public ASTVisitor<ASTDumper> {
+public:
+  void VisitVariableDeclaration(VariableDeclaration *VD);
+  void VisitMemberDeclaration(MemberDeclaration *MD);
+  void VisitStructDeclaration(StructDeclaration *SD);
+  void VisitEnumDeclaration(EnumDeclaration *ED);
+  void VisitCompoundStatement(CompoundStatement *CS);
+  void VisitExpressionStatement(ExpressionStatement *ES);
+  void VisitIfStatement(IfStatement *IS);
+  void VisitSwitchStatement(SwitchStatement *SS);
+  void VisitWhileStatement(WhileStatement *WS);
+  void VisitForStatement(ForStatement *FS);
+  void VisitReturnStatement(ReturnStatement *RS);
+  void VisitBreakStatement(BreakStatement *BS);
+  void VisitContinueStatement(ContinueStatement *CS);
+  void VisitFunctionParameterDeclaration(FunctionParameterDeclaration *FPD);
+  void VisitFunctionDeclaration(FunctionDeclaration *FD);
+  void VisitTranslationUnit(TranslationUnit *TU);
+
+  void VisitBinaryExpression(BinaryExpression *BE);
+  void VisitTernaryExpression(TernaryExpression *TE);
+  void VisitStructMemberReference(StructMemberReference *SMR);
+  void VisitStructInitExpression(StructInitExpression *SIE);
+  void VisitUnaryExpression(UnaryExpression *UE);
+  void VisitCallExpression(CallExpression *CE);
+  void VisitReferenceExpression(ReferenceExpression *RE);
+  void VisitIntegerLiteralExpression(IntegerLiteralExpression *ILE);
+  void VisitFloatLiteralExpression(FloatLiteralExpression *FLE);
+  void VisitArrayExpression(ArrayExpression *AE);
+  void VisitImplicitCastExpression(ImplicitCastExpression *ICE);
+  void VisitInitializerListExpression(InitializerListExpression *ILE);
+
+private:
+  /// Dump @N indented by @Indent more than the current node.
+  void VisitChild(Node *N, unsigned Indent = 2);
+
+  /// The indentation of the current node.
+  unsigned Tab = 0;
+};
+
+#endif
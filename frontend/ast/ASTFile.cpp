@@ -0,0 +1,754 @@
+#include "ASTFile.hpp"
+#include "../../support/BinaryStream.hpp"
+#include "ASTVisitor.hpp"
+#include "TypeTable.hpp"
+#include <fstream>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+static constexpr uint32_t Magic = 0x5453414d; // "MAST"
+static constexpr uint32_t Version = 1;
+
+/// The offset of a missing child while writing, like the else body of an if
+/// statement.
+static constexpr uint32_t NoNode = UINT32_MAX;
+
+static_assert(Token::NumKinds <= UINT8_MAX + 1,
+              "The operators are written as a byte.");
+
+namespace {
+/// Writes the nodes into the node section, visiting a node writes its
+/// children, then the node itself and returns its offset.
+class ASTWriter : public ASTVisitor<ASTWriter, uint32_t> {
+public:
+  uint32_t VisitVariableDeclaration(VariableDeclaration *VD);
+  uint32_t VisitMemberDeclaration(MemberDeclaration *MD);
+  uint32_t VisitStructDeclaration(StructDeclaration *SD);
+  uint32_t VisitEnumDeclaration(EnumDeclaration *ED);
+  uint32_t VisitCompoundStatement(CompoundStatement *CS);
+  uint32_t VisitExpressionStatement(ExpressionStatement *ES);
+  uint32_t VisitIfStatement(IfStatement *IS);
+  uint32_t VisitSwitchStatement(SwitchStatement *SS);
+  uint32_t VisitWhileStatement(WhileStatement *WS);
+  uint32_t VisitForStatement(ForStatement *FS);
+  uint32_t VisitReturnStatement(ReturnStatement *RS);
+  uint32_t VisitBreakStatement(BreakStatement *BS);
+  uint32_t VisitContinueStatement(ContinueStatement *CS);
+  uint32_t VisitFunctionParameterDeclaration(FunctionParameterDeclaration *FPD);
+  uint32_t VisitFunctionDeclaration(FunctionDeclaration *FD);
+  uint32_t VisitTranslationUnit(TranslationUnit *TU);
+
+  uint32_t VisitBinaryExpression(BinaryExpression *BE);
+  /// Write @BE, whose operands are written already at @Left and @Right.
+  uint32_t VisitBinaryOperands(BinaryExpression *BE, uint32_t Left,
+                               uint32_t Right);
+  uint32_t VisitBinaryOperand(Expression *E) { return WriteChild(E); }
+  uint32_t VisitTernaryExpression(TernaryExpression *TE);
+  uint32_t VisitStructMemberReference(StructMemberReference *SMR);
+  uint32_t VisitStructInitExpression(StructInitExpression *SIE);
+  uint32_t VisitUnaryExpression(UnaryExpression *UE);
+  uint32_t VisitCallExpression(CallExpression *CE);
+  uint32_t VisitReferenceExpression(ReferenceExpression *RE);
+  uint32_t VisitIntegerLiteralExpression(IntegerLiteralExpression *ILE);
+  uint32_t VisitFloatLiteralExpression(FloatLiteralExpression *FLE);
+  uint32_t VisitArrayExpression(ArrayExpression *AE);
+  uint32_t VisitImplicitCastExpression(ImplicitCastExpression *ICE);
+  uint32_t VisitInitializerListExpression(InitializerListExpression *ILE);
+
+  /// The whole file, with the node at @Root as the translation unit.
+  std::string Finish(uint32_t Root) const;
+
+private:
+  uint32_t WriteChild(Node *N) { return N ? Visit(N) : NoNode; }
+
+  template <typename T>
+  std::vector<uint32_t> WriteChildren(const ASTList<T> &Children) {
+    std::vector<uint32_t> Offsets;
+    for (auto Child : Children)
+      Offsets.push_back(WriteChild(Child));
+    return Offsets;
+  }
+
+  /// Start the record of @S, returns its offset.
+  uint32_t WriteHeader(Statement *S);
+  /// The type and the lvalueness of @E are in the header of every expression.
+  uint32_t WriteHeader(Expression *E);
+
+  /// The children are referred to by their distance from the start of the
+  /// record, which is a small number, 0 is a missing child.
+  void WriteChildOffset(uint32_t Child) {
+    Nodes.WriteVarUInt(Child == NoNode ? 0 : RecordOffset - Child);
+  }
+  void WriteChildOffsets(const std::vector<uint32_t> &Children);
+
+  void WriteName(Symbol Name);
+  void WriteType(const Type *T) { Nodes.WriteVarUInt(Types.GetIndex(T)); }
+
+  BinaryWriter Nodes;
+  /// The offset of the record being written.
+  uint32_t RecordOffset = 0;
+  TypeTableWriter Types;
+  std::unordered_map<Symbol, uint32_t> StringIndices;
+  std::vector<Symbol> Strings;
+};
+
+/// Reads the fields of the record of a node.
+struct RecordReader : BinaryReader {
+  RecordReader(std::string_view Nodes, uint32_t Offset)
+      : BinaryReader(Nodes.substr(Offset)), Offset(Offset) {}
+
+  /// The offset of the record in the node section.
+  uint32_t Offset;
+};
+
+/// Creates the nodes of a node section. The records are read in the order
+/// they were written, so the children of a node are created before it, and
+/// loading is linear in the size of the file without recursion. A node is
+/// the child of one parent at most, so a malformed file cannot share nodes
+/// between parents.
+class ASTReader {
+public:
+  ASTReader(std::string_view Nodes, std::vector<Symbol> Strings,
+            const TypeTableReader &Types, ASTContext &Ctx)
+      : Nodes(Nodes), Strings(std::move(Strings)), Types(Types), Ctx(Ctx),
+        TC(Ctx.GetTypeContext()) {}
+
+  /// Read every record and return the translation unit at @Root, which has
+  /// to be the only node without a parent. Returns nullptr if the section is
+  /// malformed.
+  TranslationUnit *Read(uint32_t Root);
+
+private:
+  Node *ReadRecord(RecordReader &R);
+  Statement *ReadStatement(RecordReader &R, uint8_t Kind);
+  Expression *ReadExpression(RecordReader &R, uint8_t Kind, const Type *Ty);
+
+  /// The child of the record, which is a node read before without a parent
+  /// so far. A node which is not a @T sets the error.
+  template <typename T> T *ReadChild(RecordReader &R) {
+    auto Distance = R.ReadVarUInt();
+    if (Distance == 0)
+      return nullptr;
+    // the children are before their parent
+    if (Distance > R.Offset) {
+      R.SetError();
+      return nullptr;
+    }
+
+    auto It = Orphans.find(R.Offset - Distance);
+    auto Child = It != Orphans.end() ? DynCast<T>(It->second) : nullptr;
+    if (!Child) {
+      R.SetError();
+      return nullptr;
+    }
+    Orphans.erase(It);
+    return Child;
+  }
+
+  /// A child which the node cannot be without, a missing one sets the error.
+  template <typename T> T *ReadRequiredChild(RecordReader &R) {
+    auto Child = ReadChild<T>(R);
+    if (!Child)
+      R.SetError();
+    return Child;
+  }
+
+  template <typename T> ASTList<T *> ReadChildren(RecordReader &R) {
+    std::vector<T *> Children;
+    for (auto NumChildren = R.ReadVarUInt();
+         NumChildren > 0 && !R.HasError(); NumChildren--)
+      Children.push_back(ReadRequiredChild<T>(R));
+    return Ctx.CreateList(Children);
+  }
+
+  Symbol ReadName(RecordReader &R);
+  const Type *ReadType(RecordReader &R);
+
+  /// Reads an operator, which is only valid if it is a token kind.
+  std::optional<Token> ReadOperation(RecordReader &R);
+
+  std::string_view Nodes;
+  std::vector<Symbol> Strings;
+  const TypeTableReader &Types;
+  ASTContext &Ctx;
+  TypeContext &TC;
+  /// The nodes read so far which are not the child of a node yet, by the
+  /// offset of their record.
+  std::unordered_map<uint32_t, Node *> Orphans;
+};
+} // namespace
+
+uint32_t ASTWriter::WriteHeader(Statement *S) {
+  RecordOffset = Nodes.GetBuffer().size();
+  Nodes.Write<uint8_t>(S->GetKind());
+  return RecordOffset;
+}
+
+uint32_t ASTWriter::WriteHeader(Expression *E) {
+  RecordOffset = Nodes.GetBuffer().size();
+  Nodes.Write<uint8_t>(E->GetKind());
+  WriteType(E->GetResultType());
+  Nodes.Write<uint8_t>(E->GetLValueness());
+  return RecordOffset;
+}
+
+void ASTWriter::WriteChildOffsets(const std::vector<uint32_t> &Children) {
+  Nodes.WriteVarUInt(Children.size());
+  for (auto Child : Children)
+    WriteChildOffset(Child);
+}
+
+void ASTWriter::WriteName(Symbol Name) {
+  auto [It, Inserted] = StringIndices.try_emplace(Name, Strings.size());
+  if (Inserted)
+    Strings.push_back(Name);
+  Nodes.WriteVarUInt(It->second);
+}
+
+uint32_t ASTWriter::VisitVariableDeclaration(VariableDeclaration *VD) {
+  auto Init = WriteChild(VD->GetInitExpr());
+  auto Offset = WriteHeader(VD);
+  WriteName(VD->GetName());
+  WriteType(VD->GetType());
+  WriteChildOffset(Init);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitMemberDeclaration(MemberDeclaration *MD) {
+  auto Offset = WriteHeader(MD);
+  WriteName(MD->GetName());
+  WriteType(MD->GetType());
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitStructDeclaration(StructDeclaration *SD) {
+  auto Members = WriteChildren(SD->GetMembers());
+  auto Offset = WriteHeader(SD);
+  WriteName(SD->GetName());
+  WriteType(SD->GetType());
+  WriteChildOffsets(Members);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitEnumDeclaration(EnumDeclaration *ED) {
+  auto Offset = WriteHeader(ED);
+  WriteType(ED->GetBaseType());
+  Nodes.WriteVarUInt(ED->GetEnumerators().size());
+  for (auto &[Name, Value] : ED->GetEnumerators()) {
+    WriteName(Name);
+    Nodes.Write<int32_t>(Value);
+  }
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitCompoundStatement(CompoundStatement *CS) {
+  auto Statements = WriteChildren(CS->GetStatements());
+  auto Offset = WriteHeader(CS);
+  WriteChildOffsets(Statements);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitExpressionStatement(ExpressionStatement *ES) {
+  auto Expr = WriteChild(ES->GetExpression());
+  auto Offset = WriteHeader(ES);
+  WriteChildOffset(Expr);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitIfStatement(IfStatement *IS) {
+  auto Condition = WriteChild(IS->GetCondition());
+  auto IfBody = WriteChild(IS->GetIfBody());
+  auto ElseBody = WriteChild(IS->GetElseBody());
+  auto Offset = WriteHeader(IS);
+  WriteChildOffset(Condition);
+  WriteChildOffset(IfBody);
+  WriteChildOffset(ElseBody);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitSwitchStatement(SwitchStatement *SS) {
+  auto Condition = WriteChild(SS->GetCondition());
+  std::vector<std::vector<uint32_t>> Cases;
+  for (auto &[Value, Body] : SS->GetCaseBodies())
+    Cases.push_back(WriteChildren(Body));
+  auto DefaultBody = WriteChildren(SS->GetDefaultBody());
+
+  auto Offset = WriteHeader(SS);
+  WriteChildOffset(Condition);
+  Nodes.WriteVarUInt(Cases.size());
+  for (size_t i = 0; i < Cases.size(); i++) {
+    Nodes.Write<int32_t>(SS->GetCaseBodies()[i].first);
+    WriteChildOffsets(Cases[i]);
+  }
+  WriteChildOffsets(DefaultBody);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitWhileStatement(WhileStatement *WS) {
+  auto Condition = WriteChild(WS->GetCondition());
+  auto Body = WriteChild(WS->GetBody());
+  auto Offset = WriteHeader(WS);
+  WriteChildOffset(Condition);
+  WriteChildOffset(Body);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitForStatement(ForStatement *FS) {
+  auto VarDecl = WriteChild(FS->GetVarDecl());
+  auto Init = WriteChild(FS->GetInit());
+  auto Condition = WriteChild(FS->GetCondition());
+  auto Increment = WriteChild(FS->GetIncrement());
+  auto Body = WriteChild(FS->GetBody());
+  auto Offset = WriteHeader(FS);
+  WriteChildOffset(VarDecl);
+  WriteChildOffset(Init);
+  WriteChildOffset(Condition);
+  WriteChildOffset(Increment);
+  WriteChildOffset(Body);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitReturnStatement(ReturnStatement *RS) {
+  auto RetVal = RS->HasValue() ? WriteChild(RS->GetRetVal()) : NoNode;
+  auto Offset = WriteHeader(RS);
+  WriteChildOffset(RetVal);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitBreakStatement(BreakStatement *BS) {
+  return WriteHeader(BS);
+}
+
+uint32_t ASTWriter::VisitContinueStatement(ContinueStatement *CS) {
+  return WriteHeader(CS);
+}
+
+uint32_t ASTWriter::VisitFunctionParameterDeclaration(
+    FunctionParameterDeclaration *FPD) {
+  auto Offset = WriteHeader(FPD);
+  WriteName(FPD->GetName());
+  WriteType(FPD->GetType());
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitFunctionDeclaration(FunctionDeclaration *FD) {
+  auto Arguments = WriteChildren(FD->GetArguments());
+  auto Body = WriteChild(FD->GetBody());
+  auto Offset = WriteHeader(FD);
+  WriteName(FD->GetName());
+  WriteType(FD->GetType());
+  WriteChildOffsets(Arguments);
+  WriteChildOffset(Body);
+  Nodes.WriteVarUInt(FD->GetReturnsNumber());
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitTranslationUnit(TranslationUnit *TU) {
+  auto Declarations = WriteChildren(TU->GetDeclarations());
+  auto Offset = WriteHeader(TU);
+  WriteChildOffsets(Declarations);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitBinaryExpression(BinaryExpression *BE) {
+  return VisitBinaryChain(BE);
+}
+
+uint32_t ASTWriter::VisitBinaryOperands(BinaryExpression *BE, uint32_t Left,
+                                        uint32_t Right) {
+  auto Offset = WriteHeader(BE);
+  Nodes.Write<uint8_t>(BE->GetOperation().GetKind());
+  WriteChildOffset(Left);
+  WriteChildOffset(Right);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitTernaryExpression(TernaryExpression *TE) {
+  auto Condition = WriteChild(TE->GetCondition());
+  auto ExprIfTrue = WriteChild(TE->GetExprIfTrue());
+  auto ExprIfFalse = WriteChild(TE->GetExprIfFalse());
+  auto Offset = WriteHeader(TE);
+  WriteChildOffset(Condition);
+  WriteChildOffset(ExprIfTrue);
+  WriteChildOffset(ExprIfFalse);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitStructMemberReference(StructMemberReference *SMR) {
+  auto Expr = WriteChild(SMR->GetExpr());
+  auto Offset = WriteHeader(SMR);
+  WriteChildOffset(Expr);
+  WriteName(SMR->GetMemberId());
+  Nodes.WriteVarUInt(SMR->GetMemberIndex());
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitStructInitExpression(StructInitExpression *SIE) {
+  auto InitValues = WriteChildren(SIE->GetInitList());
+  auto Offset = WriteHeader(SIE);
+  WriteChildOffsets(InitValues);
+  Nodes.WriteVarUInt(SIE->GetMemberId().size());
+  for (auto MemberName : SIE->GetMemberId())
+    WriteName(MemberName);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitUnaryExpression(UnaryExpression *UE) {
+  auto Expr = WriteChild(UE->GetExpr());
+  auto Offset = WriteHeader(UE);
+  Nodes.Write<uint8_t>(UE->GetOperation().GetKind());
+  WriteChildOffset(Expr);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitCallExpression(CallExpression *CE) {
+  auto Arguments = WriteChildren(CE->GetArguments());
+  auto Offset = WriteHeader(CE);
+  WriteName(CE->GetName());
+  WriteChildOffsets(Arguments);
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitReferenceExpression(ReferenceExpression *RE) {
+  auto Offset = WriteHeader(RE);
+  WriteName(RE->GetIdentifier());
+  return Offset;
+}
+
+uint32_t
+ASTWriter::VisitIntegerLiteralExpression(IntegerLiteralExpression *ILE) {
+  auto Offset = WriteHeader(ILE);
+  Nodes.WriteVarUInt(ILE->GetUIntValue());
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitFloatLiteralExpression(FloatLiteralExpression *FLE) {
+  auto Offset = WriteHeader(FLE);
+  Nodes.Write<double>(FLE->GetValue());
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitArrayExpression(ArrayExpression *AE) {
+  auto Base = WriteChild(AE->GetBaseExpression());
+  auto Index = WriteChild(AE->GetIndexExpression());
+  auto Offset = WriteHeader(AE);
+  WriteChildOffset(Base);
+  WriteChildOffset(Index);
+  // the array expression has an lvalueness of its own besides the one of the
+  // expressions
+  Nodes.Write<uint8_t>(AE->GetLValueness());
+  return Offset;
+}
+
+uint32_t ASTWriter::VisitImplicitCastExpression(ImplicitCastExpression *ICE) {
+  auto Expr = WriteChild(ICE->GetCastableExpression());
+  auto Offset = WriteHeader(ICE);
+  WriteChildOffset(Expr);
+  return Offset;
+}
+
+uint32_t
+ASTWriter::VisitInitializerListExpression(InitializerListExpression *ILE) {
+  auto Expressions = WriteChildren(ILE->GetExprList());
+  auto Offset = WriteHeader(ILE);
+  WriteChildOffsets(Expressions);
+  return Offset;
+}
+
+std::string ASTWriter::Finish(uint32_t Root) const {
+  BinaryWriter W;
+  W.Write<uint32_t>(Magic);
+  W.Write<uint32_t>(Version);
+
+  W.Write<uint32_t>(Strings.size());
+  for (auto Str : Strings)
+    W.WriteString(Str.GetString());
+
+  Types.Write(W);
+  W.Write<uint32_t>(Root);
+  W.WriteString(Nodes.GetBuffer());
+  return W.GetBuffer();
+}
+
+TranslationUnit *ASTReader::Read(uint32_t Root) {
+  for (uint32_t Offset = 0; Offset < Nodes.size();) {
+    RecordReader R(Nodes, Offset);
+    auto N = ReadRecord(R);
+    if (!N || R.HasError())
+      return nullptr;
+    Orphans[Offset] = N;
+    Offset += R.GetPosition();
+  }
+
+  auto It = Orphans.find(Root);
+  if (Orphans.size() != 1 || It == Orphans.end())
+    return nullptr;
+  return DynCast<TranslationUnit>(It->second);
+}
+
+Symbol ASTReader::ReadName(RecordReader &R) {
+  auto Index = R.ReadVarUInt();
+  if (Index >= Strings.size()) {
+    R.SetError();
+    return Symbol();
+  }
+  return Strings[Index];
+}
+
+const Type *ASTReader::ReadType(RecordReader &R) {
+  auto Ty = Types.Get(R.ReadVarUInt());
+  if (!Ty) {
+    R.SetError();
+    return TypeContext::GetInvalid();
+  }
+  return Ty;
+}
+
+std::optional<Token> ASTReader::ReadOperation(RecordReader &R) {
+  auto Kind = R.Read<uint8_t>();
+  if (Kind >= Token::NumKinds)
+    return std::nullopt;
+  return Token(static_cast<Token::TokenKind>(Kind));
+}
+
+Node *ASTReader::ReadRecord(RecordReader &R) {
+  auto Kind = R.Read<uint8_t>();
+  if (Kind <= Node::TranslationUnitKind)
+    return ReadStatement(R, Kind);
+
+  auto Ty = ReadType(R);
+  auto IsLValue = R.Read<uint8_t>();
+  auto E = ReadExpression(R, Kind, Ty);
+  if (E) {
+    E->SetType(Ty);
+    E->SetLValueness(IsLValue);
+  }
+  return E;
+}
+
+Statement *ASTReader::ReadStatement(RecordReader &R, uint8_t Kind) {
+  switch (Kind) {
+  case Node::VariableDeclarationKind: {
+    auto Name = ReadName(R);
+    auto Ty = ReadType(R);
+    return Ctx.Create<VariableDeclaration>(Name, Ty, ReadChild<Expression>(R));
+  }
+  case Node::MemberDeclarationKind: {
+    auto Name = ReadName(R);
+    return Ctx.Create<MemberDeclaration>(Name, ReadType(R));
+  }
+  case Node::StructDeclarationKind: {
+    auto Name = ReadName(R);
+    auto StructType = ReadType(R);
+    auto Members = ReadChildren<MemberDeclaration>(R);
+    return Ctx.Create<StructDeclaration>(Name, Members, StructType);
+  }
+  case Node::EnumDeclarationKind: {
+    auto BaseType = ReadType(R);
+    std::vector<std::pair<Symbol, int>> Enumerators;
+    for (auto NumEnumerators = R.ReadVarUInt();
+         NumEnumerators > 0 && !R.HasError(); NumEnumerators--) {
+      auto Name = ReadName(R);
+      Enumerators.push_back({Name, R.Read<int32_t>()});
+    }
+    return Ctx.Create<EnumDeclaration>(BaseType, Ctx.CreateList(Enumerators));
+  }
+  case Node::CompoundStatementKind:
+    return Ctx.Create<CompoundStatement>(ReadChildren<Statement>(R));
+  case Node::ExpressionStatementKind: {
+    auto ES = Ctx.Create<ExpressionStatement>();
+    ES->SetExpression(ReadChild<Expression>(R));
+    return ES;
+  }
+  case Node::IfStatementKind: {
+    auto IS = Ctx.Create<IfStatement>();
+    IS->SetCondition(ReadRequiredChild<Expression>(R));
+    IS->SetIfBody(ReadRequiredChild<Statement>(R));
+    IS->SetElseBody(ReadChild<Statement>(R));
+    return IS;
+  }
+  case Node::SwitchStatementKind: {
+    auto SS = Ctx.Create<SwitchStatement>();
+    SS->SetCondition(ReadRequiredChild<Expression>(R));
+    std::vector<std::pair<int, ASTList<Statement *>>> Cases;
+    for (auto NumCases = R.ReadVarUInt();
+         NumCases > 0 && !R.HasError(); NumCases--) {
+      auto Value = R.Read<int32_t>();
+      Cases.push_back({Value, ReadChildren<Statement>(R)});
+    }
+    SS->SetCaseBodies(Ctx.CreateList(Cases));
+    SS->SetDefaultBody(ReadChildren<Statement>(R));
+    return SS;
+  }
+  case Node::WhileStatementKind: {
+    auto WS = Ctx.Create<WhileStatement>();
+    WS->SetCondition(ReadRequiredChild<Expression>(R));
+    WS->SetBody(ReadRequiredChild<Statement>(R));
+    return WS;
+  }
+  case Node::ForStatementKind: {
+    auto FS = Ctx.Create<ForStatement>();
+    FS->SetVarDecl(ReadChild<Statement>(R));
+    FS->SetInit(ReadChild<Expression>(R));
+    FS->SetCondition(ReadChild<Expression>(R));
+    FS->SetIncrement(ReadChild<Expression>(R));
+    FS->SetBody(ReadRequiredChild<Statement>(R));
+    return FS;
+  }
+  case Node::ReturnStatementKind:
+    return Ctx.Create<ReturnStatement>(ReadChild<Expression>(R));
+  case Node::BreakStatementKind:
+    return Ctx.Create<BreakStatement>();
+  case Node::ContinueStatementKind:
+    return Ctx.Create<ContinueStatement>();
+  case Node::FunctionParameterDeclarationKind: {
+    auto FPD = Ctx.Create<FunctionParameterDeclaration>();
+    FPD->SetName(ReadName(R));
+    FPD->SetType(ReadType(R));
+    return FPD;
+  }
+  case Node::FunctionDeclarationKind: {
+    auto Name = ReadName(R);
+    auto FuncType = ReadType(R);
+    auto Arguments = ReadChildren<FunctionParameterDeclaration>(R);
+    auto Body = ReadChild<CompoundStatement>(R);
+    auto ReturnsNumber = R.ReadVarUInt();
+    return Ctx.Create<FunctionDeclaration>(FuncType, Name, Arguments, Body,
+                                           ReturnsNumber);
+  }
+  case Node::TranslationUnitKind:
+    return Ctx.Create<TranslationUnit>(ReadChildren<Statement>(R));
+  default:
+    R.SetError();
+    return nullptr;
+  }
+}
+
+Expression *ASTReader::ReadExpression(RecordReader &R, uint8_t Kind,
+                                      const Type *Ty) {
+  switch (Kind) {
+  case Node::BinaryExpressionKind: {
+    auto Operation = ReadOperation(R);
+    if (!Operation)
+      break;
+    auto BE = Ctx.Create<BinaryExpression>();
+    BE->SetOperation(*Operation);
+    BE->SetLeftExpr(ReadRequiredChild<Expression>(R));
+    BE->SetRightExpr(ReadRequiredChild<Expression>(R));
+    return BE;
+  }
+  case Node::TernaryExpressionKind: {
+    auto TE = Ctx.Create<TernaryExpression>();
+    TE->SetCondition(ReadRequiredChild<Expression>(R));
+    TE->SetExprIfTrue(ReadRequiredChild<Expression>(R));
+    TE->SetExprIfFalse(ReadRequiredChild<Expression>(R));
+    return TE;
+  }
+  case Node::StructMemberReferenceKind: {
+    auto Expr = ReadRequiredChild<Expression>(R);
+    auto MemberId = ReadName(R);
+    auto MemberIndex = R.ReadVarUInt();
+    if (!Expr ||
+        MemberIndex >= Expr->GetResultType()->GetTypeList().size())
+      break;
+    return Ctx.Create<StructMemberReference>(Expr, MemberId, MemberIndex);
+  }
+  case Node::StructInitExpressionKind: {
+    auto InitValues = ReadChildren<Expression>(R);
+    std::vector<Symbol> MemberNames;
+    for (auto NumMembers = R.ReadVarUInt();
+         NumMembers > 0 && !R.HasError(); NumMembers--)
+      MemberNames.push_back(ReadName(R));
+    return Ctx.Create<StructInitExpression>(Ty, InitValues,
+                                            Ctx.CreateList(MemberNames));
+  }
+  case Node::UnaryExpressionKind: {
+    auto Operation = ReadOperation(R);
+    if (!Operation)
+      break;
+    auto UE = Ctx.Create<UnaryExpression>();
+    UE->SetOperation(*Operation);
+    UE->SetExpr(ReadRequiredChild<Expression>(R));
+    return UE;
+  }
+  case Node::CallExpressionKind: {
+    auto Name = ReadName(R);
+    return Ctx.Create<CallExpression>(Name, ReadChildren<Expression>(R), Ty);
+  }
+  case Node::ReferenceExpressionKind: {
+    auto RE = Ctx.Create<ReferenceExpression>(Token());
+    RE->SetIdentifier(ReadName(R));
+    return RE;
+  }
+  case Node::IntegerLiteralExpressionKind:
+    return Ctx.Create<IntegerLiteralExpression>(TC, R.ReadVarUInt());
+  case Node::FloatLiteralExpressionKind:
+    return Ctx.Create<FloatLiteralExpression>(TC, R.Read<double>());
+  case Node::ArrayExpressionKind: {
+    auto Base = ReadRequiredChild<Expression>(R);
+    auto Index = ReadRequiredChild<Expression>(R);
+    auto AE = Ctx.Create<ArrayExpression>(Base, Index, Ty);
+    AE->SetLValueness(R.Read<uint8_t>());
+    return AE;
+  }
+  case Node::ImplicitCastExpressionKind:
+    return Ctx.Create<ImplicitCastExpression>(ReadRequiredChild<Expression>(R),
+                                               Ty);
+  case Node::InitializerListExpressionKind:
+    return Ctx.Create<InitializerListExpression>(ReadChildren<Expression>(R));
+  default:
+    break;
+  }
+
+  R.SetError();
+  return nullptr;
+}
+
+std::string ASTFile::Write(TranslationUnit *TU) {
+  ASTWriter Writer;
+  auto Root = Writer.Visit(TU);
+  return Writer.Finish(Root);
+}
+
+bool ASTFile::Emit(const std::string &Path, TranslationUnit *TU,
+                   std::ostream &Errors) {
+  auto Content = Write(TU);
+  std::ofstream File(Path, std::ios::binary);
+  File.write(Content.data(), Content.size());
+  if (!File) {
+    Errors << "Cannot write the AST file: " << Path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+TranslationUnit *ASTFile::Read(std::string_view Buffer, ASTContext &Ctx) {
+  BinaryReader Reader(Buffer);
+  if (Reader.Read<uint32_t>() != Magic || Reader.Read<uint32_t>() != Version)
+    return nullptr;
+
+  std::vector<Symbol> Strings;
+  for (auto NumStrings = Reader.Read<uint32_t>();
+       NumStrings > 0 && !Reader.HasError(); NumStrings--)
+    Strings.emplace_back(Reader.ReadString());
+
+  TypeTableReader Types;
+  if (!Types.Read(Reader, Ctx.GetTypeContext()))
+    return nullptr;
+
+  auto Root = Reader.Read<uint32_t>();
+  auto Nodes = Reader.ReadString();
+  if (Reader.HasError() || !Reader.AtEnd())
+    return nullptr;
+
+  return ASTReader(Nodes, std::move(Strings), Types, Ctx).Read(Root);
+}
+
+TranslationUnit *ASTFile::Load(SourceManager &SM, const std::string &Path,
+                               ASTContext &Ctx) {
+  auto ID = SM.AddFile(Path);
+  if (!ID)
+    return nullptr;
+  return Read(SM.GetBuffer(*ID), Ctx);
+}
@@ -0,0 +1,43 @@
+#ifndef ASTFILE_HPP
+#define ASTFILE_HPP
+
+#include "../lexer/SourceManager.hpp"
+#include "AST.hpp"
+#include "ASTContext.hpp"
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/// Compact binary format of a translation unit, so the AST of an unchanged
+/// file can be given to the IR generation without preprocessing and parsing
+/// it again. It is up to the build to emit it again when the source changes.
+///
+/// The file starts with a magic number and a version, followed by the table of
+/// the strings, each distinct name is stored once, the table of the types and
+/// the offset of the translation unit in the node section, which is the rest
+/// of the file. A node is a kind tag followed by its fields, the names and
+/// the types are indices into their tables. The children are written before
+/// their parent, which refers to them by their distance back from itself
+/// instead of pointers. The numbers are variable length encoded, since most
+/// of them are small. The records are read in order without recursion, so
+/// loading is linear in the size of the file.
+class ASTFile {
+public:
+  /// The content of the file for @TU.
+  static std::string Write(TranslationUnit *TU);
+
+  /// Write @TU into the file @Path. Returns false and reports the problem to
+  /// @Errors if the file cannot be written.
+  static bool Emit(const std::string &Path, TranslationUnit *TU,
+                   std::ostream &Errors);
+
+  /// Create the nodes and the types of the file content @Buffer in @Ctx.
+  /// Returns nullptr if it is not an AST file or it is malformed.
+  static TranslationUnit *Read(std::string_view Buffer, ASTContext &Ctx);
+
+  /// Memory map the file @Path with @SM and read it into @Ctx.
+  static TranslationUnit *Load(SourceManager &SM, const std::string &Path,
+                               ASTContext &Ctx);
+};
+
+#endif
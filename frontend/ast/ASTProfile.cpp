@@ -0,0 +1,277 @@
+#include "ASTProfile.hpp"
+#include "Type.hpp"
+
+void ASTProfile::AddType(const Type *T) {
+  if (!T) {
+    AddValue<uint8_t>(0);
+    return;
+  }
+
+  if (auto It = TypeIndices.find(T); It != TypeIndices.end()) {
+    AddValue<uint8_t>(1);
+    AddValue<uint32_t>(It->second);
+    return;
+  }
+
+  uint32_t Index = TypeIndices.size();
+  TypeIndices[T] = Index;
+
+  AddValue<uint8_t>(2);
+  AddValue<uint8_t>(T->GetTypeKind());
+  AddValue<uint8_t>(T->GetTypeVariant());
+  AddValue<uint8_t>(T->GetPointerLevel());
+  AddValue<uint32_t>(T->GetQualifiers());
+  AddSymbol(T->GetName());
+
+  AddValue<uint32_t>(T->IsArray() ? T->GetDimensions().size() : 0);
+  if (T->IsArray())
+    for (auto Dim : T->GetDimensions())
+      AddValue<uint32_t>(Dim);
+
+  AddValue<uint32_t>(T->GetTypeList().size());
+  for (auto Member : T->GetTypeList())
+    AddType(Member);
+  AddValue<uint32_t>(T->GetParameterList().size());
+  for (auto Param : T->GetParameterList())
+    AddType(Param);
+}
+
+void ASTProfile::AddChild(Node *N) {
+  AddValue<uint8_t>(N != nullptr);
+  if (N)
+    Visit(N);
+}
+
+void ASTProfile::VisitVariableDeclaration(VariableDeclaration *VD) {
+  AddKind("VariableDeclaration");
+  AddSymbol(VD->GetName());
+  AddType(VD->GetType());
+  AddChild(VD->GetInitExpr());
+}
+
+void ASTProfile::VisitMemberDeclaration(MemberDeclaration *MD) {
+  AddKind("MemberDeclaration");
+  AddSymbol(MD->GetName());
+  AddType(MD->GetType());
+}
+
+void ASTProfile::VisitStructDeclaration(StructDeclaration *SD) {
+  AddKind("StructDeclaration");
+  AddSymbol(SD->GetName());
+  AddType(SD->GetType());
+  AddValue(SD->GetMembers().size());
+  for (auto &M : SD->GetMembers())
+    AddChild(M);
+}
+
+void ASTProfile::VisitEnumDeclaration(EnumDeclaration *ED) {
+  AddKind("EnumDeclaration");
+  AddType(ED->GetBaseType());
+  AddValue(ED->GetEnumerators().size());
+  for (auto &[Enum, Val] : ED->GetEnumerators()) {
+    AddSymbol(Enum);
+    AddValue(Val);
+  }
+}
+
+void ASTProfile::VisitCompoundStatement(CompoundStatement *CS) {
+  AddKind("CompoundStatement");
+  AddValue(CS->GetStatements().size());
+  for (auto &S : CS->GetStatements())
+    AddChild(S);
+}
+
+void ASTProfile::VisitExpressionStatement(ExpressionStatement *ES) {
+  AddKind("ExpressionStatement");
+  AddChild(ES->GetExpression());
+}
+
+void ASTProfile::VisitIfStatement(IfStatement *IS) {
+  AddKind("IfStatement");
+  AddChild(IS->GetCondition());
+  AddChild(IS->GetIfBody());
+  AddChild(IS->GetElseBody());
+}
+
+void ASTProfile::VisitSwitchStatement(SwitchStatement *SS) {
+  AddKind("SwitchStatement");
+  AddChild(SS->GetCondition());
+  AddValue(SS->GetCaseBodies().size());
+  for (auto &[CaseConst, CaseBody] : SS->GetCaseBodies()) {
+    AddValue(CaseConst);
+    AddValue(CaseBody.size());
+    for (auto &CaseStatement : CaseBody)
+      AddChild(CaseStatement);
+  }
+  AddValue(SS->GetDefaultBody().size());
+  for (auto &DefaultStatement : SS->GetDefaultBody())
+    AddChild(DefaultStatement);
+}
+
+void ASTProfile::VisitWhileStatement(WhileStatement *WS) {
+  AddKind("WhileStatement");
+  AddChild(WS->GetCondition());
+  AddChild(WS->GetBody());
+}
+
+void ASTProfile::VisitForStatement(ForStatement *FS) {
+  AddKind("ForStatement");
+  AddChild(FS->GetVarDecl());
+  AddChild(FS->GetInit());
+  AddChild(FS->GetCondition());
+  AddChild(FS->GetIncrement());
+  AddChild(FS->GetBody());
+}
+
+void ASTProfile::VisitReturnStatement(ReturnStatement *RS) {
+  AddKind("ReturnStatement");
+  AddChild(RS->HasValue() ? RS->GetRetVal() : nullptr);
+}
+
+void ASTProfile::VisitBreakStatement(BreakStatement *BS) {
+  AddKind("BreakStatement");
+}
+
+void ASTProfile::VisitContinueStatement(ContinueStatement *CS) {
+  AddKind("ContinueStatement");
+}
+
+void ASTProfile::VisitFunctionParameterDeclaration(
+    FunctionParameterDeclaration *FPD) {
+  AddKind("FunctionParameterDeclaration");
+  AddSymbol(FPD->GetName());
+  AddType(FPD->GetType());
+}
+
+void ASTProfile::VisitFunctionDeclaration(FunctionDeclaration *FD) {
+  AddKind("FunctionDeclaration");
+  AddType(FD->GetType());
+  AddReference(FD->GetName());
+  AddValue(FD->GetReturnsNumber());
+  AddValue(FD->GetArguments().size());
+  for (auto &Argument : FD->GetArguments())
+    AddChild(Argument);
+  AddChild(FD->GetBody());
+}
+
+void ASTProfile::VisitTranslationUnit(TranslationUnit *TU) {
+  AddKind("TranslationUnit");
+  AddValue(TU->GetDeclarations().size());
+  for (auto &Declaration : TU->GetDeclarations())
+    AddChild(Declaration);
+}
+
+void ASTProfile::VisitBinaryExpression(BinaryExpression *BE) {
+  // the operands are added like with AddChild, but a chain of binary
+  // expressions is walked with an explicit stack, since it can be deeper than
+  // the call stack
+  std::vector<Expression *> Operands = {BE};
+  while (!Operands.empty()) {
+    auto E = Operands.back();
+    Operands.pop_back();
+
+    // BE was added as a child by its parent already
+    if (E != BE) {
+      AddValue<uint8_t>(E != nullptr);
+      if (!E)
+        continue;
+    }
+
+    auto Binary = DynCast<BinaryExpression>(E);
+    if (!Binary) {
+      Visit(E);
+      continue;
+    }
+
+    AddKind("BinaryExpression");
+    AddResult(Binary);
+    AddValue(Binary->GetOperation().GetKind());
+    Operands.push_back(Binary->GetRightExpr());
+    Operands.push_back(Binary->GetLeftExpr());
+  }
+}
+
+void ASTProfile::VisitTernaryExpression(TernaryExpression *TE) {
+  AddKind("TernaryExpression");
+  AddResult(TE);
+  AddChild(TE->GetCondition());
+  AddChild(TE->GetExprIfTrue());
+  AddChild(TE->GetExprIfFalse());
+}
+
+void ASTProfile::VisitStructMemberReference(StructMemberReference *SMR) {
+  AddKind("StructMemberReference");
+  AddResult(SMR);
+  AddSymbol(SMR->GetMemberId());
+  AddValue(SMR->GetMemberIndex());
+  AddChild(SMR->GetExpr());
+}
+
+void ASTProfile::VisitStructInitExpression(StructInitExpression *SIE) {
+  AddKind("StructInitExpression");
+  AddResult(SIE);
+  AddValue(SIE->GetMemberId().size());
+  for (auto &MemberIdentifier : SIE->GetMemberId())
+    AddSymbol(MemberIdentifier);
+  AddValue(SIE->GetInitList().size());
+  for (auto &InitValue : SIE->GetInitList())
+    AddChild(InitValue);
+}
+
+void ASTProfile::VisitUnaryExpression(UnaryExpression *UE) {
+  AddKind("UnaryExpression");
+  AddResult(UE);
+  AddValue(UE->GetOperation().GetKind());
+  AddChild(UE->GetExpr());
+}
+
+void ASTProfile::VisitCallExpression(CallExpression *CE) {
+  AddKind("CallExpression");
+  AddResult(CE);
+  AddReference(CE->GetName());
+  AddValue(CE->GetArguments().size());
+  for (auto &Argument : CE->GetArguments())
+    AddChild(Argument);
+}
+
+void ASTProfile::VisitReferenceExpression(ReferenceExpression *RE) {
+  AddKind("ReferenceExpression");
+  AddResult(RE);
+  AddReference(RE->GetIdentifier());
+}
+
+void ASTProfile::VisitIntegerLiteralExpression(IntegerLiteralExpression *ILE) {
+  AddKind("IntegerLiteralExpression");
+  AddResult(ILE);
+  AddValue(ILE->GetUIntValue());
+}
+
+void ASTProfile::VisitFloatLiteralExpression(FloatLiteralExpression *FLE) {
+  AddKind("FloatLiteralExpression");
+  AddResult(FLE);
+  AddValue(FLE->GetValue());
+}
+
+void ASTProfile::VisitArrayExpression(ArrayExpression *AE) {
+  AddKind("ArrayExpression");
+  AddResult(AE);
+  // the array expressions have their own lvalueness
+  AddValue(AE->GetLValueness());
+  AddChild(AE->GetBaseExpression());
+  AddChild(AE->GetIndexExpression());
+}
+
+void ASTProfile::VisitImplicitCastExpression(ImplicitCastExpression *ICE) {
+  AddKind("ImplicitCastExpression");
+  AddResult(ICE);
+  AddChild(ICE->GetCastableExpression());
+}
+
+void ASTProfile::VisitInitializerListExpression(
+    InitializerListExpression *ILE) {
+  AddKind("InitializerListExpression");
+  AddResult(ILE);
+  AddValue(ILE->GetExprList().size());
+  for (auto &E : ILE->GetExprList())
+    AddChild(E);
+}
@@ -0,0 +1,89 @@
+#ifndef ASTPROFILE_HPP
+#define ASTPROFILE_HPP
+
+#include "../../support/SHA256.hpp"
+#include "../../support/Symbol.hpp"
+#include "ASTVisitor.hpp"
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// Structural hash of an AST subtree, to recognize code which did not change
+/// since an earlier compilation. Visiting a node adds its kind and each field
+/// the code generation depends on. The types are hashed by their structure, so
+/// eg.: a changed struct layout changes the hash of the code using the struct.
+class ASTProfile : public ASTVisitor<ASTProfile> {
+public:
+  void VisitVariableDeclaration(VariableDeclaration *VD);
+  void VisitMemberDeclaration(MemberDeclaration *MD);
+  void VisitStructDeclaration(StructDeclaration *SD);
+  void VisitEnumDeclaration(EnumDeclaration *ED);
+  void VisitCompoundStatement(CompoundStatement *CS);
+  void VisitExpressionStatement(ExpressionStatement *ES);
+  void VisitIfStatement(IfStatement *IS);
+  void VisitSwitchStatement(SwitchStatement *SS);
+  void VisitWhileStatement(WhileStatement *WS);
+  void VisitForStatement(ForStatement *FS);
+  void VisitReturnStatement(ReturnStatement *RS);
+  void VisitBreakStatement(BreakStatement *BS);
+  void VisitContinueStatement(ContinueStatement *CS);
+  void VisitFunctionParameterDeclaration(FunctionParameterDeclaration *FPD);
+  void VisitFunctionDeclaration(FunctionDeclaration *FD);
+  void VisitTranslationUnit(TranslationUnit *TU);
+
+  void VisitBinaryExpression(BinaryExpression *BE);
+  void VisitTernaryExpression(TernaryExpression *TE);
+  void VisitStructMemberReference(StructMemberReference *SMR);
+  void VisitStructInitExpression(StructInitExpression *SIE);
+  void VisitUnaryExpression(UnaryExpression *UE);
+  void VisitCallExpression(CallExpression *CE);
+  void VisitReferenceExpression(ReferenceExpression *RE);
+  void VisitIntegerLiteralExpression(IntegerLiteralExpression *ILE);
+  void VisitFloatLiteralExpression(FloatLiteralExpression *FLE);
+  void VisitArrayExpression(ArrayExpression *AE);
+  void VisitImplicitCastExpression(ImplicitCastExpression *ICE);
+  void VisitInitializerListExpression(InitializerListExpression *ILE);
+
+  void AddKind(const char *Kind) { AddString(Kind); }
+
+  void AddString(std::string_view Str) {
+    Hash.UpdateValue(Str.size());
+    Hash.Update(Str);
+  }
+
+  void AddSymbol(Symbol S) { AddString(S.GetString()); }
+
+  template <typename T> void AddValue(T Value) { Hash.UpdateValue(Value); }
+
+  void AddType(const Type *T);
+
+  /// Add the subtree @N, which might be missing.
+  void AddChild(Node *N);
+
+  /// Add the name @S of a declaration referred to, which might be outside of
+  /// the subtree.
+  void AddReference(Symbol S) {
+    AddSymbol(S);
+    References.push_back(S);
+  }
+
+  const std::vector<Symbol> &GetReferences() const { return References; }
+
+  SHA256::Digest Final() { return Hash.Final(); }
+
+private:
+  /// Add the fields every expression has.
+  void AddResult(Expression *E) {
+    AddType(E->GetResultType());
+    AddValue(E->GetLValueness());
+  }
+
+  SHA256 Hash;
+  /// A type added before is only referred to by its index. This also ends
+  /// the recursion on self referencing structs.
+  std::unordered_map<const Type *, uint32_t> TypeIndices;
+  std::vector<Symbol> References;
+};
+
+#endif
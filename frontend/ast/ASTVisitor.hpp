@@ -0,0 +1,102 @@
+#ifndef ASTVISITOR_HPP
+#define ASTVISITOR_HPP
+
+#include "AST.hpp"
+#include <cassert>
+#include <vector>
+
+/// Traversal of the AST dispatched statically on the kind of the nodes, so
+/// there are no virtual calls. @Derived implements VisitX(X *) for the node
+/// classes it handles, the rest fall back to VisitStatement or
+/// VisitExpression, then to VisitNode, which returns a default constructed
+/// @RetT. Visit does not go into the children, the VisitX functions visit
+/// the ones they need.
+template <typename Derived, typename RetT = void> class ASTVisitor {
+public:
+  RetT Visit(Node *N) {
+    switch (N->GetKind()) {
+#define AST_VISIT_CASE(Class)                                                  \
+  case Node::Class##Kind:                                                      \
+    return GetDerived().Visit##Class(static_cast<Class *>(N));
+      AST_NODES(AST_VISIT_CASE)
+#undef AST_VISIT_CASE
+    }
+    assert(!"Invalid node kind");
+    return RetT();
+  }
+
+#define AST_VISIT_STATEMENT(Class)                                             \
+  RetT Visit##Class(Class *S) { return GetDerived().VisitStatement(S); }
+  AST_STATEMENT_NODES(AST_VISIT_STATEMENT)
+#undef AST_VISIT_STATEMENT
+
+#define AST_VISIT_EXPRESSION(Class)                                            \
+  RetT Visit##Class(Class *E) { return GetDerived().VisitExpression(E); }
+  AST_EXPRESSION_NODES(AST_VISIT_EXPRESSION)
+#undef AST_VISIT_EXPRESSION
+
+  RetT VisitStatement(Statement *S) { return GetDerived().VisitNode(S); }
+  RetT VisitExpression(Expression *E) { return GetDerived().VisitNode(E); }
+  RetT VisitNode(Node *N) { return RetT(); }
+
+  /// Visit @Root and the binary expressions nested into its operands with an
+  /// explicit stack instead of recursion, since a machine generated chain of
+  /// operations can be deeper than the call stack. The operands which are
+  /// not part of the chain are visited with VisitBinaryOperand, then
+  /// VisitBinaryOperands(BE, L, R) of @Derived gets the results of the
+  /// operands of BE and returns the result of BE. A nested BE is part of the
+  /// chain if IsBinaryChain(BE) is true, and its right operand is visited
+  /// first if VisitsRightFirst(BE) is true.
+  RetT VisitBinaryChain(BinaryExpression *Root) {
+    struct Frame {
+      BinaryExpression *BE;
+      RetT First;
+      bool FirstDone;
+    };
+    std::vector<Frame> Stack;
+    Expression *Next = Root;
+
+    for (;;) {
+      // step down to the first operand which is not part of the chain
+      auto BE = DynCast<BinaryExpression>(Next);
+      if (BE && (BE == Root || GetDerived().IsBinaryChain(BE))) {
+        Stack.push_back({BE, RetT(), false});
+        Next = GetDerived().VisitsRightFirst(BE) ? BE->GetRightExpr()
+                                                 : BE->GetLeftExpr();
+        continue;
+      }
+
+      auto Result = GetDerived().VisitBinaryOperand(Next);
+
+      // step up while both operands of the top of the stack are done
+      for (;;) {
+        auto &Top = Stack.back();
+        const bool RightFirst = GetDerived().VisitsRightFirst(Top.BE);
+        if (!Top.FirstDone) {
+          Top.First = Result;
+          Top.FirstDone = true;
+          Next = RightFirst ? Top.BE->GetLeftExpr() : Top.BE->GetRightExpr();
+          break;
+        }
+
+        Result = RightFirst
+                     ? GetDerived().VisitBinaryOperands(Top.BE, Result,
+                                                        Top.First)
+                     : GetDerived().VisitBinaryOperands(Top.BE, Top.First,
+                                                        Result);
+        Stack.pop_back();
+        if (Stack.empty())
+          return Result;
+      }
+    }
+  }
+
+  RetT VisitBinaryOperand(Expression *E) { return Visit(E); }
+  bool IsBinaryChain(BinaryExpression *BE) { return true; }
+  bool VisitsRightFirst(BinaryExpression *BE) { return false; }
+
+protected:
+  Derived &GetDerived() { return *static_cast<Derived *>(this); }
+};
+
+#endif
@@ -0,0 +1,376 @@
+#include "ConstantFolder.hpp"
+#include <cstdint>
+#include <optional>
+
+/// True if values of @Ty can be folded, that is it is an integer type or
+/// double and not a pointer.
+static bool IsArithmeticType(const Type *Ty) {
+  return Ty->IsSimpleType() && !Ty->IsPointerType() &&
+         (Ty->IsIntegerType() || Ty->GetTypeVariant() == Type::Double);
+}
+
+static unsigned GetBitWidth(const Type *Ty) {
+  switch (Ty->GetTypeVariant()) {
+  case Type::Char:
+  case Type::UnsignedChar:
+    return 8;
+  case Type::Int:
+  case Type::UnsignedInt:
+    return 32;
+  default:
+    return 64;
+  }
+}
+
+/// Truncate @Value to the width of the integer type @Ty, then extend it back
+/// to 64 bit according to the signedness of @Ty. Literals are kept in this
+/// form, so a negative value is sign extended like the ones the parser makes.
+static uint64_t ConvertInteger(uint64_t Value, const Type *Ty) {
+  const unsigned Width = GetBitWidth(Ty);
+  if (Width == 64)
+    return Value;
+
+  const uint64_t Mask = (uint64_t(1) << Width) - 1;
+  Value &= Mask;
+  if (!Ty->IsUnsigned() && (Value >> (Width - 1)) != 0)
+    Value |= ~Mask;
+  return Value;
+}
+
+/// The value of the integer literal @E converted to @Ty.
+static uint64_t GetIntegerValue(Expression *E, const Type *Ty) {
+  auto Value = static_cast<IntegerLiteralExpression *>(E)->GetUIntValue();
+  return ConvertInteger(ConvertInteger(Value, E->GetResultType()), Ty);
+}
+
+/// The value of the literal @E as a double.
+static double GetFloatValue(Expression *E) {
+  if (auto FLE = DynCast<FloatLiteralExpression>(E))
+    return FLE->GetValue();
+
+  auto Value = GetIntegerValue(E, E->GetResultType());
+  if (E->GetResultType()->IsUnsigned())
+    return static_cast<double>(Value);
+  return static_cast<double>(static_cast<int64_t>(Value));
+}
+
+/// The type of @E before the implicit conversion to the type of the operation
+/// using it.
+static const Type *GetUnconvertedType(Expression *E) {
+  if (auto ICE = DynCast<ImplicitCastExpression>(E))
+    return ICE->GetSourceType();
+  return E->GetResultType();
+}
+
+static bool IsLiteral(Expression *E) {
+  return Isa<IntegerLiteralExpression>(E) || Isa<FloatLiteralExpression>(E);
+}
+
+/// True if the literal @E is not zero.
+static bool IsTrue(Expression *E) {
+  if (auto FLE = DynCast<FloatLiteralExpression>(E))
+    return FLE->GetValue() != 0.0;
+  return GetIntegerValue(E, E->GetResultType()) != 0;
+}
+
+/// Evaluate the integer operation @Op on @L and @R, which are already
+/// converted to @Ty, the type the operation is done in.
+static std::optional<uint64_t>
+EvaluateInteger(BinaryExpression::BinaryOperation Op, uint64_t L, uint64_t R,
+                const Type *Ty) {
+  const bool IsSigned = !Ty->IsUnsigned();
+  const auto SL = static_cast<int64_t>(L);
+  const auto SR = static_cast<int64_t>(R);
+
+  switch (Op) {
+  case BinaryExpression::ADD:
+    return L + R;
+  case BinaryExpression::SUB:
+    return L - R;
+  case BinaryExpression::MUL:
+    return L * R;
+  case BinaryExpression::DIV:
+  case BinaryExpression::MOD:
+    // dividing the smallest 64 bit value by -1 overflows
+    if (SR == 0 || (SR == -1 && SL == INT64_MIN))
+      return std::nullopt;
+    return Op == BinaryExpression::DIV ? SL / SR : SL % SR;
+  case BinaryExpression::DIVU:
+  case BinaryExpression::MODU:
+    if (R == 0)
+      return std::nullopt;
+    return Op == BinaryExpression::DIVU ? L / R : L % R;
+  case BinaryExpression::LSL:
+  case BinaryExpression::LSR:
+    // shifting by the width or more or shifting a negative value is
+    // undefined or implementation defined
+    if (R >= GetBitWidth(Ty) || (IsSigned && SL < 0))
+      return std::nullopt;
+    return Op == BinaryExpression::LSL ? L << R : L >> R;
+  case BinaryExpression::AND:
+    return L & R;
+  case BinaryExpression::EQ:
+    return L == R;
+  case BinaryExpression::NE:
+    return L != R;
+  case BinaryExpression::LT:
+    return IsSigned ? SL < SR : L < R;
+  case BinaryExpression::GT:
+    return IsSigned ? SL > SR : L > R;
+  case BinaryExpression::LE:
+    return IsSigned ? SL <= SR : L <= R;
+  case BinaryExpression::GE:
+    return IsSigned ? SL >= SR : L >= R;
+  default:
+    return std::nullopt;
+  }
+}
+
+Expression *ConstantFolder::CreateLiteral(uint64_t Value, const Type *Ty) {
+  auto Literal = Ctx.Create<IntegerLiteralExpression>(
+      Ctx.GetTypeContext(), ConvertInteger(Value, Ty));
+  Literal->SetType(Ty);
+  return Literal;
+}
+
+Expression *ConstantFolder::CreateLiteral(double Value) {
+  return Ctx.Create<FloatLiteralExpression>(Ctx.GetTypeContext(), Value);
+}
+
+Expression *ConstantFolder::VisitVariableDeclaration(VariableDeclaration *VD) {
+  VD->SetInitExpr(Fold(VD->GetInitExpr()));
+  return nullptr;
+}
+
+Expression *ConstantFolder::VisitCompoundStatement(CompoundStatement *CS) {
+  for (auto &S : CS->GetStatements())
+    Visit(S);
+  return nullptr;
+}
+
+Expression *ConstantFolder::VisitExpressionStatement(ExpressionStatement *ES) {
+  ES->SetExpression(Fold(ES->GetExpression()));
+  return nullptr;
+}
+
+Expression *ConstantFolder::VisitIfStatement(IfStatement *IS) {
+  IS->SetCondition(Visit(IS->GetCondition()));
+  Visit(IS->GetIfBody());
+  if (IS->GetElseBody())
+    Visit(IS->GetElseBody());
+  return nullptr;
+}
+
+Expression *ConstantFolder::VisitSwitchStatement(SwitchStatement *SS) {
+  SS->SetCondition(Visit(SS->GetCondition()));
+  for (auto &[CaseConst, CaseBody] : SS->GetCaseBodies())
+    for (auto &CaseStatement : CaseBody)
+      Visit(CaseStatement);
+  for (auto &DefaultStatement : SS->GetDefaultBody())
+    Visit(DefaultStatement);
+  return nullptr;
+}
+
+Expression *ConstantFolder::VisitWhileStatement(WhileStatement *WS) {
+  WS->SetCondition(Visit(WS->GetCondition()));
+  Visit(WS->GetBody());
+  return nullptr;
+}
+
+Expression *ConstantFolder::VisitForStatement(ForStatement *FS) {
+  if (FS->GetInit())
+    FS->SetInit(Visit(FS->GetInit()));
+  else if (FS->GetVarDecl())
+    Visit(FS->GetVarDecl());
+  FS->SetCondition(Fold(FS->GetCondition()));
+  FS->SetIncrement(Fold(FS->GetIncrement()));
+  Visit(FS->GetBody());
+  return nullptr;
+}
+
+Expression *ConstantFolder::VisitReturnStatement(ReturnStatement *RS) {
+  if (RS->HasValue())
+    RS->SetRetVal(Visit(RS->GetRetVal()));
+  return nullptr;
+}
+
+Expression *ConstantFolder::VisitFunctionDeclaration(FunctionDeclaration *FD) {
+  if (FD->GetBody())
+    Visit(FD->GetBody());
+  return nullptr;
+}
+
+Expression *ConstantFolder::VisitTranslationUnit(TranslationUnit *TU) {
+  for (auto &Declaration : TU->GetDeclarations())
+    Visit(Declaration);
+  return nullptr;
+}
+
+Expression *ConstantFolder::VisitBinaryExpression(BinaryExpression *BE) {
+  return VisitBinaryChain(BE);
+}
+
+Expression *ConstantFolder::VisitBinaryOperands(BinaryExpression *BE,
+                                                Expression *L, Expression *R) {
+  // the conversion of the left operand is folded already, but the width of a
+  // shift depends on the type before it
+  auto LeftType = GetUnconvertedType(BE->GetLeftExpr());
+
+  BE->SetLeftExpr(L);
+  BE->SetRightExpr(R);
+
+  if (!IsLiteral(L) || !IsLiteral(R) ||
+      !IsArithmeticType(BE->GetResultType()))
+    return BE;
+
+  const auto Op = BE->GetOperationKind();
+  auto &TC = Ctx.GetTypeContext();
+
+  // the operands are converted to their common type, which is the result type
+  // unless it is a comparison
+  auto OperandType = TC.Get(Type::GetStrongestType(
+      Type::GetStrongestType(L->GetResultType()->GetTypeVariant(),
+                             R->GetResultType()->GetTypeVariant()),
+      Type::Int));
+
+  if (Op == BinaryExpression::ANDL)
+    return CreateLiteral(uint64_t(IsTrue(L) && IsTrue(R)),
+                         BE->GetResultType());
+
+  if (OperandType->GetTypeVariant() == Type::Double) {
+    const double FL = GetFloatValue(L);
+    const double FR = GetFloatValue(R);
+
+    switch (Op) {
+    case BinaryExpression::ADD:
+      return CreateLiteral(FL + FR);
+    case BinaryExpression::SUB:
+      return CreateLiteral(FL - FR);
+    case BinaryExpression::MUL:
+      return CreateLiteral(FL * FR);
+    case BinaryExpression::DIV:
+      return CreateLiteral(FL / FR);
+    case BinaryExpression::EQ:
+      return CreateLiteral(uint64_t(FL == FR), BE->GetResultType());
+    case BinaryExpression::NE:
+      return CreateLiteral(uint64_t(FL != FR), BE->GetResultType());
+    case BinaryExpression::LT:
+      return CreateLiteral(uint64_t(FL < FR), BE->GetResultType());
+    case BinaryExpression::GT:
+      return CreateLiteral(uint64_t(FL > FR), BE->GetResultType());
+    case BinaryExpression::LE:
+      return CreateLiteral(uint64_t(FL <= FR), BE->GetResultType());
+    case BinaryExpression::GE:
+      return CreateLiteral(uint64_t(FL >= FR), BE->GetResultType());
+    default:
+      return BE;
+    }
+  }
+
+  // shifting by the width of the promoted left operand or more is undefined,
+  // even if a wider count makes the operation wider, like 1 << 40l
+  if ((Op == BinaryExpression::LSL || Op == BinaryExpression::LSR) &&
+      GetIntegerValue(R, OperandType) >=
+          GetBitWidth(TC.Get(Type::GetStrongestType(
+              LeftType->GetTypeVariant(), Type::Int))))
+    return BE;
+
+  auto Result =
+      EvaluateInteger(Op, GetIntegerValue(L, OperandType),
+                      GetIntegerValue(R, OperandType), OperandType);
+  if (!Result)
+    return BE;
+  return CreateLiteral(*Result, BE->GetResultType());
+}
+
+Expression *ConstantFolder::VisitTernaryExpression(TernaryExpression *TE) {
+  TE->SetCondition(Visit(TE->GetCondition()));
+  TE->SetExprIfTrue(Visit(TE->GetExprIfTrue()));
+  TE->SetExprIfFalse(Visit(TE->GetExprIfFalse()));
+
+  if (!IsLiteral(TE->GetCondition()))
+    return TE;
+
+  // the type of the expression is the type of the true branch, so the false
+  // one can only replace it if it has the same type
+  auto Selected = IsTrue(TE->GetCondition()) ? TE->GetExprIfTrue()
+                                             : TE->GetExprIfFalse();
+  if (Selected->GetResultType() != TE->GetResultType())
+    return TE;
+  return Selected;
+}
+
+Expression *
+ConstantFolder::VisitStructMemberReference(StructMemberReference *SMR) {
+  SMR->SetExpr(Visit(SMR->GetExpr()));
+  return SMR;
+}
+
+Expression *
+ConstantFolder::VisitStructInitExpression(StructInitExpression *SIE) {
+  for (auto &InitValue : SIE->GetInitList())
+    InitValue = Visit(InitValue);
+  return SIE;
+}
+
+Expression *ConstantFolder::VisitUnaryExpression(UnaryExpression *UE) {
+  UE->SetExpr(Visit(UE->GetExpr()));
+
+  auto E = UE->GetExpr();
+  if (!IsLiteral(E) || !IsArithmeticType(UE->GetResultType()))
+    return UE;
+
+  switch (UE->GetOperationKind()) {
+  case UnaryExpression::MINUS:
+    if (auto FLE = DynCast<FloatLiteralExpression>(E))
+      return CreateLiteral(-FLE->GetValue());
+    return CreateLiteral(0 - GetIntegerValue(E, UE->GetResultType()),
+                         UE->GetResultType());
+  case UnaryExpression::NOT:
+    return CreateLiteral(uint64_t(!IsTrue(E)), UE->GetResultType());
+  default:
+    return UE;
+  }
+}
+
+Expression *ConstantFolder::VisitCallExpression(CallExpression *CE) {
+  for (auto &Argument : CE->GetArguments())
+    Argument = Visit(Argument);
+  return CE;
+}
+
+Expression *ConstantFolder::VisitArrayExpression(ArrayExpression *AE) {
+  AE->SetIndexExpression(Visit(AE->GetIndexExpression()));
+  return AE;
+}
+
+Expression *
+ConstantFolder::VisitImplicitCastExpression(ImplicitCastExpression *ICE) {
+  ICE->SetCastableExpression(Visit(ICE->GetCastableExpression()));
+
+  auto E = ICE->GetCastableExpression();
+  auto DestType = ICE->GetResultType();
+  if (!IsLiteral(E) || !IsArithmeticType(DestType))
+    return ICE;
+
+  if (DestType->GetTypeVariant() == Type::Double)
+    return CreateLiteral(GetFloatValue(E));
+
+  if (auto FLE = DynCast<FloatLiteralExpression>(E)) {
+    // converting a value which does not fit into the integer is undefined
+    const double Value = FLE->GetValue();
+    if (!(Value > -9223372036854775808.0 && Value < 9223372036854775808.0) ||
+        (DestType->IsUnsigned() && Value <= -1.0))
+      return ICE;
+    return CreateLiteral(uint64_t(static_cast<int64_t>(Value)), DestType);
+  }
+
+  return CreateLiteral(GetIntegerValue(E, DestType), DestType);
+}
+
+Expression *
+ConstantFolder::VisitInitializerListExpression(InitializerListExpression *ILE) {
+  for (auto &E : ILE->GetExprList())
+    E = Visit(E);
+  return ILE;
+}
@@ -0,0 +1,59 @@
+#ifndef CONSTANTFOLDER_HPP
+#define CONSTANTFOLDER_HPP
+
+#include "ASTContext.hpp"
+#include "ASTVisitor.hpp"
+
+/// Replace the expressions which only operate on literals with the literal
+/// they evaluate to, following the C conversion rules of their types, eg.:
+/// "(1 + 2) * 3u" becomes the unsigned 9. Signed overflow wraps around like
+/// on the targets, operations which would trap or are implementation defined,
+/// like a division by zero, are left to the runtime.
+///
+/// Visiting an expression folds its operands and returns the expression to
+/// use in its place, which is the expression itself if it cannot be folded.
+/// Visiting a statement updates the expressions in it and returns null.
+class ConstantFolder : public ASTVisitor<ConstantFolder, Expression *> {
+public:
+  explicit ConstantFolder(ASTContext &Ctx) : Ctx(Ctx) {}
+
+  Expression *VisitVariableDeclaration(VariableDeclaration *VD);
+  Expression *VisitCompoundStatement(CompoundStatement *CS);
+  Expression *VisitExpressionStatement(ExpressionStatement *ES);
+  Expression *VisitIfStatement(IfStatement *IS);
+  Expression *VisitSwitchStatement(SwitchStatement *SS);
+  Expression *VisitWhileStatement(WhileStatement *WS);
+  Expression *VisitForStatement(ForStatement *FS);
+  Expression *VisitReturnStatement(ReturnStatement *RS);
+  Expression *VisitFunctionDeclaration(FunctionDeclaration *FD);
+  Expression *VisitTranslationUnit(TranslationUnit *TU);
+
+  Expression *VisitBinaryExpression(BinaryExpression *BE);
+  Expression *VisitTernaryExpression(TernaryExpression *TE);
+  Expression *VisitStructMemberReference(StructMemberReference *SMR);
+  Expression *VisitStructInitExpression(StructInitExpression *SIE);
+  Expression *VisitUnaryExpression(UnaryExpression *UE);
+  Expression *VisitCallExpression(CallExpression *CE);
+  Expression *VisitArrayExpression(ArrayExpression *AE);
+  Expression *VisitImplicitCastExpression(ImplicitCastExpression *ICE);
+  Expression *VisitInitializerListExpression(InitializerListExpression *ILE);
+
+  /// Fold @BE, whose operands are folded to @L and @R already.
+  Expression *VisitBinaryOperands(BinaryExpression *BE, Expression *L,
+                                  Expression *R);
+
+  /// References and literals cannot be folded any further.
+  Expression *VisitExpression(Expression *E) { return E; }
+
+private:
+  /// Fold @E if it is present.
+  Expression *Fold(Expression *E) { return E ? Visit(E) : nullptr; }
+
+  /// @Value converted to the integer type @Ty.
+  Expression *CreateLiteral(uint64_t Value, const Type *Ty);
+  Expression *CreateLiteral(double Value);
+
+  ASTContext &Ctx;
+};
+
+#endif
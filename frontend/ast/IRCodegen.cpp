@@ -1,4 +1,4 @@
-#include "AST.hpp"
+#include "IRCodegen.hpp"
 #include "Type.hpp"
 #include <memory>
 
@@ -34,26 +34,26 @@ static IRType GetIRTypeFromVK(Type::VariantKind VK) {
   }
 }
 
-static IRType GetIRTypeFromASTType(Type &CT) {
-  IRType Result = GetIRTypeFromVK(CT.GetTypeVariant());
+static IRType GetIRTypeFromASTType(const Type *CT) {
+  IRType Result = GetIRTypeFromVK(CT->GetTypeVariant());
 
   if (Result.IsStruct()) {
-    auto StructName = CT.GetName();
+    auto StructName = CT->GetName().GetString();
     Result.SetStructName(StructName);
 
     // convert each members AST type to IRType (recursive)
-    for (auto &MemberASTType : CT.GetTypeList())
+    for (auto MemberASTType : CT->GetTypeList())
       Result.GetMemberTypes().push_back(GetIRTypeFromASTType(MemberASTType));
   }
-  if (CT.IsArray()) {
-    Result.SetDimensions(CT.GetDimensions());
+  if (CT->IsArray()) {
+    Result.SetDimensions(CT->GetDimensions());
   }
 
-  Result.SetPointerLevel(CT.GetPointerLevel());
+  Result.SetPointerLevel(CT->GetPointerLevel());
   return Result;
 }
 
-Value *IfStatement::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitIfStatement(IfStatement *IS) {
   // if there is no else clause, then IR should be something like:
   //    # generate code for Condition
   //    # if the Condition is a CMP instruction, then revert its
@@ -78,7 +78,7 @@ Value *IfStatement::IRCodegen(IRFactory *IRF) {
   //    j <if_end>
   // <if_end>
 
-  const bool HaveElse = ElseBody != nullptr;
+  const bool HaveElse = IS->GetElseBody() != nullptr;
   const auto FuncPtr = IRF->GetCurrentFunction();
 
   std::unique_ptr<BasicBlock> Else;
@@ -87,7 +87,7 @@ Value *IfStatement::IRCodegen(IRFactory *IRF) {
 
   auto IfEnd = std::make_unique<BasicBlock>("if_end", FuncPtr);
 
-  auto Cond = Condition->IRCodegen(IRF);
+  auto Cond = Visit(IS->GetCondition());
 
   // if Condition was a compare instruction then just revert its relation
   if (auto CMP = dynamic_cast<CompareInstruction *>(Cond); CMP != nullptr) {
@@ -102,12 +102,12 @@ Value *IfStatement::IRCodegen(IRFactory *IRF) {
   // if true
   auto IfTrue = std::make_unique<BasicBlock>("if_true", FuncPtr);
   IRF->InsertBB(std::move(IfTrue));
-  IfBody->IRCodegen(IRF);
+  Visit(IS->GetIfBody());
   IRF->CreateJUMP(IfEnd.get());
 
   if (HaveElse) {
     IRF->InsertBB(std::move(Else));
-    ElseBody->IRCodegen(IRF);
+    Visit(IS->GetElseBody());
     IRF->CreateJUMP(IfEnd.get());
   }
 
@@ -115,7 +115,7 @@ Value *IfStatement::IRCodegen(IRFactory *IRF) {
   return nullptr;
 }
 
-Value *SwitchStatement::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitSwitchStatement(SwitchStatement *SS) {
   //   # generate code for Condition
   //   cmp.eq $cmp_res1, %Condition, case1_const
   //   br $cmp_res1, <case1_body>
@@ -141,11 +141,11 @@ Value *SwitchStatement::IRCodegen(IRFactory *IRF) {
   auto SwitchEnd = std::make_unique<BasicBlock>("switch_end", FuncPtr);
   auto DefaultCase = std::make_unique<BasicBlock>("switch_default", FuncPtr);
 
-  auto Cond = Condition->IRCodegen(IRF);
+  auto Cond = Visit(SS->GetCondition());
 
   std::vector<std::unique_ptr<BasicBlock>> CaseBodies;
 
-  for (auto &[Const, Statements] : Cases)
+  for (auto &[Const, Statements] : SS->GetCaseBodies())
     if (!Statements.empty())
       CaseBodies.push_back(std::make_unique<BasicBlock>("switch_case", FuncPtr));
 
@@ -155,7 +155,7 @@ Value *SwitchStatement::IRCodegen(IRFactory *IRF) {
   // code block, CaseIdx keep track the current target basic block so falling
   // through cases could refer to it
   size_t CaseIdx = 0;
-  for (auto &[Const, Statements] : Cases) {
+  for (auto &[Const, Statements] : SS->GetCaseBodies()) {
     auto CMP_res = IRF->CreateCMP(CompareInstruction::EQ, Cond,
                                   IRF->GetConstant((uint64_t)Const));
     IRF->CreateBR(CMP_res, CaseBodies[CaseIdx].get());
@@ -167,11 +167,11 @@ Value *SwitchStatement::IRCodegen(IRFactory *IRF) {
   IRF->CreateJUMP(DefaultCase.get());
 
   // Generating the bodies for the cases
-  for (auto &[Const, Statements] : Cases) {
+  for (auto &[Const, Statements] : SS->GetCaseBodies()) {
     if (!Statements.empty()) {
       IRF->InsertBB(std::move(CaseBodies.front()));
       for (auto &Statement : Statements) {
-        Statement->IRCodegen(IRF);
+        Visit(Statement);
       }
       CaseBodies.erase(CaseBodies.begin());
     }
@@ -179,8 +179,8 @@ Value *SwitchStatement::IRCodegen(IRFactory *IRF) {
 
   // Generate default case
   IRF->InsertBB(std::move(DefaultCase));
-  for (auto &Statement : DefaultBody)
-    Statement->IRCodegen(IRF);
+  for (auto &Statement : SS->GetDefaultBody())
+    Visit(Statement);
 
   IRF->GetBreaksEndBBsTable().erase(IRF->GetBreaksEndBBsTable().end() - 1);
   IRF->InsertBB(std::move(SwitchEnd));
@@ -188,7 +188,7 @@ Value *SwitchStatement::IRCodegen(IRFactory *IRF) {
   return nullptr;
 }
 
-Value *WhileStatement::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitWhileStatement(WhileStatement *WS) {
   //  <loop_header>
   //    # generate code for the Condition
   //    # if the Condition is a CMP instruction, then revert its
@@ -209,7 +209,7 @@ Value *WhileStatement::IRCodegen(IRFactory *IRF) {
   IRF->CreateJUMP(Header.get());
 
   IRF->InsertBB(std::move(Header));
-  auto Cond = Condition->IRCodegen(IRF);
+  auto Cond = Visit(WS->GetCondition());
 
   // if Condition was a compare instruction then just revert its relation
   if (auto CMP = dynamic_cast<CompareInstruction *>(Cond); CMP != nullptr) {
@@ -223,7 +223,7 @@ Value *WhileStatement::IRCodegen(IRFactory *IRF) {
 
   IRF->GetBreaksEndBBsTable().push_back(LoopEnd.get());
   IRF->InsertBB(std::move(LoopBody));
-  Body->IRCodegen(IRF);
+  Visit(WS->GetBody());
   IRF->GetBreaksEndBBsTable().erase(IRF->GetBreaksEndBBsTable().end() - 1);
   IRF->CreateJUMP(HeaderPtr);
 
@@ -232,7 +232,7 @@ Value *WhileStatement::IRCodegen(IRFactory *IRF) {
   return nullptr;
 }
 
-Value *ForStatement::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitForStatement(ForStatement *FS) {
   // Similar solution to WhileStatement. The difference is that here the
   // initialization part has to be generated before the loop_header basicblock
   // and also inserting the increment expression before the backward jump to the
@@ -247,16 +247,16 @@ Value *ForStatement::IRCodegen(IRFactory *IRF) {
 
   // Generating code for the initializing expression or the variable declaration
   // and adding and explicit unconditional jump to the loop header basic block
-  if (Init)
-    Init->IRCodegen(IRF);
+  if (FS->GetInit())
+    Visit(FS->GetInit());
   else
-    VarDecl->IRCodegen(IRF);
+    Visit(FS->GetVarDecl());
   IRF->CreateJUMP(Header.get());
 
   // Inserting the loop header basicblock and generating the code for the
   // loop condition
   IRF->InsertBB(std::move(Header));
-  auto Cond = Condition->IRCodegen(IRF);
+  auto Cond = Visit(FS->GetCondition());
 
   // if Condition was a compare instruction then just revert its relation
   if (auto CMP = dynamic_cast<CompareInstruction *>(Cond); CMP != nullptr) {
@@ -272,13 +272,13 @@ Value *ForStatement::IRCodegen(IRFactory *IRF) {
   // Push entry
   IRF->GetLoopIncrementBBsTable().push_back(LoopIncrement.get());
   IRF->GetBreaksEndBBsTable().push_back(LoopEnd.get());
-  Body->IRCodegen(IRF);
+  Visit(FS->GetBody());
   // Pop entry
   IRF->GetBreaksEndBBsTable().erase(IRF->GetBreaksEndBBsTable().end() - 1);
   IRF->GetLoopIncrementBBsTable().erase(IRF->GetLoopIncrementBBsTable().end() - 1);
   IRF->CreateJUMP(LoopIncrement.get());
   IRF->InsertBB(std::move(LoopIncrement));
-  Increment->IRCodegen(IRF); // generating loop increment code here
+  Visit(FS->GetIncrement()); // generating loop increment code here
   IRF->CreateJUMP(HeaderPtr);
 
   IRF->InsertBB(std::move(LoopEnd));
@@ -286,24 +286,24 @@ Value *ForStatement::IRCodegen(IRFactory *IRF) {
   return nullptr;
 }
 
-Value *CompoundStatement::IRCodegen(IRFactory *IRF) {
-  for (auto &Statement : Statements)
-    Statement->IRCodegen(IRF);
+Value *IRCodegen::VisitCompoundStatement(CompoundStatement *CS) {
+  for (auto &Statement : CS->GetStatements())
+    Visit(Statement);
   return nullptr;
 }
 
-Value *ExpressionStatement::IRCodegen(IRFactory *IRF) {
-  return Expr->IRCodegen(IRF);
+Value *IRCodegen::VisitExpressionStatement(ExpressionStatement *ES) {
+  return Visit(ES->GetExpression());
 }
 
-Value *ReturnStatement::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitReturnStatement(ReturnStatement *RS) {
   auto RetNum = IRF->GetCurrentFunction()->GetReturnsNumber();
   IRF->GetCurrentFunction()->SetReturnsNumber(RetNum - 1);
 
-  bool HasRetVal = ReturnValue.has_value() &&
+  bool HasRetVal = RS->HasValue() &&
                    !IRF->GetCurrentFunction()->IsRetTypeVoid();
 
-  Value* RetVal = HasRetVal ? ReturnValue.value()->IRCodegen(IRF) : nullptr;
+  Value* RetVal = HasRetVal ? Visit(RS->GetRetVal()) : nullptr;
 
   if (IRF->GetCurrentFunction()->HasMultipleReturn()) {
     if (HasRetVal)
@@ -313,7 +313,7 @@ Value *ReturnStatement::IRCodegen(IRFactory *IRF) {
   return IRF->CreateRET(RetVal);
 }
 
-Value *FunctionDeclaration::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitFunctionDeclaration(FunctionDeclaration *FD) {
   IRF->SetGlobalScope(false);
 
   IRType RetType;
@@ -321,10 +321,10 @@ Value *FunctionDeclaration::IRCodegen(IRFactory *IRF) {
   std::unique_ptr<FunctionParameter> ImplicitStructPtr = nullptr;
   bool NeedIgnore = false;
 
-  switch (T.GetReturnType()) {
+  switch (FD->GetType()->GetReturnType()) {
   case Type::Composite:
-    if (T.IsStruct()) {
-      RetType = GetIRTypeFromASTType(T);
+    if (FD->GetType()->IsStruct()) {
+      RetType = GetIRTypeFromASTType(FD->GetType());
 
       // in case the struct is to big to pass by value
       if (!RetType.IsPTR() &&
@@ -340,7 +340,7 @@ Value *FunctionDeclaration::IRCodegen(IRFactory *IRF) {
         RetType = IRType(IRType::NONE);
 
         // on the same note create the extra struct pointer operand
-        auto ParamName = "struct." + ParamType.GetStructName();
+        auto ParamName = Symbol("struct." + ParamType.GetStructName());
         ImplicitStructPtr =
             std::make_unique<FunctionParameter>(ParamName, ParamType);
       }
@@ -382,10 +382,10 @@ Value *FunctionDeclaration::IRCodegen(IRFactory *IRF) {
     break;
   }
 
-  IRF->CreateNewFunction(Name, RetType);
-  IRF->GetCurrentFunction()->SetReturnsNumber(ReturnsNumber);
+  IRF->CreateNewFunction(FD->GetName().GetString(), RetType);
+  IRF->GetCurrentFunction()->SetReturnsNumber(FD->GetReturnsNumber());
 
-  if (Body == nullptr) {
+  if (FD->GetBody() == nullptr) {
     IRF->GetCurrentFunction()->SetToDeclarationOnly();
     return nullptr;
   }
@@ -395,18 +395,18 @@ Value *FunctionDeclaration::IRCodegen(IRFactory *IRF) {
     IRF->Insert(std::move(ImplicitStructPtr));
   }
 
-  for (auto &Argument : Arguments)
-    Argument->IRCodegen(IRF);
+  for (auto &Argument : FD->GetArguments())
+    Visit(Argument);
 
   // iterate over the statements and find returns
   if (NeedIgnore) {
-    auto CS = dynamic_cast<CompoundStatement *>(Body.get());
+    auto CS = DynCast<CompoundStatement>(FD->GetBody());
     assert(CS);
     for (auto &Stmt : CS->GetStatements())
       if (Stmt->IsRet()) {
-        auto RetStmt = dynamic_cast<ReturnStatement *>(Stmt.get());
+        auto RetStmt = DynCast<ReturnStatement>(Stmt);
         auto RefExpr =
-            dynamic_cast<ReferenceExpression *>(RetStmt->GetRetVal().get());
+            DynCast<ReferenceExpression>(RetStmt->GetRetVal());
         if (RefExpr)
           IRF->GetCurrentFunction()->SetIgnorableStructVarName(
               RefExpr->GetIdentifier());
@@ -415,16 +415,16 @@ Value *FunctionDeclaration::IRCodegen(IRFactory *IRF) {
 
   // if there are multiple returns, then create a local variable on the stack
   // which will hold the different return values
-  auto HasMultipleReturn = ReturnsNumber > 1 && !RetType.IsVoid();
+  auto HasMultipleReturn = FD->GetReturnsNumber() > 1 && !RetType.IsVoid();
   if (HasMultipleReturn)
-    IRF->GetCurrentFunction()->SetReturnValue(IRF->CreateSA(Name + ".return",
-                                                       RetType));
+    IRF->GetCurrentFunction()->SetReturnValue(
+        IRF->CreateSA(FD->GetName().GetString() + ".return", RetType));
 
-  Body->IRCodegen(IRF);
+  Visit(FD->GetBody());
 
   // patching JUMP -s with nullptr destination to make them point to the last BB
   if (HasMultipleReturn) {
-    auto BBName = Name + "_end";
+    auto BBName = FD->GetName().GetString() + "_end";
     auto RetBB = std::make_unique<BasicBlock>(BBName, IRF->GetCurrentFunction());
     auto RetBBPtr = RetBB.get();
     IRF->InsertBB(std::move(RetBB));
@@ -440,23 +440,24 @@ Value *FunctionDeclaration::IRCodegen(IRFactory *IRF) {
   }
 
   // if its a void function without return statement, then add one
-  if (ReturnsNumber == 0 && RetType.IsVoid())
+  if (FD->GetReturnsNumber() == 0 && RetType.IsVoid())
     IRF->CreateRET(nullptr);
 
   return nullptr;
 }
 
-Value *ContinueStatement::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitContinueStatement(ContinueStatement *CS) {
   return IRF->CreateJUMP(IRF->GetLoopIncrementBBsTable().back());
 }
 
-Value *BreakStatement::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitBreakStatement(BreakStatement *BS) {
   assert(IRF->GetBreaksEndBBsTable().size() > 0);
   return IRF->CreateJUMP(IRF->GetBreaksEndBBsTable().back());
 }
 
-Value *FunctionParameterDeclaration::IRCodegen(IRFactory *IRF) {
-  auto ParamType = GetIRTypeFromASTType(Ty);
+Value *IRCodegen::VisitFunctionParameterDeclaration(
+    FunctionParameterDeclaration *FPD) {
+  auto ParamType = GetIRTypeFromASTType(FPD->GetType());
 
   // if the param is a struct and too big to passed by value then change it
   // to a struct pointer, because that is how it will be passed by callers
@@ -465,22 +466,22 @@ Value *FunctionParameterDeclaration::IRCodegen(IRFactory *IRF) {
           GetMaxStructSizePassedByValue())
     ParamType.IncrementPointerLevel();
 
-  auto Param = std::make_unique<FunctionParameter>(Name, ParamType);
+  auto Param = std::make_unique<FunctionParameter>(FPD->GetName(), ParamType);
 
-  auto SA = IRF->CreateSA(Name, ParamType);
-  IRF->AddToSymbolTable(Name, SA);
+  auto SA = IRF->CreateSA(FPD->GetName().GetString(), ParamType);
+  IRF->AddToSymbolTable(FPD->GetName(), SA);
   IRF->CreateSTR(Param.get(), SA);
   IRF->Insert(std::move(Param));
 
   return nullptr;
 }
 
-Value *VariableDeclaration::IRCodegen(IRFactory *IRF) {
-  auto Type = GetIRTypeFromASTType(AType);
+Value *IRCodegen::VisitVariableDeclaration(VariableDeclaration *VD) {
+  auto Type = GetIRTypeFromASTType(VD->GetType());
 
   // If an array type, then change Type to reflect this
-  if (AType.IsArray())
-    Type.SetDimensions(AType.GetDimensions());
+  if (VD->GetType()->IsArray())
+    Type.SetDimensions(VD->GetType()->GetDimensions());
 
   // If we are in global scope, then its a global variable declaration
   std::vector<uint64_t> InitList;
@@ -488,18 +489,19 @@ Value *VariableDeclaration::IRCodegen(IRFactory *IRF) {
     // if the initialization is done by an initializer
     // FIXME: assuming max 2 dimensional init list like "{ { 1, 2 }, { 3, 4 } }"
     // add support for arbitrary dimension
-    if (auto InitListExpr = dynamic_cast<InitializerListExpression*>(Init.get());
+    if (auto InitListExpr =
+            DynCast<InitializerListExpression>(VD->GetInitExpr());
         InitListExpr != nullptr) {
       for (auto &Expr : InitListExpr->GetExprList())
-        if (auto ConstExpr = dynamic_cast<IntegerLiteralExpression*>(Expr.get());
+        if (auto ConstExpr = DynCast<IntegerLiteralExpression>(Expr);
             ConstExpr != nullptr) {
           InitList.push_back(ConstExpr->GetUIntValue());
         } else if (auto InitListExpr =
-                     dynamic_cast<InitializerListExpression*>(Expr.get());
+                     DynCast<InitializerListExpression>(Expr);
                  InitListExpr != nullptr) {
           for (auto &Expr : InitListExpr->GetExprList())
             if (auto ConstExpr =
-                    dynamic_cast<IntegerLiteralExpression *>(Expr.get());
+                    DynCast<IntegerLiteralExpression>(Expr);
                 ConstExpr != nullptr)
               InitList.push_back(ConstExpr->GetUIntValue());
             else
@@ -510,38 +512,39 @@ Value *VariableDeclaration::IRCodegen(IRFactory *IRF) {
     // FIXME: for now only IntegerLiteralExpression, add support for const
     // expressions like 1 + 2 - 4 * 12
     else {
-      if (auto ConstExpr = dynamic_cast<IntegerLiteralExpression*>(Init.get());
+      if (auto ConstExpr = DynCast<IntegerLiteralExpression>(VD->GetInitExpr());
           ConstExpr != nullptr) {
         InitList.push_back(ConstExpr->GetUIntValue());
       }
     }
-    return IRF->CreateGlobalVar(Name, Type, std::move(InitList));
+    return IRF->CreateGlobalVar(VD->GetName(), Type, std::move(InitList));
   }
 
-  if (IRF->GetCurrentFunction()->GetIgnorableStructVarName() == Name) {
+  if (IRF->GetCurrentFunction()->GetIgnorableStructVarName() == VD->GetName()) {
     auto ParamValue =
         IRF->GetCurrentFunction()
             ->GetParameters()
                 [IRF->GetCurrentFunction()->GetParameters().size() - 1]
             .get();
-    IRF->AddToSymbolTable(Name, ParamValue);
+    IRF->AddToSymbolTable(VD->GetName(), ParamValue);
     return ParamValue;
   }
 
   // Otherwise we are in a local scope of a function. Allocate space on
   // stack and update the local symbol table.
-  auto SA = IRF->CreateSA(Name, Type);
+  auto SA = IRF->CreateSA(VD->GetName().GetString(), Type);
 
   // TODO: revisit this
-  if (Init) {
+  if (VD->GetInitExpr()) {
     // If initialized with initializer list then assuming its only 1 dimensional
     // and only contain integer literal expressions.
-    if (auto InitListExpr = dynamic_cast<InitializerListExpression*>(Init.get());
+    if (auto InitListExpr =
+            DynCast<InitializerListExpression>(VD->GetInitExpr());
         InitListExpr != nullptr) {
       unsigned LoopCounter = 0;
       for (auto &Expr : InitListExpr->GetExprList()) {
         if (auto ConstExpr =
-                dynamic_cast<IntegerLiteralExpression *>(Expr.get());
+                DynCast<IntegerLiteralExpression>(Expr);
             ConstExpr != nullptr) {
           // basically storing each entry to the right stack area
           // TODO: problematic for big arrays, Clang and GCC create a global
@@ -560,34 +563,34 @@ Value *VariableDeclaration::IRCodegen(IRFactory *IRF) {
       }
     }
     else
-      IRF->CreateSTR(Init->IRCodegen(IRF), SA);
+      IRF->CreateSTR(Visit(VD->GetInitExpr()), SA);
   }
 
-  IRF->AddToSymbolTable(Name, SA);
+  IRF->AddToSymbolTable(VD->GetName(), SA);
   return SA;
 }
 
-Value *MemberDeclaration::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitMemberDeclaration(MemberDeclaration *MD) {
   return nullptr;
 }
 
-Value *StructDeclaration::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitStructDeclaration(StructDeclaration *SD) {
   return nullptr;
 }
 
-Value *EnumDeclaration::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitEnumDeclaration(EnumDeclaration *ED) {
   return nullptr;
 }
 
-Value *CallExpression::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitCallExpression(CallExpression *CE) {
   std::vector<Value *> Args;
 
-  for (auto &Arg : Arguments) {
-    auto ArgIR = Arg->IRCodegen(IRF);
+  for (auto &Arg : CE->GetArguments()) {
+    auto ArgIR = Visit(Arg);
     // if the generated IR result is a struct pointer, but the actual function
     // expects a struct by value, then issue an extra load
     if (ArgIR->GetTypeRef().IsStruct() && ArgIR->GetTypeRef().IsPTR() &&
-        Arg->GetResultType().IsStruct() && !Arg->GetResultType().IsPointerType()) {
+        Arg->GetResultType()->IsStruct() && !Arg->GetResultType()->IsPointerType()) {
       // if it possible to pass it by value then issue a load first otherwise
       // it passed by pointer which already is
       if (!((ArgIR->GetTypeRef().GetByteSize() * 8) >
@@ -599,7 +602,7 @@ Value *CallExpression::IRCodegen(IRFactory *IRF) {
     Args.push_back(ArgIR);
   }
 
-  auto RetType = GetResultType().GetReturnType();
+  auto RetType = CE->GetResultType()->GetReturnType();
 
   IRType IRRetType;
   StackAllocationInstruction* StructTemp = nullptr;
@@ -631,12 +634,12 @@ Value *CallExpression::IRCodegen(IRFactory *IRF) {
     IRRetType = IRType(IRType::NONE, 0);
     break;
   case Type::Composite: {
-    IRRetType = GetIRTypeFromASTType(GetResultType());
+    IRRetType = GetIRTypeFromASTType(CE->GetResultType());
 
     // If the return type is a struct, then also make a stack allocation
     // to use that as a temporary, where the result would be copied to after
     // the call
-    StructTemp = IRF->CreateSA(Name + ".temp", IRRetType);
+    StructTemp = IRF->CreateSA(CE->GetName().GetString() + ".temp", IRRetType);
 
     // check if the call expression is returning a non pointer struct which is
     // to big to be returned back. In this case the called function were already
@@ -672,7 +675,7 @@ Value *CallExpression::IRCodegen(IRFactory *IRF) {
   // in case if the ret type was a struct, so StructTemp not nullptr
   if (StructTemp) {
     // make the call
-    auto CallRes = IRF->CreateCALL(Name, Args, IRRetType);
+    auto CallRes = IRF->CreateCALL(CE->GetName().GetString(), Args, IRRetType);
     // issue a store using the freshly allocated temporary StructTemp if
     // needed
     if (!IsRetChanged)
@@ -680,40 +683,40 @@ Value *CallExpression::IRCodegen(IRFactory *IRF) {
     return StructTemp;
   }
 
-  return IRF->CreateCALL(Name, Args, IRRetType);
+  return IRF->CreateCALL(CE->GetName().GetString(), Args, IRRetType);
 }
 
-Value *ReferenceExpression::IRCodegen(IRFactory *IRF) {
-  auto Local = IRF->GetSymbolValue(Identifier);
+Value *IRCodegen::VisitReferenceExpression(ReferenceExpression *RE) {
+  auto Local = IRF->GetSymbolValue(RE->GetIdentifier());
 
-  if (Local && this->GetResultType().IsStruct())
+  if (Local && RE->GetResultType()->IsStruct())
     return Local;
 
   if (Local) {
-    if (GetLValueness())
+    if (RE->GetLValueness())
       return Local;
     else
       return IRF->CreateLD(Local->GetType(), Local);
   }
 
-  auto GV = IRF->GetGlobalVar(Identifier);
+  auto GV = IRF->GetGlobalVar(RE->GetIdentifier());
   assert(GV && "Cannot be null");
 
   // If LValue, then return as a ptr to the global val
-  if (GetLValueness())
+  if (RE->GetLValueness())
     return GV;
 
-  if (this->GetResultType().IsStruct())
+  if (RE->GetResultType()->IsStruct())
     return GV;
 
   return IRF->CreateLD(GV->GetType(), GV);
 }
 
-Value *ArrayExpression::IRCodegen(IRFactory *IRF) {
-  assert(BaseExpression && "BaseExpression cannot be NULL");
-  auto BaseValue = BaseExpression->IRCodegen(IRF);
-  assert(IndexExpression && "IndexExpression cannot be NULL");
-  auto IndexValue = IndexExpression->IRCodegen(IRF);
+Value *IRCodegen::VisitArrayExpression(ArrayExpression *AE) {
+  assert(AE->GetBaseExpression() && "BaseExpression cannot be NULL");
+  auto BaseValue = Visit(AE->GetBaseExpression());
+  assert(AE->GetIndexExpression() && "IndexExpression cannot be NULL");
+  auto IndexValue = Visit(AE->GetIndexExpression());
 
   auto ResultType = BaseValue->GetType();
 
@@ -733,24 +736,25 @@ Value *ArrayExpression::IRCodegen(IRFactory *IRF) {
 
   auto GEP = IRF->CreateGEP(ResultType, BaseValue, IndexValue);
 
-  if (!GetLValueness() && ResultType.GetDimensions().size() == 0)
+  if (!AE->GetLValueness() && ResultType.GetDimensions().size() == 0)
     return IRF->CreateLD(ResultType, GEP);
 
   return GEP;
 }
 
-Value *ImplicitCastExpression::IRCodegen(IRFactory *IRF) {
-  auto SourceTypeVariant = CastableExpression->GetResultType().GetTypeVariant();
-  auto DestTypeVariant = GetResultType().GetTypeVariant();
+Value *IRCodegen::VisitImplicitCastExpression(ImplicitCastExpression *ICE) {
+  auto SourceTypeVariant =
+      ICE->GetCastableExpression()->GetResultType()->GetTypeVariant();
+  auto DestTypeVariant = ICE->GetResultType()->GetTypeVariant();
 
   // If its an array to pointer decay
   // Note: its only allowed if the expression is a ReferenceExpression
   // TODO: Investigate whether other types of expressions should be allowed
-  if (CastableExpression->GetResultType().IsArray() &&
-      GetResultType().IsPointerType()) {
+  if (ICE->GetCastableExpression()->GetResultType()->IsArray() &&
+      ICE->GetResultType()->IsPointerType()) {
     assert(SourceTypeVariant == DestTypeVariant);
 
-    auto RefExp = dynamic_cast<ReferenceExpression *>(CastableExpression.get());
+    auto RefExp = DynCast<ReferenceExpression>(ICE->GetCastableExpression());
     assert(RefExp);
 
     auto Referee = RefExp->GetIdentifier();
@@ -759,13 +763,13 @@ Value *ImplicitCastExpression::IRCodegen(IRFactory *IRF) {
       Res = IRF->GetGlobalVar(Referee);
     assert(Res);
 
-    auto Gep = IRF->CreateGEP(GetIRTypeFromASTType(GetResultType()), Res,
+    auto Gep = IRF->CreateGEP(GetIRTypeFromASTType(ICE->GetResultType()), Res,
                               IRF->GetConstant((uint64_t)0));
 
     return Gep;
   }
 
-  auto Val = CastableExpression->IRCodegen(IRF);
+  auto Val = Visit(ICE->GetCastableExpression());
 
   if (Type::OnlySigndnessDifference(SourceTypeVariant, DestTypeVariant))
     return Val;
@@ -849,21 +853,21 @@ Value *ImplicitCastExpression::IRCodegen(IRFactory *IRF) {
   return nullptr;
 }
 
-Value *StructMemberReference::IRCodegen(IRFactory *IRF) {
-  assert(StructTypedExpression && "cannot be NULL");
-  auto BaseValue = StructTypedExpression->IRCodegen(IRF);
+Value *IRCodegen::VisitStructMemberReference(StructMemberReference *SMR) {
+  assert(SMR->GetExpr() && "cannot be NULL");
+  auto BaseValue = Visit(SMR->GetExpr());
   assert(BaseValue && "cannot be NULL");
 
   auto ExprType = BaseValue->GetType();
   assert(ExprType.IsStruct());
 
-  auto IndexValue = IRF->GetConstant((uint64_t)MemberIndex);
+  auto IndexValue = IRF->GetConstant((uint64_t)SMR->GetMemberIndex());
 
-  assert(ExprType.GetMemberTypes().size() > MemberIndex);
+  assert(ExprType.GetMemberTypes().size() > SMR->GetMemberIndex());
 
   // The result type is a pointer to the member type. Ex: referred member is
   // an i32 than an i32*.
-  auto ResultType = ExprType.GetMemberTypes()[MemberIndex];
+  auto ResultType = ExprType.GetMemberTypes()[SMR->GetMemberIndex()];
   ResultType.IncrementPointerLevel();
 
   auto BaseType = BaseValue->GetType();
@@ -874,23 +878,24 @@ Value *StructMemberReference::IRCodegen(IRFactory *IRF) {
 
   auto GEP = IRF->CreateGEP(ResultType, BaseValue, IndexValue);
 
-  if (GetLValueness())
+  if (SMR->GetLValueness())
     return GEP;
 
-  auto ResultIRType = GetIRTypeFromASTType(this->GetResultType());
+  auto ResultIRType = GetIRTypeFromASTType(SMR->GetResultType());
 
   return IRF->CreateLD(ResultIRType, GEP);
 }
 
-Value *StructInitExpression::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitStructInitExpression(StructInitExpression *SIE) {
   // allocate stack for the struct first
-  auto IRResultType = GetIRTypeFromASTType(ResultType);
+  auto IRResultType = GetIRTypeFromASTType(SIE->GetResultType());
   // TODO: make sure the name will be unique
-  auto StructTemp = IRF->CreateSA(ResultType.GetName() + ".temp", IRResultType);
+  auto StructTemp = IRF->CreateSA(
+      SIE->GetResultType()->GetName().GetString() + ".temp", IRResultType);
 
   unsigned CurrentMemberIndex = 0;
-  for (auto &InitExpr : InitValues) {
-    auto InitExprCode = InitExpr->IRCodegen(IRF);
+  for (auto &InitExpr : SIE->GetInitList()) {
+    auto InitExprCode = Visit(InitExpr);
 
     auto ResultType = IRResultType.GetMemberTypes()[CurrentMemberIndex];
     ResultType.IncrementPointerLevel();
@@ -904,15 +909,16 @@ Value *StructInitExpression::IRCodegen(IRFactory *IRF) {
   return StructTemp;
 }
 
-Value *UnaryExpression::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitUnaryExpression(UnaryExpression *UE) {
   Value* E = nullptr;
 
-  if (GetOperationKind() != ADDRESS && GetOperationKind() != MINUS)
-    E = Expr->IRCodegen(IRF);
+  if (UE->GetOperationKind() != UnaryExpression::ADDRESS &&
+      UE->GetOperationKind() != UnaryExpression::MINUS)
+    E = Visit(UE->GetExpr());
 
-  switch (GetOperationKind()) {
-  case ADDRESS: {
-    auto RefExp = dynamic_cast<ReferenceExpression*>(Expr.get());
+  switch (UE->GetOperationKind()) {
+  case UnaryExpression::ADDRESS: {
+    auto RefExp = DynCast<ReferenceExpression>(UE->GetExpr());
     assert(RefExp);
     auto Referee = RefExp->GetIdentifier();
     auto Res = IRF->GetSymbolValue(Referee);
@@ -922,11 +928,11 @@ Value *UnaryExpression::IRCodegen(IRFactory *IRF) {
     }
     return Res;
   }
-  case DEREF: {
+  case UnaryExpression::DEREF: {
     auto ResultType = E->GetType();
     return IRF->CreateLD(ResultType, E);
   }
-  case NOT: {
+  case UnaryExpression::NOT: {
     // goal IR:
     //    # E generated here
     //    sa $result
@@ -966,18 +972,18 @@ Value *UnaryExpression::IRCodegen(IRFactory *IRF) {
     // the result seems to be always an rvalue so loading it also
     return IRF->CreateLD(IRType::CreateBool(), Result);
   }
-  case MINUS: {
-    if (auto ConstE = dynamic_cast<IntegerLiteralExpression*>(Expr.get());
+  case UnaryExpression::MINUS: {
+    if (auto ConstE = DynCast<IntegerLiteralExpression>(UE->GetExpr());
         ConstE != nullptr) {
       ConstE->SetValue(-ConstE->GetSIntValue());
-      return Expr->IRCodegen(IRF);
+      return Visit(UE->GetExpr());
     }
 
-    E = Expr->IRCodegen(IRF);
+    E = Visit(UE->GetExpr());
     return IRF->CreateSUB(IRF->GetConstant((uint64_t)0), E);
   }
-  case POST_DECREMENT:
-  case POST_INCREMENT: {
+  case UnaryExpression::POST_DECREMENT:
+  case UnaryExpression::POST_INCREMENT: {
     // make the assumption that the expression E is an LValue which means
     // its basically a pointer, so it requires a load first for addition to work
     auto LoadedValType = E->GetTypeRef();
@@ -985,7 +991,7 @@ Value *UnaryExpression::IRCodegen(IRFactory *IRF) {
     auto LoadedExpr = IRF->CreateLD(LoadedValType, E);
 
     Instruction* AddSub;
-    if (GetOperationKind() == POST_INCREMENT)
+    if (UE->GetOperationKind() == UnaryExpression::POST_INCREMENT)
       AddSub = IRF->CreateADD(LoadedExpr, IRF->GetConstant((uint64_t)1));
     else
       AddSub = IRF->CreateSUB(LoadedExpr, IRF->GetConstant((uint64_t)1));
@@ -1000,10 +1006,10 @@ Value *UnaryExpression::IRCodegen(IRFactory *IRF) {
   return nullptr;
 }
 
-Value *BinaryExpression::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitBinaryExpression(BinaryExpression *BE) {
   // TODO: simplify this, specially in case if there are actually multiple
   // logical operations like "a > 0 && a < 10 && a != 5"
-  if (GetOperationKind() == ANDL) {
+  if (BE->GetOperationKind() == BinaryExpression::ANDL) {
     // goal IR:
     //    # L generated here
     //    sa $result
@@ -1031,7 +1037,7 @@ Value *BinaryExpression::IRCodegen(IRFactory *IRF) {
     auto Result = IRF->CreateSA("result", IRType::CreateBool());
     IRF->CreateSTR(IRF->GetConstant((uint64_t)0), Result);
 
-    auto L = Left->IRCodegen(IRF);
+    auto L = Visit(BE->GetLeftExpr());
 
     // if L was a compare instruction then just revert its relation
     if (auto LCMP = dynamic_cast<CompareInstruction *>(L); LCMP != nullptr) {
@@ -1045,7 +1051,7 @@ Value *BinaryExpression::IRCodegen(IRFactory *IRF) {
 
     // RHS Test
     IRF->InsertBB(std::move(TestRhsBB));
-    auto R = Right->IRCodegen(IRF);
+    auto R = Visit(BE->GetRightExpr());
 
     // if R was a compare instruction then just revert its relation
     if (auto RCMP = dynamic_cast<CompareInstruction *>(R); RCMP != nullptr) {
@@ -1073,14 +1079,15 @@ Value *BinaryExpression::IRCodegen(IRFactory *IRF) {
     return IRF->CreateLD(IRType::CreateBool(), Result);
   }
 
-  if (GetOperationKind() == ASSIGN) {
-    // Assignment right associative so generate R first
-    auto R = Right->IRCodegen(IRF);
-    auto L = Left->IRCodegen(IRF);
+  return VisitBinaryChain(BE);
+}
 
-    if (!L || !R)
-      return nullptr;
+Value *IRCodegen::VisitBinaryOperands(BinaryExpression *BE, Value *L,
+                                      Value *R) {
+  if (!L || !R)
+    return nullptr;
 
+  if (BE->GetOperationKind() == BinaryExpression::ASSIGN) {
     if (R->GetTypeRef().IsStruct())
       IRF->CreateMEMCOPY(L, R, R->GetTypeRef().GetByteSize());
     else
@@ -1088,31 +1095,27 @@ Value *BinaryExpression::IRCodegen(IRFactory *IRF) {
     return R;
   }
 
-  if (GetOperationKind() == ADD_ASSIGN || GetOperationKind() == SUB_ASSIGN ||
-      GetOperationKind() == MUL_ASSIGN || GetOperationKind() == DIV_ASSIGN) {
-    // Assignment right associative so generate R first
-    auto R = Right->IRCodegen(IRF);
-    auto L = Left->IRCodegen(IRF);
-
-    if (!L || !R)
-      return nullptr;
-
-    if (R->GetTypeRef().IsStruct())
+  if (BE->GetOperationKind() == BinaryExpression::ADD_ASSIGN ||
+      BE->GetOperationKind() == BinaryExpression::SUB_ASSIGN ||
+      BE->GetOperationKind() == BinaryExpression::MUL_ASSIGN ||
+      BE->GetOperationKind() == BinaryExpression::DIV_ASSIGN) {
+    if (R->GetTypeRef().IsStruct()) {
       IRF->CreateMEMCOPY(L, R, R->GetTypeRef().GetByteSize());
-    else {
+      return R;
+    } else {
       Instruction *OperationResult = nullptr;
 
-      switch (GetOperationKind()) {
-      case ADD_ASSIGN:
+      switch (BE->GetOperationKind()) {
+      case BinaryExpression::ADD_ASSIGN:
         OperationResult = IRF->CreateADD(L, R);
         break;
-      case SUB_ASSIGN:
+      case BinaryExpression::SUB_ASSIGN:
         OperationResult = IRF->CreateSUB(L, R);
         break;
-      case MUL_ASSIGN:
+      case BinaryExpression::MUL_ASSIGN:
         OperationResult = IRF->CreateMUL(L, R);
         break;
-      case DIV_ASSIGN:
+      case BinaryExpression::DIV_ASSIGN:
         OperationResult = IRF->CreateDIV(L, R);
         break;
       default:
@@ -1127,21 +1130,15 @@ Value *BinaryExpression::IRCodegen(IRFactory *IRF) {
     }
   }
 
-  auto L = Left->IRCodegen(IRF);
-  auto R = Right->IRCodegen(IRF);
-
-  if (!L || !R)
-    return nullptr;
-
   // if the left operand is a constant
   if (L->IsConstant() && !R->IsConstant()) {
     // and if its a commutative operation
-    switch (GetOperationKind()) {
-    case ADD:
-    case MUL:
-    case AND:
-    case EQ:
-    case NE:
+    switch (BE->GetOperationKind()) {
+    case BinaryExpression::ADD:
+    case BinaryExpression::MUL:
+    case BinaryExpression::AND:
+    case BinaryExpression::EQ:
+    case BinaryExpression::NE:
       // then swap the operands, since most architecture supports immediate
       // as the last operand. Ex.: AArch64 add x0, x1, #123 not add x0, #123, x1
       std::swap(L, R);
@@ -1154,38 +1151,38 @@ Value *BinaryExpression::IRCodegen(IRFactory *IRF) {
   if (L->IsConstant())
     L = IRF->CreateMOV(L, R->GetBitWidth());
 
-  switch (GetOperationKind()) {
-  case LSL:
+  switch (BE->GetOperationKind()) {
+  case BinaryExpression::LSL:
     return IRF->CreateLSL(L, R);
-  case LSR:
+  case BinaryExpression::LSR:
     return IRF->CreateLSR(L, R);
-  case ADD:
+  case BinaryExpression::ADD:
     return IRF->CreateADD(L, R);
-  case SUB:
+  case BinaryExpression::SUB:
     return IRF->CreateSUB(L, R);
-  case MUL:
+  case BinaryExpression::MUL:
     return IRF->CreateMUL(L, R);
-  case DIV:
+  case BinaryExpression::DIV:
     return IRF->CreateDIV(L, R);
-  case DIVU:
+  case BinaryExpression::DIVU:
     return IRF->CreateDIVU(L, R);
-  case MOD:
+  case BinaryExpression::MOD:
     return IRF->CreateMOD(L, R);
-  case MODU:
+  case BinaryExpression::MODU:
     return IRF->CreateMODU(L, R);
-  case AND:
+  case BinaryExpression::AND:
     return IRF->CreateAND(L, R);
-  case EQ:
+  case BinaryExpression::EQ:
     return IRF->CreateCMP(CompareInstruction::EQ, L, R);
-  case LT:
+  case BinaryExpression::LT:
     return IRF->CreateCMP(CompareInstruction::LT, L, R);
-  case GT:
+  case BinaryExpression::GT:
     return IRF->CreateCMP(CompareInstruction::GT, L, R);
-  case NE:
+  case BinaryExpression::NE:
     return IRF->CreateCMP(CompareInstruction::NE, L, R);
-  case GE:
+  case BinaryExpression::GE:
     return IRF->CreateCMP(CompareInstruction::GE, L, R);
-  case LE:
+  case BinaryExpression::LE:
     return IRF->CreateCMP(CompareInstruction::LE, L, R);
   default:
     assert(!"Unhandled binary instruction type");
@@ -1193,7 +1190,7 @@ Value *BinaryExpression::IRCodegen(IRFactory *IRF) {
   }
 }
 
-Value *TernaryExpression::IRCodegen(IRFactory *IRF) {
+Value *IRCodegen::VisitTernaryExpression(TernaryExpression *TE) {
   // goal IR:
   //    # Condition generated here
   //    sa $result
@@ -1208,6 +1205,7 @@ Value *TernaryExpression::IRCodegen(IRFactory *IRF) {
   //    str [$result], ExprIfFalse
   //    j <end>
   // <end>
+  //    ld $value, [$result]
 
   const auto FuncPtr = IRF->GetCurrentFunction();
 
@@ -1215,7 +1213,7 @@ Value *TernaryExpression::IRCodegen(IRFactory *IRF) {
   auto FalseBB = std::make_unique<BasicBlock>("false", FuncPtr);
   auto FinalBB = std::make_unique<BasicBlock>("end", FuncPtr);
 
-  auto C = Condition->IRCodegen(IRF);
+  auto C = Visit(TE->GetCondition());
 
   // Condition Test
 
@@ -1231,33 +1229,49 @@ Value *TernaryExpression::IRCodegen(IRFactory *IRF) {
 
   // TRUE
   IRF->InsertBB(std::move(TrueBB));
-  auto TrueExpr = ExprIfTrue->IRCodegen(IRF);
+  auto TrueExpr = Visit(TE->GetExprIfTrue());
   auto Result = IRF->CreateSA("result", TrueExpr->GetType());
   IRF->CreateSTR(TrueExpr, Result);
   IRF->CreateJUMP(FinalBB.get());
 
   // FALSE
   IRF->InsertBB(std::move(FalseBB));
-  IRF->CreateSTR(ExprIfFalse->IRCodegen(IRF), Result);
+  IRF->CreateSTR(Visit(TE->GetExprIfFalse()), Result);
   IRF->CreateJUMP(FinalBB.get());
 
   IRF->InsertBB(std::move(FinalBB));
 
-  return Result;
+  // the ternary is an rvalue, like the operands of the expression using it
+  return IRF->CreateLD(TrueExpr->GetType(), Result);
 }
 
-Value *IntegerLiteralExpression::IRCodegen(IRFactory *IRF) {
-  return IRF->GetConstant(IntValue);
+Value *IRCodegen::VisitIntegerLiteralExpression(IntegerLiteralExpression *ILE) {
+  return IRF->GetConstant(ILE->GetUIntValue());
 }
 
-Value *FloatLiteralExpression::IRCodegen(IRFactory *IRF) {
-  return IRF->GetConstant(FPValue);
+Value *IRCodegen::VisitFloatLiteralExpression(FloatLiteralExpression *FLE) {
+  return IRF->GetConstant(FLE->GetValue());
 }
 
-Value *TranslationUnit::IRCodegen(IRFactory *IRF) {
-  for (auto &Declaration : Declarations) {
+Value *IRCodegen::VisitInitializerListExpression(
+    InitializerListExpression *ILE) {
+  return nullptr;
+}
+
+Value *IRCodegen::VisitTranslationUnit(TranslationUnit *TU) {
+  size_t FunctionIndex = 0;
+  for (auto &Declaration : TU->GetDeclarations()) {
+    if (auto Function = DynCast<FunctionDeclaration>(Declaration);
+        Function && Function->GetBody()) {
+      auto Skipped = FunctionIndex < SkippedFunctions.size() &&
+                     SkippedFunctions[FunctionIndex];
+      FunctionIndex++;
+      if (Skipped)
+        continue;
+    }
+
     IRF->SetGlobalScope();
-    if (auto Decl = Declaration->IRCodegen(IRF); Decl != nullptr)
+    if (auto Decl = Visit(Declaration); Decl != nullptr)
       IRF->AddGlobalVariable(Decl);
   }
   return nullptr;
@@ -0,0 +1,80 @@
+#ifndef IRCODEGEN_HPP
+#define IRCODEGEN_HPP
+
+#include "../../middle_end/IR/IRFactory.hpp"
+#include "../../middle_end/IR/Value.hpp"
+#include "ASTVisitor.hpp"
+#include <utility>
+#include <vector>
+
+/// Generate the IR of the AST with an IRFactory. Visiting an expression
+/// returns its value, a declaration might return what it created, like the
+/// stack allocation of a local variable, the rest returns nullptr.
+class IRCodegen : public ASTVisitor<IRCodegen, Value *> {
+public:
+  explicit IRCodegen(IRFactory *IRF) : IRF(IRF) {}
+
+  /// Skip the function definitions with true in @SkippedFunctions, indexed
+  /// by the order of the definitions in the translation unit.
+  IRCodegen(IRFactory *IRF, std::vector<bool> SkippedFunctions)
+      : IRF(IRF), SkippedFunctions(std::move(SkippedFunctions)) {}
+
+  Value *VisitVariableDeclaration(VariableDeclaration *VD);
+  Value *VisitMemberDeclaration(MemberDeclaration *MD);
+  Value *VisitStructDeclaration(StructDeclaration *SD);
+  Value *VisitEnumDeclaration(EnumDeclaration *ED);
+  Value *VisitCompoundStatement(CompoundStatement *CS);
+  Value *VisitExpressionStatement(ExpressionStatement *ES);
+  Value *VisitIfStatement(IfStatement *IS);
+  Value *VisitSwitchStatement(SwitchStatement *SS);
+  Value *VisitWhileStatement(WhileStatement *WS);
+  Value *VisitForStatement(ForStatement *FS);
+  Value *VisitReturnStatement(ReturnStatement *RS);
+  Value *VisitBreakStatement(BreakStatement *BS);
+  Value *VisitContinueStatement(ContinueStatement *CS);
+  Value *VisitFunctionParameterDeclaration(FunctionParameterDeclaration *FPD);
+  Value *VisitFunctionDeclaration(FunctionDeclaration *FD);
+  Value *VisitTranslationUnit(TranslationUnit *TU);
+
+  Value *VisitBinaryExpression(BinaryExpression *BE);
+  Value *VisitTernaryExpression(TernaryExpression *TE);
+  Value *VisitStructMemberReference(StructMemberReference *SMR);
+  Value *VisitStructInitExpression(StructInitExpression *SIE);
+  Value *VisitUnaryExpression(UnaryExpression *UE);
+  Value *VisitCallExpression(CallExpression *CE);
+  Value *VisitReferenceExpression(ReferenceExpression *RE);
+  Value *VisitIntegerLiteralExpression(IntegerLiteralExpression *ILE);
+  Value *VisitFloatLiteralExpression(FloatLiteralExpression *FLE);
+  Value *VisitArrayExpression(ArrayExpression *AE);
+  Value *VisitImplicitCastExpression(ImplicitCastExpression *ICE);
+  Value *VisitInitializerListExpression(InitializerListExpression *ILE);
+
+  /// Generate @BE, whose operands are generated already to @L and @R.
+  Value *VisitBinaryOperands(BinaryExpression *BE, Value *L, Value *R);
+
+  /// A logical and needs basic blocks between its operands, so it is
+  /// generated by VisitBinaryExpression on its own.
+  bool IsBinaryChain(BinaryExpression *BE) {
+    return BE->GetOperationKind() != BinaryExpression::ANDL;
+  }
+
+  /// Assignments are right associative, the value is generated first.
+  bool VisitsRightFirst(BinaryExpression *BE) {
+    switch (BE->GetOperationKind()) {
+    case BinaryExpression::ASSIGN:
+    case BinaryExpression::ADD_ASSIGN:
+    case BinaryExpression::SUB_ASSIGN:
+    case BinaryExpression::MUL_ASSIGN:
+    case BinaryExpression::DIV_ASSIGN:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+private:
+  IRFactory *IRF;
+  std::vector<bool> SkippedFunctions;
+};
+
+#endif
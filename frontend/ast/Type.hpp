@@ -1,10 +1,15 @@
 #ifndef TYPE_HPP
 #define TYPE_HPP
 
+#include "../../support/Symbol.hpp"
 #include <cassert>
 #include <string>
 #include <vector>
 
+/// C type of the frontend. The AST and the parser only refer to canonical
+/// instances handed out by a TypeContext as const Type *, so two types are the
+/// same if and only if their pointers are equal. A Type value is only built
+/// as a prototype to look up its canonical instance.
 class Type {
 public:
   /// Basic type variants. Numerical ones are ordered by conversion rank.
@@ -14,8 +19,8 @@ public:
   enum TypeKind { Simple, Array, Struct };
   enum TypeQualifier : unsigned { None, Typedef, Const };
 
-  std::string GetName() const { return Name; }
-  void SetName(std::string &n) { Name = n; }
+  Symbol GetName() const { return Name; }
+  void SetName(Symbol n) { Name = n; }
 
   TypeKind GetTypeKind() const { return Kind; }
   void SetTypeKind(TypeKind t) { Kind = t; }
@@ -72,7 +77,7 @@ public:
       Result = "void";
       break;
     case Composite:
-      return t->GetName();
+      return t->GetName().GetString();
     case Invalid:
       return "invalid";
     default:
@@ -89,8 +94,8 @@ public:
   /// Given two type variants it return the stronger one.
   /// Type variants must be numerical ones.
   /// Example Int and Double -> result Double.
-  static Type GetStrongestType(const Type::VariantKind type1,
-                               const Type::VariantKind type2) {
+  static VariantKind GetStrongestType(const Type::VariantKind type1,
+                                      const Type::VariantKind type2) {
     if (type1 > type2)
       return type1;
     else
@@ -114,20 +119,20 @@ public:
     }
   }
 
-  static bool IsImplicitlyCastable(const Type from, const Type to) {
-    const bool IsToPtr = to.IsPointerType();
-    const bool IsFromPtr = from.IsPointerType();
-    const bool IsFromArray = from.IsArray();
+  static bool IsImplicitlyCastable(const Type *from, const Type *to) {
+    const bool IsToPtr = to->IsPointerType();
+    const bool IsFromPtr = from->IsPointerType();
+    const bool IsFromArray = from->IsArray();
 
     // array to pointer decay case
     if (IsFromArray && !IsFromPtr && IsToPtr) {
-      if (from.GetTypeVariant() == to.GetTypeVariant())
+      if (from->GetTypeVariant() == to->GetTypeVariant())
         return true;
       return false;
     }
 
     bool Result;
-    switch (to.GetTypeVariant()) {
+    switch (to->GetTypeVariant()) {
     case Char:
     case UnsignedChar:
     case Int:
@@ -136,7 +141,7 @@ public:
     case UnsignedLong:
     case LongLong:
     case UnsignedLongLong:
-      Result = from.GetTypeVariant() >= Char;
+      Result = from->GetTypeVariant() >= Char;
       break;
     default:
       return false;
@@ -201,21 +206,13 @@ public:
     }
   }
 
-  Type(Type t, std::vector<Type> a) {
+  Type(Type t, std::vector<const Type *> a) {
     ParameterList = std::move(a);
     Ty = t.GetTypeVariant();
   }
 
-  Type(Type &&ct) {
-    PointerLevel = ct.PointerLevel;
-    Ty = ct.Ty;
-    Kind = ct.Kind;
-    Dimensions = std::move(ct.Dimensions);
-    TypeList = std::move(ct.TypeList);
-    ParameterList = std::move(ct.ParameterList);
-    Name = ct.Name;
-  }
-
+  Type(Type &&ct) = default;
+  Type &operator=(Type &&ct) = default;
   Type(const Type &ct) = default;
   Type &operator=(const Type &ct) = default;
 
@@ -253,49 +250,40 @@ public:
 
   bool IsConst() const { return Qualifiers & Const; }
 
-  std::vector<Type> &GetTypeList() { return TypeList; }
-  std::vector<Type> &GetParameterList() { return ParameterList; }
+  std::vector<const Type *> &GetTypeList() { return TypeList; }
+  const std::vector<const Type *> &GetTypeList() const { return TypeList; }
+  std::vector<const Type *> &GetParameterList() { return ParameterList; }
+  const std::vector<const Type *> &GetParameterList() const {
+    return ParameterList;
+  }
   VariantKind GetReturnType() const { return Ty; }
 
   std::vector<unsigned> &GetDimensions() {
     assert(IsArray() && "Must be an Array type to access Dimensions.");
     return Dimensions;
   }
+  const std::vector<unsigned> &GetDimensions() const {
+    assert(IsArray() && "Must be an Array type to access Dimensions.");
+    return Dimensions;
+  }
 
    void SetDimensions(std::vector<unsigned> D) {
      Kind = Array;
      Dimensions = std::move(D);
    }
 
-  std::vector<Type> &GetArgTypes() { return ParameterList; }
-
-  Type GetStructMemberType(const std::string &Member) {
-    for (auto &T : TypeList)
-      if (T.GetName() == Member)
-        return T;
-
-    return Type(VariantKind::Invalid);
+  std::vector<const Type *> &GetArgTypes() { return ParameterList; }
+  const std::vector<const Type *> &GetArgTypes() const {
+    return ParameterList;
   }
 
-  friend bool operator==(const Type &lhs, const Type &rhs) {
-    bool result = lhs.Kind == rhs.Kind && lhs.Ty == rhs.Ty;
-    result = result && lhs.GetPointerLevel() == rhs.GetPointerLevel();
-
-    if (!result)
-      return false;
-
-    switch (lhs.Kind) {
-    case Array:
-      result = result && (lhs.Dimensions == rhs.Dimensions);
-      break;
-    default:
-      break;
-    }
-    return result;
-  }
+  /// Returns nullptr if there is no member called @Member.
+  const Type *GetStructMemberType(Symbol Member) const {
+    for (auto T : TypeList)
+      if (T->GetName() == Member)
+        return T;
 
-  friend bool operator!=(const Type &lhs, const Type &rhs) {
-      return !(lhs == rhs);
+    return nullptr;
   }
 
   std::string ToString() const {
@@ -305,7 +293,7 @@ public:
       if (ArgSize > 0)
         TyStr += " (";
       for (size_t i = 0; i < ArgSize; i++) {
-        TyStr += Type::ToString(&ParameterList[i]);
+        TyStr += Type::ToString(ParameterList[i]);
         if (i + 1 < ArgSize)
           TyStr += ",";
         else
@@ -324,7 +312,9 @@ public:
   }
 
 private:
-  std::string Name; // For structs
+  friend class TypeContext;
+
+  Symbol Name; // For structs
   VariantKind Ty;
   uint8_t PointerLevel = 0;
 
@@ -332,8 +322,8 @@ private:
   unsigned Qualifiers = None;
   // TODO: revisit the use of union, deleted from here since
   // it just made things complicated
-  std::vector<Type> TypeList;
-  std::vector<Type> ParameterList;
+  std::vector<const Type *> TypeList;
+  std::vector<const Type *> ParameterList;
   std::vector<unsigned> Dimensions;
 };
 
@@ -0,0 +1,77 @@
+#include "TypeContext.hpp"
+
+static size_t HashCombine(size_t Seed, size_t Value) {
+  return Seed ^ (Value + 0x9e3779b97f4a7c15ULL + (Seed << 6) + (Seed >> 2));
+}
+
+size_t TypeContext::TypeHash::operator()(const Type *T) const {
+  size_t Hash = T->Ty;
+  Hash = HashCombine(Hash, T->Kind);
+  Hash = HashCombine(Hash, T->PointerLevel);
+  Hash = HashCombine(Hash, T->Qualifiers);
+  Hash = HashCombine(Hash, T->Name.GetID());
+  for (auto Dim : T->Dimensions)
+    Hash = HashCombine(Hash, Dim);
+  for (auto Member : T->TypeList)
+    Hash = HashCombine(Hash, reinterpret_cast<uintptr_t>(Member));
+  for (auto Param : T->ParameterList)
+    Hash = HashCombine(Hash, reinterpret_cast<uintptr_t>(Param));
+  return Hash;
+}
+
+// The member and parameter types are canonical, so comparing their pointers is
+// enough and the comparison is never recursive.
+bool TypeContext::TypeEqual::operator()(const Type *LHS,
+                                        const Type *RHS) const {
+  return LHS->Ty == RHS->Ty && LHS->Kind == RHS->Kind &&
+         LHS->PointerLevel == RHS->PointerLevel &&
+         LHS->Qualifiers == RHS->Qualifiers && LHS->Name == RHS->Name &&
+         LHS->Dimensions == RHS->Dimensions &&
+         LHS->TypeList == RHS->TypeList &&
+         LHS->ParameterList == RHS->ParameterList;
+}
+
+const Type *TypeContext::GetInvalid() {
+  static const Type Invalid;
+  return &Invalid;
+}
+
+const Type *TypeContext::Get(const Type &T) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  if (auto It = Uniqued.find(&T); It != Uniqued.end())
+    return *It;
+
+  Types.push_back(T);
+  Uniqued.insert(&Types.back());
+  return &Types.back();
+}
+
+const Type *TypeContext::GetPointerTo(const Type *T) {
+  Type Pointer = *T;
+  Pointer.IncrementPointerLevel();
+  return Get(Pointer);
+}
+
+const Type *TypeContext::GetPointee(const Type *T) {
+  Type Pointee = *T;
+  Pointee.DecrementPointerLevel();
+  return Get(Pointee);
+}
+
+const Type *TypeContext::GetUnqualified(const Type *T) {
+  if (T->GetQualifiers() == Type::None)
+    return T;
+
+  Type Unqualified = *T;
+  Unqualified.SetQualifiers(Type::None);
+  return Get(Unqualified);
+}
+
+void TypeContext::Reset() {
+  Uniqued.clear();
+  Types.clear();
+
+  Uniqued.insert(GetInvalid());
+  for (unsigned VK = 0; VK < SimpleTypes.size(); VK++)
+    SimpleTypes[VK] = Get(Type(static_cast<Type::VariantKind>(VK)));
+}
@@ -0,0 +1,58 @@
+#ifndef TYPECONTEXT_HPP
+#define TYPECONTEXT_HPP
+
+#include "Type.hpp"
+#include <array>
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+/// Uniques the frontend types. Every distinct type (including its qualifiers,
+/// pointer level, dimensions, struct name and member or parameter types) is
+/// stored exactly once and handed out as a const Type *, which stays valid
+/// until Reset. Get can be called from several threads, like the workers of
+/// the parallel parsing.
+class TypeContext {
+public:
+  TypeContext() { Reset(); }
+  TypeContext(const TypeContext &) = delete;
+  TypeContext &operator=(const TypeContext &) = delete;
+
+  /// Returns the canonical instance of @T. The member and parameter types of
+  /// @T must be canonical already.
+  const Type *Get(const Type &T);
+
+  /// Returns the unqualified, non pointer simple type of @VK.
+  const Type *Get(Type::VariantKind VK) { return SimpleTypes[VK]; }
+
+  /// The shared invalid type, which is canonical in every TypeContext. Used as
+  /// the type of the expressions whose type is not known (yet).
+  static const Type *GetInvalid();
+
+  const Type *GetPointerTo(const Type *T);
+  const Type *GetPointee(const Type *T);
+  const Type *GetUnqualified(const Type *T);
+
+  size_t Size() const { return Uniqued.size(); }
+
+  /// Release every type. All the pointers handed out so far become invalid.
+  void Reset();
+
+private:
+  struct TypeHash {
+    size_t operator()(const Type *T) const;
+  };
+
+  struct TypeEqual {
+    bool operator()(const Type *LHS, const Type *RHS) const;
+  };
+
+  /// A deque never moves its elements, so the canonical pointers stay valid.
+  std::deque<Type> Types;
+  std::unordered_set<const Type *, TypeHash, TypeEqual> Uniqued;
+  std::mutex Lock;
+  std::array<const Type *, Type::Double + 1> SimpleTypes;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include "TypeTable.hpp"
+
+uint32_t TypeTableWriter::GetIndex(const Type *T) {
+  if (auto It = Indices.find(T); It != Indices.end())
+    return It->second;
+
+  std::vector<uint32_t> Members, Params;
+  for (auto Member : T->GetTypeList())
+    Members.push_back(GetIndex(Member));
+  for (auto Param : T->GetParameterList())
+    Params.push_back(GetIndex(Param));
+
+  Records.Write<uint8_t>(T->GetTypeKind());
+  Records.Write<uint8_t>(T->GetTypeVariant());
+  Records.Write<uint8_t>(T->GetPointerLevel());
+  Records.Write<uint32_t>(T->GetQualifiers());
+  Records.WriteString(T->GetName().GetString());
+
+  Records.Write<uint32_t>(T->IsArray() ? T->GetDimensions().size() : 0);
+  if (T->IsArray())
+    for (auto Dim : T->GetDimensions())
+      Records.Write<uint32_t>(Dim);
+
+  Records.Write<uint32_t>(Members.size());
+  for (auto Member : Members)
+    Records.Write<uint32_t>(Member);
+  Records.Write<uint32_t>(Params.size());
+  for (auto Param : Params)
+    Records.Write<uint32_t>(Param);
+
+  uint32_t Index = Indices.size();
+  Indices[T] = Index;
+  return Index;
+}
+
+void TypeTableWriter::Write(BinaryWriter &W) const {
+  W.Write<uint32_t>(Indices.size());
+  W.Append(Records);
+}
+
+bool TypeTableReader::Read(BinaryReader &Reader, TypeContext &TC) {
+  for (auto NumTypes = Reader.Read<uint32_t>();
+       NumTypes > 0 && !Reader.HasError(); NumTypes--) {
+    auto Kind = Reader.Read<uint8_t>();
+    auto Variant = Reader.Read<uint8_t>();
+    if (Kind > Type::Struct || Variant > Type::Double)
+      return false;
+
+    Type T;
+    T.SetTypeKind(static_cast<Type::TypeKind>(Kind));
+    T.SetTypeVariant(static_cast<Type::VariantKind>(Variant));
+    T.SetPointerLevel(Reader.Read<uint8_t>());
+    T.SetQualifiers(Reader.Read<uint32_t>());
+    T.SetName(Symbol(Reader.ReadString()));
+
+    std::vector<unsigned> Dimensions;
+    for (auto NumDims = Reader.Read<uint32_t>();
+         NumDims > 0 && !Reader.HasError(); NumDims--)
+      Dimensions.push_back(Reader.Read<uint32_t>());
+    if (!Dimensions.empty())
+      T.SetDimensions(std::move(Dimensions));
+
+    for (auto NumMembers = Reader.Read<uint32_t>();
+         NumMembers > 0 && !Reader.HasError(); NumMembers--)
+      T.GetTypeList().push_back(ReadType(Reader));
+    for (auto NumParams = Reader.Read<uint32_t>();
+         NumParams > 0 && !Reader.HasError(); NumParams--)
+      T.GetParameterList().push_back(ReadType(Reader));
+
+    Types.push_back(TC.Get(T));
+  }
+
+  return !Reader.HasError();
+}
+
+const Type *TypeTableReader::ReadType(BinaryReader &Reader) const {
+  auto Ty = Get(Reader.Read<uint32_t>());
+  if (!Ty) {
+    Reader.SetError();
+    return TypeContext::GetInvalid();
+  }
+  return Ty;
+}
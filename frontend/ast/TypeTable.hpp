@@ -0,0 +1,47 @@
+#ifndef TYPETABLE_HPP
+#define TYPETABLE_HPP
+
+#include "../../support/BinaryStream.hpp"
+#include "Type.hpp"
+#include "TypeContext.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/// Collects the types referred to by a binary file, like a precompiled header,
+/// while the rest of the file is written. The file refers to the types by
+/// their index in the table. A type is written after the types it refers to,
+/// so the reader can look up the canonical instances in order.
+class TypeTableWriter {
+public:
+  /// The index of @T, adding it and the types it refers to if they are new.
+  uint32_t GetIndex(const Type *T);
+
+  void Write(BinaryWriter &W) const;
+
+private:
+  std::unordered_map<const Type *, uint32_t> Indices;
+  BinaryWriter Records;
+};
+
+/// Reads back the table written by a TypeTableWriter.
+class TypeTableReader {
+public:
+  /// Read the table from @Reader and get the canonical instances of its types
+  /// from @TC. Returns false if the table is malformed.
+  bool Read(BinaryReader &Reader, TypeContext &TC);
+
+  /// The type at @Index, nullptr if it is out of range.
+  const Type *Get(uint64_t Index) const {
+    return Index < Types.size() ? Types[Index] : nullptr;
+  }
+
+  /// Read a type index from @Reader and return the type. An index out of
+  /// range sets the error of @Reader and returns the invalid type.
+  const Type *ReadType(BinaryReader &Reader) const;
+
+private:
+  std::vector<const Type *> Types;
+};
+
+#endif
@@ -8,36 +8,121 @@
 #include "../backend/TargetArchs/RISCV/RISCVTargetMachine.hpp"
 #include "../backend/TargetArchs/AArch64/AArch64MOVFixPass.hpp"
 #include "../middle_end/IR/IRFactory.hpp"
+#include "../support/CompileCache.hpp"
+#include "../support/SHA256.hpp"
+#include "ast/ASTDumper.hpp"
+#include "ast/ASTFile.hpp"
+#include "ast/ConstantFolder.hpp"
+#include "ast/IRCodegen.hpp"
+#include "incremental/IncrementalDatabase.hpp"
 #include "lexer/Lexer.hpp"
+#include "lexer/PipelinedLexer.hpp"
+#include "lexer/SourceManager.hpp"
 #include "parser/Parser.hpp"
+#include "pch/PrecompiledHeader.hpp"
 #include "preprocessor/PreProcessor.hpp"
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <sstream>
 #include <string>
 #include <vector>
 
-/*
- * It will iterate through all the lines in file and
- * put them in given vector
- */
-bool getFileContent(std::string fileName, std::vector<std::string> &vecOfStrs) {
-  // Open the File
-  std::ifstream in(fileName.c_str());
-  // Check if object is valid
-  if (!in) {
-    std::cerr << "Cannot open the File : " << fileName << std::endl;
-    return false;
+/// Identifies the build of the compiler by the size and the modification
+/// time of its executable.
+static std::string GetCompilerIdentity() {
+  std::error_code EC;
+  auto Size = std::filesystem::file_size("/proc/self/exe", EC);
+  auto Time = std::filesystem::last_write_time("/proc/self/exe", EC);
+  return std::to_string(Size) + ":" +
+         std::to_string(Time.time_since_epoch().count());
+}
+
+/// The key of the compilation cache: a hash of everything the output depends
+/// on. Those are the preprocessed text @PreProcessedFile, the names of the
+/// files it came from (they are in the diagnostics), the codegen flags, the
+/// precompiled header @PCHPath and the compiler itself.
+static std::string GetCacheKey(const SourceManager &SM,
+                               const PieceTable &PreProcessedFile,
+                               const std::string &TargetArch,
+                               const std::string &PCHPath) {
+  SHA256 Hash;
+  auto UpdateString = [&Hash](std::string_view Str) {
+    Hash.UpdateValue(Str.size());
+    Hash.Update(Str);
+  };
+
+  // a rebuilt compiler might generate different code
+  UpdateString(GetCompilerIdentity());
+  UpdateString(TargetArch);
+
+  std::ostringstream PCHContent;
+  if (!PCHPath.empty())
+    PCHContent << std::ifstream(PCHPath, std::ios::binary).rdbuf();
+  UpdateString(PCHContent.str());
+
+  std::optional<SourceManager::BufferID> LastID;
+  for (auto &P : PreProcessedFile.GetPieces()) {
+    if (P.ID != LastID) {
+      UpdateString(SM.GetBufferName(P.ID));
+      LastID = P.ID;
+    }
+    UpdateString(SM.GetBuffer(P.ID).substr(P.Offset, P.Length));
   }
-  std::string str;
-  // Read the next line from File until it reaches the end.
-  while (std::getline(in, str)) {
-    // Line contains string of length > 0 then save it in vector
-    vecOfStrs.push_back(str);
+
+  return SHA256::ToHex(Hash.Final());
+}
+
+/// Stream buffer writing into @Target and also keeping a copy of the output,
+/// so it is still shown as it is produced, even if the compiler crashes.
+class TeeBuffer : public std::streambuf {
+public:
+  explicit TeeBuffer(std::streambuf *Target) : Target(Target) {}
+
+  const std::string &GetCopy() const { return Copy; }
+
+protected:
+  int overflow(int C) override {
+    if (C == traits_type::eof())
+      return traits_type::not_eof(C);
+    Copy.push_back(C);
+    return Target->sputc(C);
+  }
+
+  std::streamsize xsputn(const char *S, std::streamsize N) override {
+    Copy.append(S, N);
+    return Target->sputn(S, N);
   }
-  // Close The File
-  in.close();
-  return true;
+
+  int sync() override { return Target->pubsync(); }
+
+private:
+  std::streambuf *Target;
+  std::string Copy;
+};
+
+/// Parse a size like 64M, with an optional K, M or G suffix.
+static std::optional<uint64_t> ParseSize(const std::string &Str) {
+  size_t End = 0;
+  uint64_t Size;
+  try {
+    Size = std::stoull(Str, &End);
+  } catch (...) {
+    return std::nullopt;
+  }
+
+  auto Suffix = Str.substr(End);
+  if (Suffix == "K")
+    Size <<= 10;
+  else if (Suffix == "M")
+    Size <<= 20;
+  else if (Suffix == "G")
+    Size <<= 30;
+  else if (!Suffix.empty())
+    return std::nullopt;
+  return Size;
 }
 
 /// TODO: Make a proper driver
@@ -48,7 +133,19 @@ int main(int argc, char *argv[]) {
   bool DumpAST = false;
   bool DumpIR = false;
   bool PrintBeforePasses = false;
+  bool PrintASTStats = false;
+  bool LazyParsing = false;
+  std::optional<unsigned> ParsingThreads;
+  bool Pipeline = false;
   std::string TargetArch = "aarch64";
+  std::string EmitPCHPath;
+  std::string IncludePCHPath;
+  std::string EmitASTPath;
+  std::string LoadASTPath;
+  std::string CacheDir;
+  uint64_t CacheMaxSize = CompileCache::DefaultMaxSize;
+  bool PrintCacheStats = false;
+  std::string IncrementalDBPath;
 
   for (int i = 0; i < argc; i++)
     if (argv[i][0] != '-')
@@ -69,6 +166,60 @@ int main(int argc, char *argv[]) {
       } else if (!std::string(&argv[i][1]).compare("print-before-passes")) {
         PrintBeforePasses = true;
         continue;
+      } else if (!std::string(&argv[i][1]).compare("print-ast-stats")) {
+        PrintASTStats = true;
+        continue;
+      } else if (!std::string(&argv[i][1]).compare("lazy-parsing")) {
+        LazyParsing = true;
+        continue;
+      } else if (!std::string(&argv[i][1]).compare("parallel-parsing")) {
+        ParsingThreads = 0;
+        continue;
+      } else if (!std::string(&argv[i][1]).compare(0, 17,
+                                                   "parallel-parsing=")) {
+        try {
+          ParsingThreads = std::stoul(std::string(&argv[i][18]));
+        } catch (...) {
+          std::cerr << "Error: Invalid thread count '" << argv[i] << "'"
+                    << std::endl;
+          return -1;
+        }
+        continue;
+      } else if (!std::string(&argv[i][1]).compare("pipeline")) {
+        Pipeline = true;
+        continue;
+      } else if (!std::string(&argv[i][1]).compare(0, 9, "emit-pch=")) {
+        EmitPCHPath = std::string(&argv[i][10]);
+        continue;
+      } else if (!std::string(&argv[i][1]).compare(0, 12, "include-pch=")) {
+        IncludePCHPath = std::string(&argv[i][13]);
+        continue;
+      } else if (!std::string(&argv[i][1]).compare(0, 9, "emit-ast=")) {
+        EmitASTPath = std::string(&argv[i][10]);
+        continue;
+      } else if (!std::string(&argv[i][1]).compare(0, 9, "load-ast=")) {
+        LoadASTPath = std::string(&argv[i][10]);
+        continue;
+      } else if (!std::string(&argv[i][1]).compare(0, 10, "cache-dir=")) {
+        CacheDir = std::string(&argv[i][11]);
+        continue;
+      } else if (!std::string(&argv[i][1]).compare(0, 15,
+                                                   "cache-max-size=")) {
+        auto Size = ParseSize(std::string(&argv[i][16]));
+        if (!Size) {
+          std::cerr << "Error: Invalid cache size '" << argv[i] << "'"
+                    << std::endl;
+          return -1;
+        }
+        CacheMaxSize = Size.value();
+        continue;
+      } else if (!std::string(&argv[i][1]).compare("cache-stats")) {
+        PrintCacheStats = true;
+        continue;
+      } else if (!std::string(&argv[i][1]).compare(0, 15,
+                                                   "incremental-db=")) {
+        IncrementalDBPath = std::string(&argv[i][16]);
+        continue;
       } else if (!std::string(&argv[i][1]).compare(0, 5, "arch=")) {
         TargetArch = std::string(&argv[i][6]);
         continue;
@@ -78,29 +229,40 @@ int main(int argc, char *argv[]) {
       }
     }
 
-  if (DumpTokens) {
-    std::vector<std::string> src;
-    getFileContent(FilePath.c_str(), src);
-
-    Lexer lexer(src);
+  std::optional<CompileCache> Cache;
+  if (!CacheDir.empty())
+    Cache.emplace(CacheDir, CacheMaxSize);
 
-    auto t1 = lexer.Lex();
-    while (t1.GetKind() != Token::EndOfFile && t1.GetKind() != Token::Invalid) {
-      std::cout << t1.ToString() << std::endl;
-      t1 = lexer.Lex();
+  if (PrintCacheStats) {
+    if (!Cache) {
+      std::cerr << "Error: -cache-stats needs -cache-dir" << std::endl;
+      return -1;
     }
+    Cache->PrintStats(std::cout);
+    return 0;
   }
 
-  std::vector<std::string> src;
-  getFileContent(FilePath.c_str(), src);
+  // only the assembly is cached, the rest of the outputs are for debugging
+  if (DumpPreProcessedFile || DumpTokens || DumpAST || DumpIR ||
+      PrintBeforePasses || PrintASTStats || !EmitPCHPath.empty() ||
+      !EmitASTPath.empty())
+    Cache.reset();
 
-  PreProcessor(src, FilePath).Run();
+  // the key of the cache is computed from the preprocessed text, which a
+  // loaded AST does not have
+  if (!LoadASTPath.empty())
+    Cache.reset();
 
-  if (DumpPreProcessedFile) {
-    for (auto &Line : src)
-      std::cout << Line << std::endl;
-    std::cout << std::endl;
-  }
+  // the IR and the passes would only show the changed functions
+  if (DumpIR || PrintBeforePasses)
+    IncrementalDBPath.clear();
+
+  SourceManager SM;
+
+  // the output is cached once the cache key is known
+  std::string CacheKey;
+  std::optional<TeeBuffer> CachedOutput;
+  std::streambuf *StdOutBuffer = nullptr;
 
   std::unique_ptr<TargetMachine> TM;
 
@@ -111,13 +273,146 @@ int main(int argc, char *argv[]) {
 
   Module IRModule;
   IRFactory IRF(IRModule, TM.get());
-  Parser parser(src, &IRF);
-  auto AST = parser.Parse();
+  ASTContext ASTCtx;
+
+  Node *AST = nullptr;
+  if (!LoadASTPath.empty()) {
+    // the AST replaces the preprocessing and the parsing of the source file
+    AST = ASTFile::Load(SM, LoadASTPath, ASTCtx);
+    if (!AST) {
+      std::cerr << "Cannot load the AST file: " << LoadASTPath << std::endl;
+      return -1;
+    }
+  } else {
+    auto MainFile = SM.AddFile(FilePath);
+    if (!MainFile) {
+      std::cerr << "Cannot open the File : " << FilePath << std::endl;
+      return -1;
+    }
+
+    if (DumpTokens) {
+      Lexer lexer(SM, MainFile.value());
+
+      auto t1 = lexer.Lex();
+      while (t1.GetKind() != Token::EndOfFile &&
+             t1.GetKind() != Token::Invalid) {
+        auto [Line, Col] = lexer.GetLineAndColumn(t1);
+        std::cout << t1.ToString(Line, Col) << std::endl;
+        t1 = lexer.Lex();
+      }
+    }
+
+    PreProcessor PP(SM, MainFile.value(), FilePath);
+
+    PrecompiledHeader PCH;
+    if (!IncludePCHPath.empty() && (!PCH.Open(SM, IncludePCHPath) ||
+                                    !PCH.LoadPreProcessorState(PP))) {
+      std::cerr << "Cannot load the precompiled header: " << IncludePCHPath
+                << std::endl;
+      return -1;
+    }
+
+    // the parser pulls the preprocessed text while parsing, unless it is
+    // dumped anyway
+    std::optional<PieceTable> PreProcessedFile;
+    if (DumpPreProcessedFile) {
+      PreProcessedFile = PP.Run();
+      auto Src = PreProcessedFile->GetText(SM);
+      std::cout << Src;
+      if (!Src.empty() && Src.back() != '\n')
+        std::cout << std::endl;
+      std::cout << std::endl;
+    }
+
+    // the cache needs the whole preprocessed text for the key, before parsing
+    if (Cache) {
+      PreProcessedFile = PP.Run();
+      CacheKey =
+          GetCacheKey(SM, *PreProcessedFile, TargetArch, IncludePCHPath);
+
+      if (auto Output = Cache->Lookup(CacheKey)) {
+        std::cout << *Output << std::flush;
+        return 0;
+      }
+
+      // everything written to the standard output from now on is the cached
+      // output, the diagnostics of the parser too
+      StdOutBuffer = std::cout.rdbuf();
+      CachedOutput.emplace(StdOutBuffer);
+      std::cout.rdbuf(&*CachedOutput);
+    }
+
+    // preprocess and lex on threads of their own, unless the preprocessed
+    // text is there already
+    std::optional<PipelinedLexer> Pipelined;
+    if (Pipeline && !PreProcessedFile)
+      Pipelined.emplace(SM, PP);
+
+    auto parser = PreProcessedFile
+                      ? Parser(SM, std::move(*PreProcessedFile), ASTCtx, &IRF)
+                  : Pipelined ? Parser(SM, *Pipelined, ASTCtx, &IRF)
+                              : Parser(SM, PP, ASTCtx, &IRF);
+
+    if (LazyParsing)
+      parser.EnableLazyParsing();
+    if (ParsingThreads)
+      parser.EnableParallelParsing(ParsingThreads.value());
+
+    if (!IncludePCHPath.empty() && !PCH.LoadParserState(parser)) {
+      std::cerr << "Malformed precompiled header: " << IncludePCHPath
+                << std::endl;
+      return -1;
+    }
+
+    AST = parser.Parse();
+
+    // the input is the header to precompile, no code is generated
+    if (!EmitPCHPath.empty())
+      return PrecompiledHeader::Emit(EmitPCHPath, PP, parser, AST, std::cerr)
+                 ? 0
+                 : -1;
+  }
+
+  // the AST is saved for a later -load-ast, no code is generated
+  if (!EmitASTPath.empty())
+    return ASTFile::Emit(EmitASTPath, static_cast<TranslationUnit *>(AST),
+                         std::cerr)
+               ? 0
+               : -1;
 
   if (DumpAST)
-    AST->ASTDump();
+    ASTDumper().Visit(AST);
+
+  // the dump above shows the code as it was written, the code generation
+  // works on the folded one
+  ConstantFolder(ASTCtx).Visit(AST);
+
+  // with an incremental database only the functions which changed since the
+  // previous compilation are compiled, the assembly of the rest is reused
+  std::optional<IncrementalDatabase> IncrementalDB;
+  std::vector<IncrementalDatabase::Key> FunctionKeys;
+  std::vector<std::optional<std::string>> ReusedFunctions;
+  if (!IncrementalDBPath.empty()) {
+    auto TU = static_cast<TranslationUnit *>(AST);
+    IncrementalDB.emplace();
+    IncrementalDB->Load(IncrementalDBPath);
+    FunctionKeys = IncrementalDatabase::GetFunctionKeys(
+        TU, TargetArch + "\n" + GetCompilerIdentity());
+
+    std::vector<bool> SkippedFunctions;
+    for (unsigned i = 0; i < FunctionKeys.size(); i++) {
+      ReusedFunctions.push_back(IncrementalDB->Lookup(FunctionKeys[i], i));
+      SkippedFunctions.push_back(ReusedFunctions.back().has_value());
+    }
+    IRCodegen(&IRF, SkippedFunctions).Visit(TU);
+  } else
+    IRCodegen(&IRF).Visit(AST);
+
+  if (PrintASTStats)
+    ASTCtx.PrintStats(std::cerr);
 
-  AST->IRCodegen(&IRF);
+  // The AST is not needed anymore, free it before running the backend
+  ASTCtx.Reset();
   if (DumpIR)
     IRModule.Print();
 
@@ -174,7 +469,36 @@ int main(int argc, char *argv[]) {
   }
 
   AssemblyEmitter AE(&LLIRModule, TM.get());
-  AE.GenerateAssembly();
+  if (!IncrementalDB)
+    AE.GenerateAssembly();
+  else {
+    // the compiled functions are in order between the reused ones
+    auto CompiledFunction = LLIRModule.GetFunctions().begin();
+    for (unsigned i = 0; i < FunctionKeys.size(); i++) {
+      if (ReusedFunctions[i]) {
+        std::cout << *ReusedFunctions[i];
+        continue;
+      }
+
+      std::ostringstream Assembly;
+      AE.EmitFunction(*CompiledFunction++, i, Assembly);
+      std::cout << Assembly.str();
+      IncrementalDB->Insert(FunctionKeys[i], i, Assembly.str());
+    }
+    AE.EmitGlobalData();
+
+    if (!IncrementalDB->Save(IncrementalDBPath)) {
+      std::cerr << "Cannot write the incremental database: "
+                << IncrementalDBPath << std::endl;
+      return -1;
+    }
+  }
+
+  if (Cache) {
+    std::cout.flush();
+    std::cout.rdbuf(StdOutBuffer);
+    Cache->Store(CacheKey, CachedOutput->GetCopy());
+  }
 
   return 0;
 }
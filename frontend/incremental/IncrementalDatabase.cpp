@@ -0,0 +1,155 @@
+#include "IncrementalDatabase.hpp"
+#include "../../support/BinaryStream.hpp"
+#include "../ast/ASTProfile.hpp"
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+static constexpr uint32_t Magic = 0x434e494d; // "MINC"
+static constexpr uint32_t Version = 1;
+
+void IncrementalDatabase::Load(const std::string &Path) {
+  Previous.clear();
+
+  std::ifstream File(Path, std::ios::binary);
+  if (!File)
+    return;
+  std::ostringstream Content;
+  Content << File.rdbuf();
+  auto Buffer = Content.str();
+
+  BinaryReader Reader(Buffer);
+  if (Reader.Read<uint32_t>() != Magic || Reader.Read<uint32_t>() != Version)
+    return;
+
+  auto Count = Reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < Count && !Reader.HasError(); i++) {
+    auto KeyBytes = Reader.ReadString();
+    auto FunctionIndex = Reader.Read<uint32_t>();
+    auto Assembly = Reader.ReadString();
+    if (KeyBytes.size() != sizeof(Key))
+      Reader.SetError();
+    if (Reader.HasError())
+      break;
+
+    Key K;
+    std::copy(KeyBytes.begin(), KeyBytes.end(), K.begin());
+    Previous[K] = {FunctionIndex, std::string(Assembly)};
+  }
+
+  if (Reader.HasError() || !Reader.AtEnd())
+    Previous.clear();
+}
+
+bool IncrementalDatabase::Save(const std::string &Path) const {
+  BinaryWriter W;
+  W.Write<uint32_t>(Magic);
+  W.Write<uint32_t>(Version);
+  W.Write<uint32_t>(Current.size());
+  for (auto &[K, E] : Current) {
+    W.WriteString({reinterpret_cast<const char *>(K.data()), K.size()});
+    W.Write<uint32_t>(E.FunctionIndex);
+    W.WriteString(E.Assembly);
+  }
+
+  std::ofstream File(Path, std::ios::binary);
+  File.write(W.GetBuffer().data(), W.GetBuffer().size());
+  return bool(File);
+}
+
+std::vector<IncrementalDatabase::Key>
+IncrementalDatabase::GetFunctionKeys(TranslationUnit *TU,
+                                     std::string_view Configuration) {
+  // the hashes of the global declarations by the names they declare
+  std::unordered_map<Symbol, Key> Declarations;
+  auto AddDeclaration = [&Declarations](Symbol Name, ASTProfile &P) {
+    // a name might be declared more than once, eg.: a prototype and the
+    // definition of a function
+    if (auto It = Declarations.find(Name); It != Declarations.end())
+      P.AddString({reinterpret_cast<const char *>(It->second.data()),
+                   It->second.size()});
+    Declarations[Name] = P.Final();
+  };
+
+  for (auto Declaration : TU->GetDeclarations()) {
+    if (auto Var = DynCast<VariableDeclaration>(Declaration)) {
+      ASTProfile P;
+      P.Visit(Var);
+      AddDeclaration(Var->GetName(), P);
+    } else if (auto Function = DynCast<FunctionDeclaration>(Declaration)) {
+      // the callers only depend on the signature
+      ASTProfile P;
+      P.AddKind("FunctionSignature");
+      P.AddType(Function->GetType());
+      AddDeclaration(Function->GetName(), P);
+    } else if (auto Enum = DynCast<EnumDeclaration>(Declaration)) {
+      for (auto &[Enumerator, Val] : Enum->GetEnumerators()) {
+        ASTProfile P;
+        P.Visit(Enum);
+        AddDeclaration(Enumerator, P);
+      }
+    }
+    // the structs are part of the types using them
+  }
+
+  std::vector<Key> Keys;
+  for (auto Declaration : TU->GetDeclarations()) {
+    auto Function = DynCast<FunctionDeclaration>(Declaration);
+    if (!Function || !Function->GetBody())
+      continue;
+
+    ASTProfile P;
+    P.AddString(Configuration);
+    P.Visit(Function);
+
+    // a name declared in the function might shadow a global one, which is
+    // then added needlessly, but that is only a missed reuse
+    std::unordered_set<Symbol> Added;
+    auto References = P.GetReferences();
+    for (auto Name : References) {
+      if (!Added.insert(Name).second)
+        continue;
+
+      P.AddSymbol(Name);
+      if (auto It = Declarations.find(Name); It != Declarations.end())
+        P.AddString({reinterpret_cast<const char *>(It->second.data()),
+                     It->second.size()});
+      else
+        P.AddString({});
+    }
+
+    Keys.push_back(P.Final());
+  }
+
+  return Keys;
+}
+
+std::optional<std::string> IncrementalDatabase::Lookup(const Key &K,
+                                                       unsigned FunctionIndex) {
+  auto It = Previous.find(K);
+  if (It == Previous.end())
+    return std::nullopt;
+
+  // renumber the local labels, like .L3_if_end to .L5_if_end
+  auto &[PreviousIndex, Assembly] = It->second;
+  auto From = ".L" + std::to_string(PreviousIndex) + "_";
+  auto To = ".L" + std::to_string(FunctionIndex) + "_";
+  std::string Relabeled;
+  size_t Pos = 0;
+  for (auto Next = Assembly.find(From); Next != std::string::npos;
+       Next = Assembly.find(From, Pos)) {
+    Relabeled.append(Assembly, Pos, Next - Pos);
+    Relabeled += To;
+    Pos = Next + From.size();
+  }
+  Relabeled.append(Assembly, Pos);
+
+  Current[K] = {FunctionIndex, Relabeled};
+  return Relabeled;
+}
+
+void IncrementalDatabase::Insert(const Key &K, unsigned FunctionIndex,
+                                 std::string Assembly) {
+  Current[K] = {FunctionIndex, std::move(Assembly)};
+}
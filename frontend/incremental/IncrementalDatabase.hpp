@@ -0,0 +1,57 @@
+#ifndef INCREMENTALDATABASE_H
+#define INCREMENTALDATABASE_H
+
+#include "../../support/SHA256.hpp"
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class TranslationUnit;
+
+/// The assembly of the function definitions of the previous compilation of a
+/// file, saved next to it, so the functions which did not change since are
+/// not compiled again.
+///
+/// A function is identified by a key: the structural hash of its subtree
+/// (see ASTProfile), of the global declarations it refers to and of the
+/// configuration of the compiler. The local labels of a function contain its
+/// index, which is renumbered when a function is reused at another index.
+class IncrementalDatabase {
+public:
+  using Key = SHA256::Digest;
+
+  /// Load the database from @Path. A missing or malformed file is taken as an
+  /// empty database, so everything is compiled.
+  void Load(const std::string &Path);
+
+  /// Save the functions of the current compilation, the ones looked up
+  /// successfully and the inserted ones, into @Path.
+  bool Save(const std::string &Path) const;
+
+  /// The keys of the function definitions of @TU, in order. @Configuration is
+  /// the rest of what the generated code depends on, like the target.
+  static std::vector<Key> GetFunctionKeys(TranslationUnit *TU,
+                                          std::string_view Configuration);
+
+  /// The assembly of the function @K, with its local labels numbered for the
+  /// function at @FunctionIndex, if it was compiled before.
+  std::optional<std::string> Lookup(const Key &K, unsigned FunctionIndex);
+
+  /// Add the assembly of the function @K at @FunctionIndex.
+  void Insert(const Key &K, unsigned FunctionIndex, std::string Assembly);
+
+private:
+  struct Entry {
+    unsigned FunctionIndex;
+    std::string Assembly;
+  };
+
+  /// The functions of the previous compilation.
+  std::map<Key, Entry> Previous;
+  /// The functions of the current compilation.
+  std::map<Key, Entry> Current;
+};
+
+#endif
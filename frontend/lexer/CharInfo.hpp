@@ -0,0 +1,50 @@
+#ifndef CHARINFO_H
+#define CHARINFO_H
+
+#include <array>
+#include <cstdint>
+
+/// Character classification used by the lexers. Unlike the <cctype>
+/// functions it is locale independent, branch free and every byte above 127
+/// is classified as CC_Other.
+enum CharClassFlags : uint8_t {
+  CC_Other = 0,
+  CC_Whitespace = 1 << 0,
+  CC_Digit = 1 << 1,
+  CC_Letter = 1 << 2, // including '_'
+  CC_Punctuation = 1 << 3,
+};
+
+constexpr std::array<uint8_t, 256> BuildCharClassTable() {
+  std::array<uint8_t, 256> Table{};
+
+  for (unsigned char C : {' ', '\t', '\n', '\v', '\f', '\r', '\0'})
+    Table[C] = CC_Whitespace;
+  for (unsigned C = '0'; C <= '9'; C++)
+    Table[C] = CC_Digit;
+  for (unsigned C = 'a'; C <= 'z'; C++)
+    Table[C] = CC_Letter;
+  for (unsigned C = 'A'; C <= 'Z'; C++)
+    Table[C] = CC_Letter;
+  Table['_'] = CC_Letter;
+  for (unsigned char C : ".,+-*/%=<>!?&:;()[]{}")
+    if (C != '\0')
+      Table[C] = CC_Punctuation;
+
+  return Table;
+}
+
+inline constexpr std::array<uint8_t, 256> CharClassTable = BuildCharClassTable();
+
+inline uint8_t GetCharClass(char C) {
+  return CharClassTable[static_cast<unsigned char>(C)];
+}
+
+inline bool IsWhitespace(char C) { return GetCharClass(C) & CC_Whitespace; }
+inline bool IsDigit(char C) { return GetCharClass(C) & CC_Digit; }
+
+inline bool IsIdentifierChar(char C) {
+  return GetCharClass(C) & (CC_Letter | CC_Digit);
+}
+
+#endif
@@ -0,0 +1,217 @@
+#include "CharScan.hpp"
+#include "CharInfo.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CHARSCAN_X86 1
+#include <immintrin.h>
+#endif
+
+//===----------------------------------------------------------------------===//
+// Scalar kernels
+//===----------------------------------------------------------------------===//
+
+static const char *SkipWhitespaceScalar(const char *Pos, const char *End) {
+  while (Pos < End && IsWhitespace(*Pos))
+    Pos++;
+  return Pos;
+}
+
+static const char *SkipIdentifierCharsScalar(const char *Pos,
+                                             const char *End) {
+  while (Pos < End && IsIdentifierChar(*Pos))
+    Pos++;
+  return Pos;
+}
+
+static const char *SkipDigitsScalar(const char *Pos, const char *End) {
+  while (Pos < End && IsDigit(*Pos))
+    Pos++;
+  return Pos;
+}
+
+static const char *FindLineEndScalar(const char *Pos, const char *End) {
+  auto LineEnd = static_cast<const char *>(memchr(Pos, '\n', End - Pos));
+  return LineEnd ? LineEnd : End;
+}
+
+static const CharScanKernels ScalarKernels = {
+    SkipWhitespaceScalar, SkipIdentifierCharsScalar, SkipDigitsScalar,
+    FindLineEndScalar, "scalar"};
+
+#ifdef CHARSCAN_X86
+
+//===----------------------------------------------------------------------===//
+// SSE2 kernels
+//===----------------------------------------------------------------------===//
+//
+// Each kernel computes a byte mask of the characters belonging to the run,
+// then the first zero bit of its movemask gives the end of the run. Unsigned
+// range checks are done as min(x - Low, High - Low) == x - Low.
+
+static inline __m128i InRangeSSE2(__m128i Chars, char Low, char High) {
+  auto Shifted = _mm_sub_epi8(Chars, _mm_set1_epi8(Low));
+  auto Limit = _mm_set1_epi8(static_cast<char>(High - Low));
+  return _mm_cmpeq_epi8(_mm_min_epu8(Shifted, Limit), Shifted);
+}
+
+static inline __m128i WhitespaceMaskSSE2(__m128i Chars) {
+  auto Mask = InRangeSSE2(Chars, '\t', '\r');
+  Mask = _mm_or_si128(Mask, _mm_cmpeq_epi8(Chars, _mm_set1_epi8(' ')));
+  return _mm_or_si128(Mask, _mm_cmpeq_epi8(Chars, _mm_setzero_si128()));
+}
+
+static inline __m128i IdentifierMaskSSE2(__m128i Chars) {
+  // setting bit 5 maps upper case letters to lower case ones and does not
+  // make any other character a letter
+  auto Lower = _mm_or_si128(Chars, _mm_set1_epi8(0x20));
+  auto Mask = InRangeSSE2(Lower, 'a', 'z');
+  Mask = _mm_or_si128(Mask, InRangeSSE2(Chars, '0', '9'));
+  return _mm_or_si128(Mask, _mm_cmpeq_epi8(Chars, _mm_set1_epi8('_')));
+}
+
+static inline __m128i DigitMaskSSE2(__m128i Chars) {
+  return InRangeSSE2(Chars, '0', '9');
+}
+
+static inline __m128i NewLineMaskSSE2(__m128i Chars) {
+  // inverted, since the kernels stop at the first character not in the mask
+  auto Mask = _mm_cmpeq_epi8(Chars, _mm_set1_epi8('\n'));
+  return _mm_xor_si128(Mask, _mm_set1_epi8(-1));
+}
+
+template <__m128i (*MaskFn)(__m128i), const char *(*ScalarFn)(const char *,
+                                                               const char *)>
+static const char *ScanSSE2(const char *Pos, const char *End) {
+  while (End - Pos >= 16) {
+    auto Chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Pos));
+    unsigned Outside = ~_mm_movemask_epi8(MaskFn(Chars)) & 0xFFFF;
+    if (Outside)
+      return Pos + __builtin_ctz(Outside);
+    Pos += 16;
+  }
+  return ScalarFn(Pos, End);
+}
+
+static const CharScanKernels SSE2Kernels = {
+    ScanSSE2<WhitespaceMaskSSE2, SkipWhitespaceScalar>,
+    ScanSSE2<IdentifierMaskSSE2, SkipIdentifierCharsScalar>,
+    ScanSSE2<DigitMaskSSE2, SkipDigitsScalar>,
+    ScanSSE2<NewLineMaskSSE2, FindLineEndScalar>, "sse2"};
+
+//===----------------------------------------------------------------------===//
+// AVX2 kernels
+//===----------------------------------------------------------------------===//
+
+#define CHARSCAN_AVX2 __attribute__((target("avx2")))
+
+CHARSCAN_AVX2 static inline __m256i InRangeAVX2(__m256i Chars, char Low,
+                                                char High) {
+  auto Shifted = _mm256_sub_epi8(Chars, _mm256_set1_epi8(Low));
+  auto Limit = _mm256_set1_epi8(static_cast<char>(High - Low));
+  return _mm256_cmpeq_epi8(_mm256_min_epu8(Shifted, Limit), Shifted);
+}
+
+CHARSCAN_AVX2 static inline __m256i WhitespaceMaskAVX2(__m256i Chars) {
+  auto Mask = InRangeAVX2(Chars, '\t', '\r');
+  Mask =
+      _mm256_or_si256(Mask, _mm256_cmpeq_epi8(Chars, _mm256_set1_epi8(' ')));
+  return _mm256_or_si256(Mask,
+                         _mm256_cmpeq_epi8(Chars, _mm256_setzero_si256()));
+}
+
+CHARSCAN_AVX2 static inline __m256i IdentifierMaskAVX2(__m256i Chars) {
+  auto Lower = _mm256_or_si256(Chars, _mm256_set1_epi8(0x20));
+  auto Mask = InRangeAVX2(Lower, 'a', 'z');
+  Mask = _mm256_or_si256(Mask, InRangeAVX2(Chars, '0', '9'));
+  return _mm256_or_si256(Mask,
+                         _mm256_cmpeq_epi8(Chars, _mm256_set1_epi8('_')));
+}
+
+CHARSCAN_AVX2 static inline __m256i DigitMaskAVX2(__m256i Chars) {
+  return InRangeAVX2(Chars, '0', '9');
+}
+
+CHARSCAN_AVX2 static inline __m256i NewLineMaskAVX2(__m256i Chars) {
+  auto Mask = _mm256_cmpeq_epi8(Chars, _mm256_set1_epi8('\n'));
+  return _mm256_xor_si256(Mask, _mm256_set1_epi8(-1));
+}
+
+// The identifier and digit runs are usually short, so the tail is finished
+// with the SSE2 kernel instead of going byte by byte.
+template <__m256i (*MaskFn)(__m256i), const char *(*TailFn)(const char *,
+                                                             const char *)>
+CHARSCAN_AVX2 static const char *ScanAVX2(const char *Pos, const char *End) {
+  while (End - Pos >= 32) {
+    auto Chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(Pos));
+    unsigned Outside = ~_mm256_movemask_epi8(MaskFn(Chars));
+    if (Outside)
+      return Pos + __builtin_ctz(Outside);
+    Pos += 32;
+  }
+  return TailFn(Pos, End);
+}
+
+static const CharScanKernels AVX2Kernels = {
+    ScanAVX2<WhitespaceMaskAVX2,
+             ScanSSE2<WhitespaceMaskSSE2, SkipWhitespaceScalar>>,
+    ScanAVX2<IdentifierMaskAVX2,
+             ScanSSE2<IdentifierMaskSSE2, SkipIdentifierCharsScalar>>,
+    ScanAVX2<DigitMaskAVX2, ScanSSE2<DigitMaskSSE2, SkipDigitsScalar>>,
+    ScanAVX2<NewLineMaskAVX2, ScanSSE2<NewLineMaskSSE2, FindLineEndScalar>>,
+    "avx2"};
+
+#endif // CHARSCAN_X86
+
+//===----------------------------------------------------------------------===//
+// Dispatch
+//===----------------------------------------------------------------------===//
+
+bool IsCharScanISASupported(CharScanISA ISA) {
+  switch (ISA) {
+  case CharScanISA::Scalar:
+    return true;
+#ifdef CHARSCAN_X86
+  case CharScanISA::SSE2:
+    return __builtin_cpu_supports("sse2");
+  case CharScanISA::AVX2:
+    return __builtin_cpu_supports("avx2");
+#endif
+  default:
+    return false;
+  }
+}
+
+static const CharScanKernels &GetKernelsFor(CharScanISA ISA) {
+  switch (ISA) {
+#ifdef CHARSCAN_X86
+  case CharScanISA::SSE2:
+    return SSE2Kernels;
+  case CharScanISA::AVX2:
+    return AVX2Kernels;
+#endif
+  default:
+    return ScalarKernels;
+  }
+}
+
+static const CharScanKernels *SelectBestKernels() {
+  for (auto ISA : {CharScanISA::AVX2, CharScanISA::SSE2})
+    if (IsCharScanISASupported(ISA))
+      return &GetKernelsFor(ISA);
+  return &ScalarKernels;
+}
+
+static const CharScanKernels *&ActiveKernels() {
+  static const CharScanKernels *Active = SelectBestKernels();
+  return Active;
+}
+
+const CharScanKernels &GetCharScanKernels() { return *ActiveKernels(); }
+
+bool SelectCharScanKernels(CharScanISA ISA) {
+  if (!IsCharScanISASupported(ISA))
+    return false;
+  ActiveKernels() = &GetKernelsFor(ISA);
+  return true;
+}
@@ -0,0 +1,38 @@
+#ifndef CHARSCAN_H
+#define CHARSCAN_H
+
+/// Vectorized kernels for the hot character runs of the lexer. Every kernel
+/// scans the range [Pos, End) and returns a pointer to the first character
+/// which does not belong to the run, or End if there is no such character.
+///
+/// There is a scalar, an SSE2 and an AVX2 implementation. The best one
+/// supported by the host CPU is selected at startup.
+struct CharScanKernels {
+  /// Skip ' ', '\t', '\n', '\v', '\f', '\r' and '\0' characters.
+  const char *(*SkipWhitespace)(const char *Pos, const char *End);
+
+  /// Skip [a-zA-Z0-9_] characters.
+  const char *(*SkipIdentifierChars)(const char *Pos, const char *End);
+
+  /// Skip [0-9] characters.
+  const char *(*SkipDigits)(const char *Pos, const char *End);
+
+  /// Find the next '\n' character.
+  const char *(*FindLineEnd)(const char *Pos, const char *End);
+
+  const char *Name;
+};
+
+enum class CharScanISA { Scalar, SSE2, AVX2 };
+
+/// Returns true if @ISA is compiled in and supported by the host CPU.
+bool IsCharScanISASupported(CharScanISA ISA);
+
+/// Returns the kernels used by the lexer.
+const CharScanKernels &GetCharScanKernels();
+
+/// Force the lexer to use the kernels of @ISA. Returns false and keeps the
+/// current selection if it is not supported. Meant for benchmarks.
+bool SelectCharScanKernels(CharScanISA ISA);
+
+#endif
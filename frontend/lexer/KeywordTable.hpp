@@ -0,0 +1,98 @@
+#ifndef KEYWORDTABLE_H
+#define KEYWORDTABLE_H
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+/// Compile time generated perfect hash table for recognizing keywords in an
+/// already scanned identifier. The hash only looks at the length and the
+/// first and last characters of the word:
+///
+///   (Length + First * FirstMul + Last * LastMul) & (TableSize - 1)
+///
+/// The constructor searches for multipliers which map every keyword into a
+/// different slot, so a lookup is one hash and at most one string compare,
+/// without any allocation.
+template <typename KindT, std::size_t N, unsigned TableSize = 64>
+class KeywordTable {
+  static_assert(TableSize >= N && (TableSize & (TableSize - 1)) == 0,
+                "TableSize must be a power of 2 and fit every keyword");
+
+public:
+  struct Entry {
+    std::string_view Spelling;
+    KindT Kind;
+  };
+
+  constexpr KeywordTable(const std::array<Entry, N> &Keywords) {
+    for (std::size_t i = 0; i < N; i++) {
+      auto Length = Keywords[i].Spelling.size();
+      if (i == 0 || Length < MinLength)
+        MinLength = Length;
+      if (Length > MaxLength)
+        MaxLength = Length;
+    }
+
+    for (unsigned F = 1; F < TableSize && !Perfect; F++)
+      for (unsigned L = 0; L < TableSize && !Perfect; L++) {
+        FirstMul = F;
+        LastMul = L;
+        Perfect = TryFill(Keywords);
+      }
+  }
+
+  /// True if a collision free hash function was found. Meant to be checked
+  /// with a static_assert where the table is defined.
+  constexpr bool IsPerfect() const { return Perfect; }
+
+  /// Returns the kind of the keyword spelled by @Word or std::nullopt if it
+  /// is not a keyword.
+  constexpr std::optional<KindT> Lookup(std::string_view Word) const {
+    if (Word.size() < MinLength || Word.size() > MaxLength)
+      return std::nullopt;
+
+    auto &Slot = Slots[Hash(Word)];
+    if (!Slot.Used || Slot.Keyword.Spelling != Word)
+      return std::nullopt;
+
+    return Slot.Keyword.Kind;
+  }
+
+private:
+  struct SlotEntry {
+    Entry Keyword{};
+    bool Used = false;
+  };
+
+  constexpr unsigned Hash(std::string_view Word) const {
+    unsigned First = static_cast<unsigned char>(Word.front());
+    unsigned Last = static_cast<unsigned char>(Word.back());
+    return (Word.size() + First * FirstMul + Last * LastMul) & (TableSize - 1);
+  }
+
+  constexpr bool TryFill(const std::array<Entry, N> &Keywords) {
+    for (auto &Slot : Slots)
+      Slot = SlotEntry();
+
+    for (auto &Keyword : Keywords) {
+      auto &Slot = Slots[Hash(Keyword.Spelling)];
+      if (Slot.Used)
+        return false;
+      Slot.Keyword = Keyword;
+      Slot.Used = true;
+    }
+
+    return true;
+  }
+
+  std::array<SlotEntry, TableSize> Slots{};
+  std::size_t MinLength = 0;
+  std::size_t MaxLength = 0;
+  unsigned FirstMul = 0;
+  unsigned LastMul = 0;
+  bool Perfect = false;
+};
+
+#endif
@@ -1,338 +1,367 @@
 #include "Lexer.hpp"
+#include "CharInfo.hpp"
+#include "CharScan.hpp"
+#include "KeywordTable.hpp"
+#include <algorithm>
+#include <array>
 #include <cassert>
-#include <cctype>
-
-std::unordered_map<std::string, Token::TokenKind> Lexer::Keywords =
-    std::unordered_map<std::string, Token::TokenKind>{
-        {"const", Token::Const},   {"int", Token::Int},
-        {"long", Token::Long},
-        {"double", Token::Double}, {"unsigned", Token::Unsigned},
-        {"void", Token::Void},     {"char", Token::Char},
-        {"if", Token::If},         {"switch", Token::Switch},
-        {"case", Token::Case},     {"default", Token::Default},
-        {"break", Token::Break},   {"else", Token::Else},
-        {"for", Token::For},       {"while", Token::While},
-        {"return", Token::Return}, {"struct", Token::Struct},
-        {"enum", Token::Enum},     {"typedef", Token::Typedef},
-        {"continue", Token::Continue},
-    };
-
-Lexer::Lexer(std::vector<std::string> &s) {
-  Source = std::move(s);
-  TokenBuffer = std::vector<Token>();
-  LineIndex = 0;
-  ColumnIndex = 0;
+#include <iostream>
+
+static constexpr KeywordTable<Token::TokenKind, 21> Keywords({{
+    {"const", Token::Const},       {"int", Token::Int},
+    {"long", Token::Long},         {"double", Token::Double},
+    {"unsigned", Token::Unsigned}, {"void", Token::Void},
+    {"char", Token::Char},         {"if", Token::If},
+    {"switch", Token::Switch},     {"case", Token::Case},
+    {"default", Token::Default},   {"break", Token::Break},
+    {"else", Token::Else},         {"for", Token::For},
+    {"while", Token::While},       {"return", Token::Return},
+    {"struct", Token::Struct},     {"enum", Token::Enum},
+    {"typedef", Token::Typedef},   {"continue", Token::Continue},
+    {"static", Token::Static},
+}});
+
+static_assert(Keywords.IsPerfect(), "No perfect hash found for the keywords");
+
+/// A state of the punctuation DFA. It gives the kind of the single character
+/// token and the multi character tokens reachable with one more character.
+struct SymbolState {
+  struct Transition {
+    char Next = 0;
+    Token::TokenKind Kind = Token::Invalid;
+  };
+
+  Token::TokenKind Kind = Token::Invalid;
+  std::array<Transition, 3> Transitions{};
+};
+
+static constexpr std::array<SymbolState, 256> BuildSymbolTable() {
+  std::array<SymbolState, 256> Table{};
+
+  auto Add = [&Table](char C, Token::TokenKind Kind,
+                      std::array<SymbolState::Transition, 3> Transitions = {}) {
+    Table[static_cast<unsigned char>(C)] = {Kind, Transitions};
+  };
+
+  Add('.', Token::Dot);
+  Add(',', Token::Comma);
+  Add('+', Token::Plus, {{{'+', Token::PlusPlus}, {'=', Token::PlusEqual}}});
+  Add('-', Token::Minus,
+      {{{'-', Token::MinusMinus},
+        {'>', Token::MinusGreaterThan},
+        {'=', Token::MinusEqual}}});
+  Add('*', Token::Astrix, {{{'=', Token::AstrixEqual}}});
+  Add('/', Token::ForwardSlash,
+      {{{'/', Token::DoubleForwardSlash}, {'=', Token::ForwardSlashEqual}}});
+  Add('%', Token::Percent);
+  Add('=', Token::Equal, {{{'=', Token::DoubleEqual}}});
+  Add('<', Token::LessThan,
+      {{{'<', Token::LessThanLessThan}, {'=', Token::LessEqual}}});
+  Add('>', Token::GreaterThan,
+      {{{'>', Token::GreaterThanGreaterThan}, {'=', Token::GreaterEqual}}});
+  Add('!', Token::Bang, {{{'=', Token::BangEqual}}});
+  Add('?', Token::QuestionMark);
+  Add('&', Token::And, {{{'&', Token::DoubleAnd}}});
+  Add(':', Token::Colon);
+  Add(';', Token::SemiColon);
+  Add('(', Token::LeftParen);
+  Add(')', Token::RightParen);
+  Add('[', Token::LeftBracet);
+  Add(']', Token::RightBracet);
+  Add('{', Token::LeftCurly);
+  Add('}', Token::RightCurly);
+
+  return Table;
+}
+
+static constexpr std::array<SymbolState, 256> SymbolTable = BuildSymbolTable();
+
+Lexer::Lexer(SourceManager &SM, PieceTable Text)
+    : SM(SM), Text(std::move(Text)), Scanner(GetCharScanKernels()) {
+  Index = 0;
+  EnterNextPiece();
+
+  LookAhead(1);
+}
+
+Lexer::Lexer(SourceManager &SM, PieceSource &Stream)
+    : SM(SM), Stream(&Stream), Scanner(GetCharScanKernels()) {
+  Index = 0;
+  EnterNextPiece();
+
+  LookAhead(1);
+}
+
+Lexer::Lexer(SourceManager &SM, TokenSource &Tokens)
+    : SM(SM), Tokens(&Tokens), Scanner(GetCharScanKernels()) {
+  Index = 0;
 
   LookAhead(1);
 }
 
+bool Lexer::EnterNextPiece() {
+  PieceTable::Piece P;
+  if (Stream) {
+    if (!Stream->NextPiece(P))
+      return false;
+  } else {
+    if (NextPiece >= Text.GetPieces().size())
+      return false;
+    P = Text.GetPieces()[NextPiece++];
+  }
+
+  BufferID = P.ID;
+  Source = SM.GetBuffer(P.ID).substr(0, P.Offset + P.Length);
+  Index = P.Offset;
+  return true;
+}
+
+void Lexer::ReleaseConsumedText() {
+  if (!Stream)
+    return;
+
+  // the looked ahead tokens may still be in an earlier piece
+  for (unsigned i = 0; i < TokenBuffer.Size(); i++)
+    if (TokenBuffer[i].GetBufferStart() &&
+        TokenBuffer[i].GetBufferStart() != Source.data())
+      return;
+
+  Stream->ReleaseConsumed(BufferID);
+}
+
+SourceManager::BufferID Lexer::GetBufferID(const Token &T) const {
+  if (!T.GetBufferStart())
+    return BufferID;
+  return SM.FindBuffer(T.GetBufferStart()).value_or(BufferID);
+}
+
 void Lexer::ConsumeCurrentToken() {
-  assert(TokenBuffer.size() > 0 && "TokenBuffer is empty.");
-  TokenBuffer.erase(TokenBuffer.begin());
+  assert(!TokenBuffer.Empty() && "TokenBuffer is empty.");
+  TokenBuffer.PopFront();
 }
 
 int Lexer::GetNextChar() {
-  // If its an empty line then move forward by calling EatNextChar() which will
-  // advance to the next line's first character.
-  if (LineIndex < Source.size() && Source[LineIndex].length() == 0)
-    EatNextChar();
-  if (LineIndex >= Source.size() || (LineIndex == Source.size() - 1 &&
-                                     ColumnIndex == Source[LineIndex].length()))
+  if (Index >= Source.size())
     return EOF;
-  return Source[LineIndex][ColumnIndex];
+  return Source[Index];
 }
 
 int Lexer::GetNextNthCharOnSameLine(unsigned n) {
-  if (LineIndex >= Source.size() ||
-      (ColumnIndex + n >= Source[LineIndex].length()))
+  if (Index + n >= Source.size() || Source[Index + n] == '\n')
     return EOF;
-  return Source[LineIndex][ColumnIndex + n];
+  return Source[Index + n];
 }
 
 void Lexer::EatNextChar() {
-  if (LineIndex < Source.size()) {
-    if (Source[LineIndex].size() == 0 ||
-        ColumnIndex >= Source[LineIndex].size() - 1) {
-      ColumnIndex = 0;
-      LineIndex++;
-    } else {
-      ColumnIndex++;
-    }
-  }
+  if (Index < Source.size())
+    Index++;
+}
+
+/// Most of the runs are only a few characters long. For those an indirect call
+/// to a vector kernel costs more than checking the characters one by one, so
+/// the kernels are only called for runs longer than this.
+static constexpr unsigned ShortRunLength = 8;
+
+template <uint8_t Class>
+static inline unsigned ScanRun(std::string_view Source, unsigned Start,
+                               const char *(*Kernel)(const char *,
+                                                     const char *)) {
+  auto Size = Source.size();
+  auto ShortEnd = std::min<size_t>(Size, Start + ShortRunLength);
+
+  while (Start < ShortEnd && (GetCharClass(Source[Start]) & Class))
+    Start++;
+
+  if (Start < ShortEnd || Start == Size)
+    return Start;
+
+  return Kernel(Source.data() + Start, Source.data() + Size) - Source.data();
+}
+
+unsigned Lexer::ScanIdentifierChars(unsigned Start) const {
+  return ScanRun<CC_Letter | CC_Digit>(Source, Start,
+                                       Scanner.SkipIdentifierChars);
+}
+
+unsigned Lexer::ScanDigits(unsigned Start) const {
+  return ScanRun<CC_Digit>(Source, Start, Scanner.SkipDigits);
+}
+
+unsigned Lexer::ScanWhitespace(unsigned Start) const {
+  return ScanRun<CC_Whitespace>(Source, Start, Scanner.SkipWhitespace);
+}
+
+Token Lexer::MakeToken(Token::TokenKind Kind, unsigned StartIndex) {
+  auto Length = Index - StartIndex;
+  if (Length <= Token::MaxLength)
+    return Token(Kind, Source.data(), StartIndex, Length);
+
+  // the whole text is skipped, the Invalid token only keeps its location
+  Token Result(Token::Invalid, Source.data(), StartIndex, 0);
+  auto [Line, Col] = GetLineAndColumn(Result);
+  std::cout << ":" << Line + 1 << ":" << Col + 1 << ": error: token is "
+            << Length << " characters long, the limit is " << Token::MaxLength
+            << std::endl
+            << "\t\t" << GetLine(Result) << std::endl
+            << std::endl;
+
+  return Result;
 }
 
 std::optional<Token> Lexer::LexNumber() {
-  unsigned StartLineIndex = LineIndex;
-  unsigned StartColumnIndex = ColumnIndex;
-  unsigned Length = 0;
+  unsigned StartIndex = Index;
   auto TokenKind = Token::Integer;
 
-  while (isdigit(GetNextChar())) {
-    Length++;
-    EatNextChar();
-  }
+  Index = ScanDigits(Index);
 
   // if its a real value like 3.14
-  if (GetNextChar() == '.') {
-    Length++;
-    EatNextChar();
+  if (Index < Source.size() && Source[Index] == '.') {
     TokenKind = Token::Real;
+    Index++;
 
-    if (!isdigit(GetNextChar()))
+    if (Index >= Source.size() || !IsDigit(Source[Index]))
       return std::nullopt; // TODO it might be better to make Invalid token
 
-    while (isdigit(GetNextChar())) {
-      Length++;
-      EatNextChar();
-    }
+    Index = ScanDigits(Index);
   }
 
-  if (Length == 0)
+  if (Index == StartIndex)
     return std::nullopt;
 
-  std::string_view StringValue{&Source[StartLineIndex][StartColumnIndex],
-                               Length};
-  return Token(TokenKind, StringValue, StartLineIndex, StartColumnIndex);
+  return MakeToken(TokenKind, StartIndex);
 }
 
 std::optional<Token> Lexer::LexIdentifier() {
-  unsigned StartLineIndex = LineIndex;
-  unsigned StartColumnIndex = ColumnIndex;
-  unsigned Length = 0;
+  unsigned StartIndex = Index;
 
   // Cannot start with a digit
-  if (isdigit(GetNextChar()))
+  if (Index >= Source.size() || !(GetCharClass(Source[Index]) & CC_Letter))
     return std::nullopt;
 
-  while (isalnum(GetNextChar()) || GetNextChar() == '_') {
-    Length++;
-    EatNextChar();
-  }
+  Index = ScanIdentifierChars(Index + 1);
 
-  if (Length == 0)
-    return std::nullopt;
+  auto Word = Source.substr(StartIndex, Index - StartIndex);
+  auto Kind = Keywords.Lookup(Word).value_or(Token::Identifier);
 
-  std::string_view StringValue{&Source[StartLineIndex][StartColumnIndex],
-                               Length};
-  return Token(Token::Identifier, StringValue, StartLineIndex,
-               StartColumnIndex);
+  return MakeToken(Kind, StartIndex);
 }
 
-std::optional<Token> Lexer::LexKeyword() {
-  std::size_t WordEnd =
-      Source[LineIndex].substr(ColumnIndex).find_first_of("\t\n\v\f\r;: ");
-
-  auto Word = Source[LineIndex].substr(ColumnIndex, WordEnd);
-
-  if (!Keywords.count(Word))
+std::optional<Token> Lexer::LexSymbol() {
+  if (Index >= Source.size())
     return std::nullopt;
 
-  unsigned StartLineIndex = LineIndex;
-  unsigned StartColumnIndex = ColumnIndex;
-
-  for (int i = Word.length(); i > 0; i--)
-    EatNextChar();
-
-  std::string_view StringValue{&Source[StartLineIndex][StartColumnIndex],
-                               Word.length()};
-  return Token(Lexer::Keywords[Word], StringValue, StartLineIndex,
-               StartColumnIndex);
-}
+  auto &State = SymbolTable[static_cast<unsigned char>(Source[Index])];
+  if (State.Kind == Token::Invalid)
+    return std::nullopt;
 
-std::optional<Token> Lexer::LexSymbol() {
-  auto TokenKind = Token::Invalid;
+  auto TokenKind = State.Kind;
   unsigned Size = 1;
 
-  switch (GetNextChar()) {
-  case '.':
-    TokenKind = Token::Dot;
-    break;
-  case ',':
-    TokenKind = Token::Comma;
-    break;
-  case '+':
-    if (GetNextNthCharOnSameLine(1) == '+') {
-      TokenKind = Token::PlusPlus;
-      Size = 2;
-    } else if (GetNextNthCharOnSameLine(1) == '=') {
-      TokenKind = Token::PlusEqual;
-      Size = 2;
-    } else
-      TokenKind = Token::Plus;
-    break;
-  case '-':
-    if (GetNextNthCharOnSameLine(1) == '-') {
-      TokenKind = Token::MinusMinus;
-      Size = 2;
-    } else if (GetNextNthCharOnSameLine(1) == '>') {
-      TokenKind = Token::MinusGreaterThan;
-      Size = 2;
-    } else if (GetNextNthCharOnSameLine(1) == '=') {
-      TokenKind = Token::MinusEqual;
-      Size = 2;
-    } else
-      TokenKind = Token::Minus;
-    break;
-  case '*':
-    if (GetNextNthCharOnSameLine(1) == '=') {
-      TokenKind = Token::AstrixEqual;
-      Size = 2;
-    } else
-      TokenKind = Token::Astrix;
-    break;
-  case '/':
-    if (GetNextNthCharOnSameLine(1) == '/') {
-      TokenKind = Token::DoubleForwardSlash;
-      Size = 2;
-    } else if (GetNextNthCharOnSameLine(1) == '=') {
-      TokenKind = Token::ForwardSlashEqual;
-      Size = 2;
-    } else
-      TokenKind = Token::ForwardSlash;
-    break;
-  case '%':
-    TokenKind = Token::Percent;
-    break;
-  case '=':
-    if (GetNextNthCharOnSameLine(1) == '=') {
-      TokenKind = Token::DoubleEqual;
-      Size = 2;
-    } else
-      TokenKind = Token::Equal;
-    break;
-  case '<':
-    if (GetNextNthCharOnSameLine(1) == '<') {
-      TokenKind = Token::LessThanLessThan;
-      Size = 2;
-    } else if (GetNextNthCharOnSameLine(1) == '=') {
-      TokenKind = Token::LessEqual;
-      Size = 2;
-    } else
-      TokenKind = Token::LessThan;
-    break;
-  case '>':
-    if (GetNextNthCharOnSameLine(1) == '>') {
-      TokenKind = Token::GreaterThanGreaterThan;
-      Size = 2;
-    } else if (GetNextNthCharOnSameLine(1) == '=') {
-      TokenKind = Token::GreaterEqual;
-      Size = 2;
-    } else
-      TokenKind = Token::GreaterThan;
-    break;
-  case '!':
-    if (GetNextNthCharOnSameLine(1) == '=') {
-      TokenKind = Token::BangEqual;
-      Size = 2;
-    } else
-      TokenKind = Token::Bang;
-    break;
-  case '?':
-    TokenKind = Token::QuestionMark;
-    break;
-  case '&':
-    if (GetNextNthCharOnSameLine(1) == '&') {
-      TokenKind = Token::DoubleAnd;
-      Size = 2;
-    } else
-      TokenKind = Token::And;
-    break;
-  case ':':
-    TokenKind = Token::Colon;
-    break;
-  case ';':
-    TokenKind = Token::SemiColon;
-    break;
-  case '(':
-    TokenKind = Token::LeftParen;
-    break;
-  case ')':
-    TokenKind = Token::RightParen;
-    break;
-  case '[':
-    TokenKind = Token::LeftBracet;
-    break;
-  case ']':
-    TokenKind = Token::RightBracet;
-    break;
-  case '{':
-    TokenKind = Token::LeftCurly;
-    break;
-  case '}':
-    TokenKind = Token::RightCurly;
-    break;
-  default:
-    return std::nullopt;
-    break;
+  // multi character operators are at most 2 character long, so one step in
+  // the DFA is enough
+  if (Index + 1 < Source.size()) {
+    char Next = Source[Index + 1];
+    for (auto &Transition : State.Transitions) {
+      if (Transition.Kind == Token::Invalid)
+        break;
+      if (Transition.Next == Next) {
+        TokenKind = Transition.Kind;
+        Size = 2;
+        break;
+      }
+    }
   }
 
-  std::string_view StringValue{&Source[LineIndex][ColumnIndex], Size};
-  auto Result = Token(TokenKind, StringValue, LineIndex, ColumnIndex);
-
-  EatNextChar();
-  if (Size == 2)
-    EatNextChar();
+  auto Result = Token(TokenKind, Source.data(), Index, Size);
+  Index += Size;
 
   return Result;
 }
 
-Token Lexer::LookAhead(unsigned n) {
+const Token &Lexer::LookAhead(unsigned n) {
+  assert(n > 0 && n <= MaxLookAhead && "Invalid lookahead.");
+
   // fill in the TokenBuffer to have at least n element
-  for (size_t i = TokenBuffer.size(); i < n; i++)
-    TokenBuffer.push_back(Lex(true));
+  while (TokenBuffer.Size() < n)
+    TokenBuffer.PushBack(LexToken());
 
   return TokenBuffer[n - 1];
 }
 
-bool Lexer::Is(Token::TokenKind tk) {
-  // fill in the buffer with one token if it is empty
-  if (TokenBuffer.size() == 0)
-    LookAhead(1);
+void Lexer::Replay(const Token *Begin, const Token *End) {
+  while (!TokenBuffer.Empty())
+    TokenBuffer.PopFront();
+
+  ReplayNext = Begin;
+  ReplayEnd = End;
+  Replaying = true;
+}
 
+bool Lexer::Is(Token::TokenKind tk) {
   return GetCurrentToken().GetKind() == tk;
 }
 
 bool Lexer::IsNot(Token::TokenKind tk) { return !Is(tk); }
 
-Token Lexer::Lex(bool LookAhead) {
+Token Lexer::Lex() {
   // if the TokenBuffer not empty then return the Token from there
-  // and remove it from the stack
-  if (TokenBuffer.size() > 0 && !LookAhead) {
-    auto CurrentToken = GetCurrentToken();
+  // and remove it from the queue
+  if (!TokenBuffer.Empty()) {
+    auto CurrentToken = TokenBuffer.Front();
     ConsumeCurrentToken();
     return CurrentToken;
   }
 
-  int CurrentCharacter = GetNextChar();
-  std::string WhiteSpaceChars("\t\n\v\f\r ");
+  return LexToken();
+}
 
-  // consume white space characters
-  while (WhiteSpaceChars.find(CurrentCharacter) != std::string::npos ||
-         CurrentCharacter == '\0') {
-    EatNextChar();
-    CurrentCharacter = GetNextChar();
-  }
+Token Lexer::LexToken() {
+  if (Replaying)
+    return ReplayNext != ReplayEnd ? *ReplayNext++ : Token(Token::EndOfFile);
+
+  if (Tokens)
+    return Tokens->NextToken();
+
+  std::optional<Token> Result;
+
+  // a single line comment is skipped in a loop, not by lexing again
+  // recursively, so the number of comment lines in a row is not limited by the
+  // stack
+  for (;;) {
+    // consume white space characters, a piece may end with some, then the
+    // next piece continues
+    Index = ScanWhitespace(Index);
+    while (Index >= Source.size() && EnterNextPiece())
+      Index = ScanWhitespace(Index);
+
+    auto Size = Source.size();
+    if (Index >= Size)
+      return Token(Token::EndOfFile);
+
+    // the class of the first character decides which kind of token it can be
+    switch (GetCharClass(Source[Index])) {
+    case CC_Letter:
+      Result = LexIdentifier();
+      break;
+    case CC_Digit:
+      Result = LexNumber();
+      break;
+    case CC_Punctuation:
+      Result = LexSymbol();
+      break;
+    default:
+      Result = std::nullopt;
+      break;
+    }
 
-  if (CurrentCharacter == EOF) {
-    return Token(Token::EndOfFile);
-  }
+    if (!Result || Result.value().GetKind() != Token::DoubleForwardSlash)
+      break;
 
-  auto Result = LexKeyword();
-
-  if (!Result)
-    Result = LexSymbol();
-  if (!Result)
-    Result = LexNumber();
-  if (!Result)
-    Result = LexIdentifier();
-
-  // Handle single line comment. If "//" detected, then advance to next line and
-  // lex again.
-  if (Result.has_value() &&
-      Result.value().GetKind() == Token::DoubleForwardSlash) {
-    LineIndex++;
-    ColumnIndex = 0;
-    return Lex();
+    // "//" detected, advance to the next line and lex again
+    auto Begin = Source.data();
+    Index = Scanner.FindLineEnd(Begin + Index, Begin + Size) - Begin;
+    if (Index < Size)
+      Index++;
   }
 
   if (Result)
@@ -1,47 +1,133 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include "CharScan.hpp"
+#include "PieceTable.hpp"
+#include "SourceManager.hpp"
 #include "Token.hpp"
+#include "TokenQueue.hpp"
 #include <cassert>
 #include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
+/// Produces the tokens for a lexer which does not lex any text itself, like
+/// the one of the parser in the pipelined frontend.
+class TokenSource {
+public:
+  virtual ~TokenSource() = default;
+
+  /// Returns the next token, EndOfFile at the end and after it.
+  virtual Token NextToken() = 0;
+};
+
 class Lexer {
 public:
   void ConsumeCurrentToken();
   int GetNextChar();
   int GetNextNthCharOnSameLine(unsigned n);
 
-  // Update LineIndex and ColumnIndex to make them pointing to the next
-  // input character
+  // Update Index to make it pointing to the next input character
   void EatNextChar();
 
   // For matching an integer or real number
   std::optional<Token> LexNumber();
+
+  /// Lex an identifier or a keyword. Keywords are recognized on the scanned
+  /// span with a perfect hash lookup.
   std::optional<Token> LexIdentifier();
-  std::optional<Token> LexKeyword();
   std::optional<Token> LexSymbol();
-  Token LookAhead(unsigned n);
-  Token GetCurrentToken() { return LookAhead(1); }
+  const Token &LookAhead(unsigned n);
+  const Token &GetCurrentToken() { return LookAhead(1); }
   bool Is(Token::TokenKind tk);
   bool IsNot(Token::TokenKind tk);
 
-  std::vector<std::string> &GetSource() { return Source; }
+  SourceManager &GetSourceManager() { return SM; }
+
+  /// Returns the 0 based line and column number of the given token in its
+  /// buffer.
+  std::pair<unsigned, unsigned> GetLineAndColumn(const Token &T) {
+    return SM.GetLineAndColumn(GetBufferID(T), T.GetOffset());
+  }
+
+  /// Returns the text of the line containing @T.
+  std::string_view GetLine(const Token &T) {
+    return SM.GetLine(GetBufferID(T), GetLineAndColumn(T).first);
+  }
+
+  /// Returns the next token and consumes it.
+  Token Lex();
+
+  Lexer(SourceManager &SM, SourceManager::BufferID ID)
+      : Lexer(SM, PieceTable(SM, ID)) {}
+
+  /// Lex the pieces of @Text one after the other. Tokens do not span pieces.
+  Lexer(SourceManager &SM, PieceTable Text);
 
-  unsigned GetLineNum() { return LineIndex + 1; }
+  /// Lex the pieces of @Stream, pulling the next one only when the previous
+  /// one is used up. @Stream must outlive the lexer.
+  Lexer(SourceManager &SM, PieceSource &Stream);
 
-  Token Lex(bool LookAhead = false);
+  /// Return the tokens of @Tokens, lexed elsewhere. @Tokens must outlive the
+  /// lexer.
+  Lexer(SourceManager &SM, TokenSource &Tokens);
 
-  Lexer(std::vector<std::string> &s);
+  /// Tell the lexer that the tokens returned so far, except the ones still in
+  /// the lookahead buffer, are not used anymore. Then the text of the earlier
+  /// pieces can be released by the PieceSource.
+  void ReleaseConsumedText();
+
+  /// Lex the tokens from @Begin until @End, recorded earlier, instead of the
+  /// rest of the text, like the tokens of a function body parsed later. They
+  /// must outlive the replay and their text must be still available, so it
+  /// must not have been released.
+  void Replay(const Token *Begin, const Token *End);
+
+  /// The maximum number of tokens can be looked ahead.
+  static constexpr unsigned MaxLookAhead = 8;
 
 private:
-  static std::unordered_map<std::string, Token::TokenKind> Keywords;
-  std::vector<std::string> Source;
-  std::vector<Token> TokenBuffer;
-  unsigned LineIndex;
-  unsigned ColumnIndex;
+  /// Lex a new token from the source, bypassing the TokenBuffer.
+  Token LexToken();
+
+  /// The token of @Kind from @StartIndex until the current index. A text longer
+  /// than a token can hold is reported and lexed as an Invalid token.
+  Token MakeToken(Token::TokenKind Kind, unsigned StartIndex);
+
+  /// Returns the index of the first non identifier character from @Start.
+  unsigned ScanIdentifierChars(unsigned Start) const;
+
+  /// Returns the index of the first non digit character from @Start.
+  unsigned ScanDigits(unsigned Start) const;
+
+  /// Returns the index of the first non white space character from @Start.
+  unsigned ScanWhitespace(unsigned Start) const;
+
+  /// Continue lexing with the next piece. Returns false if there is none.
+  bool EnterNextPiece();
+
+  /// The buffer of the token @T, which is not necessarily the one being lexed.
+  SourceManager::BufferID GetBufferID(const Token &T) const;
+
+  SourceManager &SM;
+  PieceTable Text;
+  unsigned NextPiece = 0;
+  /// If set, the pieces are pulled from it instead of Text.
+  PieceSource *Stream = nullptr;
+  /// If set, the tokens are pulled from it instead of lexing any text.
+  TokenSource *Tokens = nullptr;
+  SourceManager::BufferID BufferID = 0;
+  /// The buffer of the current piece until the end of the piece. The indices
+  /// are relative to the buffer, so the token offsets are too.
+  std::string_view Source;
+  const CharScanKernels &Scanner;
+  TokenQueue<Token, MaxLookAhead> TokenBuffer;
+  unsigned Index;
+  /// The tokens lexed instead of the text, if Replaying.
+  const Token *ReplayNext = nullptr;
+  const Token *ReplayEnd = nullptr;
+  bool Replaying = false;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef PIECETABLE_H
+#define PIECETABLE_H
+
+#include "SourceManager.hpp"
+#include <string>
+#include <vector>
+
+/// Text made of ranges (pieces) of the buffers of a SourceManager, without
+/// copying them. The preprocessor output is a piece table: splicing in an
+/// included file or dropping a directive line is only appending, or not
+/// appending, a piece, and the lexer walks the pieces directly.
+class PieceTable {
+public:
+  struct Piece {
+    SourceManager::BufferID ID;
+    unsigned Offset;
+    unsigned Length;
+  };
+
+  PieceTable() = default;
+
+  /// The whole buffer @ID as a single piece.
+  PieceTable(const SourceManager &SM, SourceManager::BufferID ID) {
+    Append(ID, 0, SM.GetBuffer(ID).size());
+  }
+
+  /// Append @Length characters from @Offset of buffer @ID. A range directly
+  /// following the last piece in the same buffer extends that piece.
+  void Append(SourceManager::BufferID ID, unsigned Offset, unsigned Length) {
+    if (Length == 0)
+      return;
+
+    Size += Length;
+    if (!Pieces.empty() && Pieces.back().ID == ID &&
+        Pieces.back().Offset + Pieces.back().Length == Offset) {
+      Pieces.back().Length += Length;
+      return;
+    }
+
+    Pieces.push_back({ID, Offset, Length});
+  }
+
+  /// Make the pieces of buffer @From refer to buffer @To instead.
+  void ReplaceBufferID(SourceManager::BufferID From,
+                       SourceManager::BufferID To) {
+    for (auto &P : Pieces)
+      if (P.ID == From)
+        P.ID = To;
+  }
+
+  const std::vector<Piece> &GetPieces() const { return Pieces; }
+
+  /// Number of characters in all the pieces.
+  size_t GetSize() const { return Size; }
+
+  /// Concatenate the pieces.
+  std::string GetText(const SourceManager &SM) const {
+    std::string Text;
+    Text.reserve(Size);
+    for (auto &P : Pieces)
+      Text.append(SM.GetBuffer(P.ID).substr(P.Offset, P.Length));
+    return Text;
+  }
+
+private:
+  std::vector<Piece> Pieces;
+  size_t Size = 0;
+};
+
+/// Produces the text for the lexer piece by piece, only when the lexer needs
+/// the next one. The preprocessor is one, so the lexer can pull its output
+/// on demand instead of waiting for the whole translation unit.
+class PieceSource {
+public:
+  virtual ~PieceSource() = default;
+
+  /// Store the next piece of the text in @P. Returns false at the end.
+  virtual bool NextPiece(PieceTable::Piece &P) = 0;
+
+  /// Called when the tokens still in use are all in buffer @InUse, which
+  /// holds the last piece. The text produced for the earlier pieces in other
+  /// buffers can be freed.
+  virtual void ReleaseConsumed(SourceManager::BufferID InUse) {}
+};
+
+#endif
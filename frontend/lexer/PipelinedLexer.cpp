@@ -0,0 +1,66 @@
+#include "PipelinedLexer.hpp"
+
+PipelinedLexer::PipelinedLexer(SourceManager &SM, PieceSource &Source) {
+  PreProcessorThread = std::thread([this, &Source] { PreProcess(Source); });
+  LexerThread = std::thread([this, &SM] { Lex(SM); });
+}
+
+PipelinedLexer::~PipelinedLexer() {
+  Stopping = true;
+  PreProcessorThread.join();
+  LexerThread.join();
+}
+
+template <typename OpT> bool PipelinedLexer::Wait(OpT Op) {
+  while (!Op()) {
+    if (Stopping)
+      return false;
+    // the other side of the queue needs the time, which might be on this
+    // core
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+Token PipelinedLexer::NextToken() {
+  if (Finished)
+    return Token(Token::EndOfFile);
+
+  // the lexer thread only stops early if the pipeline is stopped, which is
+  // not while it is read
+  Token T;
+  Wait([this, &T] { return Tokens.TryPop(T); });
+  Finished = T.GetKind() == Token::EndOfFile;
+  return T;
+}
+
+bool PipelinedLexer::PieceQueueSource::NextPiece(PieceTable::Piece &P) {
+  std::optional<PieceTable::Piece> Next;
+  if (!Pipeline.Wait([this, &Next] { return Pipeline.Pieces.TryPop(Next); }) ||
+      !Next)
+    return false;
+
+  P = *Next;
+  return true;
+}
+
+void PipelinedLexer::PreProcess(PieceSource &Source) {
+  PieceTable::Piece P;
+  while (Source.NextPiece(P))
+    if (!Wait([this, &P] { return Pieces.TryPush(P); }))
+      return;
+
+  Wait([this] { return Pieces.TryPush(std::nullopt); });
+}
+
+void PipelinedLexer::Lex(SourceManager &SM) {
+  PieceQueueSource Source(*this);
+  Lexer L(SM, Source);
+
+  Token T;
+  do {
+    T = L.Lex();
+    if (!Wait([this, &T] { return Tokens.TryPush(T); }))
+      return;
+  } while (T.GetKind() != Token::EndOfFile);
+}
@@ -0,0 +1,57 @@
+#ifndef PIPELINEDLEXER_H
+#define PIPELINEDLEXER_H
+
+#include "../../support/SPSCQueue.hpp"
+#include "Lexer.hpp"
+#include "PieceTable.hpp"
+#include <atomic>
+#include <optional>
+#include <thread>
+
+/// Runs the preprocessing and the lexing on threads of their own, so they
+/// overlap with each other and with the parsing. The pieces pulled from the
+/// PieceSource are pushed into a queue read by a Lexer, whose tokens are
+/// pushed into another queue, which the parser reads with NextToken as they
+/// arrive. The tokens are the same as the ones of a Lexer pulling the pieces
+/// itself, but their text is never released while parsing.
+class PipelinedLexer : public TokenSource {
+public:
+  /// Start the threads. @SM and @Source must outlive the pipeline.
+  PipelinedLexer(SourceManager &SM, PieceSource &Source);
+  PipelinedLexer(const PipelinedLexer &) = delete;
+  PipelinedLexer &operator=(const PipelinedLexer &) = delete;
+
+  /// Stop the threads, even if not every token was consumed.
+  ~PipelinedLexer();
+
+  Token NextToken() override;
+
+private:
+  /// Hands the pieces of the preprocessor thread to the lexer thread.
+  class PieceQueueSource : public PieceSource {
+  public:
+    PieceQueueSource(PipelinedLexer &Pipeline) : Pipeline(Pipeline) {}
+    bool NextPiece(PieceTable::Piece &P) override;
+
+  private:
+    PipelinedLexer &Pipeline;
+  };
+
+  void PreProcess(PieceSource &Source);
+  void Lex(SourceManager &SM);
+
+  /// Retry @Op until it succeeds. Returns false if the pipeline is stopped
+  /// meanwhile.
+  template <typename OpT> bool Wait(OpT Op);
+
+  /// The pieces, std::nullopt after the last one.
+  SPSCQueue<std::optional<PieceTable::Piece>, 1024> Pieces;
+  SPSCQueue<Token, 4096> Tokens;
+  std::atomic<bool> Stopping = false;
+  /// The EndOfFile token was returned already.
+  bool Finished = false;
+  std::thread PreProcessorThread;
+  std::thread LexerThread;
+};
+
+#endif
@@ -0,0 +1,167 @@
+#include "SourceManager.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MemoryBuffer::MemoryBuffer(std::string Name, std::string Content)
+    : Name(std::move(Name)), OwnedContent(std::move(Content)) {
+  Data = OwnedContent.data();
+  Size = OwnedContent.size();
+}
+
+MemoryBuffer::MemoryBuffer(std::string Name, const char *MappedData,
+                           size_t MappedSize)
+    : Name(std::move(Name)), Data(MappedData), Size(MappedSize),
+      IsMapped(true) {}
+
+MemoryBuffer::~MemoryBuffer() {
+  if (IsMapped)
+    munmap(const_cast<char *>(Data), Size);
+}
+
+bool MemoryBuffer::Append(std::string_view Text) {
+  assert(!IsMapped && "Mapped files are read-only.");
+
+  if (OwnedContent.size() + Text.size() > OwnedContent.capacity())
+    return false;
+
+  OwnedContent.append(Text);
+  Data = OwnedContent.data();
+  Size = OwnedContent.size();
+  LineOffsets.clear();
+  return true;
+}
+
+const std::vector<unsigned> &MemoryBuffer::GetLineOffsets() {
+  if (!LineOffsets.empty())
+    return LineOffsets;
+
+  LineOffsets.push_back(0);
+  const char *Pos = Data;
+  const char *End = Data + Size;
+  while ((Pos = static_cast<const char *>(memchr(Pos, '\n', End - Pos)))) {
+    Pos++;
+    LineOffsets.push_back(Pos - Data);
+  }
+
+  return LineOffsets;
+}
+
+std::optional<SourceManager::BufferID>
+SourceManager::AddFile(const std::string &Path) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  if (auto It = FilesByPath.find(Path); It != FilesByPath.end())
+    return It->second;
+
+  int FD = open(Path.c_str(), O_RDONLY);
+  if (FD < 0)
+    return std::nullopt;
+
+  struct stat FileStat;
+  if (fstat(FD, &FileStat) != 0) {
+    close(FD);
+    return std::nullopt;
+  }
+
+  // the same file reached through another path
+  std::pair FileKey(FileStat.st_dev, FileStat.st_ino);
+  if (auto It = LoadedFiles.find(FileKey); It != LoadedFiles.end()) {
+    auto &Loaded = It->second;
+    if (Loaded.Size == FileStat.st_size &&
+        Loaded.ModificationTime.tv_sec == FileStat.st_mtim.tv_sec &&
+        Loaded.ModificationTime.tv_nsec == FileStat.st_mtim.tv_nsec) {
+      close(FD);
+      return FilesByPath[Path] = Loaded.ID;
+    }
+  }
+
+  BufferID ID;
+  // mmap cannot map an empty file
+  if (FileStat.st_size == 0) {
+    Buffers.push_back(std::make_unique<MemoryBuffer>(Path, ""));
+    ID = Buffers.size() - 1;
+  } else {
+    void *Mapped =
+        mmap(nullptr, FileStat.st_size, PROT_READ, MAP_PRIVATE, FD, 0);
+
+    if (Mapped == MAP_FAILED) {
+      close(FD);
+      return std::nullopt;
+    }
+
+    Buffers.push_back(std::make_unique<MemoryBuffer>(
+        Path, static_cast<const char *>(Mapped), FileStat.st_size));
+    ID = Buffers.size() - 1;
+  }
+  close(FD);
+
+  LoadedFiles[FileKey] = {FileStat.st_mtim, FileStat.st_size, ID};
+  return FilesByPath[Path] = ID;
+}
+
+SourceManager::BufferID SourceManager::AddBuffer(std::string Content,
+                                                 std::string Name) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  Buffers.push_back(
+      std::make_unique<MemoryBuffer>(std::move(Name), std::move(Content)));
+  return Buffers.size() - 1;
+}
+
+SourceManager::BufferID SourceManager::AddScratchBuffer(size_t Capacity,
+                                                        std::string Name) {
+  std::string Content;
+  Content.reserve(Capacity);
+  return AddBuffer(std::move(Content), std::move(Name));
+}
+
+std::optional<unsigned> SourceManager::AppendToBuffer(BufferID ID,
+                                                      std::string_view Text) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  unsigned Offset = Buffers[ID]->GetBuffer().size();
+  if (!Buffers[ID]->Append(Text))
+    return std::nullopt;
+  return Offset;
+}
+
+void SourceManager::ReleaseBuffer(BufferID ID) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  Buffers[ID] = std::make_unique<MemoryBuffer>(Buffers[ID]->GetName(), "");
+}
+
+std::optional<SourceManager::BufferID>
+SourceManager::FindBuffer(const char *BufferStart) const {
+  std::lock_guard<std::mutex> Guard(Lock);
+  for (BufferID ID = 0; ID < Buffers.size(); ID++)
+    if (Buffers[ID]->GetBuffer().data() == BufferStart)
+      return ID;
+  return std::nullopt;
+}
+
+std::pair<unsigned, unsigned>
+SourceManager::GetLineAndColumn(BufferID ID, unsigned Offset) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  auto &LineOffsets = Buffers[ID]->GetLineOffsets();
+
+  // find the first line starting after the offset, the previous one is the
+  // line containing it
+  auto It = std::upper_bound(LineOffsets.begin(), LineOffsets.end(), Offset);
+  unsigned Line = (It - LineOffsets.begin()) - 1;
+
+  return {Line, Offset - LineOffsets[Line]};
+}
+
+std::string_view SourceManager::GetLine(BufferID ID, unsigned Line) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  auto &LineOffsets = Buffers[ID]->GetLineOffsets();
+  auto Buffer = Buffers[ID]->GetBuffer();
+
+  if (Line >= LineOffsets.size())
+    return "";
+
+  auto LineText = Buffer.substr(LineOffsets[Line]);
+  return LineText.substr(0, LineText.find('\n'));
+}
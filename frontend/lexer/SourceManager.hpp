@@ -0,0 +1,126 @@
+#ifndef SOURCEMANAGER_H
+#define SOURCEMANAGER_H
+
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// A read-only, contiguous chunk of source text. It is either a memory mapped
+/// file or an owned string (used for preprocessed output).
+class MemoryBuffer {
+public:
+  MemoryBuffer(std::string Name, std::string Content);
+  MemoryBuffer(std::string Name, const char *MappedData, size_t MappedSize);
+  ~MemoryBuffer();
+
+  MemoryBuffer(const MemoryBuffer &) = delete;
+  MemoryBuffer &operator=(const MemoryBuffer &) = delete;
+
+  std::string_view GetBuffer() const { return {Data, Size}; }
+  const std::string &GetName() const { return Name; }
+
+  /// Append @Text to an owned content if it fits into its capacity, so the
+  /// content does not move. Returns false if it does not fit.
+  bool Append(std::string_view Text);
+
+  /// Returns the offsets of the line beginnings. It is computed lazily on the
+  /// first request, since most of the buffers never need it.
+  const std::vector<unsigned> &GetLineOffsets();
+
+private:
+  std::string Name;
+  std::string OwnedContent;
+  const char *Data = nullptr;
+  size_t Size = 0;
+  bool IsMapped = false;
+  std::vector<unsigned> LineOffsets;
+};
+
+/// Owns every buffer used during the compilation. Lexers, tokens and the
+/// preprocessor only refer to these buffers with offsets and views, so the
+/// source text is not copied around. Line and column numbers are computed on
+/// demand from a newline index. It can be used from several threads, like the
+/// stages of the pipelined frontend.
+class SourceManager {
+public:
+  using BufferID = unsigned;
+
+  SourceManager() = default;
+  SourceManager(const SourceManager &) = delete;
+  SourceManager &operator=(const SourceManager &) = delete;
+
+  /// Memory map the file given by @Path. Returns std::nullopt if it cannot
+  /// be opened.
+  ///
+  /// Files are loaded only once: a path seen before is resolved without any
+  /// system call, and a new path of an already loaded file (same device,
+  /// inode, modification time and size) gets the buffer of that file.
+  std::optional<BufferID> AddFile(const std::string &Path);
+
+  /// Register a buffer with the given content and take its ownership.
+  BufferID AddBuffer(std::string Content, std::string Name = "");
+
+  /// Register an empty buffer which can hold @Capacity bytes appended by
+  /// AppendToBuffer. Its content never moves, so the views of it stay valid.
+  BufferID AddScratchBuffer(size_t Capacity, std::string Name = "");
+
+  /// Append @Text to the scratch buffer @ID. Returns the offset of the text
+  /// in the buffer, or std::nullopt if it does not fit.
+  std::optional<unsigned> AppendToBuffer(BufferID ID, std::string_view Text);
+
+  /// Free the content of buffer @ID, which becomes empty. Every view of its
+  /// old content is invalidated.
+  void ReleaseBuffer(BufferID ID);
+
+  std::string_view GetBuffer(BufferID ID) const {
+    std::lock_guard<std::mutex> Guard(Lock);
+    return Buffers[ID]->GetBuffer();
+  }
+
+  /// The name is copied, since the buffers can be added from another thread
+  /// once the lock is released.
+  std::string GetBufferName(BufferID ID) const {
+    std::lock_guard<std::mutex> Guard(Lock);
+    return Buffers[ID]->GetName();
+  }
+
+  /// Returns the ID of the buffer starting at @BufferStart. It is a linear
+  /// search, meant for the diagnostics.
+  std::optional<BufferID> FindBuffer(const char *BufferStart) const;
+
+  /// Returns the 0 based line and column number of @Offset in buffer @ID.
+  std::pair<unsigned, unsigned> GetLineAndColumn(BufferID ID, unsigned Offset);
+
+  /// Returns the 0 based @Line of buffer @ID without the newline character.
+  std::string_view GetLine(BufferID ID, unsigned Line);
+
+  /// Number of files actually mapped by AddFile.
+  size_t GetNumLoadedFiles() const {
+    std::lock_guard<std::mutex> Guard(Lock);
+    return LoadedFiles.size();
+  }
+
+private:
+  struct LoadedFile {
+    timespec ModificationTime;
+    off_t Size;
+    BufferID ID;
+  };
+
+  std::vector<std::unique_ptr<MemoryBuffer>> Buffers;
+  std::unordered_map<std::string, BufferID> FilesByPath;
+  /// Keyed by the device and inode numbers.
+  std::map<std::pair<dev_t, ino_t>, LoadedFile> LoadedFiles;
+  /// Guards the buffers, a scratch buffer grows while it is read.
+  mutable std::mutex Lock;
+};
+
+#endif
@@ -2,7 +2,10 @@
 #define TOKEN_H
 
 #include <cassert>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 
 class Token {
@@ -82,24 +85,45 @@ public:
     Struct,
     Enum,
     Typedef,
+    Static,
   };
 
-  Token() : Kind(Invalid) {}
+  /// The number of token kinds, for the tables indexed by them. Static must be
+  /// the last kind.
+  static constexpr unsigned NumKinds = Static + 1;
+
+  /// The longest text a token can have, its length is stored on 16 bits.
+  static constexpr unsigned MaxLength = UINT16_MAX;
+
+  Token() = default;
 
   Token(TokenKind tk) : Kind(tk) {}
 
-  Token(TokenKind tk, std::string_view sv, unsigned l, unsigned c)
-      : Kind(tk), StringValue(sv), LineNumber(l), ColumnNumber(c) {}
+  /// The text of the token is @Length character long, starting at @Offset in
+  /// the buffer pointed by @BufferStart.
+  Token(TokenKind tk, const char *BufferStart, unsigned Offset, unsigned Length)
+      : Kind(tk), Length(Length), Offset(Offset), BufferStart(BufferStart) {
+    assert(Length <= MaxLength && "Token is too long.");
+  }
+
+  std::string GetString() const { return std::string(GetStringView()); }
+  std::string_view GetStringView() const {
+    if (!BufferStart)
+      return {};
+    return {BufferStart + Offset, Length};
+  }
+  TokenKind GetKind() const { return static_cast<TokenKind>(Kind); }
 
-  std::string GetString() const { return std::string(StringValue); }
-  TokenKind GetKind() const { return Kind; }
+  /// The offset of the token in the lexed buffer. The line and column number
+  /// can be retrieved from it through the SourceManager.
+  unsigned GetOffset() const { return Offset; }
 
-  unsigned GetLineNum() const { return LineNumber; }
-  unsigned GetColNum() const { return ColumnNumber; }
+  /// The start of the lexed buffer, or nullptr if the token has no text.
+  const char *GetBufferStart() const { return BufferStart; }
 
-  std::string ToString() const {
+  std::string ToString(unsigned LineNumber, unsigned ColumnNumber) const {
     std::string Result("");
-    Result += "\"" + std::string(StringValue) + "\", ";
+    Result += "\"" + GetString() + "\", ";
     Result += "Line: " + std::to_string(LineNumber + 1) + ", ";
     Result += "Col: " + std::to_string(ColumnNumber + 1);
     return Result;
@@ -229,6 +253,8 @@ public:
       return "enum";
     case Typedef:
       return "typedef";
+    case Static:
+      return "static";
     default:
       assert(false && "Unhandled token type.");
       break;
@@ -236,10 +262,17 @@ public:
   }
 
 private:
-  TokenKind Kind;
-  std::string_view StringValue;
-  unsigned LineNumber;
-  unsigned ColumnNumber;
+  // Tokens are copied around a lot, so they are kept small and trivially
+  // copyable. The line and column numbers are not stored, they are computed
+  // from the offset by the SourceManager when needed.
+  uint16_t Kind = Invalid;
+  uint16_t Length = 0;
+  uint32_t Offset = 0;
+  const char *BufferStart = nullptr;
 };
 
+static_assert(sizeof(Token) == 16, "Token should be 16 bytes");
+static_assert(std::is_trivially_copyable<Token>::value,
+              "Token should be trivially copyable");
+
 #endif
\ No newline at end of file
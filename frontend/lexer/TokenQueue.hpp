@@ -0,0 +1,48 @@
+#ifndef TOKENQUEUE_H
+#define TOKENQUEUE_H
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+/// Fixed capacity circular queue for the lookahead tokens of the lexers.
+/// Consuming the front and peeking at any element are O(1) and do not move
+/// the other buffered tokens.
+template <typename TokenT, unsigned Capacity> class TokenQueue {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of 2");
+
+public:
+  static constexpr unsigned GetCapacity() { return Capacity; }
+
+  unsigned Size() const { return Count; }
+  bool Empty() const { return Count == 0; }
+  bool Full() const { return Count == Capacity; }
+
+  /// Returns the @n th element counted from the front (0 is the front).
+  TokenT &operator[](unsigned n) {
+    assert(n < Count && "Index out of range.");
+    return Buffer[(Head + n) & (Capacity - 1)];
+  }
+
+  TokenT &Front() { return (*this)[0]; }
+
+  void PushBack(const TokenT &T) {
+    assert(!Full() && "TokenQueue is full.");
+    Buffer[(Head + Count) & (Capacity - 1)] = T;
+    Count++;
+  }
+
+  void PopFront() {
+    assert(!Empty() && "TokenQueue is empty.");
+    Head = (Head + 1) & (Capacity - 1);
+    Count--;
+  }
+
+private:
+  std::array<TokenT, Capacity> Buffer;
+  unsigned Head = 0;
+  unsigned Count = 0;
+};
+
+#endif
@@ -1,39 +1,44 @@
 #include "Parser.hpp"
+#include "../../support/ThreadPool.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <memory>
 #include <typeinfo>
+#include <unordered_set>
 
 Token Parser::Expect(Token::TokenKind TKind) {
   auto t = Lex();
   if (t.GetKind() != TKind) {
-    std::cout << ":" << t.GetLineNum() + 1 << ":" << t.GetColNum() + 1
+    auto [Line, Col] = lexer.GetLineAndColumn(t);
+    std::cout << ":" << Line + 1 << ":" << Col + 1
               << ": error: Unexpected symbol `" << t.GetString()
               << "`. Expected is `" << Token::ToString(TKind) << "`."
               << std::endl
-              << "\t\t" << lexer.GetSource()[t.GetLineNum()] << std::endl
+              << "\t\t" << lexer.GetLine(t) << std::endl
               << std::endl;
   }
   return t; // consume Tokens
 }
 
-std::unique_ptr<Node> Parser::Parse() {
-  return std::move(ParseExternalDeclaration());
+Node *Parser::Parse() {
+  return ParseExternalDeclaration();
 }
 
 // TODO: To report the location of error we would need the token holding the
 // symbol name. It would be wise anyway to save it in AST nodes rather than
 // just a string.
-void Parser::InsertToSymTable(const std::string &SymName, Type SymType,
+void Parser::InsertToSymTable(Symbol SymName, const Type *SymType,
                               const bool ToGlobal = false,
                               ValueType SymValue = ValueType()) {
 
-  std::tuple<std::string, Type, ValueType> SymEntry(SymName, SymType,
-                                                           SymValue);
+  SymbolTableStack::Entry SymEntry(SymName, SymType, SymValue);
   // Check if it is already defined in the current scope
   if (SymTabStack.ContainsInCurrentScope(SymEntry))
-    std::cout << "error: Symbol '" + SymName + "' with type '" +
-                     SymType.ToString() + "' is already defined."
+    std::cout << "error: Symbol '" + SymName.GetString() + "' with type '" +
+                     SymType->ToString() + "' is already defined."
               << std::endl
               << std::endl;
   else if (ToGlobal)
@@ -43,39 +48,36 @@ void Parser::InsertToSymTable(const std::string &SymName, Type SymType,
 }
 
 void static UndefinedSymbolError(Token sym, Lexer &L) {
-  std::cout << ":" << sym.GetLineNum() + 1 << ":" << sym.GetColNum() + 1
+  auto [Line, Col] = L.GetLineAndColumn(sym);
+  std::cout << ":" << Line + 1 << ":" << Col + 1
             << ": error: "
             << "Undefined symbol '" << sym.GetString() << "'." << std::endl
-            << "\t\t" << L.GetSource()[sym.GetLineNum()].substr(sym.GetColNum())
+            << "\t\t" << L.GetLine(sym).substr(Col)
             << std::endl
             << std::endl;
 }
 
 [[maybe_unused]]
-void static ArrayTypeMismatchError(Token sym, Type actual) {
-  std::cout << sym.GetLineNum() + 1 << ":" << sym.GetColNum() + 1 << " error:"
+void static ArrayTypeMismatchError(Token sym, const Type *actual, Lexer &L) {
+  auto [Line, Col] = L.GetLineAndColumn(sym);
+  std::cout << Line + 1 << ":" << Col + 1 << " error:"
             << ": Type mismatch'" << sym.GetString() << "' type is '"
-            << actual.ToString() << "', it is not an array type.'" << std::endl;
-}
-
-void static EmitError(const std::string &msg, Lexer &L) {
-  std::cout << ":" << L.GetLineNum() << ": error: " << msg << std::endl
-            << "\t\t" << L.GetSource()[L.GetLineNum() - 1] << std::endl
-            << std::endl;
+            << actual->ToString() << "', it is not an array type.'" << std::endl;
 }
 
 void static EmitError(const std::string &msg, Lexer &L, Token &T) {
-  std::cout << ":" << T.GetLineNum() + 1 << ":" << T.GetColNum() + 1
+  auto [Line, Col] = L.GetLineAndColumn(T);
+  std::cout << ":" << Line + 1 << ":" << Col + 1
             << ": error: " << msg << std::endl
-            << "\t\t" << L.GetSource()[T.GetLineNum()] << std::endl
+            << "\t\t" << L.GetLine(T) << std::endl
             << std::endl;
 }
 
-bool Parser::IsUserDefined(std::string Name) {
+bool Parser::IsUserDefined(Symbol Name) {
   return UserDefinedTypes.count(Name) > 0 || TypeDefinitions.count(Name);
 }
 
-Type Parser::GetUserDefinedType(std::string Name) {
+const Type *Parser::GetUserDefinedType(Symbol Name) {
   assert(IsUserDefined(Name));
 
   if (UserDefinedTypes.count(Name) > 0)
@@ -94,7 +96,7 @@ bool Parser::IsTypeSpecifier(Token T) {
   case Token::Struct:
     return true;
   case Token::Identifier: {
-    auto Id = T.GetString();
+    auto Id = Symbol(T.GetStringView());
     if (TypeDefinitions.count(Id) != 0)
       return true;
   }
@@ -226,16 +228,19 @@ Type Parser::ParseType(Token::TokenKind tk) {
     Lex(); // eat 'struct' here
     auto CurrToken = lexer.GetCurrentToken();
 
-    std::string Name = CurrToken.GetString();
-    Result = std::get<0>(UserDefinedTypes[Name]);
+    auto Name = Symbol(CurrToken.GetStringView());
+    if (auto StructType = std::get<0>(UserDefinedTypes[Name]))
+      Result = *StructType;
     break;
   }
   case Token::Identifier: {
     // assuming we parsing the current token
     // TODO: Change this function expect the Token and not the TokenKind
     assert(GetCurrentTokenKind() == Token::Identifier);
-    auto Id = GetCurrentToken().GetString();
-    return TypeDefinitions[Id];
+    auto Id = Symbol(GetCurrentToken().GetStringView());
+    if (auto Typedef = TypeDefinitions[Id])
+      Result = *Typedef;
+    break;
   }
   default:
     assert(!"Unknown token kind.");
@@ -250,37 +255,50 @@ Type Parser::ParseType(Token::TokenKind tk) {
 //
 // First set : {void, int, double}
 // Second set : {Identifier}
-std::unique_ptr<Node> Parser::ParseExternalDeclaration() {
-  std::unique_ptr<TranslationUnit> TU = std::make_unique<TranslationUnit>();
+Node *Parser::ParseExternalDeclaration() {
+  std::vector<Statement *> Declarations = std::move(PrecompiledDeclarations);
   auto Token = GetCurrentToken();
 
   while (IsReturnTypeSpecifier(Token) || lexer.Is(Token::Struct) ||
-      lexer.Is(Token::Enum) || IsQualifier(Token.GetKind())) {
+      lexer.Is(Token::Enum) || lexer.Is(Token::Static) ||
+      IsQualifier(Token.GetKind())) {
+    // the text of the previous declarations is not needed anymore, unless
+    // function bodies are parsed later
+    if (DeferredBodies.empty())
+      lexer.ReleaseConsumedText();
+
+    // the declaration is only visible in the translation unit
+    bool IsStatic = false;
+    if (lexer.Is(Token::Static)) {
+      Lex(); // eat 'static'
+      IsStatic = true;
+    }
+
     auto Qualifiers = ParseQualifiers();
     Token = GetCurrentToken();
 
     if (lexer.Is(Token::Struct) && lexer.LookAhead(3).GetKind() == Token::LeftCurly) {
-      TU->AddDeclaration(ParseStructDeclaration(Qualifiers));
+      Declarations.push_back(ParseStructDeclaration(Qualifiers));
       Token = GetCurrentToken();
       continue;
     }
 
     if (lexer.Is(Token::Enum)) {
-      TU->AddDeclaration(ParseEnumDeclaration(Qualifiers));
+      Declarations.push_back(ParseEnumDeclaration(Qualifiers));
       Token = GetCurrentToken();
       continue;
     }
 
     Type type = ParseType(Token.GetKind());
     type.SetQualifiers(Qualifiers);
-    CurrentFuncRetType = type;
+    CurrentFuncRetType = TC.Get(type);
     Lex();
 
     auto Name = Expect(Token::Identifier);
-    auto NameStr = Name.GetString();
+    auto NameStr = Symbol(Name.GetStringView());
 
     if (Qualifiers & Type::Typedef) {
-      TypeDefinitions[NameStr] = type;
+      TypeDefinitions[NameStr] = TC.Get(type);
       Expect(Token::SemiColon);
       Token = GetCurrentToken();
       continue;
@@ -288,7 +306,8 @@ std::unique_ptr<Node> Parser::ParseExternalDeclaration() {
 
     // if a function declaration then a left parenthesis '(' expected
     if (lexer.Is(Token::LeftParen)) {
-      TU->AddDeclaration(ParseFunctionDeclaration(type, Name));
+      Declarations.push_back(
+          ParseFunctionDeclaration(TC.Get(type), Name, IsStatic));
     } else { // Variable declaration
       std::vector<unsigned> Dimensions;
 
@@ -303,7 +322,7 @@ std::unique_ptr<Node> Parser::ParseExternalDeclaration() {
         type.SetDimensions(std::move(Dimensions));
 
       // If the variable initialized
-      std::unique_ptr<Expression> InitExpr = nullptr;
+      Expression *InitExpr = nullptr;
       if (lexer.Is(Token::Equal)) {
         Lex(); // eat '='
         if (lexer.Is(Token::LeftCurly))
@@ -314,55 +333,234 @@ std::unique_ptr<Node> Parser::ParseExternalDeclaration() {
 
       Expect(Token::SemiColon);
 
-      InsertToSymTable(NameStr, type);
+      auto VarType = TC.Get(type);
+      InsertToSymTable(NameStr, VarType);
 
-      TU->AddDeclaration(std::make_unique<VariableDeclaration>(
-          NameStr, type, std::move(InitExpr)));
+      Declarations.push_back(
+          Ctx.Create<VariableDeclaration>(NameStr, VarType, InitExpr));
     }
 
     Token = GetCurrentToken();
   }
 
-  return TU;
+  if (!DeferredBodies.empty())
+    ParseDeferredBodies(Declarations);
+
+  return Ctx.Create<TranslationUnit>(Ctx.CreateList(Declarations));
 }
 
 // <FunctionDeclaration> ::= <ReturnTypeSpecifier> <Identifier> '('
 //                             <ParameterList>? ')' ';'
 //			   | <ReturnTypeSpecifier> <Identifier>
 //                             '(' <ParameterList>? ')' <CompoundStatement>
-std::unique_ptr<FunctionDeclaration>
-Parser::ParseFunctionDeclaration(const Type &ReturnType, const Token &Name) {
+FunctionDeclaration *
+Parser::ParseFunctionDeclaration(const Type *ReturnType, const Token &Name,
+                                 bool IsStatic) {
   Expect(Token::LeftParen); // consume '('
 
   // Creating new scope by pushing a new symbol table to the stack
   SymTabStack.PushSymTable();
 
-  auto PL = ParseParameterList();
+  auto PL = Ctx.CreateList(ParseParameterList());
 
   Expect(Token::RightParen);
 
-  auto FuncType = FunctionDeclaration::CreateType(ReturnType, PL);
-  auto NameStr = Name.GetString();
+  auto FuncType = FunctionDeclaration::CreateType(TC, ReturnType, PL);
+  auto NameStr = Symbol(Name.GetStringView());
   InsertToSymTable(NameStr, FuncType, true);
 
   ReturnsNumber = 0;
-  std::unique_ptr<CompoundStatement> Body = nullptr;
+  CompoundStatement *Body = nullptr;
+  bool IsDeferred = false;
   if (lexer.Is(Token::SemiColon))
     Lex(); // eat ';'
-  else
+  else if ((LazyParsing && IsStatic) || NumThreads > 0) {
+    // only parsed at the end, if it is needed
+    auto TokensBegin = DeferredTokens.size();
+    SkipCompoundStatement();
+    DeferredBodies.push_back({nullptr, ReturnType, IsStatic, TokensBegin,
+                              DeferredTokens.size(),
+                              SymTabStack.GetNumGlobals(), GetTypesSnapshot(),
+                              {}});
+    IsDeferred = true;
+  } else
     Body = ParseCompoundStatement();
 
   // Removing the function's scope since we done with its parsing
   SymTabStack.PopSymTable();
 
-  return std::make_unique<FunctionDeclaration>(FuncType, NameStr, PL, Body,
-                                               ReturnsNumber);
+  auto Function = Ctx.Create<FunctionDeclaration>(FuncType, NameStr, PL, Body,
+                                                  ReturnsNumber);
+  if (IsDeferred)
+    DeferredBodies.back().Function = Function;
+  return Function;
+}
+
+/// Append the tokens of a compound statement, from the '{' until the matching
+/// '}', to DeferredTokens without parsing them.
+void Parser::SkipCompoundStatement() {
+  unsigned Depth = 0;
+  do {
+    auto T = Lex();
+    if (T.GetKind() == Token::EndOfFile)
+      break;
+
+    if (T.GetKind() == Token::LeftCurly)
+      Depth++;
+    else if (T.GetKind() == Token::RightCurly && Depth > 0)
+      Depth--;
+    DeferredTokens.push_back(T);
+  } while (Depth > 0);
+}
+
+void Parser::EnableParallelParsing(unsigned NumThreads) {
+  this->NumThreads =
+      NumThreads ? NumThreads : ThreadPool::GetHardwareConcurrency();
+}
+
+Parser::Parser(Parser &Main, ASTContext &WorkerCtx)
+    : lexer(Main.lexer.GetSourceManager(), PieceTable()), Ctx(WorkerCtx),
+      TC(Main.TC), IRF(nullptr), LazyParsing(Main.LazyParsing) {}
+
+std::shared_ptr<const Parser::TypeTables> Parser::GetTypesSnapshot() {
+  // the tables only grow, a redefinition with another type is an error anyway
+  if (!TypesSnapshot ||
+      TypesSnapshot->UserDefined.size() != UserDefinedTypes.size() ||
+      TypesSnapshot->Definitions.size() != TypeDefinitions.size())
+    TypesSnapshot = std::make_shared<const TypeTables>(
+        TypeTables{UserDefinedTypes, TypeDefinitions});
+
+  return TypesSnapshot;
+}
+
+/// Parse the deferred bodies which are needed: every one, except that only
+/// the static functions called from a parsed body are needed when parsing
+/// lazily. The rest of the static functions are dropped.
+void Parser::ParseDeferredBodies(std::vector<Statement *> &Declarations) {
+  std::unordered_map<Symbol, size_t> StaticFunctions;
+  for (size_t i = 0; i < DeferredBodies.size(); i++)
+    if (DeferredBodies[i].IsStatic)
+      StaticFunctions[DeferredBodies[i].Function->GetName()] = i;
+
+  std::vector<bool> Needed(DeferredBodies.size());
+  std::vector<size_t> Worklist;
+  for (size_t i = 0; i < DeferredBodies.size(); i++)
+    if (!LazyParsing || !DeferredBodies[i].IsStatic) {
+      Needed[i] = true;
+      Worklist.push_back(i);
+    }
+
+  // the functions called from the bodies parsed so far are needed, then the
+  // ones called from their bodies and so on
+  auto AddCalledFunctions = [&]() {
+    for (auto Name : CalledFunctions)
+      if (auto It = StaticFunctions.find(Name);
+          It != StaticFunctions.end() && !Needed[It->second]) {
+        Needed[It->second] = true;
+        Worklist.push_back(It->second);
+      }
+    CalledFunctions.clear();
+  };
+  AddCalledFunctions();
+
+  std::unique_ptr<ThreadPool> Pool;
+  if (NumThreads > 1)
+    Pool = std::make_unique<ThreadPool>(NumThreads);
+
+  for (size_t Next = 0; Next < Worklist.size();) {
+    // the bodies known to be needed so far, in source order
+    std::vector<size_t> Round(Worklist.begin() + Next, Worklist.end());
+    std::sort(Round.begin(), Round.end());
+    Next = Worklist.size();
+
+    ParseDeferredBodies(Round, Pool.get());
+
+    for (auto i : Round) {
+      auto &Called = DeferredBodies[i].CalledFunctions;
+      CalledFunctions.insert(CalledFunctions.end(), Called.begin(),
+                             Called.end());
+    }
+    AddCalledFunctions();
+  }
+
+  std::unordered_set<Statement *> Unused;
+  for (size_t i = 0; i < DeferredBodies.size(); i++)
+    if (!Needed[i])
+      Unused.insert(DeferredBodies[i].Function);
+  Declarations.erase(std::remove_if(Declarations.begin(), Declarations.end(),
+                                    [&Unused](Statement *Declaration) {
+                                      return Unused.count(Declaration) > 0;
+                                    }),
+                     Declarations.end());
+
+  DeferredBodies.clear();
+  DeferredTokens.clear();
+}
+
+void Parser::ParseDeferredBodies(const std::vector<size_t> &Indices,
+                                 ThreadPool *Pool) {
+  // every worker takes the next few bodies in source order, so it only has to
+  // add the globals declared since its previous ones
+  constexpr size_t ChunkSize = 16;
+  std::atomic<size_t> NextChunk = 0;
+  auto Work = [this, &Indices, &NextChunk](ASTContext &WorkerCtx) {
+    Parser Worker(*this, WorkerCtx);
+    for (size_t Begin; (Begin = NextChunk.fetch_add(ChunkSize)) <
+                       Indices.size();)
+      for (auto i = Begin; i < std::min(Begin + ChunkSize, Indices.size()); i++)
+        Worker.ParseDeferredBody(*this, DeferredBodies[Indices[i]]);
+  };
+
+  if (!Pool) {
+    Work(Ctx);
+    return;
+  }
+
+  // the arena is not shared, the nodes are moved into Ctx at the end
+  std::vector<std::unique_ptr<ASTContext>> WorkerContexts;
+  for (unsigned i = 0; i < Pool->GetNumThreads(); i++) {
+    WorkerContexts.push_back(std::make_unique<ASTContext>());
+    Pool->Async([&Work, &WorkerCtx = *WorkerContexts.back()] {
+      Work(WorkerCtx);
+    });
+  }
+  Pool->Wait();
+
+  for (auto &WorkerCtx : WorkerContexts)
+    Ctx.Adopt(*WorkerCtx);
+}
+
+void Parser::ParseDeferredBody(const Parser &Main, DeferredBody &Deferred) {
+  SymTabStack.InsertGlobalsOf(Main.SymTabStack, SymTabStack.GetNumGlobals(),
+                              Deferred.NumGlobals);
+  if (TypesSnapshot != Deferred.Types) {
+    UserDefinedTypes = Deferred.Types->UserDefined;
+    TypeDefinitions = Deferred.Types->Definitions;
+    TypesSnapshot = Deferred.Types;
+  }
+
+  auto Function = Deferred.Function;
+  lexer.Replay(Main.DeferredTokens.data() + Deferred.TokensBegin,
+               Main.DeferredTokens.data() + Deferred.TokensEnd);
+  SymTabStack.PushSymTable();
+  for (auto Param : Function->GetArguments())
+    if (!Param->GetName().Empty())
+      InsertToSymTable(Param->GetName(), Param->GetType());
+
+  CurrentFuncRetType = Deferred.ReturnType;
+  ReturnsNumber = 0;
+  Function->SetBody(ParseCompoundStatement());
+  Function->SetReturnsNumber(ReturnsNumber);
+
+  SymTabStack.PopSymTable();
+  Deferred.CalledFunctions = std::move(CalledFunctions);
+  CalledFunctions.clear();
 }
 
 // <ParameterList> ::= <ParameterDeclaration>? {',' <ParameterDeclaration>}*
-std::vector<std::unique_ptr<FunctionParameterDeclaration>>
+std::vector<FunctionParameterDeclaration *>
 Parser::ParseParameterList() {
-  std::vector<std::unique_ptr<FunctionParameterDeclaration>> Params;
+  std::vector<FunctionParameterDeclaration *> Params;
 
   if (!IsTypeSpecifier(GetCurrentToken()) && !IsQualifier(GetCurrentTokenKind()))
     return Params;
@@ -376,10 +574,8 @@ Parser::ParseParameterList() {
 }
 
 // <ParameterDeclaration> ::= { <TypeSpecifier> '*'* <Identifier>? }?
-std::unique_ptr<FunctionParameterDeclaration>
-Parser::ParseParameterDeclaration() {
-  std::unique_ptr<FunctionParameterDeclaration> FPD =
-      std::make_unique<FunctionParameterDeclaration>();
+FunctionParameterDeclaration *Parser::ParseParameterDeclaration() {
+  auto FPD = Ctx.Create<FunctionParameterDeclaration>();
 
   if (IsTypeSpecifier(GetCurrentToken()) || IsQualifier(GetCurrentTokenKind())) {
     unsigned Qualifiers = ParseQualifiers();
@@ -392,12 +588,12 @@ Parser::ParseParameterDeclaration() {
       Lex(); // Eat the * character
     }
 
-    FPD->SetType(type);
+    FPD->SetType(TC.Get(type));
 
     if (lexer.Is(Token::Identifier)) {
-      auto Name = Lex().GetString();
+      auto Name = Symbol(Lex().GetStringView());
       FPD->SetName(Name);
-      InsertToSymTable(Name, type);
+      InsertToSymTable(Name, FPD->GetType());
     }
   }
 
@@ -425,27 +621,27 @@ Type Parser::ParseTypeSpecifier() {
 }
 
 // <CompoundStatement> ::= '{' <VariableDeclaration>* <Statement>* '}'
-std::unique_ptr<CompoundStatement> Parser::ParseCompoundStatement() {
+CompoundStatement *Parser::ParseCompoundStatement() {
   Expect(Token::LeftCurly);
 
-  std::vector<std::unique_ptr<Statement>> Statements;
+  std::vector<Statement *> Statements;
 
   while (IsTypeSpecifier(GetCurrentToken()) ||
          IsQualifier(GetCurrentTokenKind()) || lexer.IsNot(Token::RightCurly)) {
     if (IsTypeSpecifier(GetCurrentToken()) ||
         IsQualifier(GetCurrentTokenKind()))
-      Statements.push_back(std::move(ParseVariableDeclaration()));
+      Statements.push_back(ParseVariableDeclaration());
     else
-      Statements.push_back(std::move(ParseStatement()));
+      Statements.push_back(ParseStatement());
   }
   Expect(Token::RightCurly);
 
-  return std::make_unique<CompoundStatement>(Statements);
+  return Ctx.Create<CompoundStatement>(Ctx.CreateList(Statements));
 }
 
 // <VariableDeclaration> ::= <TypeSpecifier> '*'* <Identifier>
 //                           {'[' <IntegerConstant> ]'}* { = <Expression> }? ';'
-std::unique_ptr<VariableDeclaration> Parser::ParseVariableDeclaration() {
+VariableDeclaration *Parser::ParseVariableDeclaration() {
   Type type = ParseTypeSpecifier();
   Lex();
 
@@ -454,7 +650,7 @@ std::unique_ptr<VariableDeclaration> Parser::ParseVariableDeclaration() {
     Lex(); // Eat the * character
   }
 
-  std::string Name = Expect(Token::Identifier).GetString();
+  auto Name = Symbol(Expect(Token::Identifier).GetStringView());
 
   std::vector<unsigned> Dimensions;
   while (lexer.Is(Token::LeftBracet)) {
@@ -466,10 +662,11 @@ std::unique_ptr<VariableDeclaration> Parser::ParseVariableDeclaration() {
   if (!Dimensions.empty())
     type = Type(type, Dimensions);
 
-  InsertToSymTable(Name, type);
+  auto VarType = TC.Get(type);
+  InsertToSymTable(Name, VarType);
 
   // If the variable initialized
-  std::unique_ptr<Expression> InitExpr = nullptr;
+  Expression *InitExpr = nullptr;
   if (lexer.Is(Token::Equal)) {
     Lex(); // eat '='
     if (lexer.Is(Token::LeftCurly))
@@ -479,17 +676,16 @@ std::unique_ptr<VariableDeclaration> Parser::ParseVariableDeclaration() {
       // if the variable type not match the size of the initializer expression
       // then also do an implicit cast
       if ((type.GetTypeVariant() !=
-           InitExpr->GetResultType().GetTypeVariant()) &&
+           InitExpr->GetResultType()->GetTypeVariant()) &&
           !Type::OnlySigndnessDifference(
               type.GetTypeVariant(),
-              InitExpr->GetResultType().GetTypeVariant())) {
+              InitExpr->GetResultType()->GetTypeVariant())) {
         if (!Type::IsImplicitlyCastable(
-                InitExpr->GetResultType().GetTypeVariant(),
+                InitExpr->GetResultType()->GetTypeVariant(),
                 type.GetTypeVariant())) {
           assert(!"Invalid initialization");
         } else {
-          InitExpr = std::make_unique<ImplicitCastExpression>(
-              std::move(InitExpr), type);
+          InitExpr = Ctx.Create<ImplicitCastExpression>(InitExpr, VarType);
         }
       }
     }
@@ -497,17 +693,17 @@ std::unique_ptr<VariableDeclaration> Parser::ParseVariableDeclaration() {
 
   Expect(Token::SemiColon);
 
-  auto VD = std::make_unique<VariableDeclaration>(Name, type, Dimensions);
+  auto VD = Ctx.Create<VariableDeclaration>(Name, VarType);
 
   if (InitExpr)
-    VD->SetInitExpr(std::move(InitExpr));
+    VD->SetInitExpr(InitExpr);
 
   return VD;
 }
 
 // <VariableDeclaration> ::= <TypeSpecifier> '*'* <Identifier>
 //                           {'[' <IntegerConstant> ]'}* ';'
-std::unique_ptr<MemberDeclaration> Parser::ParseMemberDeclaration() {
+MemberDeclaration *Parser::ParseMemberDeclaration() {
   Type type = ParseTypeSpecifier();
   Lex();
 
@@ -516,7 +712,7 @@ std::unique_ptr<MemberDeclaration> Parser::ParseMemberDeclaration() {
     Lex(); // Eat the * character
   }
 
-  std::string Name = Expect(Token::Identifier).GetString();
+  auto Name = Symbol(Expect(Token::Identifier).GetStringView());
 
   std::vector<unsigned> Dimensions;
   while (lexer.Is(Token::LeftBracet)) {
@@ -527,66 +723,66 @@ std::unique_ptr<MemberDeclaration> Parser::ParseMemberDeclaration() {
 
   Expect(Token::SemiColon);
 
-  return std::make_unique<MemberDeclaration>(Name, type, Dimensions);
+  return Ctx.Create<MemberDeclaration>(Name, TC.Get(Type(type, Dimensions)));
 }
 
 // <StructDeclaration> ::= 'struct' <Identifier>
 //                                  '{' <StructDeclarationList>+ '}' ';'
-std::unique_ptr<StructDeclaration>
-Parser::ParseStructDeclaration(unsigned Qualifiers = 0) {
+StructDeclaration *Parser::ParseStructDeclaration(unsigned Qualifiers = 0) {
   Expect(Token::Struct);
 
-  std::string Name = Expect(Token::Identifier).GetString();
+  auto Name = Symbol(Expect(Token::Identifier).GetStringView());
 
   Expect(Token::LeftCurly);
 
-  std::vector<std::unique_ptr<MemberDeclaration>> Members;
+  std::vector<MemberDeclaration *> Members;
   Type type(Type::Struct);
   type.SetName(Name);
   type.SetQualifiers(Qualifiers);
 
-  std::vector<std::string> StructMemberIdentifiers;
+  std::vector<Symbol> StructMemberIdentifiers;
   while (lexer.IsNot(Token::RightCurly)) {
     auto MD = ParseMemberDeclaration();
     type.GetTypeList().push_back(MD->GetType());
     StructMemberIdentifiers.push_back(MD->GetName());
-    Members.push_back(std::move(MD));
+    Members.push_back(MD);
   }
 
   Expect(Token::RightCurly);
 
+  auto StructType = TC.Get(type);
   if (Qualifiers & Type::Typedef) {
-    auto AliasName = Expect(Token::Identifier).GetString();
-    TypeDefinitions[AliasName] = type;
+    auto AliasName = Symbol(Expect(Token::Identifier).GetStringView());
+    TypeDefinitions[AliasName] = StructType;
   }
 
   Expect(Token::SemiColon);
 
   // saving the struct type and name
-  UserDefinedTypes[Name] = {type, std::move(StructMemberIdentifiers)};
+  UserDefinedTypes[Name] = {StructType, std::move(StructMemberIdentifiers)};
 
-  return std::make_unique<StructDeclaration>(Name, Members, type);
+  return Ctx.Create<StructDeclaration>(Name, Ctx.CreateList(Members),
+                                       StructType);
 }
 
 // <EnumDeclaration> ::= 'enum' '{' <Identifier> (, <Identifier>)* '}' ';'
-std::unique_ptr<EnumDeclaration>
-Parser::ParseEnumDeclaration(unsigned Qualifiers) {
+EnumDeclaration *Parser::ParseEnumDeclaration(unsigned Qualifiers) {
   Expect(Token::Enum);
   Expect(Token::LeftCurly);
 
-  EnumDeclaration::EnumList Enumerators;
+  std::vector<std::pair<Symbol, int>> Enumerators;
 
   int EnumCounter = 0;
   do {
     if (lexer.Is(Token::Comma))
       Lex(); // eat ','
 
-    auto Identifier = Expect(Token::Identifier);
-    Enumerators.push_back({Identifier.GetString(), EnumCounter});
+    auto Identifier = Symbol(Expect(Token::Identifier).GetStringView());
+    Enumerators.push_back({Identifier, EnumCounter});
 
     // Insert into the symbol table and for now assign the index of the enum
     // to it, not considering explicit assignments like "enum { A = 10 };"
-    InsertToSymTable(Identifier.GetString(), Type(Type::Int), false,
+    InsertToSymTable(Identifier, TC.Get(Type::Int), false,
                      ValueType((unsigned)EnumCounter));
     EnumCounter++;
   } while (lexer.Is(Token::Comma));
@@ -594,13 +790,14 @@ Parser::ParseEnumDeclaration(unsigned Qualifiers) {
   Expect(Token::RightCurly);
 
   if (Qualifiers & Type::Typedef) {
-    auto AliasName = Expect(Token::Identifier).GetString();
-    TypeDefinitions[AliasName] = Type(Type::Int);
+    auto AliasName = Symbol(Expect(Token::Identifier).GetStringView());
+    TypeDefinitions[AliasName] = TC.Get(Type::Int);
   }
 
   Expect(Token::SemiColon);
 
-  return std::make_unique<EnumDeclaration>(Enumerators);
+  return Ctx.Create<EnumDeclaration>(TC.Get(Type::Int),
+                                     Ctx.CreateList(Enumerators));
 }
 
 unsigned Parser::ParseIntegerConstant() {
@@ -647,7 +844,7 @@ double Parser::ParseRealConstant() {
 //               | <SwitchStatement>
 //               | <CompoundStatement>
 //               | <ReturnStatement>
-std::unique_ptr<Statement> Parser::ParseStatement() {
+Statement *Parser::ParseStatement() {
   if (lexer.Is(Token::If))
     return ParseIfStatement();
   if (lexer.Is(Token::Switch))
@@ -668,18 +865,18 @@ std::unique_ptr<Statement> Parser::ParseStatement() {
 }
 
 // <IfStatement> ::= if '(' <Expression> ')' <Statement> {else <Statement>}?
-std::unique_ptr<IfStatement> Parser::ParseIfStatement() {
-  std::unique_ptr<IfStatement> IS = std::make_unique<IfStatement>();
+IfStatement *Parser::ParseIfStatement() {
+  IfStatement *IS = Ctx.Create<IfStatement>();
 
   Expect(Token::If);
   Expect(Token::LeftParen);
-  IS->SetCondition(std::move(ParseExpression()));
+  IS->SetCondition(ParseExpression());
   Expect(Token::RightParen);
-  IS->SetIfBody(std::move(ParseStatement()));
+  IS->SetIfBody(ParseStatement());
 
   if (lexer.Is(Token::Else)) {
     Lex();
-    IS->SetElseBody(std::move(ParseStatement()));
+    IS->SetElseBody(ParseStatement());
   }
   return IS;
 }
@@ -688,16 +885,16 @@ std::unique_ptr<IfStatement> Parser::ParseIfStatement() {
 //                       'case' <Constant> ':' <Statement>*
 //                       'default' ':' <Statement>*
 //                       '}'
-std::unique_ptr<SwitchStatement> Parser::ParseSwitchStatement() {
-  std::unique_ptr<SwitchStatement> SS = std::make_unique<SwitchStatement>();
+SwitchStatement *Parser::ParseSwitchStatement() {
+  SwitchStatement *SS = Ctx.Create<SwitchStatement>();
 
   Expect(Token::Switch);
   Expect(Token::LeftParen);
-  SS->SetCondition(std::move(ParseExpression()));
+  SS->SetCondition(ParseExpression());
   Expect(Token::RightParen);
   Expect(Token::LeftCurly);
 
-  SwitchStatement::VecOfCasesData CasesData;
+  std::vector<std::pair<int, SwitchStatement::VecOfStmts>> CasesData;
 
   unsigned FoundDefaults = 0;
 
@@ -705,7 +902,7 @@ std::unique_ptr<SwitchStatement> Parser::ParseSwitchStatement() {
     const bool IsCase = lexer.Is(Token::Case);
     Lex(); // eat 'case' or 'default'
 
-    std::unique_ptr<Expression> ConstExpr;
+    Expression *ConstExpr;
 
     if (IsCase) {
       ConstExpr = ParseConstantExpression();
@@ -716,29 +913,29 @@ std::unique_ptr<SwitchStatement> Parser::ParseSwitchStatement() {
       if (!ConstExpr)
         ConstExpr = ParseIdentifierExpression();
       // TODO: make it a semantic check and not assertion
-      assert(ConstExpr.get()->GetResultType().IsIntegerType() &&
+      assert(ConstExpr->GetResultType()->IsIntegerType() &&
              "Case expression must be an integer type");
     }
 
     Expect(Token::Colon);
 
-    SwitchStatement::VecOfStmts Statements;
+    std::vector<Statement *> Statements;
     while (lexer.IsNot(Token::RightCurly) && lexer.IsNot(Token::Case) &&
            lexer.IsNot(Token::Default))
-      Statements.push_back(std::move(ParseStatement()));
+      Statements.push_back(ParseStatement());
 
     if (IsCase) {
-      int CaseConstVal = dynamic_cast<IntegerLiteralExpression*>(ConstExpr.get())->GetSIntValue();
-      CasesData.push_back({CaseConstVal, std::move(Statements)});
+      int CaseConstVal = DynCast<IntegerLiteralExpression>(ConstExpr)->GetSIntValue();
+      CasesData.push_back({CaseConstVal, Ctx.CreateList(Statements)});
     } else {
       FoundDefaults++;
       // TODO: Make it a semantic check
       assert(FoundDefaults <= 1 && "Too much default case!");
-      SS->SetDefaultBody(std::move(Statements));
+      SS->SetDefaultBody(Ctx.CreateList(Statements));
     }
   }
   
-  SS->SetCaseBodies(std::move(CasesData));
+  SS->SetCaseBodies(Ctx.CreateList(CasesData));
 
   Expect(Token::RightCurly);
 
@@ -746,14 +943,14 @@ std::unique_ptr<SwitchStatement> Parser::ParseSwitchStatement() {
 }
 
 // <WhileStatement> ::= while '(' <Expression> ')' <Statement>
-std::unique_ptr<WhileStatement> Parser::ParseWhileStatement() {
-  std::unique_ptr<WhileStatement> WS = std::make_unique<WhileStatement>();
+WhileStatement *Parser::ParseWhileStatement() {
+  WhileStatement *WS = Ctx.Create<WhileStatement>();
 
   Expect(Token::While);
   Expect(Token::LeftParen);
-  WS->SetCondition(std::move(ParseExpression()));
+  WS->SetCondition(ParseExpression());
   Expect(Token::RightParen);
-  WS->SetBody(std::move(ParseStatement()));
+  WS->SetBody(ParseStatement());
 
   return WS;
 }
@@ -762,8 +959,8 @@ std::unique_ptr<WhileStatement> Parser::ParseWhileStatement() {
 //                            <Statement>
 //                  | for '(' <VariableDeclaration> <Expression> ';'
 //                            <Expression> ')' <Statement>
-std::unique_ptr<ForStatement> Parser::ParseForStatement() {
-  std::unique_ptr<ForStatement> FS = std::make_unique<ForStatement>();
+ForStatement *Parser::ParseForStatement() {
+  ForStatement *FS = Ctx.Create<ForStatement>();
 
   Expect(Token::For);
   Expect(Token::LeftParen);
@@ -772,66 +969,65 @@ std::unique_ptr<ForStatement> Parser::ParseForStatement() {
 
   // Parse variable declaration
   if (IsTypeSpecifier(GetCurrentToken())) {
-    FS->SetVarDecl(std::move(ParseVariableDeclaration()));
+    FS->SetVarDecl(ParseVariableDeclaration());
   } else {
-    FS->SetInit(std::move(ParseExpression()));
+    FS->SetInit(ParseExpression());
     Expect(Token::SemiColon);
   }
-  FS->SetCondition(std::move(ParseExpression()));
+  FS->SetCondition(ParseExpression());
   Expect(Token::SemiColon);
 
-  FS->SetIncrement(std::move(ParseExpression()));
+  FS->SetIncrement(ParseExpression());
   Expect(Token::RightParen);
 
-  FS->SetBody(std::move(ParseStatement()));
+  FS->SetBody(ParseStatement());
   SymTabStack.PopSymTable();
 
   return FS;
 }
 
 // <ExpressionStatement> ::= <Expression>? ';'
-std::unique_ptr<ExpressionStatement> Parser::ParseExpressionStatement() {
-  std::unique_ptr<ExpressionStatement> ES =
-      std::make_unique<ExpressionStatement>();
+ExpressionStatement *Parser::ParseExpressionStatement() {
+  auto ES = Ctx.Create<ExpressionStatement>();
 
   if (lexer.IsNot(Token::SemiColon))
-    ES->SetExpression(std::move(ParseExpression()));
+    ES->SetExpression(ParseExpression());
   Expect(Token::SemiColon);
 
   return ES;
 }
 
 // <BreakStatement> ::= 'break' ';'
-std::unique_ptr<BreakStatement> Parser::ParseBreakStatement() {
+BreakStatement *Parser::ParseBreakStatement() {
   Expect(Token::Break);
   Expect(Token::SemiColon);
-  return std::make_unique<BreakStatement>();
+  return Ctx.Create<BreakStatement>();
 }
 
 // <ContinueStatement> ::= 'continue' ';'
-std::unique_ptr<ContinueStatement> Parser::ParseContinueStatement() {
+ContinueStatement *Parser::ParseContinueStatement() {
   Expect(Token::Continue);
   Expect(Token::SemiColon);
-  return std::make_unique<ContinueStatement>();
+  return Ctx.Create<ContinueStatement>();
 }
 
 // <ReturnStatement> ::= return <Expression>? ';'
 // TODO: we need explicit type conversions here as well
-std::unique_ptr<ReturnStatement> Parser::ParseReturnStatement() {
+ReturnStatement *Parser::ParseReturnStatement() {
   ReturnsNumber++;
 
   Expect(Token::Return);
   auto Expr = ParseExpression();
-  auto LeftType = CurrentFuncRetType.GetTypeVariant();
-  auto RightType = Expr->GetResultType().GetTypeVariant();
-  std::unique_ptr<ReturnStatement> RS;
+  auto LeftType = CurrentFuncRetType->GetTypeVariant();
+  auto RightType = Expr->GetResultType()->GetTypeVariant();
+  ReturnStatement *RS;
 
   if (LeftType != RightType) {
-    std::unique_ptr<Expression> CastExpr =
-        std::make_unique<ImplicitCastExpression>(std::move(Expr), LeftType);
-    RS = std::make_unique<ReturnStatement>(std::move(CastExpr));
+    Expression *CastExpr =
+        Ctx.Create<ImplicitCastExpression>(Expr, TC.Get(LeftType));
+    RS = Ctx.Create<ReturnStatement>(CastExpr);
   } else {
-    RS = std::make_unique<ReturnStatement>(std::move(Expr));
+    RS = Ctx.Create<ReturnStatement>(Expr);
   }
 
   Expect(Token::SemiColon);
@@ -839,7 +1035,7 @@ std::unique_ptr<ReturnStatement> Parser::ParseReturnStatement() {
 }
 
 // <Expression> ::= <AssignmentExpression>
-std::unique_ptr<Expression> Parser::ParseExpression() {
+Expression *Parser::ParseExpression() {
   return ParseBinaryExpression();
 }
 
@@ -867,26 +1063,26 @@ static bool IsPostfixOperator(Token tk) {
 //                       | <PostFixExpression> '.' <Identifier>
 //                       | <PostFixExpression> '->' <Identifier>
 //                       | ( TypeName ) '{' <Initializer-List> '}'
-std::unique_ptr<Expression> Parser::ParsePostFixExpression() {
+Expression *Parser::ParsePostFixExpression() {
   auto CurrentToken = lexer.GetCurrentToken();
 
   // Struct initializing case
   if (lexer.Is(Token::LeftParen) &&
       lexer.LookAhead(2).GetKind() == Token::Identifier &&
-      IsUserDefined(lexer.LookAhead(2).GetString())) {
+      IsUserDefined(Symbol(lexer.LookAhead(2).GetStringView()))) {
     Expect(Token::LeftParen);
-    auto TypeName = Expect(Token::Identifier).GetString();
+    auto TypeName = Symbol(Expect(Token::Identifier).GetStringView());
     Expect(Token::RightParen);
 
     Expect(Token::LeftCurly);
 
-    StructInitExpression::StrList MemberList;
-    StructInitExpression::ExprPtrList InitList;
+    std::vector<Symbol> MemberList;
+    std::vector<Expression *> InitList;
     while (lexer.Is(Token::Dot) || lexer.Is(Token::Identifier)) {
-      std::string Member = "";
+      Symbol Member;
       if (lexer.Is(Token::Dot)) {
         Lex(); // eat '.'
-        Member = Expect(Token::Identifier).GetString();
+        Member = Symbol(Expect(Token::Identifier).GetStringView());
         Expect(Token::Equal);
       }
 
@@ -901,9 +1097,9 @@ std::unique_ptr<Expression> Parser::ParsePostFixExpression() {
     Expect(Token::RightCurly);
 
     // TODO: do semantic check that the member names are valid
-    return std::make_unique<StructInitExpression>(
-        GetUserDefinedType(TypeName), std::move(InitList),
-        std::move(MemberList));
+    return Ctx.Create<StructInitExpression>(
+        GetUserDefinedType(TypeName), Ctx.CreateList(InitList),
+        Ctx.CreateList(MemberList));
   }
 
   auto Expr = ParsePrimaryExpression();
@@ -914,7 +1110,7 @@ std::unique_ptr<Expression> Parser::ParsePostFixExpression() {
       auto Operation = lexer.GetCurrentToken();
       Lex(); // eat the token
       Expr->SetLValueness(true);
-      Expr = std::make_unique<UnaryExpression>(Operation, std::move(Expr));
+      Expr = Ctx.Create<UnaryExpression>(TC, Operation, Expr);
     }
     // Parse a CallExpression here
     else if (lexer.Is(Token::LeftParen)) {
@@ -922,21 +1118,20 @@ std::unique_ptr<Expression> Parser::ParsePostFixExpression() {
     }
     // parse ArrayExpression
     else if (lexer.Is(Token::LeftBracet)) {
-      Expr = ParseArrayExpression(std::move(Expr));
+      Expr = ParseArrayExpression(Expr);
     }
     // parse StructMemberAccess
     else if (lexer.Is(Token::Dot) || lexer.Is(Token::MinusGreaterThan)) {
       const bool IsArrow = lexer.Is(Token::MinusGreaterThan);
       Lex(); // eat the token
       auto MemberId = Expect(Token::Identifier);
-      auto MemberIdStr = MemberId.GetString();
+      auto MemberIdStr = Symbol(MemberId.GetStringView());
 
-      assert(Expr->GetResultType().IsStruct() && "TODO: emit error");
-      assert((!IsArrow || (IsArrow && Expr->GetResultType().IsPointerType())) &&
+      assert(Expr->GetResultType()->IsStruct() && "TODO: emit error");
+      assert((!IsArrow || (IsArrow && Expr->GetResultType()->IsPointerType())) &&
              "struct pointer expected");
       // find the type of the member
-      auto StructDataTuple = UserDefinedTypes[Expr->GetResultType().GetName()];
-      auto StructType = std::get<0>(StructDataTuple);
+      auto StructDataTuple = UserDefinedTypes[Expr->GetResultType()->GetName()];
       auto StructMemberNames = std::get<1>(StructDataTuple);
 
       size_t i = 0;
@@ -946,9 +1141,8 @@ std::unique_ptr<Expression> Parser::ParsePostFixExpression() {
 
       assert(i <= StructMemberNames.size() && "Member not found");
 
-      Expr = std::make_unique<StructMemberReference>(std::move(Expr),
-                                                     MemberIdStr, i);
-      if (Expr->GetResultType().IsStruct() || Expr->GetResultType().IsArray())
+      Expr = Ctx.Create<StructMemberReference>(Expr, MemberIdStr, i);
+      if (Expr->GetResultType()->IsStruct() || Expr->GetResultType()->IsArray())
         Expr->SetLValueness(true);
     }
   }
@@ -956,7 +1150,7 @@ std::unique_ptr<Expression> Parser::ParsePostFixExpression() {
   return Expr;
 }
 
-std::unique_ptr<Expression> Parser::ParseUnaryExpression() {
+Expression *Parser::ParseUnaryExpression() {
   auto UnaryOperation = lexer.GetCurrentToken();
 
   if (!IsUnaryOperator(UnaryOperation.GetKind()))
@@ -964,75 +1158,104 @@ std::unique_ptr<Expression> Parser::ParseUnaryExpression() {
 
   Lex(); // eat the unary operation char
 
-  std::unique_ptr<Expression> Expr;
+  Expression *Expr;
 
   if (IsUnaryOperator((GetCurrentTokenKind())))
-    return std::make_unique<UnaryExpression>(UnaryOperation,
-                                             std::move(ParseUnaryExpression()));
+    return Ctx.Create<UnaryExpression>(TC, UnaryOperation,
+                                       ParseUnaryExpression());
 
   // TODO: Add semantic check that only pointer types are dereferenced
   Expr = ParsePostFixExpression();
-  return std::make_unique<UnaryExpression>(UnaryOperation,
-                                           std::move(Expr));
-}
-
-static int GetBinOpPrecedence(Token::TokenKind TK) {
-  switch (TK) {
-  case Token::Equal:
-  case Token::PlusEqual:
-  case Token::MinusEqual:
-  case Token::AstrixEqual:
-  case Token::ForwardSlashEqual:
-    return 10;
-  case Token::DoubleAnd:
-    return 20;
-  case Token::And:
-    return 30;
-  case Token::DoubleEqual:
-  case Token::BangEqual:
-  case Token::GreaterEqual:
-  case Token::LessEqual:
-    return 40;
-  case Token::LessThan:
-  case Token::GreaterThan:
-    return 50;
-  case Token::LessThanLessThan:
-  case Token::GreaterThanGreaterThan:
-    return 60;
-  case Token::Plus:
-  case Token::Minus:
-    return 70;
-  case Token::Astrix:
-  case Token::ForwardSlash:
-  case Token::Percent:
-    return 80;
-  default:
-    return -1;
-  }
+  return Ctx.Create<UnaryExpression>(TC, UnaryOperation, Expr);
 }
 
-std::unique_ptr<Expression> Parser::ParseBinaryExpression() {
-  auto LeftExpression = ParseUnaryExpression();
-  assert(LeftExpression && "Cannot be NULL");
-
-  // TODO: see other call sites...
-  if (lexer.Is(Token::QuestionMark))
-    LeftExpression = ParseTernaryExpression(std::move(LeftExpression));
-
-  return ParseBinaryExpressionRHS(0, std::move(LeftExpression));
-}
+/// The precedence and associativity of a binary operator, the ternary
+/// operator or an assignment. A higher precedence binds tighter, 0 is not an
+/// operator.
+struct BinaryOperatorInfo {
+  unsigned Precedence;
+  bool RightAssociative;
+
+  bool IsOperator() const { return Precedence != 0; }
+};
+
+/// The operators of ParseBinaryExpression by token kind, the rest of the
+/// kinds are not operators. The ternary operator and the assignments share the
+/// lowest precedence and are right associative, so "c ? a : b = 1" assigns to
+/// b and "a = c ? 1 : 2" assigns the ternary expression.
+static constexpr auto BinaryOperators = [] {
+  std::array<BinaryOperatorInfo, Token::NumKinds> Table{};
+  for (auto Kind : {Token::Equal, Token::PlusEqual, Token::MinusEqual,
+                    Token::AstrixEqual, Token::ForwardSlashEqual,
+                    Token::QuestionMark})
+    Table[Kind] = {10, true};
+  Table[Token::DoubleAnd] = {20};
+  Table[Token::And] = {30};
+  Table[Token::DoubleEqual] = Table[Token::BangEqual] = {40};
+  for (auto Kind : {Token::LessThan, Token::GreaterThan, Token::LessEqual,
+                    Token::GreaterEqual})
+    Table[Kind] = {50};
+  Table[Token::LessThanLessThan] = Table[Token::GreaterThanGreaterThan] = {60};
+  Table[Token::Plus] = Table[Token::Minus] = {70};
+  Table[Token::Astrix] = Table[Token::ForwardSlash] = Table[Token::Percent] =
+      {80};
+  return Table;
+}();
+
+// <BinaryExpression> ::= <UnaryExpression>
+//                        { <BinaryOperator> <UnaryExpression>
+//                        | '?' <Expression> ':' <UnaryExpression> }*
+//
+// The operators whose right operand is not complete yet are kept on an
+// explicit stack instead of recursing, so a long expression, like an unrolled
+// polynomial, cannot overflow the stack of the process.
+Expression *Parser::ParseBinaryExpression() {
+  struct PendingOperator {
+    Expression *LeftExpression;
+    Token Operator;
+    unsigned Precedence;
+    /// The second operand of a ternary operator.
+    Expression *TrueExpression;
+  };
+  std::vector<PendingOperator> Pending;
+
+  auto Operand = ParseUnaryExpression();
+  assert(Operand && "Cannot be NULL");
 
-std::unique_ptr<Expression>
-Parser::ParseBinaryExpressionRHS(int Precedence,
-                                 std::unique_ptr<Expression> LeftExpression) {
   while (true) {
-    int TokenPrecedence = GetBinOpPrecedence(GetCurrentTokenKind());
+    auto Info = BinaryOperators[GetCurrentTokenKind()];
+
+    // the pending operators binding tighter than the next one have their
+    // right operand, at the end all of them
+    while (!Pending.empty() &&
+           (!Info.IsOperator() || Pending.back().Precedence > Info.Precedence ||
+            (Pending.back().Precedence == Info.Precedence &&
+             !Info.RightAssociative))) {
+      auto &Top = Pending.back();
+      if (Top.Operator.GetKind() == Token::QuestionMark)
+        Operand = Ctx.Create<TernaryExpression>(Top.LeftExpression,
+                                                Top.TrueExpression, Operand);
+      else
+        Operand =
+            CreateBinaryExpression(Top.LeftExpression, Top.Operator, Operand);
+      Pending.pop_back();
+    }
 
-    if (TokenPrecedence < Precedence)
-      return LeftExpression;
+    if (!Info.IsOperator())
+      return Operand;
 
     Token BinaryOperator = Lex();
 
+    if (BinaryOperator.GetKind() == Token::QuestionMark) {
+      auto TrueExpression = ParseExpression();
+      Expect(Token::Colon);
+      Pending.push_back(
+          {Operand, BinaryOperator, Info.Precedence, TrueExpression});
+      Operand = ParseUnaryExpression();
+      continue;
+    }
+
+    auto LeftExpression = Operand;
     auto RightExpression = ParseUnaryExpression();
 
     bool IsArithmetic = false;
@@ -1048,23 +1271,23 @@ Parser::ParseBinaryExpressionRHS(int Precedence,
     }
 
     if (IsArithmetic &&
-        Type::IsSmallerThanInt(LeftExpression->GetResultType().GetTypeVariant())) {
-      LeftExpression = std::make_unique<ImplicitCastExpression>(
-          std::move(LeftExpression), Type(Type::Int));
+        Type::IsSmallerThanInt(LeftExpression->GetResultType()->GetTypeVariant())) {
+      LeftExpression = Ctx.Create<ImplicitCastExpression>(
+          LeftExpression, TC.Get(Type::Int));
     }
 
     if (IsArithmetic &&
-        Type::IsSmallerThanInt(RightExpression->GetResultType().GetTypeVariant())) {
-      RightExpression = std::make_unique<ImplicitCastExpression>(
-          std::move(RightExpression), Type(Type::Int));
+        Type::IsSmallerThanInt(RightExpression->GetResultType()->GetTypeVariant())) {
+      RightExpression = Ctx.Create<ImplicitCastExpression>(
+          RightExpression, TC.Get(Type::Int));
     }
 
     // In case of an assignment check if the left operand since it should be an
     // lvalue. Which is either an identifier reference or an array expression.
     if (BinaryOperator.GetKind() == Token::Equal &&
-        !dynamic_cast<ReferenceExpression *>(LeftExpression.get()) &&
-        !dynamic_cast<ArrayExpression *>(LeftExpression.get()) &&
-        !dynamic_cast<StructMemberReference *>(LeftExpression.get()))
+        !Isa<ReferenceExpression>(LeftExpression) &&
+        !Isa<ArrayExpression>(LeftExpression) &&
+        !Isa<StructMemberReference>(LeftExpression))
       // TODO: Since now we have ImplicitCast nodes we have to either check if
       // the castable object is an lv....
       EmitError("lvalue required as left operand of assignment", lexer,
@@ -1076,93 +1299,69 @@ Parser::ParseBinaryExpressionRHS(int Precedence,
     // FIX-ME: Should be solved in a better way. Seems like LLVM using
     // ImplicitCast for this purpose as well. Should investigate that solution.
     if (BinaryOperator.GetKind() == Token::Equal) {
-      if (auto LE = dynamic_cast<ArrayExpression *>(LeftExpression.get()))
+      if (auto LE = DynCast<ArrayExpression>(LeftExpression))
         LE->SetLValueness(true);
-      else if (auto LE =
-                   dynamic_cast<ReferenceExpression *>(LeftExpression.get()))
+      else if (auto LE = DynCast<ReferenceExpression>(LeftExpression))
         LE->SetLValueness(true);
-      else if (auto LE =
-          dynamic_cast<StructMemberReference *>(LeftExpression.get()))
+      else if (auto LE = DynCast<StructMemberReference>(LeftExpression))
         LE->SetLValueness(true);
     }
 
-    int NextTokenPrec = GetBinOpPrecedence(GetCurrentTokenKind());
+    Pending.push_back({LeftExpression, BinaryOperator, Info.Precedence, nullptr});
+    Operand = RightExpression;
+  }
+}
 
-    int Associviaty = 1; // left
+Expression *Parser::CreateBinaryExpression(Expression *LeftExpression,
+                                           Token BinaryOperator,
+                                           Expression *RightExpression) {
+  // Implicit cast insertion if needed.
+  auto LeftType = LeftExpression->GetResultType()->GetTypeVariant();
+  auto RightType = RightExpression->GetResultType()->GetTypeVariant();
+
+  // if its a modulo operation
+  if (BinaryOperator.GetKind() == Token::Percent) {
+    // then both side should be an integer type without a casting
+    if (LeftType != Type::Int || RightType != Type::Int)
+      // TODO: fix this semantic check
+      ;//EmitError("Modulo operator can only operate on integers", lexer,
+       //         BinaryOperator);
+  }
+  // Having different types.
+  else if (LeftType != RightType &&
+           !Type::OnlySigndnessDifference(LeftType, RightType)) {
+    // if an assingment, then try to cast the right hand side to type of the
+    // left hand side
     if (BinaryOperator.GetKind() == Token::Equal) {
-      Associviaty = 0; // right
-      NextTokenPrec++;
-    }
-    if (TokenPrecedence < NextTokenPrec)
-      RightExpression = ParseBinaryExpressionRHS(TokenPrecedence + Associviaty,
-                                                 std::move(RightExpression));
-
-    // Implicit cast insertion if needed.
-    auto LeftType = LeftExpression->GetResultType().GetTypeVariant();
-    auto RightType = RightExpression->GetResultType().GetTypeVariant();
-
-    // if its a modulo operation
-    if (BinaryOperator.GetKind() == Token::Percent) {
-      // then both side should be an integer type without a casting
-      if (LeftType != Type::Int || RightType != Type::Int)
-        // TODO: fix this semantic check
-        ;//EmitError("Modulo operator can only operate on integers", lexer,
-         //         BinaryOperator);
-    }
-    // Having different types.
-    else if (LeftType != RightType &&
-             !Type::OnlySigndnessDifference(LeftType, RightType)) {
-      // if an assingment, then try to cast the right hand side to type of the
-      // left hand side
-      if (BinaryOperator.GetKind() == Token::Equal) {
-        if (!Type::IsImplicitlyCastable(RightType, LeftType))
-          EmitError("Type mismatch", lexer, BinaryOperator);
-        else {
-          RightExpression = std::make_unique<ImplicitCastExpression>(
-              std::move(RightExpression), LeftType);
-        }
-      }
-      // Otherwise cast the one with lower conversion rank to the higher one
+      if (!Type::IsImplicitlyCastable(RightType, LeftType))
+        EmitError("Type mismatch", lexer, BinaryOperator);
       else {
-        auto DesiredType =
-            Type::GetStrongestType(LeftType, RightType).GetTypeVariant();
-
-        // If left hand side needs the conversion
-        if (LeftType != DesiredType)
-          LeftExpression = std::make_unique<ImplicitCastExpression>(
-              std::move(LeftExpression), DesiredType);
-        else // if the right one
-          RightExpression = std::make_unique<ImplicitCastExpression>(
-              std::move(RightExpression), DesiredType);
+        RightExpression = Ctx.Create<ImplicitCastExpression>(
+            RightExpression, TC.Get(LeftType));
       }
     }
-
-    // TODO: This will only work here if the ternary condition was in
-    //  parenthesis, which for the time being is sufficient. Make it work as it
-    //  should.
-    if (lexer.Is(Token::QuestionMark))
-      RightExpression = ParseTernaryExpression(std::move(RightExpression));
-
-    LeftExpression = std::make_unique<BinaryExpression>(
-        std::move(LeftExpression), BinaryOperator, std::move(RightExpression));
+    // Otherwise cast the one with lower conversion rank to the higher one
+    else {
+      auto DesiredType = Type::GetStrongestType(LeftType, RightType);
+
+      // If left hand side needs the conversion
+      if (LeftType != DesiredType)
+        LeftExpression = Ctx.Create<ImplicitCastExpression>(
+            LeftExpression, TC.Get(DesiredType));
+      else // if the right one
+        RightExpression = Ctx.Create<ImplicitCastExpression>(
+            RightExpression, TC.Get(DesiredType));
+    }
   }
-}
-
-// <TernaryExpression> ::= <Expression> '?' <Expression> ':' <Expression>
-std::unique_ptr<Expression>
-Parser::ParseTernaryExpression(std::unique_ptr<Expression> Condition) {
-  Expect(Token::QuestionMark);
-  auto TrueExpr = ParseExpression();
-  Expect(Token::Colon);
-  auto FalseExpr = ParseExpression();
 
-  return std::make_unique<TernaryExpression>(Condition, TrueExpr, FalseExpr);
+  return Ctx.Create<BinaryExpression>(TC, LeftExpression, BinaryOperator,
+                                      RightExpression);
 }
 
 // <PrimaryExpression> ::= <IdentifierExpression>
 //                       | '(' <Expression> ')'
 //                       | <ConstantExpression>
-std::unique_ptr<Expression> Parser::ParsePrimaryExpression() {
+Expression *Parser::ParsePrimaryExpression() {
   if (lexer.Is(Token::LeftParen)) {
     Lex();
     auto Expression = ParseExpression();
@@ -1179,7 +1378,7 @@ std::unique_ptr<Expression> Parser::ParsePrimaryExpression() {
 
 // <ConstantExpression> ::= -?[1-9][0-9]*
 //                        | -?[0-9]+.[0-9]+
-std::unique_ptr<Expression> Parser::ParseConstantExpression() {
+Expression *Parser::ParseConstantExpression() {
   // Handle enumerator constant cases
   bool IsNegative = false;
   if (lexer.Is(Token::Minus)) {
@@ -1189,11 +1388,11 @@ std::unique_ptr<Expression> Parser::ParseConstantExpression() {
 
   if (lexer.Is(Token::Identifier)) {
     auto Id = Expect(Token::Identifier);
-    auto IdStr = Id.GetString();
+    auto IdStr = Symbol(Id.GetStringView());
 
     if (auto SymEntry = SymTabStack.Contains(IdStr)) {
-      if (auto Val = std::get<2>(SymEntry.value()); !Val.IsEmpty()) {
-        auto Enum = std::make_unique<IntegerLiteralExpression>(Val.GetIntVal());
+      if (auto Val = std::get<2>(*SymEntry); !Val.IsEmpty()) {
+        auto Enum = Ctx.Create<IntegerLiteralExpression>(TC, Val.GetIntVal());
         if (IsNegative)
           Enum->SetValue(-Enum->GetSIntValue());
         return Enum;
@@ -1202,7 +1401,8 @@ std::unique_ptr<Expression> Parser::ParseConstantExpression() {
     } else
       assert(!"Not an enumerator constant");
   } else if (lexer.Is(Token::Integer)) {
-    auto IntLit = std::make_unique<IntegerLiteralExpression>(ParseIntegerConstant());
+    auto IntLit =
+        Ctx.Create<IntegerLiteralExpression>(TC, ParseIntegerConstant());
     if (IsNegative)
       IntLit->SetValue(-IntLit->GetSIntValue());
     // TODO: currently 1 ull would be valid since the lexer will ignore the
@@ -1211,43 +1411,47 @@ std::unique_ptr<Expression> Parser::ParseConstantExpression() {
       auto Str = GetCurrentToken().GetString();
       if (Str == "u") {
         Lex();
-        IntLit->SetType(Type::UnsignedInt);
+        IntLit->SetType(TC.Get(Type::UnsignedInt));
       } else if (Str == "l") {
         Lex();
-        IntLit->SetType(Type::Long);
+        IntLit->SetType(TC.Get(Type::Long));
       } else if (Str == "ul") {
         Lex();
-        IntLit->SetType(Type::UnsignedLong);
+        IntLit->SetType(TC.Get(Type::UnsignedLong));
       } else if (Str == "ll") {
         Lex();
-        IntLit->SetType(Type::LongLong);
+        IntLit->SetType(TC.Get(Type::LongLong));
       } else if (Str == "ull") {
         Lex();
-        IntLit->SetType(Type::UnsignedLongLong);
+        IntLit->SetType(TC.Get(Type::UnsignedLongLong));
       }
     }
     return IntLit;
   } else {
-    auto FPLit = std::make_unique<FloatLiteralExpression>(ParseRealConstant());
+    auto FPLit = Ctx.Create<FloatLiteralExpression>(TC, ParseRealConstant());
     if (IsNegative)
       FPLit->SetValue(-FPLit->GetValue());
     return FPLit;
   }
 }
 
-std::unique_ptr<Expression> Parser::ParseCallExpression(Token Id) {
+Expression *Parser::ParseCallExpression(Token Id) {
   // FIXME: Make this a semantic check
   assert(Id.GetKind() == Token::Identifier && "Identifier expected");
   Lex(); // eat the '('
 
-  Type FuncType;
+  const Type *FuncType = TypeContext::GetInvalid();
 
-  if (auto SymEntry = SymTabStack.Contains(Id.GetString()))
-    FuncType = std::get<1>(SymEntry.value());
+  auto Name = Symbol(Id.GetStringView());
+  if (auto SymEntry = SymTabStack.Contains(Name))
+    FuncType = std::get<1>(*SymEntry);
   else
     UndefinedSymbolError(Id, lexer);
 
-  std::vector<std::unique_ptr<Expression>> CallArgs;
+  if (LazyParsing)
+    CalledFunctions.push_back(Name);
+
+  std::vector<Expression *> CallArgs;
 
   if (lexer.IsNot(Token::RightParen))
     CallArgs.push_back(ParseExpression());
@@ -1259,22 +1463,24 @@ std::unique_ptr<Expression> Parser::ParseCallExpression(Token Id) {
 
   // Currently a function without argument is actually a function with
   // a type of ...(void), which is a special case checked first.
-  auto FuncArgTypes = FuncType.GetArgTypes();
+  auto &FuncArgTypes = FuncType->GetArgTypes();
   auto FuncArgNum = FuncArgTypes.size();
   if (!(CallArgs.size() == 0 && FuncArgNum == 1 &&
-        FuncArgTypes[0] == Type::Void)) {
+        FuncArgTypes[0] == TC.Get(Type::Void))) {
     if (FuncArgNum != CallArgs.size())
-      EmitError("arguments number mismatch", lexer);
+      EmitError("arguments number mismatch", lexer, Id);
 
     for (size_t i = 0; i < FuncArgNum; i++) {
       auto CallArgType = CallArgs[i]->GetResultType();
 
-      // If the ith argument type is not matching the expected one
-      if (CallArgType != FuncArgTypes[i]) {
+      // If the ith argument type is not matching the expected one. The
+      // qualifiers do not matter, the argument is copied anyway.
+      if (TC.GetUnqualified(CallArgType) !=
+          TC.GetUnqualified(FuncArgTypes[i])) {
         // Cast if allowed
         if (Type::IsImplicitlyCastable(CallArgType, FuncArgTypes[i]))
-          CallArgs[i] = std::make_unique<ImplicitCastExpression>(
-              std::move(CallArgs[i]), FuncArgTypes[i]);
+          CallArgs[i] = Ctx.Create<ImplicitCastExpression>(
+              CallArgs[i], FuncArgTypes[i]);
         else // otherwise its an error
           ;//EmitError("argument type mismatch", lexer);
       }
@@ -1283,16 +1489,15 @@ std::unique_ptr<Expression> Parser::ParseCallExpression(Token Id) {
 
   Expect(Token::RightParen);
 
-  return std::make_unique<CallExpression>(Id.GetString(), CallArgs, FuncType);
+  return Ctx.Create<CallExpression>(Name, Ctx.CreateList(CallArgs), FuncType);
 }
 
-std::unique_ptr<Expression>
-Parser::ParseArrayExpression(std::unique_ptr<Expression> Base) {
+Expression *Parser::ParseArrayExpression(Expression *Base) {
   Lex();
   auto IndexExpr = ParseExpression();
   Expect(Token::RightBracet);
 
-  Type type = Base->GetResultType();
+  Type type = *Base->GetResultType();
 
   /// Remove the first N dimensions from the actual type. Example:
   /// ActualType is 'int arr[5][10]' and our reference is 'arr[0]'
@@ -1306,30 +1511,30 @@ Parser::ParseArrayExpression(std::unique_ptr<Expression> Base) {
     type.DecrementPointerLevel();
 
   Base->SetLValueness(true);
-  return std::make_unique<ArrayExpression>(Base, IndexExpr, type);
+  return Ctx.Create<ArrayExpression>(Base, IndexExpr, TC.Get(type));
 }
 
 // <IdentifierExpression> ::= Identifier
-std::unique_ptr<Expression> Parser::ParseIdentifierExpression() {
+Expression *Parser::ParseIdentifierExpression() {
   auto Id = Expect(Token::Identifier);
 
   // Identifier case
-  auto RE = std::make_unique<ReferenceExpression>(Id);
-  auto IdStr = Id.GetString();
+  auto RE = Ctx.Create<ReferenceExpression>(Id);
+  auto IdStr = RE->GetIdentifier();
 
   if (auto SymEntry = SymTabStack.Contains(IdStr)) {
     // If the symbol value is a know constant like in case of enumerators, then
     // return just a constant expression
     // TODO: Maybe do ths check earlier to save ourself from creating RE for
     // nothing
-    if (auto Val = std::get<2>(SymEntry.value()); !Val.IsEmpty())
-      return std::make_unique<IntegerLiteralExpression>(Val.GetIntVal());
+    if (auto Val = std::get<2>(*SymEntry); !Val.IsEmpty())
+      return Ctx.Create<IntegerLiteralExpression>(TC, Val.GetIntVal());
 
-    auto Type = std::get<1>(SymEntry.value());
+    auto Type = std::get<1>(*SymEntry);
     RE->SetType(Type);
   } else if (UserDefinedTypes.count(IdStr) > 0) {
     auto Type = std::get<0>(UserDefinedTypes[IdStr]);
-    RE->SetType(std::move(Type));
+    RE->SetType(Type);
   }
   else
     UndefinedSymbolError(Id, lexer);
@@ -1341,27 +1546,27 @@ std::unique_ptr<Expression> Parser::ParseIdentifierExpression() {
 //                                      <InitializerListExpression>}
 //                                     {',' {<ConstantExpression> |
 //                                      <InitializerListExpression>} }* '}'
-std::unique_ptr<Expression> Parser::ParseInitializerListExpression() {
+Expression *Parser::ParseInitializerListExpression() {
   Expect(Token::LeftCurly);
-  std::unique_ptr<Expression> E;
+  Expression *E;
   if (lexer.Is(Token::LeftCurly))
     E = ParseInitializerListExpression();
   else
     E = ParseConstantExpression();
   assert(E && "Cannot be null");
 
-  std::vector<std::unique_ptr<Expression>> ExprList;
-  ExprList.push_back(std::move(E));
+  std::vector<Expression *> ExprList;
+  ExprList.push_back(E);
 
   while (lexer.Is(Token::Comma)) {
     Lex(); // eat ','
     if (lexer.Is(Token::LeftCurly))
-      ExprList.push_back(std::move(ParseInitializerListExpression()));
+      ExprList.push_back(ParseInitializerListExpression());
     else
-      ExprList.push_back(std::move(ParseConstantExpression()));
+      ExprList.push_back(ParseConstantExpression());
   }
 
   Expect(Token::RightCurly);
 
-  return std::make_unique<InitializerListExpression>(std::move(ExprList));
+  return Ctx.Create<InitializerListExpression>(Ctx.CreateList(ExprList));
 }
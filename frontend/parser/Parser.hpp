@@ -8,19 +8,49 @@
 #include "SymbolTable.hpp"
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+class ThreadPool;
+
 class Parser {
 public:
-  std::unique_ptr<Node> Parse();
+  Node *Parse();
 
   Parser() = delete;
 
-  Parser(std::vector<std::string> &s, IRFactory *IRF) : lexer(s), IRF(IRF) {}
+  Parser(SourceManager &SM, SourceManager::BufferID ID, ASTContext &Ctx,
+         IRFactory *IRF)
+      : Parser(SM, PieceTable(SM, ID), Ctx, IRF) {}
+
+  /// Parse the preprocessed @Text.
+  Parser(SourceManager &SM, PieceTable Text, ASTContext &Ctx, IRFactory *IRF)
+      : lexer(SM, std::move(Text)), Ctx(Ctx), TC(Ctx.GetTypeContext()),
+        IRF(IRF) {}
+
+  /// Parse the text pulled from @Source while parsing.
+  Parser(SourceManager &SM, PieceSource &Source, ASTContext &Ctx,
+         IRFactory *IRF)
+      : lexer(SM, Source), Ctx(Ctx), TC(Ctx.GetTypeContext()), IRF(IRF) {}
+
+  /// Parse the tokens pulled from @Tokens while parsing.
+  Parser(SourceManager &SM, TokenSource &Tokens, ASTContext &Ctx,
+         IRFactory *IRF)
+      : lexer(SM, Tokens), Ctx(Ctx), TC(Ctx.GetTypeContext()), IRF(IRF) {}
+
+  /// Only brace match the bodies of the static functions and record their
+  /// tokens. At the end, parse the ones called from a parsed body and drop
+  /// the rest. The externally visible functions are always needed.
+  void EnableLazyParsing() { LazyParsing = true; }
+
+  /// Only brace match every function body at first, then parse them at the
+  /// end on @NumThreads threads, or as many as the hardware threads if 0. A
+  /// body sees the globals and types declared before it.
+  void EnableParallelParsing(unsigned NumThreads);
 
   Token Lex() { return lexer.Lex(); }
 
-  Token GetCurrentToken() { return lexer.GetCurrentToken(); }
+  const Token &GetCurrentToken() { return lexer.GetCurrentToken(); }
 
   Token::TokenKind GetCurrentTokenKind() {
     return lexer.GetCurrentToken().GetKind();
@@ -30,70 +60,127 @@ public:
 
   /// Helper function to make insertion to the symbol table stack more compact
   /// and readable
-  void InsertToSymTable(const std::string &SymName, Type SymType,
+  void InsertToSymTable(Symbol SymName, const Type *SymType,
                         const bool ToGlobal, ValueType SymValue);
 
-  bool IsUserDefined(std::string Name);
-  Type GetUserDefinedType(std::string Name);
+  bool IsUserDefined(Symbol Name);
+  const Type *GetUserDefinedType(Symbol Name);
 
   unsigned ParseQualifiers();
   Type ParseType(Token::TokenKind tk);
   bool IsTypeSpecifier(Token T);
   bool IsReturnTypeSpecifier(Token T);
 
-  std::unique_ptr<Node> ParseTranslationUnit();
-  std::unique_ptr<Node> ParseExternalDeclaration();
-  std::unique_ptr<FunctionDeclaration>
-  ParseFunctionDeclaration(const Type &ReturnType, const Token &Name);
-  std::unique_ptr<VariableDeclaration> ParseVariableDeclaration();
-  std::unique_ptr<MemberDeclaration> ParseMemberDeclaration();
-  std::unique_ptr<StructDeclaration> ParseStructDeclaration(unsigned Qualifiers);
-  std::unique_ptr<EnumDeclaration> ParseEnumDeclaration(unsigned Qualifiers);
+  Node *ParseTranslationUnit();
+  Node *ParseExternalDeclaration();
+  FunctionDeclaration *ParseFunctionDeclaration(const Type *ReturnType,
+                                                const Token &Name,
+                                                bool IsStatic);
+  void SkipCompoundStatement();
+  void ParseDeferredBodies(std::vector<Statement *> &Declarations);
+  VariableDeclaration *ParseVariableDeclaration();
+  MemberDeclaration *ParseMemberDeclaration();
+  StructDeclaration *ParseStructDeclaration(unsigned Qualifiers);
+  EnumDeclaration *ParseEnumDeclaration(unsigned Qualifiers);
   Node ParseReturnTypeSpecifier();
-  std::vector<std::unique_ptr<FunctionParameterDeclaration>>
-  ParseParameterList();
-  std::unique_ptr<FunctionParameterDeclaration> ParseParameterDeclaration();
+  std::vector<FunctionParameterDeclaration *> ParseParameterList();
+  FunctionParameterDeclaration *ParseParameterDeclaration();
   Type ParseTypeSpecifier();
-  std::unique_ptr<CompoundStatement> ParseCompoundStatement();
-  std::unique_ptr<ReturnStatement> ParseReturnStatement();
-  std::unique_ptr<BreakStatement> ParseBreakStatement();
-  std::unique_ptr<ContinueStatement> ParseContinueStatement();
-  std::unique_ptr<Statement> ParseStatement();
-  std::unique_ptr<ExpressionStatement> ParseExpressionStatement();
-  std::unique_ptr<Expression> ParseExpression();
-  std::unique_ptr<Expression> ParsePostFixExpression();
-  std::unique_ptr<Expression> ParseUnaryExpression();
-  std::unique_ptr<Expression> ParseBinaryExpression();
-  std::unique_ptr<Expression>
-  ParseTernaryExpression(std::unique_ptr<Expression> Condition);
-  std::unique_ptr<Expression>
-  ParseBinaryExpressionRHS(int Precedence, std::unique_ptr<Expression> LHS);
-  std::unique_ptr<Expression> ParseCallExpression(Token ID);
-  std::unique_ptr<Expression> ParseArrayExpression(std::unique_ptr<Expression> Base);
-  std::unique_ptr<Expression> ParseIdentifierExpression();
-  std::unique_ptr<Expression> ParsePrimaryExpression();
-  std::unique_ptr<Expression> ParseInitializerListExpression();
-  std::unique_ptr<WhileStatement> ParseWhileStatement();
-  std::unique_ptr<ForStatement> ParseForStatement();
-  std::unique_ptr<IfStatement> ParseIfStatement();
-  std::unique_ptr<SwitchStatement> ParseSwitchStatement();
-  std::unique_ptr<Expression> ParseConstantExpression();
+  CompoundStatement *ParseCompoundStatement();
+  ReturnStatement *ParseReturnStatement();
+  BreakStatement *ParseBreakStatement();
+  ContinueStatement *ParseContinueStatement();
+  Statement *ParseStatement();
+  ExpressionStatement *ParseExpressionStatement();
+  Expression *ParseExpression();
+  Expression *ParsePostFixExpression();
+  Expression *ParseUnaryExpression();
+  Expression *ParseBinaryExpression();
+  Expression *CreateBinaryExpression(Expression *LHS, Token Operator,
+                                     Expression *RHS);
+  Expression *ParseCallExpression(Token ID);
+  Expression *ParseArrayExpression(Expression *Base);
+  Expression *ParseIdentifierExpression();
+  Expression *ParsePrimaryExpression();
+  Expression *ParseInitializerListExpression();
+  WhileStatement *ParseWhileStatement();
+  ForStatement *ParseForStatement();
+  IfStatement *ParseIfStatement();
+  SwitchStatement *ParseSwitchStatement();
+  Expression *ParseConstantExpression();
   unsigned ParseIntegerConstant();
   double ParseRealConstant();
 
 private:
+  friend class PrecompiledHeader;
+
   Lexer lexer;
+  ASTContext &Ctx;
+  TypeContext &TC;
   SymbolTableStack SymTabStack;
   IRFactory *IRF;
 
   /// Type name to type, and the list of names for the struct field
-  std::map<std::string, std::tuple<Type, std::vector<std::string>>> UserDefinedTypes;
+  std::unordered_map<Symbol, std::tuple<const Type *, std::vector<Symbol>>>
+      UserDefinedTypes;
 
   /// Mapping identifiers to types. Eg: "typedef int i32" -> {"i32", Type::Int}
-  std::map<std::string, Type> TypeDefinitions;
+  std::unordered_map<Symbol, const Type *> TypeDefinitions;
+
+  /// The declarations of the precompiled header, which precede the ones of the
+  /// translation unit.
+  std::vector<Statement *> PrecompiledDeclarations;
+
+  /// The user defined types and the type definitions at a point of the
+  /// parsing. They rarely change after the headers, so a snapshot is shared by
+  /// the deferred bodies until they do.
+  struct TypeTables {
+    decltype(UserDefinedTypes) UserDefined;
+    decltype(TypeDefinitions) Definitions;
+  };
+
+  /// A function body recorded, but not parsed yet, when parsing lazily or in
+  /// parallel.
+  struct DeferredBody {
+    FunctionDeclaration *Function;
+    const Type *ReturnType;
+    bool IsStatic;
+    /// The tokens of the body in DeferredTokens.
+    size_t TokensBegin;
+    size_t TokensEnd;
+    /// The number of globals and the types declared before the body.
+    size_t NumGlobals;
+    std::shared_ptr<const TypeTables> Types;
+    /// The functions called from the body, once it is parsed.
+    std::vector<Symbol> CalledFunctions;
+  };
+
+  /// A parser of the deferred bodies, creating the nodes in @WorkerCtx and the
+  /// types in the TypeContext of @Main.
+  Parser(Parser &Main, ASTContext &WorkerCtx);
+
+  std::shared_ptr<const TypeTables> GetTypesSnapshot();
+
+  /// Parse the deferred bodies @Indices, in parallel if there is a @Pool.
+  void ParseDeferredBodies(const std::vector<size_t> &Indices,
+                           ThreadPool *Pool);
+
+  /// Parse @Deferred, of @Main, with this worker parser.
+  void ParseDeferredBody(const Parser &Main, DeferredBody &Deferred);
+
+  bool LazyParsing = false;
+  /// Parse the bodies in parallel if not 0.
+  unsigned NumThreads = 0;
+  std::vector<DeferredBody> DeferredBodies;
+  std::vector<Token> DeferredTokens;
+  /// The last snapshot of the types, or the one a worker took its types from.
+  std::shared_ptr<const TypeTables> TypesSnapshot;
+  /// The functions called from the bodies parsed, but not looked at yet by
+  /// ParseDeferredBodies, when parsing lazily.
+  std::vector<Symbol> CalledFunctions;
 
   /// Used for determining if implicit cast need or not in return statements
-  Type CurrentFuncRetType = Type::Invalid;
+  const Type *CurrentFuncRetType = TypeContext::GetInvalid();
 
   /// The amount of return seen in the current function being parsed
   unsigned ReturnsNumber = 0;
@@ -1,75 +1,133 @@
 #ifndef SYMBOLTABLE_H
 #define SYMBOLTABLE_H
 
+#include "../../support/Symbol.hpp"
 #include "../ast/Type.hpp"
 #include <cassert>
-#include <optional>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
-/// Holds a stack (vector) of SymbolTables (vector of tuples).
-/// FIXME: An unordered_map would be more appropriate, but
-/// had trouble with it so rather than wasting too much time
-/// with it currently vectors used. Later improve this.
+/// Scoped symbol table of the parser. The bottom scope holds the globals and
+/// every PushSymTable opens a new local scope on top of it.
+///
+/// Each name maps to its innermost local binding, which links to the binding
+/// it shadows, so a lookup is a hash lookup regardless of the number of
+/// scopes and entries. The bindings are kept in declaration order, which
+/// doubles as the undo log of the scopes: PopSymTable only unlinks the
+/// bindings of the popped scope.
 class SymbolTableStack {
 public:
-  using Entry = std::tuple<std::string, Type, ValueType>;
-  using Table = std::vector<Entry>;
+  using Entry = std::tuple<Symbol, const Type *, ValueType>;
 
-  /// Adding the first empty table when constructed
-  SymbolTableStack() { SymTabStack.push_back(Table()); }
+  void PushSymTable() { ScopeStarts.push_back(Bindings.size()); }
 
-  void PushSymTable(Table t = Table()) { SymTabStack.push_back(std::move(t)); }
+  void PopSymTable() {
+    assert(!ScopeStarts.empty() && "Popping the global scope.");
 
-  Table PopSymTable() {
-    assert(SymTabStack.size() > 0 && "Popping item from empty stack.");
-    Table t = SymTabStack[SymTabStack.size() - 1];
-    SymTabStack.pop_back();
-    return t;
-  }
+    for (auto i = Bindings.size(); i-- > ScopeStarts.back();) {
+      auto Name = std::get<0>(Bindings[i].E);
+      if (Bindings[i].Shadowed >= 0)
+        Innermost[Name] = Bindings[i].Shadowed;
+      else
+        Innermost.erase(Name);
+    }
 
-  size_t Size() { return SymTabStack.size(); }
+    Bindings.resize(ScopeStarts.back());
+    ScopeStarts.pop_back();
+  }
 
-  Table &GetTopTable() { return SymTabStack.back(); }
+  /// Number of scopes, including the global one.
+  size_t Size() const { return ScopeStarts.size() + 1; }
 
+  /// Insert @e into the current scope.
   void InsertEntry(const Entry &e) {
-    auto idx = Size() > 0 ? Size() - 1 : 0;
-    SymTabStack[idx].push_back(e);
+    if (ScopeStarts.empty())
+      return InsertGlobalEntry(e);
+
+    auto Name = std::get<0>(e);
+    auto [It, IsNew] = Innermost.try_emplace(Name, Bindings.size());
+    Bindings.push_back({e, IsNew ? -1 : It->second});
+    It->second = Bindings.size() - 1;
   }
 
-  void InsertGlobalEntry(const Entry &e) { SymTabStack[0].push_back(e); }
+  void InsertGlobalEntry(const Entry &e) {
+    Globals[std::get<0>(e)].push_back(e);
+    GlobalOrder.push_back(std::get<0>(e));
+  }
 
-  bool Contains(Entry e) {
-    for (int i = Size() - 1; i >= 0; i--) {
-      auto table = SymTabStack[i];
-      for (int j = table.size() - 1; j >= 0; j--)
-        if (e == table[j])
-          return true;
+  /// Number of global declarations inserted so far.
+  size_t GetNumGlobals() const { return GlobalOrder.size(); }
+
+  /// Insert the global declarations of @From from the @Begin-th until before
+  /// the @End-th, to catch up with the globals @From had at a point. Every
+  /// global of this table must come from @From, in order.
+  void InsertGlobalsOf(const SymbolTableStack &From, size_t Begin,
+                       size_t End) {
+    assert(Begin == GetNumGlobals() && "Globals skipped.");
+    for (auto i = Begin; i < End; i++) {
+      auto Name = From.GlobalOrder[i];
+      auto &Entries = Globals[Name];
+      Entries.push_back(From.Globals.at(Name)[Entries.size()]);
+      GlobalOrder.push_back(Name);
     }
-    return false;
   }
 
-  std::optional<Entry> Contains(const std::string &sym) {
-    for (int i = Size() - 1; i >= 0; i--) {
-      auto table = SymTabStack[i];
-      for (int j = table.size() - 1; j >= 0; j--)
-        if (sym == std::get<0>(table[j]))
-          return table[j];
-    }
-    return std::nullopt;
+  /// Returns the visible declaration of @sym or nullptr if there is none. The
+  /// pointer is invalidated by the next insertion or pop.
+  const Entry *Contains(Symbol sym) const {
+    if (auto It = Innermost.find(sym); It != Innermost.end())
+      return &Bindings[It->second].E;
+    if (auto It = Globals.find(sym); It != Globals.end())
+      return &It->second.back();
+    return nullptr;
   }
 
-  bool ContainsInCurrentScope(Entry e) {
-    auto idx = Size() > 0 ? Size() - 1 : 0;
+  /// Returns true if exactly @e (same name, type and value) is declared in the
+  /// current scope.
+  bool ContainsInCurrentScope(const Entry &e) const {
+    auto Name = std::get<0>(e);
+
+    if (ScopeStarts.empty()) {
+      auto It = Globals.find(Name);
+      if (It == Globals.end())
+        return false;
+      for (auto &Global : It->second)
+        if (Global == e)
+          return true;
+      return false;
+    }
 
-    for (int i = SymTabStack[idx].size() - 1; i >= 0; i--)
-      if (e == SymTabStack[idx][i])
+    auto It = Innermost.find(Name);
+    if (It == Innermost.end())
+      return false;
+    for (int i = It->second; i >= int(ScopeStarts.back());
+         i = Bindings[i].Shadowed)
+      if (Bindings[i].E == e)
         return true;
     return false;
   }
 
+  /// Every global declaration by name, in declaration order.
+  const std::unordered_map<Symbol, std::vector<Entry>> &GetGlobals() const {
+    return Globals;
+  }
+
 private:
-  std::vector<Table> SymTabStack;
+  struct Binding {
+    Entry E;
+    /// Index of the binding of the same name this one hides, or -1.
+    int Shadowed;
+  };
+
+  std::unordered_map<Symbol, std::vector<Entry>> Globals;
+  /// The names of the globals in declaration order.
+  std::vector<Symbol> GlobalOrder;
+  std::vector<Binding> Bindings;
+  std::unordered_map<Symbol, int> Innermost;
+  /// Index of the first binding of each local scope.
+  std::vector<unsigned> ScopeStarts;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,326 @@
+#include "PrecompiledHeader.hpp"
+#include "../ast/AST.hpp"
+#include "../ast/TypeTable.hpp"
+#include "../parser/Parser.hpp"
+#include "../preprocessor/PreProcessor.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sys/stat.h>
+
+static constexpr uint32_t Magic = 0x4843504d; // "MPCH"
+static constexpr uint32_t Version = 1;
+
+/// The kinds of the declarations which can be precompiled.
+enum DeclarationKind : uint8_t { StructDecl, EnumDecl, FunctionDecl, VarDecl };
+
+bool PrecompiledHeader::Emit(const std::string &Path, PreProcessor &PP,
+                             Parser &P, Node *AST, std::ostream &Errors) {
+  BinaryWriter W;
+  W.Write<uint32_t>(Magic);
+  W.Write<uint32_t>(Version);
+
+  // the header itself, to detect if it changed since
+  auto HeaderPath = PP.SM.GetBufferName(PP.MainFile);
+  struct stat HeaderStat;
+  if (stat(HeaderPath.c_str(), &HeaderStat) != 0) {
+    Errors << "Cannot stat the header: " << HeaderPath << std::endl;
+    return false;
+  }
+  W.WriteString(HeaderPath);
+  W.Write<uint64_t>(HeaderStat.st_size);
+  W.Write<int64_t>(HeaderStat.st_mtim.tv_sec);
+  W.Write<int64_t>(HeaderStat.st_mtim.tv_nsec);
+
+  // the files included by the header, their include guard is detected again
+  // when they are loaded
+  W.Write<uint32_t>(PP.Files.size() - PP.Files.count(PP.MainFile));
+  for (auto &[ID, Info] : PP.Files)
+    if (ID != PP.MainFile) {
+      W.WriteString(PP.SM.GetBufferName(ID));
+      W.Write<uint8_t>(Info.IsPragmaOnce);
+    }
+
+  W.Write<uint32_t>(PP.DefinedMacros.size());
+  for (auto &[Name, M] : PP.DefinedMacros) {
+    W.WriteString(Name);
+    W.Write<uint8_t>(M.IsFunctionLike);
+    W.Write<uint32_t>(M.NumParams);
+    W.Write<uint8_t>(M.NeedsRescan);
+    W.Write<uint32_t>(M.Texts.size());
+    for (auto &Text : M.Texts)
+      W.WriteString(Text);
+    W.Write<uint32_t>(M.Params.size());
+    for (auto Param : M.Params)
+      W.Write<uint32_t>(Param);
+  }
+
+  // the parser state refers to the types by their index in the type table,
+  // which is written before it
+  TypeTableWriter Types;
+  BinaryWriter State;
+
+  State.Write<uint32_t>(P.UserDefinedTypes.size());
+  for (auto &[Name, TypeAndMembers] : P.UserDefinedTypes) {
+    auto &[Ty, MemberNames] = TypeAndMembers;
+    State.WriteString(Name.GetString());
+    State.Write<uint32_t>(Types.GetIndex(Ty));
+    State.Write<uint32_t>(MemberNames.size());
+    for (auto MemberName : MemberNames)
+      State.WriteString(MemberName.GetString());
+  }
+
+  State.Write<uint32_t>(P.TypeDefinitions.size());
+  for (auto &[Name, Ty] : P.TypeDefinitions) {
+    State.WriteString(Name.GetString());
+    State.Write<uint32_t>(Types.GetIndex(Ty));
+  }
+
+  auto &Globals = P.SymTabStack.GetGlobals();
+  State.Write<uint32_t>(Globals.size());
+  for (auto &[Name, Entries] : Globals) {
+    State.WriteString(Name.GetString());
+    State.Write<uint32_t>(Entries.size());
+    for (auto &E : Entries) {
+      State.Write<uint32_t>(Types.GetIndex(std::get<1>(E)));
+      auto Value = std::get<2>(E);
+      State.Write<uint8_t>(Value.IsInt() ? 1 : Value.IsFloat() ? 2 : 0);
+      if (Value.IsInt())
+        State.Write<int32_t>(Value.GetIntVal());
+      else if (Value.IsFloat())
+        State.Write<double>(Value.GetFloatVal());
+    }
+  }
+
+  auto &Declarations =
+      static_cast<TranslationUnit *>(AST)->GetDeclarations();
+  State.Write<uint32_t>(Declarations.size());
+  for (auto Decl : Declarations) {
+    if (auto SD = DynCast<StructDeclaration>(Decl)) {
+      State.Write<uint8_t>(StructDecl);
+      State.WriteString(SD->GetName().GetString());
+      State.Write<uint32_t>(Types.GetIndex(SD->GetType()));
+      State.Write<uint32_t>(SD->GetMembers().size());
+      for (auto Member : SD->GetMembers()) {
+        State.WriteString(Member->GetName().GetString());
+        State.Write<uint32_t>(Types.GetIndex(Member->GetType()));
+      }
+    } else if (auto ED = DynCast<EnumDeclaration>(Decl)) {
+      State.Write<uint8_t>(EnumDecl);
+      State.Write<uint32_t>(Types.GetIndex(ED->GetBaseType()));
+      State.Write<uint32_t>(ED->GetEnumerators().size());
+      for (auto &[Name, Value] : ED->GetEnumerators()) {
+        State.WriteString(Name.GetString());
+        State.Write<int32_t>(Value);
+      }
+    } else if (auto FD = DynCast<FunctionDeclaration>(Decl);
+               FD && !FD->GetBody()) {
+      State.Write<uint8_t>(FunctionDecl);
+      State.WriteString(FD->GetName().GetString());
+      State.Write<uint32_t>(Types.GetIndex(FD->GetType()));
+      State.Write<uint32_t>(FD->GetArguments().size());
+      for (auto Param : FD->GetArguments()) {
+        State.WriteString(Param->GetName().GetString());
+        State.Write<uint32_t>(Types.GetIndex(Param->GetType()));
+      }
+    } else if (auto VD = DynCast<VariableDeclaration>(Decl);
+               VD && !VD->GetInitExpr()) {
+      State.Write<uint8_t>(VarDecl);
+      State.WriteString(VD->GetName().GetString());
+      State.Write<uint32_t>(Types.GetIndex(VD->GetType()));
+    } else {
+      Errors << "Only declarations without code can be precompiled, "
+             << HeaderPath << " defines ";
+      if (FD)
+        Errors << "the function '" << FD->GetName().GetString() << "'";
+      else if (VD)
+        Errors << "the initialized variable '" << VD->GetName().GetString()
+               << "'";
+      else
+        Errors << "an unsupported declaration";
+      Errors << std::endl;
+      return false;
+    }
+  }
+
+  Types.Write(W);
+  W.Append(State);
+
+  std::ofstream File(Path, std::ios::binary);
+  File.write(W.GetBuffer().data(), W.GetBuffer().size());
+  if (!File) {
+    Errors << "Cannot write the precompiled header: " << Path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool PrecompiledHeader::Open(SourceManager &SM, const std::string &Path) {
+  auto ID = SM.AddFile(Path);
+  if (!ID)
+    return false;
+
+  this->SM = &SM;
+  Reader = BinaryReader(SM.GetBuffer(*ID));
+  if (Reader.Read<uint32_t>() != Magic || Reader.Read<uint32_t>() != Version)
+    return false;
+
+  HeaderPath = Reader.ReadString();
+  auto Size = Reader.Read<uint64_t>();
+  auto ModificationSec = Reader.Read<int64_t>();
+  auto ModificationNSec = Reader.Read<int64_t>();
+
+  struct stat HeaderStat;
+  return !Reader.HasError() &&
+         stat(std::string(HeaderPath).c_str(), &HeaderStat) == 0 &&
+         uint64_t(HeaderStat.st_size) == Size &&
+         HeaderStat.st_mtim.tv_sec == ModificationSec &&
+         HeaderStat.st_mtim.tv_nsec == ModificationNSec;
+}
+
+bool PrecompiledHeader::LoadPreProcessorState(PreProcessor &PP) {
+  auto Header = SM->AddFile(std::string(HeaderPath));
+  if (!Header)
+    return false;
+  PP.Files[*Header].IsPrecompiled = true;
+
+  for (auto NumFiles = Reader.Read<uint32_t>();
+       NumFiles > 0 && !Reader.HasError(); NumFiles--) {
+    auto Path = Reader.ReadString();
+    auto IsPragmaOnce = Reader.Read<uint8_t>();
+    auto ID = SM->AddFile(std::string(Path));
+    if (!ID)
+      return false;
+
+    auto &Info = PP.Files[*ID];
+    PreProcessor::DetectIncludeGuard(SM->GetBuffer(*ID), Info);
+    Info.IsPragmaOnce = IsPragmaOnce;
+  }
+
+  // the names view the memory mapped file, which is kept by the SourceManager
+  for (auto NumMacros = Reader.Read<uint32_t>();
+       NumMacros > 0 && !Reader.HasError(); NumMacros--) {
+    auto Name = Reader.ReadString();
+    PreProcessor::Macro M;
+    M.IsFunctionLike = Reader.Read<uint8_t>();
+    M.NumParams = Reader.Read<uint32_t>();
+    M.NeedsRescan = Reader.Read<uint8_t>();
+    for (auto NumTexts = Reader.Read<uint32_t>();
+         NumTexts > 0 && !Reader.HasError(); NumTexts--)
+      M.Texts.emplace_back(Reader.ReadString());
+    for (auto NumParams = Reader.Read<uint32_t>();
+         NumParams > 0 && !Reader.HasError(); NumParams--)
+      M.Params.push_back(Reader.Read<uint32_t>());
+
+    if (Reader.HasError() || M.Texts.size() != M.Params.size() + 1 ||
+        std::any_of(M.Params.begin(), M.Params.end(),
+                    [&](unsigned Param) { return Param >= M.NumParams; }))
+      return false;
+    PP.DefinedMacros[Name] = std::move(M);
+  }
+
+  return !Reader.HasError();
+}
+
+Statement *PrecompiledHeader::ReadDeclaration(Parser &P) {
+  auto &Ctx = P.Ctx;
+
+  switch (Reader.Read<uint8_t>()) {
+  case StructDecl: {
+    auto Name = Symbol(Reader.ReadString());
+    auto StructType = Types.ReadType(Reader);
+    std::vector<MemberDeclaration *> Members;
+    for (auto NumMembers = Reader.Read<uint32_t>();
+         NumMembers > 0 && !Reader.HasError(); NumMembers--) {
+      auto MemberName = Symbol(Reader.ReadString());
+      Members.push_back(
+          Ctx.Create<MemberDeclaration>(MemberName, Types.ReadType(Reader)));
+    }
+    return Ctx.Create<StructDeclaration>(Name, Ctx.CreateList(Members),
+                                         StructType);
+  }
+  case EnumDecl: {
+    auto BaseType = Types.ReadType(Reader);
+    std::vector<std::pair<Symbol, int>> Enumerators;
+    for (auto NumEnumerators = Reader.Read<uint32_t>();
+         NumEnumerators > 0 && !Reader.HasError(); NumEnumerators--) {
+      auto Name = Symbol(Reader.ReadString());
+      Enumerators.push_back({Name, Reader.Read<int32_t>()});
+    }
+    return Ctx.Create<EnumDeclaration>(BaseType, Ctx.CreateList(Enumerators));
+  }
+  case FunctionDecl: {
+    auto Name = Symbol(Reader.ReadString());
+    auto FuncType = Types.ReadType(Reader);
+    std::vector<FunctionParameterDeclaration *> Params;
+    for (auto NumParams = Reader.Read<uint32_t>();
+         NumParams > 0 && !Reader.HasError(); NumParams--) {
+      auto Param = Ctx.Create<FunctionParameterDeclaration>();
+      Param->SetName(Symbol(Reader.ReadString()));
+      Param->SetType(Types.ReadType(Reader));
+      Params.push_back(Param);
+    }
+    return Ctx.Create<FunctionDeclaration>(FuncType, Name,
+                                           Ctx.CreateList(Params), nullptr, 0);
+  }
+  case VarDecl: {
+    auto Name = Symbol(Reader.ReadString());
+    return Ctx.Create<VariableDeclaration>(Name, Types.ReadType(Reader));
+  }
+  default:
+    Reader.SetError();
+    return nullptr;
+  }
+}
+
+bool PrecompiledHeader::LoadParserState(Parser &P) {
+  if (!Types.Read(Reader, P.TC))
+    return false;
+
+  for (auto NumTypes = Reader.Read<uint32_t>();
+       NumTypes > 0 && !Reader.HasError(); NumTypes--) {
+    auto Name = Symbol(Reader.ReadString());
+    auto Ty = Types.ReadType(Reader);
+    std::vector<Symbol> MemberNames;
+    for (auto NumMembers = Reader.Read<uint32_t>();
+         NumMembers > 0 && !Reader.HasError(); NumMembers--)
+      MemberNames.emplace_back(Reader.ReadString());
+    P.UserDefinedTypes[Name] = {Ty, std::move(MemberNames)};
+  }
+
+  for (auto NumTypedefs = Reader.Read<uint32_t>();
+       NumTypedefs > 0 && !Reader.HasError(); NumTypedefs--) {
+    auto Name = Symbol(Reader.ReadString());
+    P.TypeDefinitions[Name] = Types.ReadType(Reader);
+  }
+
+  for (auto NumNames = Reader.Read<uint32_t>();
+       NumNames > 0 && !Reader.HasError(); NumNames--) {
+    auto Name = Symbol(Reader.ReadString());
+    for (auto NumEntries = Reader.Read<uint32_t>();
+         NumEntries > 0 && !Reader.HasError(); NumEntries--) {
+      auto Ty = Types.ReadType(Reader);
+      switch (Reader.Read<uint8_t>()) {
+      case 0:
+        P.SymTabStack.InsertGlobalEntry({Name, Ty, ValueType()});
+        break;
+      case 1:
+        P.SymTabStack.InsertGlobalEntry(
+            {Name, Ty, ValueType(unsigned(Reader.Read<int32_t>()))});
+        break;
+      case 2:
+        P.SymTabStack.InsertGlobalEntry(
+            {Name, Ty, ValueType(Reader.Read<double>())});
+        break;
+      default:
+        return false;
+      }
+    }
+  }
+
+  for (auto NumDecls = Reader.Read<uint32_t>();
+       NumDecls > 0 && !Reader.HasError(); NumDecls--)
+    if (auto Decl = ReadDeclaration(P))
+      P.PrecompiledDeclarations.push_back(Decl);
+
+  return !Reader.HasError() && Reader.AtEnd();
+}
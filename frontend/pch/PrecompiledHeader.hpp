@@ -0,0 +1,58 @@
+#ifndef PRECOMPILEDHEADER_H
+#define PRECOMPILEDHEADER_H
+
+#include "../../support/BinaryStream.hpp"
+#include "../ast/TypeTable.hpp"
+#include "../lexer/SourceManager.hpp"
+#include <ostream>
+#include <string>
+#include <string_view>
+
+class Node;
+class Parser;
+class PreProcessor;
+class Statement;
+
+/// The state of the preprocessor and the parser after a header, saved into a
+/// file. A translation unit using the header restores it instead of
+/// preprocessing and parsing the header again.
+///
+/// The file holds the defined macros, the files the header included, the
+/// types, the struct member names, the typedefs, the global symbols and the
+/// declarations of the header. Only declarations without code can be
+/// precompiled: structs, enums, typedefs, function prototypes and global
+/// variables without an initializer.
+class PrecompiledHeader {
+public:
+  /// Save the state of @PP and @P, which parsed the header into @AST, into the
+  /// file @Path. Returns false and reports the problem to @Errors if the
+  /// header has a declaration which cannot be precompiled or the file cannot
+  /// be written.
+  static bool Emit(const std::string &Path, PreProcessor &PP, Parser &P,
+                   Node *AST, std::ostream &Errors);
+
+  /// Memory map the precompiled header @Path with @SM, which keeps it mapped,
+  /// since the restored macros refer to it. Returns false if it cannot be
+  /// opened, it is not a precompiled header or its header changed since. The
+  /// path of the header is resolved the same way as when it was emitted.
+  bool Open(SourceManager &SM, const std::string &Path);
+
+  /// Restore the macros into @PP and make it skip the inclusion of the
+  /// header. Must be called before @PP processes anything.
+  bool LoadPreProcessorState(PreProcessor &PP);
+
+  /// Restore the types, symbols and declarations of the header into @P. The
+  /// declarations are put before the ones of the translation unit. Must be
+  /// called after LoadPreProcessorState and before @P starts parsing.
+  bool LoadParserState(Parser &P);
+
+private:
+  Statement *ReadDeclaration(Parser &P);
+
+  SourceManager *SM = nullptr;
+  BinaryReader Reader{{}};
+  std::string_view HeaderPath;
+  TypeTableReader Types;
+};
+
+#endif
@@ -1,23 +1,46 @@
 #include "PPLexer.hpp"
+#include "../lexer/CharInfo.hpp"
+#include "../lexer/KeywordTable.hpp"
 #include <cassert>
-#include <cctype>
 
-std::unordered_map<std::string, PPToken::PPTokenKind> PPLexer::Keywords =
-    std::unordered_map<std::string, PPToken::PPTokenKind>{
-        {"define", PPToken::Define}, {"include", PPToken::Include},
-    };
+static constexpr KeywordTable<PPToken::PPTokenKind, 9> Keywords({{
+    {"define", PPToken::Define},
+    {"include", PPToken::Include},
+    {"if", PPToken::If},
+    {"ifdef", PPToken::Ifdef},
+    {"ifndef", PPToken::Ifndef},
+    {"elif", PPToken::Elif},
+    {"else", PPToken::Else},
+    {"endif", PPToken::Endif},
+    {"pragma", PPToken::Pragma},
+}});
+
+static_assert(Keywords.IsPerfect(), "No perfect hash found for the keywords");
+
+PPToken::PPTokenKind PPLexer::GetDirectiveKind(std::string_view Line) {
+  assert(!Line.empty() && Line[0] == '#' && "Not a directive");
+
+  size_t Begin = 1;
+  while (Begin < Line.size() && (Line[Begin] == ' ' || Line[Begin] == '\t'))
+    Begin++;
+  auto End = Begin;
+  while (End < Line.size() && IsIdentifierChar(Line[End]))
+    End++;
+
+  return Keywords.Lookup(Line.substr(Begin, End - Begin))
+      .value_or(PPToken::Invalid);
+}
 
-PPLexer::PPLexer(std::string &s) {
+PPLexer::PPLexer(std::string_view s) {
   Source = s;
-  PPTokenBuffer = std::vector<PPToken>();
   LineIndex = 0;
 
   LookAhead(1);
 }
 
 void PPLexer::ConsumeCurrentPPToken() {
-  assert(PPTokenBuffer.size() > 0 && "PPTokenBuffer is empty.");
-  PPTokenBuffer.erase(PPTokenBuffer.begin());
+  assert(!PPTokenBuffer.Empty() && "PPTokenBuffer is empty.");
+  PPTokenBuffer.PopFront();
 }
 
 int PPLexer::GetNextChar() {
@@ -27,7 +50,7 @@ int PPLexer::GetNextChar() {
 }
 
 int PPLexer::GetNextNthCharOnSameLine(unsigned n) {
-  if (LineIndex >= Source.size())
+  if (LineIndex + n >= Source.size())
     return EOF;
   return Source[LineIndex + n];
 }
@@ -41,10 +64,10 @@ std::optional<PPToken> PPLexer::LexIdentifier() {
   unsigned Length = 0;
 
   // Cannot start with a digit
-  if (isdigit(GetNextChar()))
+  if (IsDigit(GetNextChar()))
     return std::nullopt;
 
-  while (isalnum(GetNextChar()) || GetNextChar() == '_') {
+  while (LineIndex < Source.size() && IsIdentifierChar(Source[LineIndex])) {
     Length++;
     EatNextChar();
   }
@@ -52,26 +75,73 @@ std::optional<PPToken> PPLexer::LexIdentifier() {
   if (Length == 0)
     return std::nullopt;
 
-  std::string_view StringValue{&Source[StartLineIndex], Length};
-  return PPToken(PPToken::Identifier, StringValue);
+  auto Word = Source.substr(StartLineIndex, Length);
+  return PPToken(Keywords.Lookup(Word).value_or(PPToken::Identifier), Word);
 }
 
-std::optional<PPToken> PPLexer::LexKeyword() {
-  std::size_t WordEnd =
-      Source.substr(LineIndex).find_first_of("\t\n\v\f\r;: ");
+std::optional<PPToken> PPLexer::LexNumber() {
+  if (!IsDigit(GetNextChar()))
+    return std::nullopt;
 
-  auto Word = Source.substr(LineIndex, WordEnd);
+  // Preprocessing number: digits, letters, '.' and the sign of an exponent,
+  // eg.: 0x1f, 10u, 1.5e-3.
+  unsigned StartLineIndex = LineIndex;
+  int Prev = 0;
+  for (int C = GetNextChar(); C != EOF; C = GetNextChar()) {
+    bool IsExponentSign =
+        (C == '+' || C == '-') &&
+        (Prev == 'e' || Prev == 'E' || Prev == 'p' || Prev == 'P');
+    if (!IsIdentifierChar(C) && C != '.' && !IsExponentSign)
+      break;
+    Prev = C;
+    EatNextChar();
+  }
 
-  if (!Keywords.count(Word))
+  return PPToken(PPToken::Number,
+                 Source.substr(StartLineIndex, LineIndex - StartLineIndex));
+}
+
+std::optional<PPToken> PPLexer::LexQuoted() {
+  int Quote = GetNextChar();
+  if (Quote != '"' && Quote != '\'')
     return std::nullopt;
 
   unsigned StartLineIndex = LineIndex;
+  EatNextChar(); // eat the opening quote
 
-  for (int i = Word.length(); i > 0; i--)
+  // an unterminated literal ends at the end of the line
+  for (int C = GetNextChar(); C != EOF && C != '\n'; C = GetNextChar()) {
     EatNextChar();
+    if (C == Quote)
+      break;
+    if (C == '\\' && GetNextChar() != EOF)
+      EatNextChar(); // the escaped character cannot end the literal
+  }
+
+  return PPToken(Quote == '"' ? PPToken::StringLiteral : PPToken::CharLiteral,
+                 Source.substr(StartLineIndex, LineIndex - StartLineIndex));
+}
 
-  std::string_view StringValue{&Source[StartLineIndex], Word.length()};
-  return PPToken(PPLexer::Keywords[Word], StringValue);
+void PPLexer::SkipWhitespaceAndComments() {
+  for (int C = GetNextChar(); C != EOF; C = GetNextChar()) {
+    if (IsWhitespace(C)) {
+      EatNextChar();
+      continue;
+    }
+
+    if (C != '/')
+      return;
+
+    if (GetNextNthCharOnSameLine(1) == '/') {
+      auto LineEnd = Source.find('\n', LineIndex);
+      LineIndex = LineEnd == std::string_view::npos ? Source.size() : LineEnd;
+    } else if (GetNextNthCharOnSameLine(1) == '*') {
+      auto CommentEnd = Source.find("*/", LineIndex + 2);
+      LineIndex = CommentEnd == std::string_view::npos ? Source.size()
+                                                       : CommentEnd + 2;
+    } else
+      return;
+  }
 }
 
 std::optional<PPToken> PPLexer::LexSymbol() {
@@ -82,7 +152,7 @@ std::optional<PPToken> PPLexer::LexSymbol() {
     PPTokenKind = PPToken::Dot;
     break;
   case ',':
-    PPTokenKind = PPToken::Colon;
+    PPTokenKind = PPToken::Comma;
     break;
   case '#':
     PPTokenKind = PPToken::Hashtag;
@@ -93,70 +163,69 @@ std::optional<PPToken> PPLexer::LexSymbol() {
   case ')':
     PPTokenKind = PPToken::RightParen;
     break;
-  case '"':
-    PPTokenKind = PPToken::DoubleQuote;
-    break;
   default:
     return std::nullopt;
     break;
   }
 
-  std::string_view StringValue{&Source[LineIndex], 1};
-  auto Result = PPToken(PPTokenKind, StringValue);
+  auto Result = PPToken(PPTokenKind, Source.substr(LineIndex, 1));
 
   EatNextChar();
 
   return Result;
 }
 
-PPToken PPLexer::LookAhead(unsigned n) {
+const PPToken &PPLexer::LookAhead(unsigned n) {
+  assert(n > 0 && n <= MaxLookAhead && "Invalid lookahead.");
+
   // fill in the PPTokenBuffer to have at least n element
-  for (size_t i = PPTokenBuffer.size(); i < n; i++)
-    PPTokenBuffer.push_back(Lex(true));
+  while (PPTokenBuffer.Size() < n)
+    PPTokenBuffer.PushBack(LexPPToken());
 
   return PPTokenBuffer[n - 1];
 }
 
 bool PPLexer::Is(PPToken::PPTokenKind tk) {
-  // fill in the buffer with one token if it is empty
-  if (PPTokenBuffer.size() == 0)
-    LookAhead(1);
-
   return GetCurrentPPToken().GetKind() == tk;
 }
 
 bool PPLexer::IsNot(PPToken::PPTokenKind tk) { return !Is(tk); }
 
-PPToken PPLexer::Lex(bool LookAhead) {
+PPToken PPLexer::Lex() {
   // if the PPTokenBuffer not empty then return the PPToken from there
-  // and remove it from the stack
-  if (PPTokenBuffer.size() > 0 && !LookAhead) {
-    auto CurrentPPToken = GetCurrentPPToken();
+  // and remove it from the queue
+  if (!PPTokenBuffer.Empty()) {
+    auto CurrentPPToken = PPTokenBuffer.Front();
     ConsumeCurrentPPToken();
     return CurrentPPToken;
   }
 
-  int CurrentCharacter = GetNextChar();
-  std::string WhiteSpaceChars("\t\n\v\f\r ");
+  return LexPPToken();
+}
 
-  // consume white space characters
-  while (WhiteSpaceChars.find(CurrentCharacter) != std::string::npos) {
-    EatNextChar();
-    CurrentCharacter = GetNextChar();
-  }
+PPToken PPLexer::LexPPToken() {
+  SkipWhitespaceAndComments();
 
-  if (CurrentCharacter == EOF)
+  if (GetNextChar() == EOF)
     return PPToken(PPToken::EndOfFile);
 
-  auto Result = LexKeyword();
-
-  if (!Result)
-    Result = LexSymbol();
-  if (!Result)
+  // the first character decides which kind of token it can be
+  auto CurrentCharacter = GetNextChar();
+  std::optional<PPToken> Result;
+  if (CurrentCharacter == '"' || CurrentCharacter == '\'')
+    Result = LexQuoted();
+  else if (IsDigit(CurrentCharacter))
+    Result = LexNumber();
+  else if (IsIdentifierChar(CurrentCharacter))
     Result = LexIdentifier();
+  else
+    Result = LexSymbol();
 
   if (Result)
     return Result.value();
 
-  return PPToken(PPToken::Invalid);
+  // every other character is a token on its own
+  auto Punctuator = PPToken(PPToken::Punctuator, Source.substr(LineIndex, 1));
+  EatNextChar();
+  return Punctuator;
 }
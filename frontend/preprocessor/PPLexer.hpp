@@ -1,11 +1,12 @@
 #ifndef PPLEXER_H
 #define PPLEXER_H
 
+#include "../lexer/TokenQueue.hpp"
 #include "PPToken.hpp"
 #include <cassert>
 #include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 class PPLexer {
@@ -18,15 +19,17 @@ public:
   void EatNextChar();
 
   std::optional<PPToken> LexIdentifier();
-  std::optional<PPToken> LexKeyword();
+  std::optional<PPToken> LexNumber();
+  /// Lex a string or character literal, including the quotes.
+  std::optional<PPToken> LexQuoted();
   std::optional<PPToken> LexSymbol();
-  PPToken LookAhead(unsigned n);
-  PPToken GetCurrentPPToken() { return LookAhead(1); }
+  const PPToken &LookAhead(unsigned n);
+  const PPToken &GetCurrentPPToken() { return LookAhead(1); }
   bool Is(PPToken::PPTokenKind tk);
   bool IsNot(PPToken::PPTokenKind tk);
 
-  std::string &GetSource() { return Source; }
-  std::string GetRemainingText() {
+  std::string_view GetSource() { return Source; }
+  std::string_view GetRemainingText() {
     if (LineIndex > Source.length())
       return "";
     return Source.substr(LineIndex);
@@ -34,14 +37,29 @@ public:
 
   unsigned GetLineNum() const { return LineIndex + 1; }
 
-  PPToken Lex(bool LookAhead = false);
+  /// Returns the next token and consumes it.
+  PPToken Lex();
 
-  PPLexer(std::string &s);
+  /// Returns the keyword naming the directive in @Line, which starts with a
+  /// '#', or Invalid if it is not a known directive. Only the name is scanned,
+  /// the rest of the line is not lexed.
+  static PPToken::PPTokenKind GetDirectiveKind(std::string_view Line);
+
+  /// The lexer only views @s, so it must outlive the lexer.
+  PPLexer(std::string_view s);
+
+  /// The maximum number of tokens can be looked ahead.
+  static constexpr unsigned MaxLookAhead = 4;
 
 private:
-  static std::unordered_map<std::string, PPToken::PPTokenKind> Keywords;
-  std::string Source;
-  std::vector<PPToken> PPTokenBuffer;
+  /// Lex a new token from the source, bypassing the PPTokenBuffer.
+  PPToken LexPPToken();
+
+  /// Comments are skipped like whitespace.
+  void SkipWhitespaceAndComments();
+
+  std::string_view Source;
+  TokenQueue<PPToken, MaxLookAhead> PPTokenBuffer;
   unsigned LineIndex = 0;
 };
 
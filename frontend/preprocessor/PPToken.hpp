@@ -3,6 +3,7 @@
 
 #include <cassert>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 class PPToken {
@@ -12,18 +13,30 @@ public:
     Invalid,
 
     Identifier,
-    
+    Number,
+    StringLiteral,
+    CharLiteral,
+
     // Symbols
     Dot,
-    Colon,
+    Comma,
     Hashtag,
     LeftParen,
     RightParen,
-    DoubleQuote,
-    
+    /// Any other character. Only one character long, since the preprocessor
+    /// does not care about the multi character operators.
+    Punctuator,
+
     // Keywords
     Define,
     Include,
+    If,
+    Ifdef,
+    Ifndef,
+    Elif,
+    Else,
+    Endif,
+    Pragma,
   };
 
   PPToken() : Kind(Invalid) {}
@@ -33,6 +46,8 @@ public:
   PPToken(PPTokenKind tk, std::string_view sv) : Kind(tk), StringValue(sv) {}
 
   std::string GetString() const { return std::string(StringValue); }
+  /// The spelling of the token, viewing the source of the lexer.
+  std::string_view GetStringView() const { return StringValue; }
   PPTokenKind GetKind() const { return Kind; }
 
   std::string ToString() const {
@@ -49,9 +64,15 @@ public:
       return "Invalid";
     case Identifier:
       return "Identifier";
+    case Number:
+      return "Number";
+    case StringLiteral:
+      return "String literal";
+    case CharLiteral:
+      return "Character literal";
     case Dot:
       return ".";
-    case Colon:
+    case Comma:
       return ",";
     case Hashtag:
       return "#";
@@ -59,12 +80,26 @@ public:
       return "(";
     case RightParen:
       return ")";
-    case DoubleQuote:
-      return "\"";
+    case Punctuator:
+      return "Punctuator";
     case Define:
       return "define";
     case Include:
       return "include";
+    case If:
+      return "if";
+    case Ifdef:
+      return "ifdef";
+    case Ifndef:
+      return "ifndef";
+    case Elif:
+      return "elif";
+    case Else:
+      return "else";
+    case Endif:
+      return "endif";
+    case Pragma:
+      return "pragma";
 
     default:
       assert(false && "Unhandled token type.");
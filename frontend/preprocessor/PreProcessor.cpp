@@ -1,30 +1,337 @@
 #include "PreProcessor.hpp"
+#include "../lexer/CharInfo.hpp"
 #include "PPLexer.hpp"
+#include <algorithm>
 #include <cassert>
-#include <fstream>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
 
-std::string WhiteSpaceChars("\t ");
-
-static bool getFileContent(std::string fileName,
-                           std::vector<std::string> &vecOfStrs) {
-  // Open the File
-  std::ifstream in(fileName.c_str());
-  // Check if object is valid
-  if (!in)
-    return false;
+/// Keywords of the preprocessor are ordinary identifiers outside directives.
+static bool IsIdentifier(const PPToken &Tok) {
+  return Tok.GetKind() == PPToken::Identifier || Tok.IsKeyword();
+}
 
-  std::string str;
-  // Read the next line from File until it reaches the end.
-  while (std::getline(in, str))
-    // Line contains string of length > 0 then save it in vector
-    vecOfStrs.push_back(str);
+static std::string_view TrimWhitespace(std::string_view Text) {
+  while (!Text.empty() && IsWhitespace(Text.front()))
+    Text.remove_prefix(1);
+  while (!Text.empty() && IsWhitespace(Text.back()))
+    Text.remove_suffix(1);
+  return Text;
+}
 
-  // Close The File
-  in.close();
-  return true;
+/// Returns the part of the directive @Line after its name.
+static std::string_view GetDirectiveOperands(std::string_view Line) {
+  size_t Pos = 1; // skip '#'
+  while (Pos < Line.size() && (Line[Pos] == ' ' || Line[Pos] == '\t'))
+    Pos++;
+  while (Pos < Line.size() && IsIdentifierChar(Line[Pos]))
+    Pos++;
+  return Line.substr(Pos);
 }
 
-void PreProcessor::ParseDirective(std::string &Line, size_t LineIdx) {
+/// Evaluates the controlling expression of an #if or #elif, after the defined
+/// operators are replaced and the macros are expanded. The identifiers left in
+/// it are 0. Every value is 64 bit, signed like intmax_t or unsigned like
+/// uintmax_t, and the operators convert them like in C. The operations
+/// undefined in C, like a division by zero, give 0 and are recorded in Errors,
+/// unless they are in an operand which is not evaluated.
+class ConditionEvaluator {
+public:
+  ConditionEvaluator(std::string_view Text) : Text(Text) { Lex(); }
+
+  /// Returns true if the condition holds.
+  bool Evaluate() {
+    auto Result = ParseConditional();
+    assert(Pos >= Text.size() && Current.empty() &&
+           "Unexpected token in the condition");
+    return Result.Bits != 0;
+  }
+
+  /// The messages of the errors found during the evaluation.
+  std::vector<const char *> Errors;
+
+private:
+  struct Integer {
+    uint64_t Bits = 0;
+    bool IsUnsigned = false;
+
+    int64_t GetSigned() const { return int64_t(Bits); }
+    bool IsNegative() const { return !IsUnsigned && GetSigned() < 0; }
+  };
+
+  static Integer MakeSigned(int64_t V) { return {uint64_t(V), false}; }
+
+  /// The binding power of the binary operator @Op, 0 if it is not one.
+  static unsigned GetPrecedence(std::string_view Op) {
+    if (Op == "*" || Op == "/" || Op == "%")
+      return 10;
+    if (Op == "+" || Op == "-")
+      return 9;
+    if (Op == "<<" || Op == ">>")
+      return 8;
+    if (Op == "<" || Op == ">" || Op == "<=" || Op == ">=")
+      return 7;
+    if (Op == "==" || Op == "!=")
+      return 6;
+    if (Op == "&")
+      return 5;
+    if (Op == "^")
+      return 4;
+    if (Op == "|")
+      return 3;
+    if (Op == "&&")
+      return 2;
+    if (Op == "||")
+      return 1;
+    return 0;
+  }
+
+  void SkipWhitespaceAndComments() {
+    while (Pos < Text.size()) {
+      if (IsWhitespace(Text[Pos]))
+        Pos++;
+      else if (Text.compare(Pos, 2, "/*") == 0) {
+        auto End = Text.find("*/", Pos + 2);
+        Pos = End == std::string_view::npos ? Text.size() : End + 2;
+      } else if (Text.compare(Pos, 2, "//") == 0)
+        Pos = Text.size();
+      else
+        break;
+    }
+  }
+
+  /// Lex the next token into Current, and its value into Value if it is a
+  /// number, a character literal or an identifier.
+  void Lex() {
+    SkipWhitespaceAndComments();
+    Current = {};
+    Value = {};
+    if (Pos >= Text.size())
+      return;
+
+    auto Begin = Pos;
+    auto c = Text[Pos];
+
+    if (IsDigit(c)) {
+      std::string Number;
+      while (Pos < Text.size() && IsIdentifierChar(Text[Pos]))
+        Number.push_back(Text[Pos++]);
+      // only the u suffix matters, every value is 64 bit
+      bool HasUnsignedSuffix = false;
+      while (!Number.empty() &&
+             (Number.back() == 'u' || Number.back() == 'U' ||
+              Number.back() == 'l' || Number.back() == 'L')) {
+        HasUnsignedSuffix |= Number.back() == 'u' || Number.back() == 'U';
+        Number.pop_back();
+      }
+      Value.Bits = strtoull(Number.c_str(), nullptr, 0);
+      // a number too big for intmax_t is unsigned
+      Value.IsUnsigned = HasUnsignedSuffix || Value.Bits > INT64_MAX;
+    } else if (IsIdentifierChar(c)) {
+      while (Pos < Text.size() && IsIdentifierChar(Text[Pos]))
+        Pos++;
+    } else if (c == '\'') {
+      Pos++;
+      if (Pos < Text.size() && Text[Pos] == '\\') {
+        Pos++;
+        switch (Pos < Text.size() ? Text[Pos] : 0) {
+        case 'n':
+          Value = MakeSigned('\n');
+          break;
+        case 't':
+          Value = MakeSigned('\t');
+          break;
+        case '0':
+          Value = MakeSigned(0);
+          break;
+        default:
+          Value = MakeSigned(Text[Pos]);
+        }
+      } else if (Pos < Text.size())
+        Value = MakeSigned(Text[Pos]);
+      Pos++;
+      assert(Pos < Text.size() && Text[Pos] == '\'' &&
+             "Unterminated character literal");
+      Pos++;
+    } else {
+      static constexpr std::string_view TwoCharOps[] = {
+          "||", "&&", "==", "!=", "<=", ">=", "<<", ">>"};
+      Pos++;
+      for (auto Op : TwoCharOps)
+        if (Text.compare(Begin, 2, Op) == 0) {
+          Pos++;
+          break;
+        }
+    }
+
+    Current = Text.substr(Begin, Pos - Begin);
+  }
+
+  /// Record the error @Message, unless the operand being parsed is not
+  /// evaluated.
+  void Error(const char *Message) {
+    if (Unevaluated == 0)
+      Errors.push_back(Message);
+  }
+
+  Integer ParseUnary() {
+    auto Op = Current;
+    auto OperandValue = Value;
+    Lex();
+
+    if (Op == "(") {
+      auto Result = ParseConditional();
+      assert(Current == ")" && "Expected ')' in the condition");
+      Lex();
+      return Result;
+    }
+    if (Op == "!")
+      return MakeSigned(ParseUnary().Bits == 0);
+    // the rest of the arithmetic is done on the bits, wrapping around on
+    // overflow like the two's complement values do
+    if (Op == "~") {
+      auto Operand = ParseUnary();
+      Operand.Bits = ~Operand.Bits;
+      return Operand;
+    }
+    if (Op == "-") {
+      auto Operand = ParseUnary();
+      Operand.Bits = 0 - Operand.Bits;
+      return Operand;
+    }
+    if (Op == "+")
+      return ParseUnary();
+
+    assert(!Op.empty() && (IsIdentifierChar(Op[0]) || Op[0] == '\'') &&
+           "Expected an operand in the condition");
+    return OperandValue;
+  }
+
+  /// Apply the binary operator @Op, other than && and ||, on @LHS and @RHS.
+  Integer Apply(std::string_view Op, Integer LHS, Integer RHS) {
+    // the result of a shift has the type of its left operand
+    if (Op == "<<" || Op == ">>") {
+      if (RHS.IsNegative() || RHS.Bits >= 64) {
+        Error("shift count is out of range in the condition");
+        return {0, LHS.IsUnsigned};
+      }
+      if (Op == "<<")
+        LHS.Bits <<= RHS.Bits;
+      else if (LHS.IsUnsigned)
+        LHS.Bits >>= RHS.Bits;
+      else
+        LHS.Bits = uint64_t(LHS.GetSigned() >> RHS.Bits);
+      return LHS;
+    }
+
+    // otherwise both are converted to unsigned if one of them is
+    bool IsUnsigned = LHS.IsUnsigned || RHS.IsUnsigned;
+    auto Less = [IsUnsigned](Integer A, Integer B) {
+      return IsUnsigned ? A.Bits < B.Bits : A.GetSigned() < B.GetSigned();
+    };
+
+    if (Op == "<")
+      return MakeSigned(Less(LHS, RHS));
+    if (Op == ">")
+      return MakeSigned(Less(RHS, LHS));
+    if (Op == "<=")
+      return MakeSigned(!Less(RHS, LHS));
+    if (Op == ">=")
+      return MakeSigned(!Less(LHS, RHS));
+    if (Op == "==")
+      return MakeSigned(LHS.Bits == RHS.Bits);
+    if (Op == "!=")
+      return MakeSigned(LHS.Bits != RHS.Bits);
+
+    Integer Result = {0, IsUnsigned};
+    if (Op == "/" || Op == "%") {
+      if (RHS.Bits == 0)
+        Error("division by zero in the condition");
+      else if (IsUnsigned)
+        Result.Bits = Op == "/" ? LHS.Bits / RHS.Bits : LHS.Bits % RHS.Bits;
+      else if (LHS.GetSigned() == INT64_MIN && RHS.GetSigned() == -1)
+        Error("integer overflow in the condition");
+      else
+        Result.Bits = uint64_t(Op == "/" ? LHS.GetSigned() / RHS.GetSigned()
+                                         : LHS.GetSigned() % RHS.GetSigned());
+    } else if (Op == "*")
+      Result.Bits = LHS.Bits * RHS.Bits;
+    else if (Op == "+")
+      Result.Bits = LHS.Bits + RHS.Bits;
+    else if (Op == "-")
+      Result.Bits = LHS.Bits - RHS.Bits;
+    else if (Op == "&")
+      Result.Bits = LHS.Bits & RHS.Bits;
+    else if (Op == "^")
+      Result.Bits = LHS.Bits ^ RHS.Bits;
+    else
+      Result.Bits = LHS.Bits | RHS.Bits;
+
+    return Result;
+  }
+
+  /// Parse the binary operators binding at least as strong as @MinPrecedence.
+  Integer ParseBinary(unsigned MinPrecedence) {
+    auto LHS = ParseUnary();
+
+    for (auto Precedence = GetPrecedence(Current);
+         Precedence != 0 && Precedence >= MinPrecedence;
+         Precedence = GetPrecedence(Current)) {
+      auto Op = Current;
+      Lex();
+
+      // the right operand is not evaluated if the left one decides the result
+      bool IsLogical = Op == "&&" || Op == "||";
+      bool Decided = IsLogical && (LHS.Bits != 0) == (Op == "||");
+      Unevaluated += Decided;
+      auto RHS = ParseBinary(Precedence + 1);
+      Unevaluated -= Decided;
+
+      if (Op == "&&")
+        LHS = MakeSigned(LHS.Bits != 0 && RHS.Bits != 0);
+      else if (Op == "||")
+        LHS = MakeSigned(LHS.Bits != 0 || RHS.Bits != 0);
+      else
+        LHS = Apply(Op, LHS, RHS);
+    }
+
+    return LHS;
+  }
+
+  Integer ParseConditional() {
+    auto Condition = ParseBinary(1);
+    if (Current != "?")
+      return Condition;
+
+    // only the chosen branch is evaluated
+    bool Holds = Condition.Bits != 0;
+    Lex(); // eat '?'
+    Unevaluated += !Holds;
+    auto TrueValue = ParseConditional();
+    Unevaluated -= !Holds;
+    assert(Current == ":" && "Expected ':' in the condition");
+    Lex(); // eat ':'
+    Unevaluated += Holds;
+    auto FalseValue = ParseConditional();
+    Unevaluated -= Holds;
+
+    auto Result = Holds ? TrueValue : FalseValue;
+    Result.IsUnsigned = TrueValue.IsUnsigned || FalseValue.IsUnsigned;
+    return Result;
+  }
+
+  std::string_view Text;
+  size_t Pos = 0;
+  /// The current token.
+  std::string_view Current;
+  Integer Value;
+  /// Nonzero while parsing an operand which is not evaluated.
+  unsigned Unevaluated = 0;
+};
+
+void PreProcessor::ParseDirective(std::string_view Line) {
   PPLexer lexer(Line);
   lexer.Lex(); // eat '#'
 
@@ -33,136 +340,577 @@ void PreProcessor::ParseDirective(std::string &Line, size_t LineIdx) {
 
   if (Directive.GetKind() == PPToken::Define) {
     auto DefinedID = lexer.Lex();
-    assert(DefinedID.GetKind() != PPToken::EndOfFile &&
-           DefinedID.GetKind() == PPToken::Identifier);
+    assert(IsIdentifier(DefinedID) && "Expected a macro name");
+    auto Name = DefinedID.GetStringView();
 
-    // must be called here otherwise the token lookaheads mess up the lineindex
-    // TODO: solve this problem, maybe with giving tokens the linenumber
-    auto RemainingText = lexer.GetRemainingText();
+    Macro NewMacro;
+    std::vector<std::string_view> Params;
 
-    if (lexer.Is(PPToken::EndOfFile))
-      DefinedMacros[DefinedID.GetString()] = {"", 0};
-    else if (lexer.Is(PPToken::LeftParen)) {
+    // only a '(' right after the name starts a parameter list, otherwise it is
+    // already part of the replacement list (eg.: #define ONE (1))
+    if (lexer.Is(PPToken::LeftParen) &&
+        lexer.GetCurrentPPToken().GetStringView().data() ==
+            Name.data() + Name.size()) {
       lexer.Lex(); // eat '('
-      std::vector<std::string> Params;
+      NewMacro.IsFunctionLike = true;
 
-      do {
+      while (lexer.IsNot(PPToken::RightParen)) {
         auto Param = lexer.Lex();
-        assert(Param.GetKind() == PPToken::Identifier);
-        Params.push_back(Param.GetString());
+        assert(IsIdentifier(Param) && "Expected a parameter name");
+        Params.push_back(Param.GetStringView());
 
-        if (lexer.IsNot(PPToken::Colon))
+        if (lexer.IsNot(PPToken::Comma))
           break;
         lexer.Lex(); // eat ','
-      } while (true);
+      }
 
       assert(lexer.Is(PPToken::RightParen));
       lexer.Lex(); // eat ')'
+      NewMacro.NumParams = Params.size();
+    }
+
+    // Split the replacement list at the parameters, so an expansion only has
+    // to concatenate the texts and the arguments. eg.: with the below macro
+    //    #define MAX(A,B) (((A) > (B)) ? (A) : (B))
+    // the Texts are "(((", ") > (", ")) ? (", ") : (", "))"
+    // and the Params are 0, 1, 0, 1.
+    // The whitespace between the tokens is collapsed into one space.
+    NewMacro.Texts.emplace_back();
+    const char *PrevTokenEnd = nullptr;
+    bool PrevIsParam = false;
+    for (auto Tok = lexer.Lex(); Tok.GetKind() != PPToken::EndOfFile;
+         Tok = lexer.Lex()) {
+      auto Spelling = Tok.GetStringView();
+      if (PrevTokenEnd && PrevTokenEnd != Spelling.data())
+        NewMacro.Texts.back().push_back(' ');
+      PrevTokenEnd = Spelling.data() + Spelling.size();
+
+      auto Param = std::find(Params.begin(), Params.end(), Spelling);
+      bool IsParam = IsIdentifier(Tok) && Param != Params.end();
+      if (IsParam) {
+        NewMacro.Params.push_back(Param - Params.begin());
+        NewMacro.Texts.emplace_back();
+      } else
+        NewMacro.Texts.back().append(Spelling);
+
+      if ((IsIdentifier(Tok) && !IsParam) ||
+          (PrevIsParam && Tok.GetKind() == PPToken::LeftParen))
+        NewMacro.NeedsRescan = true;
+      PrevIsParam = IsParam;
+    }
+
+    DefinedMacros[Name] = std::move(NewMacro);
+  } else if (Directive.GetKind() == PPToken::Include) {
+    auto FileNameToken = lexer.Lex();
+    auto FileName = FileNameToken.GetStringView();
+    assert(FileNameToken.GetKind() == PPToken::StringLiteral &&
+           FileName.size() >= 2 && FileName.back() == '"' &&
+           "Expected a \"file name\"");
+    FileName = FileName.substr(1, FileName.size() - 2); // strip the quotes
+
+    auto IncludedFile = SM.AddFile(FilePath + std::string(FileName));
+    assert(IncludedFile && "Cannot open file");
+
+    EnterFile(IncludedFile.value());
+  } else if (Directive.GetKind() == PPToken::If) {
+    EnterConditional(EvaluateCondition(GetDirectiveOperands(Line)));
+  } else if (Directive.GetKind() == PPToken::Ifdef ||
+             Directive.GetKind() == PPToken::Ifndef) {
+    auto MacroName = lexer.Lex();
+    assert(IsIdentifier(MacroName) && "Expected a macro name");
+    bool IsDefined = DefinedMacros.count(MacroName.GetStringView());
+    EnterConditional(Directive.GetKind() == PPToken::Ifdef ? IsDefined
+                                                           : !IsDefined);
+  } else if (Directive.GetKind() == PPToken::Elif ||
+             Directive.GetKind() == PPToken::Else) {
+    // reached from the taken branch, so every later branch is skipped
+    assert(!Conditionals.empty() && "#elif or #else without #if");
+    assert(!Conditionals.back().SeenElse && "#elif or #else after #else");
+    Conditionals.back().SeenElse = Directive.GetKind() == PPToken::Else;
+    SkipInactiveBranches();
+  } else if (Directive.GetKind() == PPToken::Endif) {
+    assert(Conditionals.size() > IncludeStack.back().ConditionalDepth &&
+           "#endif without #if");
+    Conditionals.pop_back();
+  } else if (Directive.GetKind() == PPToken::Pragma) {
+    // unknown pragmas are ignored
+    auto PragmaName = lexer.Lex();
+    if (PragmaName.GetKind() == PPToken::Identifier &&
+        PragmaName.GetStringView() == "once")
+      Files[IncludeStack.back().ID].IsPragmaOnce = true;
+  }
+}
+
+size_t PreProcessor::CollectArguments(PPLexer &Lexer, std::string_view Text,
+                                      size_t ArgsBegin,
+                                      std::vector<std::string> &Args) {
+  unsigned Depth = 0;
+  auto ArgBegin = ArgsBegin;
+
+  for (auto Tok = Lexer.Lex(); Tok.GetKind() != PPToken::EndOfFile;
+       Tok = Lexer.Lex()) {
+    auto Kind = Tok.GetKind();
+    auto Pos = size_t(Tok.GetStringView().data() - Text.data());
+
+    if (Kind == PPToken::LeftParen)
+      Depth++;
+    // commas of nested parentheses do not separate the arguments
+    else if (Depth == 0 &&
+             (Kind == PPToken::Comma || Kind == PPToken::RightParen)) {
+      // the arguments are fully macro expanded before the substitution
+      auto Arg = TrimWhitespace(Text.substr(ArgBegin, Pos - ArgBegin));
+      auto &ExpandedArg = Args.emplace_back();
+      if (!ExpandMacros(Arg, ExpandedArg))
+        ExpandedArg = Arg;
+      ArgBegin = Pos + 1;
+
+      if (Kind == PPToken::RightParen)
+        return Pos + 1;
+    } else if (Kind == PPToken::RightParen)
+      Depth--;
+  }
+
+  assert(false && "Unterminated macro invocation.");
+  return Text.size();
+}
+
+bool PreProcessor::ExpandMacros(std::string_view Text, std::string &Output) {
+  PPLexer Lexer(Text);
+  // the text before this position is already in the Output, it is 0 until
+  // the first invocation
+  size_t Copied = 0;
+  std::vector<std::string> Args;
+  std::string Expansion;
+
+  for (auto Tok = Lexer.Lex(); Tok.GetKind() != PPToken::EndOfFile;
+       Tok = Lexer.Lex()) {
+    if (!IsIdentifier(Tok))
+      continue;
+
+    auto It = DefinedMacros.find(Tok.GetStringView());
+    if (It == DefinedMacros.end() || It->second.Disabled)
+      continue;
+
+    // the name of a function like macro without arguments is left alone
+    if (It->second.IsFunctionLike && Lexer.IsNot(PPToken::LeftParen))
+      continue;
+
+    auto Begin = size_t(Tok.GetStringView().data() - Text.data());
+    Output.append(Text.substr(Copied, Begin - Copied));
+    Copied = Begin + Tok.GetStringView().size();
+
+    // an expansion ending with the name of a function like macro is rescanned
+    // with the rest of the text, so that macro is invoked with the arguments
+    // after the expansion, eg.: with
+    //    #define F G
+    //    #define G(x) (x + 1)
+    // "F(4)" is expanded to "G", then "G(4)" to "(4 + 1)"
+    for (auto *M = &It->second; M;) {
+      std::string_view Replacement = M->Texts[0];
 
-      auto Body = lexer.GetRemainingText();
-      for (size_t i = 0; i < Params.size(); i++) {
-        // replacing the parameters with their index eg.: with the below macro
-        //    #define MAX(A,B) (((A) > (B)) ? (A) : (B))
-        // the Body is "(((A) > (B)) ? (A) : (B))"
-        // and it became "((($0) > ($1)) ? ($0) : ($1))"
-        // this will make the substitution easier later
-        while (Body.find(Params[i]) != std::string::npos)
-          Body.replace(Body.find(Params[i]), Params[i].length(),
-                       "$" + std::to_string(i));
+      if (M->IsFunctionLike) {
+        auto LeftParen = Lexer.Lex();
+        Args.clear();
+        Copied = CollectArguments(
+            Lexer, Text, LeftParen.GetStringView().data() - Text.data() + 1,
+            Args);
+
+        // "F()" is an invocation without arguments, not with an empty one
+        if (M->NumParams == 0 && Args.size() == 1 && Args[0].empty())
+          Args.clear();
+        assert(Args.size() == M->NumParams &&
+               "Wrong number of macro arguments.");
+
+        Expansion = M->Texts[0];
+        for (size_t i = 0; i < M->Params.size(); i++) {
+          Expansion.append(Args[M->Params[i]]);
+          Expansion.append(M->Texts[i + 1]);
+        }
+        Replacement = Expansion;
       }
 
-      DefinedMacros[DefinedID.GetString()] = {Body, Params.size()};
+      auto ExpansionBegin = Output.size();
+      if (!M->NeedsRescan)
+        Output.append(Replacement);
+      else {
+        // rescan the replacement for further macros, except this one
+        M->Disabled = true;
+        if (!ExpandMacros(Replacement, Output))
+          Output.append(Replacement);
+        M->Disabled = false;
+      }
+
+      M = TakeTrailingInvocation(Output, ExpansionBegin, *M, Lexer);
     }
-    // plain define (eg.: #define TRUE 1)
-    else {
-      DefinedMacros[DefinedID.GetString()] = {RemainingText, 0};
+  }
+
+  if (Copied == 0)
+    return false;
+
+  Output.append(Text.substr(Copied));
+  return true;
+}
+
+PreProcessor::Macro *
+PreProcessor::TakeTrailingInvocation(std::string &Output, size_t Begin,
+                                     const Macro &Expanded, PPLexer &Lexer) {
+  if (Lexer.IsNot(PPToken::LeftParen))
+    return nullptr;
+
+  auto NameEnd = Output.size();
+  while (NameEnd > Begin && IsWhitespace(Output[NameEnd - 1]))
+    NameEnd--;
+  auto NameBegin = NameEnd;
+  while (NameBegin > Begin && IsIdentifierChar(Output[NameBegin - 1]))
+    NameBegin--;
+  if (NameBegin == NameEnd || IsDigit(Output[NameBegin]))
+    return nullptr;
+
+  // the expanded macro is not invoked again by its own expansion
+  auto Name = std::string_view(Output).substr(NameBegin, NameEnd - NameBegin);
+  auto It = DefinedMacros.find(Name);
+  if (It == DefinedMacros.end() || !It->second.IsFunctionLike ||
+      It->second.Disabled || &It->second == &Expanded)
+    return nullptr;
+
+  Output.resize(NameBegin);
+  return &It->second;
+}
+
+bool PreProcessor::EvaluateCondition(std::string_view Expr) {
+  // the operands of defined are not macro expanded, so they are replaced
+  // first
+  std::string Replaced;
+  PPLexer Lexer(Expr);
+  size_t Copied = 0;
+  for (auto Tok = Lexer.Lex(); Tok.GetKind() != PPToken::EndOfFile;
+       Tok = Lexer.Lex()) {
+    if (!IsIdentifier(Tok) || Tok.GetStringView() != "defined")
+      continue;
+
+    bool HasParen = Lexer.Is(PPToken::LeftParen);
+    if (HasParen)
+      Lexer.Lex(); // eat '('
+    auto MacroName = Lexer.Lex();
+    assert(IsIdentifier(MacroName) && "Expected a macro name after defined");
+    auto Name = MacroName.GetStringView();
+    auto End = Name.data() + Name.size();
+    if (HasParen) {
+      auto RightParen = Lexer.Lex();
+      assert(RightParen.GetKind() == PPToken::RightParen && "Expected ')'");
+      End = RightParen.GetStringView().data() + 1;
     }
-  } else if (Directive.GetKind() == PPToken::Include) {
-    assert(lexer.Is(PPToken::DoubleQuote));
-    lexer.Lex(); // eat '"'
 
-    auto FileNameToken = lexer.Lex();
-    assert(FileNameToken.GetKind() == PPToken::Identifier);
-    auto FileName = FileNameToken.GetString();
+    auto Begin = size_t(Tok.GetStringView().data() - Expr.data());
+    Replaced.append(Expr.substr(Copied, Begin - Copied));
+    Replaced.push_back(DefinedMacros.count(Name) ? '1' : '0');
+    Copied = End - Expr.data();
+  }
+  Replaced.append(Expr.substr(Copied));
+
+  std::string Expanded;
+  if (!ExpandMacros(Replaced, Expanded))
+    Expanded = std::move(Replaced);
 
-    assert(lexer.Is(PPToken::Dot));
-    lexer.Lex(); // eat '.'
-    FileName.push_back('.');
+  ConditionEvaluator Evaluator(Expanded);
+  bool Result = Evaluator.Evaluate();
+  for (auto Message : Evaluator.Errors)
+    EmitError(TrimWhitespace(Expr), Message);
+  return Result;
+}
 
-    auto ExtensionToken = lexer.Lex();
-    assert(ExtensionToken.GetKind() == PPToken::Identifier);
-    FileName.append(ExtensionToken.GetString());
+void PreProcessor::EmitError(std::string_view At, const std::string &Message) {
+  auto ID = IncludeStack.back().ID;
+  auto Offset = unsigned(At.data() - SM.GetBuffer(ID).data());
+  auto [Line, Col] = SM.GetLineAndColumn(ID, Offset);
+  std::cout << ":" << Line + 1 << ":" << Col + 1 << ": error: " << Message
+            << std::endl
+            << "\t\t" << SM.GetLine(ID, Line) << std::endl
+            << std::endl;
+}
 
-    assert(lexer.Is(PPToken::DoubleQuote));
-    lexer.Lex(); // eat '"'
+void PreProcessor::EnterConditional(bool Condition) {
+  Conditionals.push_back({Condition});
+  if (!Condition)
+    SkipInactiveBranches();
+}
 
-    std::vector<std::string> FileContent;
-    auto Success = getFileContent(FilePath + FileName, FileContent);
-    assert(Success && "Cannot open file");
+void PreProcessor::SkipInactiveBranches() {
+  auto &Cond = Conditionals.back();
 
-    Source.insert(Source.begin() + LineIdx + 1, FileContent.begin(),
-                  FileContent.end());
+  while (true) {
+    auto Line = SkipToNextBranch();
+    auto Kind = PPLexer::GetDirectiveKind(Line);
+
+    if (Kind == PPToken::Endif) {
+      Conditionals.pop_back();
+      return;
+    }
+
+    assert(!Cond.SeenElse && "#elif or #else after #else");
+    if (Kind == PPToken::Else)
+      Cond.SeenElse = true;
+
+    if (!Cond.Taken &&
+        (Kind == PPToken::Else ||
+         EvaluateCondition(GetDirectiveOperands(Line)))) {
+      Cond.Taken = true;
+      return;
+    }
   }
 }
 
-void PreProcessor::SubstituteMacros(std::string &Line) {
-  for (auto &[MacroID, MacroData] : DefinedMacros) {
-    auto &[MacroBody, MacroParam] = MacroData;
+std::string_view PreProcessor::SkipToNextBranch() {
+  auto &Text = IncludeStack.back().Text;
+  unsigned Depth = 0;
 
-    // simple search and replace of plain macros
-    if (MacroParam == 0)
-      while (Line.find(MacroID) != std::string::npos)
-        Line.replace(Line.find(MacroID), MacroID.length(), MacroBody);
-    // otherwise it a function macro and have to substitute the right values
-    // into its parameters
-    else {
-      auto Pos = Line.find(MacroID); // macro start pos
-      if (Pos == std::string::npos)
-        continue;
-      Pos += MacroID.length();
-      assert(Line[Pos] == '(');
+  for (size_t Pos = 0;;) {
+    // only a '#' starting a line can be a directive
+    auto Hash = static_cast<const char *>(
+        memchr(Text.data() + Pos, '#', Text.size() - Pos));
+    assert(Hash && "Unterminated conditional directive");
+    if (!Hash) {
+      Text = {};
+      return "#endif";
+    }
+
+    Pos = Hash - Text.data();
+    if (Pos != 0 && Text[Pos - 1] != '\n') {
       Pos++;
+      continue;
+    }
 
-      auto RemainingLine = Line.substr(Pos);
-      size_t StartPos = 0;
-      std::vector<std::string> ActualParams(0);
-      for (size_t i = 0; i < MacroParam; i++) {
-        size_t EndPos = i != MacroParam - 1 ? RemainingLine.find(",")
-                                            : RemainingLine.find(")");
-        ActualParams.push_back(
-            RemainingLine.substr(StartPos, EndPos - StartPos));
-        StartPos = EndPos + 1;
-      }
+    auto LineEnd = std::min(Text.find('\n', Pos), Text.size());
+    auto Line = Text.substr(Pos, LineEnd - Pos);
+    Pos = std::min(LineEnd + 1, Text.size());
 
-      auto ReplacedMacroBody = MacroBody;
-      for (size_t i = 0; i < ActualParams.size(); i++) {
-        auto Param = "$" + std::to_string(i);
-        while (ReplacedMacroBody.find(Param) != std::string::npos)
-          ReplacedMacroBody.replace(ReplacedMacroBody.find(Param),
-                                    Param.length(), ActualParams[i]);
+    switch (PPLexer::GetDirectiveKind(Line)) {
+    case PPToken::If:
+    case PPToken::Ifdef:
+    case PPToken::Ifndef:
+      Depth++;
+      break;
+    case PPToken::Endif:
+      if (Depth == 0) {
+        Text.remove_prefix(Pos);
+        return Line;
+      }
+      Depth--;
+      break;
+    case PPToken::Elif:
+    case PPToken::Else:
+      if (Depth == 0) {
+        Text.remove_prefix(Pos);
+        return Line;
       }
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void PreProcessor::DetectIncludeGuard(std::string_view Buffer,
+                                      FileInfo &Info) {
+  enum { BeforeGuard, InGuard, AfterGuard } State = BeforeGuard;
+  std::string_view GuardMacro;
+  size_t GuardedBegin = 0, GuardedEnd = 0;
+  unsigned Depth = 0;
+
+  for (size_t LineBegin = 0; LineBegin < Buffer.size();) {
+    auto LineEnd = Buffer.find('\n', LineBegin);
+    if (LineEnd == std::string_view::npos)
+      LineEnd = Buffer.size();
+    auto Line = Buffer.substr(LineBegin, LineEnd - LineBegin);
+    auto NextLineBegin = LineEnd + 1;
 
-      if (Line.find(MacroID) != std::string::npos)
-        Line.replace(Line.find(MacroID), MacroID.length() + StartPos + 1,
-                     ReplacedMacroBody);
+    PPLexer Lexer(Line);
+    // whitespace and comments are allowed anywhere
+    if (Lexer.Is(PPToken::EndOfFile)) {
+      LineBegin = NextLineBegin;
+      continue;
     }
+
+    // there is something outside of the guard
+    if (State == AfterGuard || (Line[0] != '#' && State == BeforeGuard))
+      return;
+
+    if (Line[0] == '#') {
+      Lexer.Lex(); // eat '#'
+      auto Directive = Lexer.Lex().GetKind();
+
+      if (State == BeforeGuard) {
+        auto Macro = Lexer.Lex();
+        if (Directive != PPToken::Ifndef ||
+            Macro.GetKind() != PPToken::Identifier)
+          return;
+
+        State = InGuard;
+        GuardMacro = Macro.GetStringView();
+        GuardedBegin = std::min(NextLineBegin, Buffer.size());
+        Depth = 1;
+      } else if (Directive == PPToken::If || Directive == PPToken::Ifdef ||
+                 Directive == PPToken::Ifndef)
+        Depth++;
+      // the #ifndef of a guard has no other branch
+      else if (Depth == 1 &&
+               (Directive == PPToken::Elif || Directive == PPToken::Else))
+        return;
+      else if (Directive == PPToken::Endif && --Depth == 0) {
+        State = AfterGuard;
+        GuardedEnd = LineBegin;
+      }
+    }
+
+    LineBegin = NextLineBegin;
   }
+
+  if (State != AfterGuard)
+    return;
+
+  Info.GuardMacro = GuardMacro;
+  Info.GuardedText = Buffer.substr(GuardedBegin, GuardedEnd - GuardedBegin);
+}
+
+void PreProcessor::EnterFile(SourceManager::BufferID ID) {
+  auto [It, IsNew] = Files.try_emplace(ID);
+  auto &Info = It->second;
+  auto Buffer = SM.GetBuffer(ID);
+
+  if (IsNew)
+    DetectIncludeGuard(Buffer, Info);
+  else if (Info.IsPragmaOnce || Info.IsPrecompiled ||
+           (!Info.GuardMacro.empty() && DefinedMacros.count(Info.GuardMacro)))
+    return;
+
+  // the directives of the guard itself are not part of the output, neither
+  // are the comments around them
+  if (!Info.GuardMacro.empty()) {
+    if (!DefinedMacros.count(Info.GuardMacro))
+      IncludeStack.push_back({ID, Info.GuardedText, Conditionals.size()});
+  } else
+    IncludeStack.push_back({ID, Buffer, Conditionals.size()});
+}
+
+PieceTable::Piece PreProcessor::AddScratchText(std::string_view Text) {
+  if (!ScratchBuffers.empty())
+    if (auto Offset = SM.AppendToBuffer(ScratchBuffers.back(), Text))
+      return {ScratchBuffers.back(), *Offset, unsigned(Text.size())};
+
+  auto ID = SM.AddScratchBuffer(std::max(ScratchBufferSize, Text.size()),
+                                SM.GetBufferName(MainFile));
+  ScratchBuffers.push_back(ID);
+  return {ID, *SM.AppendToBuffer(ID, Text), unsigned(Text.size())};
 }
 
-void PreProcessor::Run() {
-  for (size_t LineIdx = 0; LineIdx < Source.size(); LineIdx++) {
-    auto &Line = Source[LineIdx];
-    if (Line.empty())
+bool PreProcessor::NextPiece(PieceTable::Piece &P) {
+  if (!Started) {
+    Started = true;
+    EnterFile(MainFile);
+  }
+
+  if (PendingPiece) {
+    P = *PendingPiece;
+    PendingPiece.reset();
+    return true;
+  }
+
+  // the consecutive lines of the current file used as they are
+  std::optional<PieceTable::Piece> Lines;
+
+  while (!IncludeStack.empty()) {
+    auto &Frame = IncludeStack.back();
+    if (Frame.Text.empty()) {
+      if (Lines)
+        break;
+      assert(Conditionals.size() == Frame.ConditionalDepth &&
+             "Unterminated conditional directive");
+      IncludeStack.pop_back();
       continue;
+    }
+
+    auto LineEnd = Frame.Text.find('\n');
+    auto Line = Frame.Text.substr(0, LineEnd);
+    auto LineOffset = unsigned(Line.data() - SM.GetBuffer(Frame.ID).data());
 
+    // directives are not part of the output, assuming they only use one line
     if (!Line.empty() && Line[0] == '#') {
-      ParseDirective(Line, LineIdx);
-      // delete current line, assuming the directive only used one line
-      Source.erase(Source.begin() + LineIdx);
-      LineIdx--; // since the erase we have to check again the same LineIdx
+      if (Lines)
+        break;
+      Frame.Text.remove_prefix(std::min(Line.size() + 1, Frame.Text.size()));
+      ParseDirective(Line); // invalidates Frame if it enters a file
+      continue;
+    }
+
+    size_t Length = std::min(Line.size() + 1, Frame.Text.size());
+    if (DefinedMacros.empty()) {
+      // without macros every line until the next directive is used as it is
+      auto DirectivePos = Frame.Text.find("\n#");
+      if (DirectivePos != std::string_view::npos)
+        Length = DirectivePos + 1;
+      else
+        Length = Frame.Text.size();
+    } else {
+      ExpandedLine.clear();
+      if (ExpandMacros(Line, ExpandedLine)) {
+        Frame.Text.remove_prefix(Length);
+        ExpandedLine.push_back('\n');
+        auto Expanded = AddScratchText(ExpandedLine);
+        if (!Lines) {
+          P = Expanded;
+          return true;
+        }
+        PendingPiece = Expanded;
+        break;
+      }
+    }
+
+    bool EndsWithNewline = Frame.Text[Length - 1] == '\n';
+    Frame.Text.remove_prefix(Length);
+
+    if (Lines)
+      Lines->Length += Length;
+    else
+      Lines = PieceTable::Piece{Frame.ID, LineOffset, unsigned(Length)};
+
+    // the last line of a file might have no newline
+    if (!EndsWithNewline) {
+      PendingPiece = AddScratchText("\n");
+      break;
     }
-    else if (!DefinedMacros.empty())
-      SubstituteMacros(Line);
   }
+
+  if (!Lines)
+    return false;
+
+  P = *Lines;
+  return true;
+}
+
+void PreProcessor::ReleaseConsumed(SourceManager::BufferID InUse) {
+  // the last scratch buffer is still being filled
+  auto Kept = ScratchBuffers.begin();
+  for (auto It = ScratchBuffers.begin(); It != ScratchBuffers.end(); ++It) {
+    if (*It == InUse || It + 1 == ScratchBuffers.end())
+      *Kept++ = *It;
+    else
+      SM.ReleaseBuffer(*It);
+  }
+  ScratchBuffers.erase(Kept, ScratchBuffers.end());
 }
 
+PieceTable PreProcessor::Run() {
+  auto Buffer = SM.GetBuffer(MainFile);
+
+  // without any '#' there is no directive to process and no macro could be
+  // defined, so the file can be used as it is
+  if (memchr(Buffer.data(), '#', Buffer.size()) == nullptr)
+    return PieceTable(SM, MainFile);
+
+  PieceTable Output;
+  PieceTable::Piece P;
+  while (NextPiece(P))
+    Output.Append(P.ID, P.Offset, P.Length);
+
+  return Output;
+}
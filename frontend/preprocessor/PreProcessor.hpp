@@ -1,27 +1,163 @@
 #ifndef PREPROCESSOR_H
 #define PREPROCESSOR_H
 
-#include <map>
+#include "../lexer/PieceTable.hpp"
+#include "../lexer/SourceManager.hpp"
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
-class PreProcessor {
+class PPLexer;
+
+/// Preprocesses the main file on demand: every NextPiece call processes the
+/// input only until it has the next piece of output, so the lexer can pull
+/// the preprocessed text while it goes. The expanded lines are written into
+/// scratch buffers, which are released once the lexer has consumed them.
+class PreProcessor : public PieceSource {
 public:
   PreProcessor() = delete;
-  PreProcessor(std::vector<std::string> &Src, std::string Path) : Source(Src) {
-    FilePath = Path.substr(0, Path.rfind('/'));
-    if (FilePath.length() > 0 && FilePath[FilePath.length() - 1] != '/')
-      FilePath.push_back('/');
+  PreProcessor(SourceManager &SM, SourceManager::BufferID MainFile,
+               std::string Path)
+      : SM(SM), MainFile(MainFile) {
+    // the directory of the main file, where the includes are searched
+    auto Slash = Path.rfind('/');
+    if (Slash != std::string::npos)
+      FilePath = Path.substr(0, Slash + 1);
   }
 
-  void ParseDirective(std::string &Line, size_t LineIdx);
-  void SubstituteMacros(std::string &Line);
-  void Run();
+  /// Process the directive in @Line. An included file is entered, so the
+  /// next lines come from it.
+  void ParseDirective(std::string_view Line);
+
+  /// Macro expand @Text and append the result to @Output. Returns false,
+  /// without appending anything, if there is no macro invocation in @Text.
+  bool ExpandMacros(std::string_view Text, std::string &Output);
+
+  bool NextPiece(PieceTable::Piece &P) override;
+  void ReleaseConsumed(SourceManager::BufferID InUse) override;
+
+  /// Preprocess the whole main file at once. The result refers to the lines
+  /// of the source files without a macro invocation, only the expanded lines
+  /// are copied into scratch buffers.
+  PieceTable Run();
 
 private:
+  friend class PrecompiledHeader;
+
+  struct Macro {
+    bool IsFunctionLike = false;
+    unsigned NumParams = 0;
+
+    /// The replacement list, split at the uses of the parameters. The
+    /// expansion is Texts[0] + Arg[Params[0]] + Texts[1] + ... + Texts.back(),
+    /// so Texts has one more element than Params.
+    std::vector<std::string> Texts;
+    std::vector<unsigned> Params;
+
+    /// False if the expansion cannot contain a macro invocation that was not
+    /// expanded yet: the replacement list has no identifiers and no argument is
+    /// followed by a '('. The arguments are expanded before the substitution.
+    bool NeedsRescan = false;
+
+    /// Set while the macro is being expanded, so it is not expanded again in
+    /// its own expansion.
+    bool Disabled = false;
+  };
+
+  /// Collect the arguments of a function like macro invocation into @Args.
+  /// The lexer must be after the '(', which is at @ArgsBegin in @Text. Returns
+  /// the position after the closing ')'.
+  size_t CollectArguments(PPLexer &Lexer, std::string_view Text,
+                          size_t ArgsBegin, std::vector<std::string> &Args);
+
+  /// If the expansion of @Expanded, which is at @Begin in @Output, ends with
+  /// the name of a function like macro and the rest of the text after the
+  /// invocation of @Expanded starts with a '(', then remove the name from
+  /// @Output and return its macro, which is invoked next.
+  Macro *TakeTrailingInvocation(std::string &Output, size_t Begin,
+                                const Macro &Expanded, PPLexer &Lexer);
+
+  /// What is known about a file after its first inclusion, so the later
+  /// inclusions can be skipped without looking at the file again.
+  struct FileInfo {
+    /// The macro of the include guard if everything in the file, except
+    /// whitespace and comments, is inside "#ifndef GuardMacro ... #endif".
+    /// Empty if the file has no include guard.
+    std::string_view GuardMacro;
+    /// The lines between the #ifndef and the #endif of the guard.
+    std::string_view GuardedText;
+    bool IsPragmaOnce = false;
+    /// The file is the header of the loaded precompiled header, so its
+    /// content is known already.
+    bool IsPrecompiled = false;
+  };
+
+  /// Find the include guard of @Buffer, if there is one, and record it in
+  /// @Info. Only the structure of the directives is checked, the file does not
+  /// have to define the guard macro.
+  static void DetectIncludeGuard(std::string_view Buffer, FileInfo &Info);
+
+  /// Evaluate the controlling expression @Expr of an #if or #elif.
+  bool EvaluateCondition(std::string_view Expr);
+
+  /// Print the error @Message at @At, which is a part of the current file.
+  void EmitError(std::string_view At, const std::string &Message);
+
+  /// Start a conditional whose first branch is taken if @Condition holds.
+  void EnterConditional(bool Condition);
+
+  /// Skip the lines of the current file until the branch of the innermost
+  /// conditional to take, or after its #endif if there is none left.
+  void SkipInactiveBranches();
+
+  /// Skip the lines of the current file up to the next #elif, #else or #endif
+  /// of the innermost conditional and return that directive line. The lines
+  /// are only searched for a '#' at their beginning, they are never lexed.
+  std::string_view SkipToNextBranch();
+
+  /// Continue with the lines of buffer @ID, unless it was included already
+  /// and its include guard or #pragma once prevents the repeated inclusion.
+  void EnterFile(SourceManager::BufferID ID);
+
+  /// Copy @Text into a scratch buffer and return its piece.
+  PieceTable::Piece AddScratchText(std::string_view Text);
+
+  /// Size of the scratch buffers, a longer line gets one of its own.
+  static constexpr size_t ScratchBufferSize = 64 * 1024;
+
+  struct IncludeFrame {
+    SourceManager::BufferID ID;
+    /// The lines not processed yet.
+    std::string_view Text;
+    /// The number of open conditionals when the file was entered.
+    size_t ConditionalDepth;
+  };
+
+  struct Conditional {
+    /// One of the branches was taken already, the rest are skipped.
+    bool Taken;
+    bool SeenElse = false;
+  };
+
+  SourceManager &SM;
+  SourceManager::BufferID MainFile;
   std::string FilePath;
-  std::vector<std::string> &Source;
-  std::map<std::string, std::pair<std::string, unsigned>> DefinedMacros;
+  /// The names view the buffers of SM, which outlive the preprocessor.
+  std::unordered_map<std::string_view, Macro> DefinedMacros;
+  std::unordered_map<SourceManager::BufferID, FileInfo> Files;
+
+  /// The files being processed, the innermost include is the last.
+  std::vector<IncludeFrame> IncludeStack;
+  /// The open #if, #ifdef and #ifndef directives, the innermost is the last.
+  std::vector<Conditional> Conditionals;
+  bool Started = false;
+  /// A piece produced while the previous one was still being collected.
+  std::optional<PieceTable::Piece> PendingPiece;
+  /// The scratch buffers not released yet, the last one is being filled.
+  std::vector<SourceManager::BufferID> ScratchBuffers;
+  std::string ExpandedLine;
 };
 
 #endif
@@ -1,6 +1,7 @@
 #ifndef FUNCTION_HPP
 #define FUNCTION_HPP
 
+#include "../../support/Symbol.hpp"
 #include "Type.hpp"
 #include <memory>
 #include <string>
@@ -30,8 +31,8 @@ public:
 
   ParameterList &GetParameters() { return Parameters; }
 
-  std::string &GetIgnorableStructVarName() { return IgnorableStructVarName; }
-  void SetIgnorableStructVarName(std::string &Name) {
+  Symbol GetIgnorableStructVarName() const { return IgnorableStructVarName; }
+  void SetIgnorableStructVarName(Symbol Name) {
     IgnorableStructVarName = Name;
   }
 
@@ -63,7 +64,7 @@ private:
   ParameterList Parameters;
   BasicBlockList BasicBlocks;
 
-  std::string IgnorableStructVarName = "";
+  Symbol IgnorableStructVarName;
   bool DeclarationOnly = false;
   unsigned ReturnsNumber = ~0;
   Value *ReturnValue = nullptr;
@@ -9,6 +9,7 @@
 #include "../../backend/TargetMachine.hpp"
 #include <map>
 #include <memory>
+#include <unordered_map>
 
 class IRFactory {
 private:
@@ -162,7 +163,7 @@ public:
     return InstPtr;
   }
 
-  CallInstruction *CreateCALL(std::string &Name, std::vector<Value *> Args,
+  CallInstruction *CreateCALL(const std::string &Name, std::vector<Value *> Args,
                               IRType Type) {
     auto Inst =
         std::make_unique<CallInstruction>(Name, Args, Type, GetCurrentBB());
@@ -238,6 +239,11 @@ public:
 
   CompareInstruction *CreateCMP(CompareInstruction::CompRel Relation,
                                 Value *LHS, Value *RHS) {
+    // a constant first operand, like the condition of "while (1)", has to be
+    // in a register, only the second one can be an immediate
+    if (LHS->IsConstant())
+      LHS = CreateMOV(LHS, RHS->GetBitWidth());
+
     auto Inst = std::make_unique<CompareInstruction>(LHS, RHS, Relation,
                                                      GetCurrentBB());
     auto InstPtr = Inst.get();
@@ -266,14 +272,14 @@ public:
     return InstPtr;
   }
 
-  GlobalVariable *CreateGlobalVar(std::string &Identifier, IRType Type) {
+  GlobalVariable *CreateGlobalVar(Symbol Identifier, IRType Type) {
     auto GlobalVar = new GlobalVariable(Identifier, Type);
     GlobalVar->SetID(ID++);
 
     return GlobalVar;
   }
 
-  GlobalVariable *CreateGlobalVar(std::string &Identifier, IRType Type,
+  GlobalVariable *CreateGlobalVar(Symbol Identifier, IRType Type,
                                   std::vector<uint64_t> InitList) {
     auto GlobalVar = new GlobalVariable(Identifier, Type, std::move(InitList));
     GlobalVar->SetID(ID++);
@@ -281,7 +287,7 @@ public:
     return GlobalVar;
   }
 
-  void CreateNewFunction(std::string &Name, IRType ReturnType) {
+  void CreateNewFunction(const std::string &Name, IRType ReturnType) {
     CurrentModule.AddFunction(std::move(Function(Name, ReturnType)));
     SymbolTable.clear();
     LabelTable.clear();
@@ -294,7 +300,7 @@ public:
     SetGlobalScope(false);
   }
 
-  Value *GetGlobalVar(const std::string &Identifier) {
+  Value *GetGlobalVar(Symbol Identifier) {
     return CurrentModule.GetGlobalVar(Identifier);
   }
 
@@ -311,9 +317,8 @@ public:
 
   void InsertBB(std::unique_ptr<BasicBlock> BB) {
     // Modify label name to guarantee its uniqueness
-    auto NewName = BB->GetName() + std::to_string(LabelTable[BB->GetName()]);
-    LabelTable[BB->GetName()]++;
-    BB->SetName(NewName);
+    auto &LabelCount = LabelTable[Symbol(BB->GetName())];
+    BB->SetName(BB->GetName() + std::to_string(LabelCount++));
 
     GetCurrentFunction()->Insert(std::move(BB));
   }
@@ -323,12 +328,13 @@ public:
     GetCurrentFunction()->Insert(std::move(FP));
   }
 
-  void AddToSymbolTable(std::string &Identifier, Value *Value) {
+  void AddToSymbolTable(Symbol Identifier, Value *Value) {
     SymbolTable[Identifier] = Value;
   }
 
-  Value *GetSymbolValue(const std::string &Identifier) {
-    return SymbolTable[Identifier];
+  Value *GetSymbolValue(Symbol Identifier) {
+    auto It = SymbolTable.find(Identifier);
+    return It != SymbolTable.end() ? It->second : nullptr;
   }
 
   Constant *GetConstant(uint64_t C) {
@@ -377,11 +383,11 @@ private:
   // FIXME: Consider putting these to Function class
 
   /// Hold the local symbols for the current function.
-  std::map<std::string, Value *> SymbolTable;
+  std::unordered_map<Symbol, Value *> SymbolTable;
 
   /// To keep track how many times each label were defined. This number
   /// can be used to concatenate it to the label to make it unique.
-  std::map<std::string, unsigned> LabelTable;
+  std::unordered_map<Symbol, unsigned> LabelTable;
 
   /// For context information for "continue" statements. Containing the pointer
   /// to the basic block which will be the target of the generated jump.
@@ -35,7 +35,7 @@ bool Module::IsGlobalValue(Value *V) const {
   return false;
 }
 
-Value *Module::GetGlobalVar(const std::string &Name) const {
+Value *Module::GetGlobalVar(Symbol Name) const {
   for (auto &GV : GlobalVars)
     if (((GlobalVariable*)GV.get())->GetName() == Name)
       return GV.get();
@@ -1,6 +1,7 @@
 #ifndef MODULE_HPP
 #define MODULE_HPP
 
+#include "../../support/Symbol.hpp"
 #include "Type.hpp"
 #include <cassert>
 #include <memory>
@@ -29,7 +30,7 @@ public:
 
   bool IsGlobalValue(Value *V) const;
 
-  Value *GetGlobalVar(const std::string &Name) const;
+  Value *GetGlobalVar(Symbol Name) const;
 
   BasicBlock *CreateBasicBlock();
 
@@ -1,6 +1,7 @@
 #ifndef VALUE_HPP
 #define VALUE_HPP
 
+#include "../../support/Symbol.hpp"
 #include "Type.hpp"
 #include <iostream>
 #include <string>
@@ -69,36 +70,36 @@ private:
 class FunctionParameter : public Value {
 public:
   FunctionParameter() = delete;
-  FunctionParameter(std::string &Name, IRType Type)
+  FunctionParameter(Symbol Name, IRType Type)
       : Value(PARAM, Type), Name(Name) {}
 
-  std::string &GetName() { return Name; }
-  std::string ValueString() const override { return "$" + Name; }
+  Symbol GetName() const { return Name; }
+  std::string ValueString() const override { return "$" + Name.GetString(); }
 
 private:
-  std::string Name;
+  Symbol Name;
 };
 
 class GlobalVariable : public Value {
 public:
   GlobalVariable() = delete;
-  GlobalVariable(std::string &Name, IRType Type)
+  GlobalVariable(Symbol Name, IRType Type)
       : Value(GLOBALVAR, Type), Name(Name) {}
 
-  GlobalVariable(std::string &Name, IRType Type, std::vector<uint64_t> InitList)
+  GlobalVariable(Symbol Name, IRType Type, std::vector<uint64_t> InitList)
       : Value(GLOBALVAR, Type), Name(Name),
         InitList(std::move(InitList)) {}
 
-  std::string &GetName() { return Name; }
+  Symbol GetName() const { return Name; }
   std::vector<uint64_t> &GetInitList() { return InitList; }
 
   std::string ValueString() const override {
-    return "@" + Name + "<" + ValueType.AsString() + ">";
+    return "@" + Name.GetString() + "<" + ValueType.AsString() + ">";
   }
 
   void Print() const {
     std::cout << "global var (" << GetType().AsString() << "):" << std::endl
-              << "\t" << Name;
+              << "\t" << Name.GetString();
 
     if (!InitList.empty()) {
       std::cout << " = {";
@@ -114,7 +115,7 @@ public:
   }
 
 private:
-  std::string Name;
+  Symbol Name;
   std::vector<uint64_t> InitList;
 };
 
@@ -0,0 +1,96 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Bump pointer allocator. Memory is carved out of large slabs and can only be
+/// released all at once, so allocating is a pointer increment and freeing the
+/// whole arena costs one deallocation per slab. Requests bigger than a slab
+/// get a slab of their own.
+class Arena {
+public:
+  static constexpr size_t SlabSize = 64 * 1024;
+
+  Arena() = default;
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  void *Allocate(size_t Size, size_t Align) {
+    assert(Align && !(Align & (Align - 1)) && "Alignment must be power of 2");
+
+    auto Pos = (reinterpret_cast<uintptr_t>(Cur) + Align - 1) & ~(Align - 1);
+    if (Cur && Pos + Size <= reinterpret_cast<uintptr_t>(End)) {
+      Cur = reinterpret_cast<char *>(Pos + Size);
+      BytesUsed += Size;
+      return reinterpret_cast<void *>(Pos);
+    }
+
+    return AllocateSlow(Size, Align);
+  }
+
+  template <typename T> T *Allocate(size_t Num = 1) {
+    return static_cast<T *>(Allocate(Num * sizeof(T), alignof(T)));
+  }
+
+  /// Release every slab. All the memory handed out so far becomes invalid.
+  void Reset() {
+    Slabs.clear();
+    Cur = End = nullptr;
+    BytesUsed = BytesAllocated = 0;
+  }
+
+  /// Take over the slabs of @Other, which becomes empty. The memory handed out
+  /// by @Other stays valid and is released with this arena.
+  void Adopt(Arena &Other) {
+    for (auto &Slab : Other.Slabs)
+      Slabs.push_back(std::move(Slab));
+    BytesUsed += Other.BytesUsed;
+    BytesAllocated += Other.BytesAllocated;
+
+    Other.Slabs.clear();
+    Other.Cur = Other.End = nullptr;
+    Other.BytesUsed = Other.BytesAllocated = 0;
+  }
+
+  /// Bytes handed out by Allocate, without the alignment padding.
+  size_t GetBytesUsed() const { return BytesUsed; }
+
+  /// Bytes requested from the system.
+  size_t GetBytesAllocated() const { return BytesAllocated; }
+
+  size_t GetNumSlabs() const { return Slabs.size(); }
+
+private:
+  void *AllocateSlow(size_t Size, size_t Align) {
+    auto NewSlabSize = Size + Align > SlabSize ? Size + Align : SlabSize;
+    // not make_unique, which would zero the slab
+    Slabs.emplace_back(new char[NewSlabSize]);
+    BytesAllocated += NewSlabSize;
+
+    auto Start = Slabs.back().get();
+    auto Pos = (reinterpret_cast<uintptr_t>(Start) + Align - 1) & ~(Align - 1);
+    BytesUsed += Size;
+
+    // Keep bumping in the current slab if the new one was only made for this
+    // oversized request and the current one still has more room left.
+    auto Remaining = NewSlabSize - (Pos + Size - uintptr_t(Start));
+    if (NewSlabSize == SlabSize || size_t(End - Cur) < Remaining) {
+      Cur = reinterpret_cast<char *>(Pos + Size);
+      End = Start + NewSlabSize;
+    }
+
+    return reinterpret_cast<void *>(Pos);
+  }
+
+  std::vector<std::unique_ptr<char[]>> Slabs;
+  char *Cur = nullptr;
+  char *End = nullptr;
+  size_t BytesUsed = 0;
+  size_t BytesAllocated = 0;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef BINARYSTREAM_HPP
+#define BINARYSTREAM_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/// Appends fixed size values and length prefixed strings to a byte string.
+/// The values are written in the byte order of the host, the files are meant
+/// to be read back by the same compiler on the same machine.
+class BinaryWriter {
+public:
+  template <typename T> void Write(T Value) {
+    static_assert(std::is_arithmetic_v<T>, "Only numbers can be written.");
+    Out.append(reinterpret_cast<const char *>(&Value), sizeof(T));
+  }
+
+  /// Write @Value 7 bits a byte (LEB128), for the values which are usually
+  /// small, like indices and counts.
+  void WriteVarUInt(uint64_t Value) {
+    while (Value >= 0x80) {
+      Out.push_back(char(Value | 0x80));
+      Value >>= 7;
+    }
+    Out.push_back(char(Value));
+  }
+
+  void WriteString(std::string_view Str) {
+    Write<uint32_t>(Str.size());
+    Out.append(Str);
+  }
+
+  /// Append the content of another writer.
+  void Append(const BinaryWriter &Other) { Out.append(Other.Out); }
+
+  const std::string &GetBuffer() const { return Out; }
+
+private:
+  std::string Out;
+};
+
+/// Reads back the values written by a BinaryWriter from a buffer, usually a
+/// memory mapped file. Reading past the end does not fail immediately, it
+/// returns zeros and empty strings and sets the error flag, so the callers
+/// only have to check HasError at the end.
+class BinaryReader {
+public:
+  BinaryReader(std::string_view Buffer) : Buffer(Buffer) {}
+
+  template <typename T> T Read() {
+    static_assert(std::is_arithmetic_v<T>, "Only numbers can be read.");
+    T Value{};
+    if (Pos + sizeof(T) > Buffer.size()) {
+      Error = true;
+      return Value;
+    }
+    memcpy(&Value, Buffer.data() + Pos, sizeof(T));
+    Pos += sizeof(T);
+    return Value;
+  }
+
+  uint64_t ReadVarUInt() {
+    uint64_t Value = 0;
+    for (unsigned Shift = 0; Shift < 64; Shift += 7) {
+      auto Byte = Read<uint8_t>();
+      Value |= uint64_t(Byte & 0x7f) << Shift;
+      if (!(Byte & 0x80))
+        return Value;
+    }
+    Error = true;
+    return 0;
+  }
+
+  /// The returned view points into the buffer.
+  std::string_view ReadString() {
+    auto Size = Read<uint32_t>();
+    if (Pos + Size > Buffer.size()) {
+      Error = true;
+      return {};
+    }
+    auto Str = Buffer.substr(Pos, Size);
+    Pos += Size;
+    return Str;
+  }
+
+  /// The number of bytes read so far.
+  size_t GetPosition() const { return Pos; }
+
+  bool AtEnd() const { return Pos == Buffer.size(); }
+  bool HasError() const { return Error; }
+
+  /// Mark the content invalid, eg.: an index out of range was read.
+  void SetError() { Error = true; }
+
+private:
+  std::string_view Buffer;
+  size_t Pos = 0;
+  bool Error = false;
+};
+
+#endif
@@ -0,0 +1,175 @@
+#include "CompileCache.hpp"
+#include <algorithm>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <sys/file.h>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+std::string CompileCache::GetEntryPath(const std::string &Key) const {
+  // the first two characters name a subdirectory, so no directory gets huge
+  return Directory + "/" + Key.substr(0, 2) + "/" + Key.substr(2);
+}
+
+int CompileCache::LockStats(Stats &S) {
+  std::error_code EC;
+  fs::create_directories(Directory, EC);
+
+  auto LockFD = open((Directory + "/stats.lock").c_str(), O_RDWR | O_CREAT,
+                     0644);
+  if (LockFD < 0)
+    return -1;
+  if (flock(LockFD, LOCK_EX) != 0) {
+    close(LockFD);
+    return -1;
+  }
+
+  std::ifstream File(Directory + "/stats");
+  std::string Name;
+  uint64_t Value;
+  while (File >> Name >> Value) {
+    if (Name == "hits")
+      S.Hits = Value;
+    else if (Name == "misses")
+      S.Misses = Value;
+    else if (Name == "evictions")
+      S.Evictions = Value;
+    else if (Name == "files")
+      S.Files = Value;
+    else if (Name == "size")
+      S.Size = Value;
+  }
+
+  return LockFD;
+}
+
+void CompileCache::UnlockStats(int LockFD, const Stats &S) {
+  auto TempPath = Directory + "/stats.tmp";
+  {
+    std::ofstream File(TempPath);
+    File << "hits " << S.Hits << "\n"
+         << "misses " << S.Misses << "\n"
+         << "evictions " << S.Evictions << "\n"
+         << "files " << S.Files << "\n"
+         << "size " << S.Size << "\n";
+  }
+  std::error_code EC;
+  fs::rename(TempPath, Directory + "/stats", EC);
+
+  close(LockFD);
+}
+
+std::optional<std::string> CompileCache::Lookup(const std::string &Key) {
+  auto Path = GetEntryPath(Key);
+  std::optional<std::string> Output;
+
+  // the entries are only renamed into place and removed, so no lock is
+  // needed to read one
+  if (std::ifstream File(Path, std::ios::binary); File) {
+    std::ostringstream Content;
+    Content << File.rdbuf();
+    Output = Content.str();
+
+    // the modification time is the time of the last use
+    std::error_code EC;
+    fs::last_write_time(Path, fs::file_time_type::clock::now(), EC);
+  }
+
+  Stats S;
+  auto LockFD = LockStats(S);
+  if (LockFD < 0)
+    return Output;
+  (Output ? S.Hits : S.Misses)++;
+  UnlockStats(LockFD, S);
+
+  return Output;
+}
+
+void CompileCache::Store(const std::string &Key, std::string_view Output) {
+  Stats S;
+  auto LockFD = LockStats(S);
+  if (LockFD < 0)
+    return;
+
+  // another process might have stored it since the lookup
+  auto Path = GetEntryPath(Key);
+  std::error_code EC;
+  if (!fs::exists(Path, EC)) {
+    fs::create_directories(fs::path(Path).parent_path(), EC);
+
+    auto TempPath = Path + ".tmp" + std::to_string(getpid());
+    std::ofstream File(TempPath, std::ios::binary);
+    File.write(Output.data(), Output.size());
+    File.close();
+
+    if (File) {
+      fs::rename(TempPath, Path, EC);
+      if (!EC) {
+        S.Files++;
+        S.Size += Output.size();
+      }
+    } else
+      fs::remove(TempPath, EC);
+  }
+
+  if (S.Size > MaxSize)
+    Evict(S);
+
+  UnlockStats(LockFD, S);
+}
+
+void CompileCache::Evict(Stats &S) {
+  // last use, size and path of every entry
+  std::vector<std::tuple<fs::file_time_type, uint64_t, fs::path>> Entries;
+  uint64_t TotalSize = 0;
+
+  std::error_code EC;
+  for (auto It = fs::recursive_directory_iterator(Directory, EC);
+       !EC && It != fs::recursive_directory_iterator(); It.increment(EC)) {
+    // the entries are in the subdirectories, the statistics are not
+    if (It.depth() != 1 || !It->is_regular_file(EC))
+      continue;
+
+    auto Size = It->file_size(EC);
+    Entries.emplace_back(It->last_write_time(EC), Size, It->path());
+    TotalSize += Size;
+  }
+
+  std::sort(Entries.begin(), Entries.end());
+
+  // evict below the limit, so not every store has to evict
+  auto Target = MaxSize / 10 * 9;
+  size_t Removed = 0;
+  for (; Removed < Entries.size() && TotalSize > Target; Removed++) {
+    auto &[LastUse, Size, Path] = Entries[Removed];
+    fs::remove(Path, EC);
+    TotalSize -= Size;
+    S.Evictions++;
+  }
+
+  S.Files = Entries.size() - Removed;
+  S.Size = TotalSize;
+}
+
+void CompileCache::PrintStats(std::ostream &OS) {
+  Stats S;
+  auto LockFD = LockStats(S);
+  if (LockFD >= 0)
+    close(LockFD); // only read, so nothing to write back
+
+  auto Lookups = S.Hits + S.Misses;
+  OS << "cache directory: " << Directory << "\n"
+     << "hits:            " << S.Hits << "\n"
+     << "misses:          " << S.Misses << "\n"
+     << "hit rate:        "
+     << (Lookups ? 100.0 * S.Hits / Lookups : 0.0) << " %\n"
+     << "evictions:       " << S.Evictions << "\n"
+     << "files:           " << S.Files << "\n"
+     << "size:            " << S.Size << " bytes (limit " << MaxSize
+     << " bytes)" << std::endl;
+}
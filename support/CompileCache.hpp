@@ -0,0 +1,62 @@
+#ifndef COMPILECACHE_HPP
+#define COMPILECACHE_HPP
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/// Content addressed cache of compilation outputs on the disk, shared by
+/// every miniCC process using the same directory. The key is a hash of
+/// everything the output depends on, computed by the driver, the value is
+/// the output.
+///
+/// The entries are files named by their key, written to a temporary file
+/// first and renamed, so a reader never sees a partial entry. Their
+/// modification time is the time of their last use: when the total size is
+/// over the limit, the least recently used entries are removed. The size and
+/// the hit and miss counters are kept in a statistics file, updated under a
+/// file lock.
+class CompileCache {
+public:
+  CompileCache(std::string Directory, uint64_t MaxSize)
+      : Directory(std::move(Directory)), MaxSize(MaxSize) {}
+
+  /// Returns the output stored for @Key, and counts a hit or a miss.
+  std::optional<std::string> Lookup(const std::string &Key);
+
+  /// Store @Output for @Key, evicting old entries if needed.
+  void Store(const std::string &Key, std::string_view Output);
+
+  void PrintStats(std::ostream &OS);
+
+  /// The default limit of the total size of the entries.
+  static constexpr uint64_t DefaultMaxSize = 64 * 1024 * 1024;
+
+private:
+  struct Stats {
+    uint64_t Hits = 0;
+    uint64_t Misses = 0;
+    uint64_t Evictions = 0;
+    uint64_t Files = 0;
+    uint64_t Size = 0;
+  };
+
+  std::string GetEntryPath(const std::string &Key) const;
+
+  /// Create the directory if needed and lock the statistics, which are read
+  /// into @S. Returns the file descriptor of the lock, or -1 on failure.
+  int LockStats(Stats &S);
+  /// Write back @S and release the lock @LockFD.
+  void UnlockStats(int LockFD, const Stats &S);
+
+  /// Remove the least recently used entries until the total size is well
+  /// below the limit. The size and the number of files are recounted.
+  void Evict(Stats &S);
+
+  std::string Directory;
+  uint64_t MaxSize;
+};
+
+#endif
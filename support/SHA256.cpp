@@ -0,0 +1,117 @@
+#include "SHA256.hpp"
+#include <algorithm>
+#include <cstring>
+
+static constexpr uint32_t RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+static uint32_t RotateRight(uint32_t X, unsigned N) {
+  return (X >> N) | (X << (32 - N));
+}
+
+void SHA256::ProcessBlock(const uint8_t *Block) {
+  uint32_t W[64];
+  for (unsigned i = 0; i < 16; i++)
+    W[i] = uint32_t(Block[i * 4]) << 24 | uint32_t(Block[i * 4 + 1]) << 16 |
+           uint32_t(Block[i * 4 + 2]) << 8 | uint32_t(Block[i * 4 + 3]);
+  for (unsigned i = 16; i < 64; i++) {
+    auto S0 = RotateRight(W[i - 15], 7) ^ RotateRight(W[i - 15], 18) ^
+              (W[i - 15] >> 3);
+    auto S1 = RotateRight(W[i - 2], 17) ^ RotateRight(W[i - 2], 19) ^
+              (W[i - 2] >> 10);
+    W[i] = W[i - 16] + S0 + W[i - 7] + S1;
+  }
+
+  auto [A, B, C, D, E, F, G, H] = State;
+  for (unsigned i = 0; i < 64; i++) {
+    auto S1 = RotateRight(E, 6) ^ RotateRight(E, 11) ^ RotateRight(E, 25);
+    auto Choice = (E & F) ^ (~E & G);
+    auto Temp1 = H + S1 + Choice + RoundConstants[i] + W[i];
+    auto S0 = RotateRight(A, 2) ^ RotateRight(A, 13) ^ RotateRight(A, 22);
+    auto Majority = (A & B) ^ (A & C) ^ (B & C);
+    auto Temp2 = S0 + Majority;
+
+    H = G;
+    G = F;
+    F = E;
+    E = D + Temp1;
+    D = C;
+    C = B;
+    B = A;
+    A = Temp1 + Temp2;
+  }
+
+  State[0] += A;
+  State[1] += B;
+  State[2] += C;
+  State[3] += D;
+  State[4] += E;
+  State[5] += F;
+  State[6] += G;
+  State[7] += H;
+}
+
+void SHA256::Update(std::string_view Data) {
+  TotalSize += Data.size();
+  auto Bytes = reinterpret_cast<const uint8_t *>(Data.data());
+  auto Size = Data.size();
+
+  // complete the partial block first
+  if (BufferSize > 0) {
+    auto Count = std::min(Size, Buffer.size() - BufferSize);
+    memcpy(Buffer.data() + BufferSize, Bytes, Count);
+    BufferSize += Count;
+    Bytes += Count;
+    Size -= Count;
+    if (BufferSize < Buffer.size())
+      return;
+    ProcessBlock(Buffer.data());
+    BufferSize = 0;
+  }
+
+  for (; Size >= Buffer.size(); Bytes += Buffer.size(), Size -= Buffer.size())
+    ProcessBlock(Bytes);
+
+  memcpy(Buffer.data(), Bytes, Size);
+  BufferSize = Size;
+}
+
+SHA256::Digest SHA256::Final() {
+  uint64_t BitSize = TotalSize * 8;
+
+  // a 1 bit, zeros until 8 bytes are left of the last block, then the size
+  static constexpr uint8_t Padding[64] = {0x80};
+  Update({reinterpret_cast<const char *>(Padding),
+          1 + (119 - BufferSize) % 64});
+
+  uint8_t SizeBytes[8];
+  for (unsigned i = 0; i < 8; i++)
+    SizeBytes[i] = BitSize >> (56 - i * 8);
+  Update({reinterpret_cast<const char *>(SizeBytes), 8});
+
+  Digest Result;
+  for (unsigned i = 0; i < 8; i++)
+    for (unsigned j = 0; j < 4; j++)
+      Result[i * 4 + j] = State[i] >> (24 - j * 8);
+  return Result;
+}
+
+std::string SHA256::ToHex(const Digest &D) {
+  static constexpr char HexDigits[] = "0123456789abcdef";
+  std::string Hex;
+  for (auto Byte : D) {
+    Hex.push_back(HexDigits[Byte >> 4]);
+    Hex.push_back(HexDigits[Byte & 0xf]);
+  }
+  return Hex;
+}
@@ -0,0 +1,40 @@
+#ifndef SHA256_HPP
+#define SHA256_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/// Incremental SHA-256 (FIPS 180-4). Used where a collision would silently
+/// produce a wrong result, like the keys of the compilation cache.
+class SHA256 {
+public:
+  using Digest = std::array<uint8_t, 32>;
+
+  SHA256() = default;
+
+  void Update(std::string_view Data);
+
+  /// Hash a number by its bytes, so eg.: a length can separate two strings.
+  template <typename T> void UpdateValue(T Value) {
+    Update({reinterpret_cast<const char *>(&Value), sizeof(T)});
+  }
+
+  /// Finish the hash. The object must not be updated afterwards.
+  Digest Final();
+
+  static std::string ToHex(const Digest &D);
+
+private:
+  void ProcessBlock(const uint8_t *Block);
+
+  std::array<uint32_t, 8> State = {0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                                   0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                   0x1f83d9ab, 0x5be0cd19};
+  std::array<uint8_t, 64> Buffer;
+  size_t BufferSize = 0;
+  uint64_t TotalSize = 0;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/// Bounded lock-free queue between exactly one producer thread, which only
+/// calls TryPush, and one consumer thread, which only calls TryPop. Each side
+/// owns its index and caches the last seen index of the other side, so the
+/// shared cache lines are only touched when the queue looks full or empty.
+template <typename T, size_t Capacity> class SPSCQueue {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of 2");
+
+public:
+  SPSCQueue() : Buffer(new T[Capacity]) {}
+  SPSCQueue(const SPSCQueue &) = delete;
+  SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+  /// Returns false if the queue is full.
+  bool TryPush(const T &Value) {
+    auto CurrentTail = Tail.load(std::memory_order_relaxed);
+    if (CurrentTail - CachedHead == Capacity) {
+      CachedHead = Head.load(std::memory_order_acquire);
+      if (CurrentTail - CachedHead == Capacity)
+        return false;
+    }
+
+    Buffer[CurrentTail & (Capacity - 1)] = Value;
+    Tail.store(CurrentTail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Returns false if the queue is empty.
+  bool TryPop(T &Value) {
+    auto CurrentHead = Head.load(std::memory_order_relaxed);
+    if (CurrentHead == CachedTail) {
+      CachedTail = Tail.load(std::memory_order_acquire);
+      if (CurrentHead == CachedTail)
+        return false;
+    }
+
+    Value = Buffer[CurrentHead & (Capacity - 1)];
+    Head.store(CurrentHead + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::unique_ptr<T[]> Buffer;
+
+  /// Written by the consumer.
+  alignas(64) std::atomic<size_t> Head = 0;
+  size_t CachedTail = 0;
+
+  /// Written by the producer.
+  alignas(64) std::atomic<size_t> Tail = 0;
+  size_t CachedHead = 0;
+};
+
+#endif
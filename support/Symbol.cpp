@@ -0,0 +1,27 @@
+#include "Symbol.hpp"
+
+SymbolInterner::SymbolInterner() { Intern(""); }
+
+SymbolInterner &SymbolInterner::Get() {
+  static SymbolInterner Interner;
+  return Interner;
+}
+
+uint32_t SymbolInterner::Intern(std::string_view Str) {
+  {
+    std::shared_lock<std::shared_mutex> Guard(Lock);
+    if (auto It = IDs.find(Str); It != IDs.end())
+      return It->second;
+  }
+
+  std::unique_lock<std::shared_mutex> Guard(Lock);
+  // another thread might have added it since
+  if (auto It = IDs.find(Str); It != IDs.end())
+    return It->second;
+
+  uint32_t ID = Strings.size();
+  Strings.emplace_back(Str);
+  IDs.emplace(Strings.back(), ID);
+
+  return ID;
+}
@@ -0,0 +1,81 @@
+#ifndef SYMBOL_HPP
+#define SYMBOL_HPP
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/// Process wide table of the interned strings. Every distinct string is
+/// stored exactly once and identified by a 32 bit ID, which never changes and
+/// whose string is never freed. ID 0 is reserved for the empty string. It can
+/// be used from several threads at once.
+class SymbolInterner {
+public:
+  static SymbolInterner &Get();
+
+  /// Returns the ID of @Str, adding it to the table if it is new.
+  uint32_t Intern(std::string_view Str);
+
+  const std::string &GetString(uint32_t ID) const {
+    std::shared_lock<std::shared_mutex> Guard(Lock);
+    return Strings[ID];
+  }
+
+  size_t Size() const {
+    std::shared_lock<std::shared_mutex> Guard(Lock);
+    return Strings.size();
+  }
+
+private:
+  SymbolInterner();
+  SymbolInterner(const SymbolInterner &) = delete;
+  SymbolInterner &operator=(const SymbolInterner &) = delete;
+
+  /// A deque never moves its elements, so the views used as keys stay valid.
+  std::deque<std::string> Strings;
+  std::unordered_map<std::string_view, uint32_t> IDs;
+  /// Most of the strings are interned already, so lookups only share it.
+  mutable std::shared_mutex Lock;
+};
+
+/// Handle of an interned string, used for every identifier (variable,
+/// function, struct, member and label names) from the parser down to the
+/// backend. Comparison and hashing only use the ID.
+class Symbol {
+public:
+  Symbol() = default;
+  explicit Symbol(std::string_view Str)
+      : ID(SymbolInterner::Get().Intern(Str)) {}
+
+  uint32_t GetID() const { return ID; }
+  bool Empty() const { return ID == 0; }
+
+  const std::string &GetString() const {
+    return SymbolInterner::Get().GetString(ID);
+  }
+
+  /// Null terminated and valid until the end of the process.
+  const char *GetCString() const { return GetString().c_str(); }
+
+  bool operator==(const Symbol &RHS) const { return ID == RHS.ID; }
+  bool operator!=(const Symbol &RHS) const { return ID != RHS.ID; }
+
+  /// Orders by ID (the order of interning), not alphabetically.
+  bool operator<(const Symbol &RHS) const { return ID < RHS.ID; }
+
+private:
+  uint32_t ID = 0;
+};
+
+namespace std {
+template <> struct hash<Symbol> {
+  size_t operator()(const Symbol &S) const { return S.GetID(); }
+};
+} // namespace std
+
+#endif
@@ -0,0 +1,60 @@
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(unsigned NumThreads) {
+  if (NumThreads == 0)
+    NumThreads = GetHardwareConcurrency();
+
+  for (unsigned i = 0; i < NumThreads; i++)
+    Threads.emplace_back([this] { Work(); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> Guard(Lock);
+    Stopping = true;
+  }
+  TaskAdded.notify_all();
+
+  for (auto &Thread : Threads)
+    Thread.join();
+}
+
+void ThreadPool::Async(std::function<void()> Task) {
+  {
+    std::lock_guard<std::mutex> Guard(Lock);
+    Tasks.push_back(std::move(Task));
+    Pending++;
+  }
+  TaskAdded.notify_one();
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock<std::mutex> Guard(Lock);
+  TasksDone.wait(Guard, [this] { return Pending == 0; });
+}
+
+unsigned ThreadPool::GetHardwareConcurrency() {
+  auto N = std::thread::hardware_concurrency();
+  return N ? N : 1;
+}
+
+void ThreadPool::Work() {
+  while (true) {
+    std::function<void()> Task;
+    {
+      std::unique_lock<std::mutex> Guard(Lock);
+      TaskAdded.wait(Guard, [this] { return Stopping || !Tasks.empty(); });
+      // the remaining tasks are still run when stopping
+      if (Tasks.empty())
+        return;
+      Task = std::move(Tasks.front());
+      Tasks.pop_front();
+    }
+
+    Task();
+
+    std::lock_guard<std::mutex> Guard(Lock);
+    if (--Pending == 0)
+      TasksDone.notify_all();
+  }
+}
@@ -0,0 +1,44 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Fixed number of threads running the tasks given to Async in FIFO order.
+/// The threads are joined by the destructor, after the remaining tasks.
+class ThreadPool {
+public:
+  /// Start @NumThreads threads, or as many as the hardware threads if 0.
+  explicit ThreadPool(unsigned NumThreads = 0);
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ~ThreadPool();
+
+  void Async(std::function<void()> Task);
+
+  /// Block until every task given so far is done.
+  void Wait();
+
+  unsigned GetNumThreads() const { return Threads.size(); }
+
+  /// The number of hardware threads, at least 1.
+  static unsigned GetHardwareConcurrency();
+
+private:
+  void Work();
+
+  std::vector<std::thread> Threads;
+  std::deque<std::function<void()>> Tasks;
+  /// The tasks given, but not finished yet.
+  unsigned Pending = 0;
+  bool Stopping = false;
+  std::mutex Lock;
+  std::condition_variable TaskAdded;
+  std::condition_variable TasksDone;
+};
+
+#endif
@@ -0,0 +1,100 @@
+// Loads AST files which are cut short or miss a required child, like
+// -load-ast does. They have to be rejected instead of giving a tree which the
+// code generation would crash on.
+
+#include "../../frontend/ast/ASTFile.hpp"
+#include "../../frontend/parser/Parser.hpp"
+#include "../../frontend/preprocessor/PreProcessor.hpp"
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <string>
+
+static const char *Source = "long test(int a, long b) {\n"
+                            "  if (a)\n"
+                            "    while (a)\n"
+                            "      return -a + b;\n"
+                            "  return 0;\n"
+                            "}\n";
+
+static const char *Path = "ast-file-test.ast";
+
+/// The nodes of Source whose children are removed.
+struct Nodes {
+  IfStatement *If;
+  WhileStatement *While;
+  BinaryExpression *Sum;
+  ImplicitCastExpression *Cast;
+  UnaryExpression *Minus;
+};
+
+/// Parse Source, change it with @Mutate and return its AST file.
+static std::string Write(std::function<void(Nodes &)> Mutate) {
+  SourceManager SM;
+  auto ID = SM.AddBuffer(Source, "ast-file-test.c");
+  PreProcessor PP(SM, ID, "ast-file-test.c");
+  ASTContext Ctx;
+  Parser P(SM, PP, Ctx, nullptr);
+  auto TU = static_cast<TranslationUnit *>(P.Parse());
+
+  auto Function = static_cast<FunctionDeclaration *>(TU->GetDeclarations()[0]);
+  Nodes N;
+  N.If = static_cast<IfStatement *>(Function->GetBody()->GetStatements()[0]);
+  N.While = static_cast<WhileStatement *>(N.If->GetIfBody());
+  auto Return = static_cast<ReturnStatement *>(N.While->GetBody());
+  N.Sum = static_cast<BinaryExpression *>(Return->GetRetVal());
+  N.Cast = static_cast<ImplicitCastExpression *>(N.Sum->GetLeftExpr());
+  N.Minus = static_cast<UnaryExpression *>(N.Cast->GetCastableExpression());
+
+  Mutate(N);
+  return ASTFile::Write(TU);
+}
+
+/// Save @Content into a file and load it. Returns true if it was accepted.
+static bool Load(const std::string &Content) {
+  std::ofstream(Path, std::ios::binary) << Content;
+  SourceManager SM;
+  ASTContext Ctx;
+  return ASTFile::Load(SM, Path, Ctx) != nullptr;
+}
+
+int main() {
+  bool Failed = false;
+
+  auto Valid = Write([](Nodes &) {});
+  if (!Load(Valid)) {
+    std::printf("the valid file was rejected\n");
+    Failed = true;
+  }
+
+  for (size_t Size = 0; Size < Valid.size(); Size++)
+    if (Load(Valid.substr(0, Size))) {
+      std::printf("the file cut to %zu of %zu bytes was loaded\n", Size,
+                  Valid.size());
+      Failed = true;
+    }
+
+  struct {
+    const char *Name;
+    std::function<void(Nodes &)> Mutate;
+  } Cases[] = {
+      {"left operand", [](Nodes &N) { N.Sum->SetLeftExpr(nullptr); }},
+      {"right operand", [](Nodes &N) { N.Sum->SetRightExpr(nullptr); }},
+      {"unary operand", [](Nodes &N) { N.Minus->SetExpr(nullptr); }},
+      {"cast operand",
+       [](Nodes &N) { N.Cast->SetCastableExpression(nullptr); }},
+      {"if condition", [](Nodes &N) { N.If->SetCondition(nullptr); }},
+      {"if body", [](Nodes &N) { N.If->SetIfBody(nullptr); }},
+      {"while condition", [](Nodes &N) { N.While->SetCondition(nullptr); }},
+      {"while body", [](Nodes &N) { N.While->SetBody(nullptr); }},
+  };
+
+  for (auto &Case : Cases)
+    if (Load(Write(Case.Mutate))) {
+      std::printf("the file without the %s was loaded\n", Case.Name);
+      Failed = true;
+    }
+
+  std::remove(Path);
+  return Failed ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+// Folds shifts whose operands have different types. The width of a shift is
+// the one of the promoted left operand, a shift by it or more is undefined and
+// has to be left to the code generation. Also folds a sum of 100k terms, which
+// must not take a stack frame per operand.
+
+#include "../../frontend/ast/ConstantFolder.hpp"
+#include "../../frontend/parser/Parser.hpp"
+#include "../../frontend/preprocessor/PreProcessor.hpp"
+#include <cstdio>
+#include <string>
+
+/// Fold "return Expr;" and return the folded value, or std::nullopt if it was
+/// not folded to a literal.
+static std::optional<uint64_t> Fold(const std::string &Expr) {
+  auto Src = "long test() {\n  return " + Expr + ";\n}\n";
+
+  SourceManager SM;
+  auto ID = SM.AddBuffer(Src, "constant-folder-test.c");
+  PreProcessor PP(SM, ID, "constant-folder-test.c");
+  ASTContext Ctx;
+  Parser P(SM, PP, Ctx, nullptr);
+  auto TU = static_cast<TranslationUnit *>(P.Parse());
+  ConstantFolder(Ctx).Visit(TU);
+
+  auto Function = static_cast<FunctionDeclaration *>(TU->GetDeclarations()[0]);
+  auto Return =
+      static_cast<ReturnStatement *>(Function->GetBody()->GetStatements()[0]);
+  auto Literal = DynCast<IntegerLiteralExpression>(Return->GetRetVal());
+  if (!Literal)
+    return std::nullopt;
+  return Literal->GetUIntValue();
+}
+
+int main() {
+  const unsigned Terms = 100000;
+  std::string Sum = "1";
+  for (unsigned i = 1; i < Terms; i++)
+    Sum += " + 1";
+
+  struct {
+    std::string Expr;
+    std::optional<uint64_t> Expected;
+  } Cases[] = {
+      {"1 << 4l", 16},
+      {"1l << 40", uint64_t(1) << 40},
+      {"1 << 31l", uint64_t(1) << 31},
+      {"1 << 32l", std::nullopt},
+      {"1 << 40l", std::nullopt},
+      {"1u >> 40l", std::nullopt},
+      {"1l << 64", std::nullopt},
+      {Sum, Terms},
+  };
+
+  bool Failed = false;
+  for (auto &Case : Cases) {
+    auto Result = Fold(Case.Expr);
+    if (Result == Case.Expected)
+      continue;
+    // the long ones are not printed whole
+    auto Expr = Case.Expr.substr(0, 32);
+    if (Case.Expected)
+      std::printf("%s: expected %llu, ", Expr.c_str(),
+                  static_cast<unsigned long long>(*Case.Expected));
+    else
+      std::printf("%s: expected no folding, ", Expr.c_str());
+    if (Result)
+      std::printf("got %llu\n", static_cast<unsigned long long>(*Result));
+    else
+      std::printf("it was not folded\n");
+    Failed = true;
+  }
+
+  return Failed ? 1 : 0;
+}
@@ -0,0 +1,40 @@
+// RUN: AArch64
+// FUNC-DECL: int test(int)
+// TEST-CASE: test(1) -> 113
+
+#define LEVEL 2
+#define SCALE(x) ((x) * LEVEL)
+
+#ifdef LEVEL
+int base(int a) { return a; }
+#else
+this branch is never lexed (
+#endif
+
+#if defined(UNKNOWN) || LEVEL < 2
+int extra() { return 0; }
+#elif SCALE(LEVEL) == 4 && !defined UNKNOWN
+#ifndef UNKNOWN
+int extra() { return 10; }
+#else
+#error nested inactive branch
+#endif
+#else
+int extra() { return 20; }
+#endif
+
+#if 0
+#define LEVEL 3
+#endif
+
+#if -1 > 0u
+int sign() { return 100; }
+#else
+int sign() { return 0; }
+#endif
+
+int test(int a) {
+  int b = base(a) + LEVEL;
+  int e = extra();
+  return b + e + sign();
+}
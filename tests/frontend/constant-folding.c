@@ -0,0 +1,65 @@
+// RUN: AArch64
+
+// FUNC-DECL: int test_arithmetic(int)
+// TEST-CASE: test_arithmetic(0) -> 18
+// TEST-CASE: test_arithmetic(5) -> 23
+
+// FUNC-DECL: int test_unsigned(int)
+// TEST-CASE: test_unsigned(0) -> 1
+// TEST-CASE: test_unsigned(1) -> 2
+
+// FUNC-DECL: int test_char(int)
+// TEST-CASE: test_char(0) -> 44
+// TEST-CASE: test_char(1) -> 45
+
+// FUNC-DECL: int test_ternary(int)
+// TEST-CASE: test_ternary(0) -> 3
+// TEST-CASE: test_ternary(7) -> 10
+
+// FUNC-DECL: int test_wide(int)
+// TEST-CASE: test_wide(0) -> 1048576
+// TEST-CASE: test_wide(6000) -> 1054576
+
+// FUNC-DECL: int test_shift(int)
+// TEST-CASE: test_shift(0) -> 20
+// TEST-CASE: test_shift(1) -> 21
+
+// FUNC-DECL: int test_global(int)
+// TEST-CASE: test_global(0) -> 42
+// TEST-CASE: test_global(1) -> 43
+
+int global = 6 * 7;
+
+int test_arithmetic(int a) {
+  return a + (1 + 2) * 3 * 2 - 1 + (10 / 3 == 3) + (-5 % 3 == -2) - 1;
+}
+
+int test_unsigned(int a) {
+  if (1)
+    return a + (-1 > 0u);
+  while (0)
+    a = 100;
+  return a;
+}
+
+int test_char(int a) {
+  char c = 300;
+  return a + c;
+}
+
+int test_ternary(int a) {
+  return a + (1 ? 3 : 4);
+}
+
+int test_wide(int a) {
+  return a + (1 << 20);
+}
+
+int test_shift(int a) {
+  long big = 1l << 40;
+  return a + (1 << 4l) + (big >> 38);
+}
+
+int test_global(int a) {
+  return a + global;
+}
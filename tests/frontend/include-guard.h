@@ -0,0 +1,7 @@
+// a header with an include guard
+#ifndef INCLUDE_GUARD_H
+#define INCLUDE_GUARD_H
+
+int guarded(int a) { return a + 1; }
+
+#endif // INCLUDE_GUARD_H
@@ -0,0 +1,13 @@
+// RUN: AArch64
+// FUNC-DECL: int test(int)
+// TEST-CASE: test(3) -> 7
+
+#include "include-guard.h"
+#include "pragma-once.h"
+#include "include-guard.h"
+#include "pragma-once.h"
+
+int test(int a) {
+  int b = once(a);
+  return guarded(b);
+}
@@ -0,0 +1,16 @@
+// RUN: AArch64
+// FUNC-DECL: int test(int)
+// TEST-CASE: test(3) -> 6
+// TEST-CASE: test(1) -> 0
+
+int test(int a) {
+  int i;
+  int sum = 0;
+  if(a < 2)
+    return(0);
+  for(i = 0; i <= a; i++)
+    sum += i;
+  while(sum > 100)
+    sum -= 100;
+  return(sum);
+}
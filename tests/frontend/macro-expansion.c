@@ -0,0 +1,18 @@
+// RUN: AArch64
+// FUNC-DECL: int test(int, int)
+// TEST-CASE: test(1, 2) -> 12
+// TEST-CASE: test(4, -3) -> 17
+
+#define TWO 2
+#define ADD(a, b) ((a) + (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define TWICE(x) ADD(x, x)
+#define INC(x) ((x) + 1)
+#define NEXT INC
+
+int test(int a, int b) {
+  int TWO_x = TWO;
+  // NEXT expands to INC, which is invoked with the "(a)" after NEXT
+  int Next = NEXT(a);
+  return ADD(TWICE(MAX(ADD(a, b), a)), ADD(TWO_x, TWO)) + Next; // not TWO here
+}
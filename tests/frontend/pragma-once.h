@@ -0,0 +1,3 @@
+#pragma once
+
+int once(int a) { return a * 2; }
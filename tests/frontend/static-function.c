@@ -0,0 +1,22 @@
+// RUN: AArch64
+// FUNC-DECL: int test(int)
+// TEST-CASE: test(4) -> 9
+
+static int twice(int a) {
+  return a * 2;
+}
+
+static int unused(int a) {
+  return a - 1;
+}
+
+static int add_one(int a);
+
+int test(int a) {
+  int b = twice(a);
+  return add_one(b);
+}
+
+static int add_one(int a) {
+  return a + 1;
+}
@@ -0,0 +1,22 @@
+// RUN: AArch64
+
+// FUNC-DECL: int test(int)
+// TEST-CASE: test(-3) -> -1
+// TEST-CASE: test(0) -> 0
+// TEST-CASE: test(7) -> 1
+
+// FUNC-DECL: int test_2(int)
+// TEST-CASE: test_2(5) -> 5
+// TEST-CASE: test_2(15) -> 10
+
+int test(int a) {
+  int res;
+  res = a < 0 ? -1 : a > 0 ? 1 : 0;
+  return res;
+}
+
+int test_2(int a) {
+  int res;
+  res = a > 10 ? a - 5 : a;
+  return res;
+}
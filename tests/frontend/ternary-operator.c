@@ -10,6 +10,10 @@
 // TEST-CASE: test_2(0) -> 22
 // TEST-CASE: test_2(1) -> 11
 
+// FUNC-DECL: int test_operand(int, int)
+// TEST-CASE: test_operand(1, 2) -> 2
+// TEST-CASE: test_operand(4, 3) -> 4
+
 int test(int a) {
   int res;
   res = (a > 10) ? a - 5 : a;
@@ -21,3 +25,7 @@ int test_2(int a) {
   res = (a) ? 11 : 22;
   return res;
 }
+
+int test_operand(int a, int b) {
+  return (a < b ? a : b) + 1;
+}
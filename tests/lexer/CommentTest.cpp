@@ -0,0 +1,32 @@
+// Lexes a file with 50k single line comments before its only tokens, the
+// comments have to be skipped without a stack frame per line.
+
+#include "../../frontend/lexer/Lexer.hpp"
+#include <cstdio>
+#include <string>
+
+int main() {
+  const unsigned Lines = 50000;
+
+  std::string Src;
+  for (unsigned i = 0; i < Lines; i++)
+    Src += "// comment " + std::to_string(i) + "\n";
+  Src += "return 1; // trailing comment";
+
+  SourceManager SM;
+  Lexer L(SM, SM.AddBuffer(Src, "comment-test.c"));
+
+  Token::TokenKind Expected[] = {Token::Return, Token::Integer,
+                                 Token::SemiColon, Token::EndOfFile};
+  for (auto Kind : Expected) {
+    auto T = L.Lex();
+    if (T.GetKind() != Kind) {
+      std::printf("expected token %s, got %s\n",
+                  Token::ToString(Kind).c_str(),
+                  Token::ToString(T.GetKind()).c_str());
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,53 @@
+// Lexes identifiers and numbers longer than a token can hold. They have to be
+// lexed as Invalid tokens at their location, then lexing goes on after them.
+
+#include "../../frontend/lexer/Lexer.hpp"
+#include <cstdio>
+#include <string>
+
+int main() {
+  std::string Long(Token::MaxLength + 1, 'a');
+  std::string LongNumber(Token::MaxLength + 1, '1');
+  std::string Longest(Token::MaxLength, 'b');
+  // the column after the too long tokens
+  const unsigned After = 4 + Token::MaxLength + 1;
+  std::string Src =
+      "x = " + Long + ";\ny = " + LongNumber + ";\nz = " + Longest + ";";
+
+  SourceManager SM;
+  Lexer L(SM, SM.AddBuffer(Src, "long-token-test.c"));
+
+  struct {
+    Token::TokenKind Kind;
+    unsigned Line, Column, Length;
+  } Expected[] = {
+      {Token::Identifier, 0, 0, 1}, {Token::Equal, 0, 2, 1},
+      {Token::Invalid, 0, 4, 0},    {Token::SemiColon, 0, After, 1},
+      {Token::Identifier, 1, 0, 1}, {Token::Equal, 1, 2, 1},
+      {Token::Invalid, 1, 4, 0},    {Token::SemiColon, 1, After, 1},
+      {Token::Identifier, 2, 0, 1}, {Token::Equal, 2, 2, 1},
+      {Token::Identifier, 2, 4, Token::MaxLength},
+      {Token::SemiColon, 2, 4 + Token::MaxLength, 1},
+  };
+
+  for (auto &E : Expected) {
+    auto T = L.Lex();
+    auto [Line, Column] = L.GetLineAndColumn(T);
+    if (T.GetKind() != E.Kind || Line != E.Line || Column != E.Column ||
+        T.GetStringView().size() != E.Length) {
+      std::printf("expected token %s at %u:%u with length %u, got %s at %u:%u "
+                  "with length %zu\n",
+                  Token::ToString(E.Kind).c_str(), E.Line, E.Column, E.Length,
+                  Token::ToString(T.GetKind()).c_str(), Line, Column,
+                  T.GetStringView().size());
+      return 1;
+    }
+  }
+
+  if (L.Lex().GetKind() != Token::EndOfFile) {
+    std::printf("expected the end of the file\n");
+    return 1;
+  }
+
+  return 0;
+}
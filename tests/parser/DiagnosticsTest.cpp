@@ -0,0 +1,81 @@
+// Compiles a source with errors in several function bodies with the miniCC
+// given as the argument, parsing the bodies in order, in parallel and from
+// the pipelined lexer. The diagnostics have to be the same, at the location
+// of the error, not where the lexer of the parser happens to be.
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static const char *Source = "int f(int a, int b) {\n"
+                            "  return a + b;\n"
+                            "}\n"
+                            "\n"
+                            "static int g(int x) {\n"
+                            "  int c;\n"
+                            "  c = f(x, x, x);\n"
+                            "  return c;\n"
+                            "}\n"
+                            "\n"
+                            "int h(int x) {\n"
+                            "  int d;\n"
+                            "  d = 1;\n"
+                            "  d = d + f(x, d, 2, 3);\n"
+                            "  return d;\n"
+                            "}\n"
+                            "\n"
+                            "int main() {\n"
+                            "  return g(1) + h(2) + f(1, 2, 3);\n"
+                            "}\n";
+
+/// The diagnostics expected in the output, in order.
+static const char *Expected[] = {
+    ":7:7: error: arguments number mismatch",
+    ":14:11: error: arguments number mismatch",
+    ":19:24: error: arguments number mismatch",
+};
+
+/// The output of "MiniCC diagnostics-test.c Flags".
+static std::string Compile(const std::string &MiniCC, const std::string &Flags) {
+  auto Command = "\"" + MiniCC + "\" diagnostics-test.c " + Flags +
+                 " > diagnostics-test.out";
+  if (std::system(Command.c_str()) != 0)
+    std::printf("failed: %s\n", Command.c_str());
+
+  std::ostringstream Output;
+  Output << std::ifstream("diagnostics-test.out", std::ios::binary).rdbuf();
+  return Output.str();
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::printf("usage: %s <miniCC>\n", argv[0]);
+    return 1;
+  }
+
+  std::ofstream("diagnostics-test.c") << Source;
+  auto Reference = Compile(argv[1], "");
+
+  bool Failed = false;
+  size_t Position = 0;
+  for (auto Diagnostic : Expected) {
+    Position = Reference.find(Diagnostic, Position);
+    if (Position == std::string::npos) {
+      std::printf("missing diagnostic: %s\n", Diagnostic);
+      Failed = true;
+      break;
+    }
+  }
+
+  for (auto Flags : {"-parallel-parsing=2", "-pipeline"})
+    if (Compile(argv[1], Flags) != Reference) {
+      std::printf("the output with %s differs\n", Flags);
+      Failed = true;
+    }
+
+  std::remove("diagnostics-test.c");
+  std::remove("diagnostics-test.out");
+  return Failed ? 1 : 0;
+}
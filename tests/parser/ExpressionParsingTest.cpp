@@ -0,0 +1,168 @@
+// Parses machine generated expressions of 100k terms: an unrolled polynomial,
+// a chain of assignments and a chain of ternary operators. The last two nest
+// to the right, so a recursive parser would run out of stack. The shape of
+// every tree is checked. The polynomial and the assignments are compiled with
+// the miniCC given as the argument too, directly, through an AST file and with
+// an incremental database, so the passes after the parser are covered as well.
+
+#include "../../frontend/parser/Parser.hpp"
+#include "../../frontend/preprocessor/PreProcessor.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+
+static std::string GeneratePolynomial(unsigned Terms) {
+  std::string Expr = "1";
+  for (unsigned i = 1; i < Terms; i++)
+    Expr += std::string(i % 2 ? " + " : " - ") + "x * " + std::to_string(i);
+  return Expr;
+}
+
+static std::string GenerateAssignments(unsigned Terms) {
+  std::string Expr;
+  for (unsigned i = 0; i < Terms; i++)
+    Expr += "a = ";
+  return Expr + "x";
+}
+
+static std::string GenerateTernaries(unsigned Terms) {
+  std::string Expr;
+  for (unsigned i = 0; i < Terms; i++) {
+    auto Id = std::to_string(i);
+    Expr += "x < " + Id + " ? " + Id + " : ";
+  }
+  return Expr + "0";
+}
+
+/// Returns the number of times @Next could step from @E to a child.
+static unsigned
+GetChainLength(Expression *E, std::function<Expression *(Expression *)> Next) {
+  unsigned Length = 0;
+  while ((E = Next(E)))
+    Length++;
+  return Length;
+}
+
+static Expression *LeftOperand(Expression *E) {
+  auto Binary = DynCast<BinaryExpression>(E);
+  if (!Binary || Binary->GetOperation().GetKind() == Token::Astrix)
+    return nullptr;
+  return Binary->GetLeftExpr();
+}
+
+static Expression *RightOperand(Expression *E) {
+  auto Binary = DynCast<BinaryExpression>(E);
+  return Binary ? Binary->GetRightExpr() : nullptr;
+}
+
+static Expression *FalseOperand(Expression *E) {
+  auto Ternary = DynCast<TernaryExpression>(E);
+  return Ternary ? Ternary->GetExprIfFalse() : nullptr;
+}
+
+/// A function which assigns @Expr to a local.
+static std::string GetSource(const std::string &Expr) {
+  return "int test(int x) {\n  int a;\n  a = " + Expr +
+         ";\n  return a;\n}\n";
+}
+
+/// Parse "a = Expr;" and return the length of the chain of @Next from Expr.
+static unsigned Parse(const std::string &Expr,
+                      std::function<Expression *(Expression *)> Next) {
+  SourceManager SM;
+  auto ID = SM.AddBuffer(GetSource(Expr), "expression-test.c");
+  PreProcessor PP(SM, ID, "expression-test.c");
+  ASTContext Ctx;
+  Parser P(SM, PP, Ctx, nullptr);
+
+  auto AST = static_cast<TranslationUnit *>(P.Parse());
+  auto Function =
+      static_cast<FunctionDeclaration *>(AST->GetDeclarations()[0]);
+  auto Statement =
+      static_cast<ExpressionStatement *>(Function->GetBody()->GetStatements()[1]);
+  auto Assignment = static_cast<BinaryExpression *>(Statement->GetExpression());
+  return GetChainLength(Assignment->GetRightExpr(), Next);
+}
+
+static std::string ReadFile(const char *Path) {
+  std::ostringstream Content;
+  Content << std::ifstream(Path, std::ios::binary).rdbuf();
+  return Content.str();
+}
+
+/// Run "MiniCC Args > Output". Returns false and prints the command if it
+/// failed.
+static bool Run(const std::string &MiniCC, const std::string &Args,
+                const char *Output) {
+  auto Command = "\"" + MiniCC + "\" " + Args + " > " + Output;
+  if (std::system(Command.c_str()) == 0)
+    return true;
+  std::printf("failed: %s\n", Command.c_str());
+  return false;
+}
+
+/// Compile "a = Expr;" with @MiniCC, directly, then from the AST file of it
+/// and with an incremental database. Returns true if all of them succeeded
+/// with the same assembly.
+static bool Compile(const std::string &MiniCC, const std::string &Expr) {
+  std::ofstream("expression-test.c") << GetSource(Expr);
+  std::remove("expression-test.db");
+
+  if (!Run(MiniCC, "expression-test.c", "expression-test.s") ||
+      !Run(MiniCC, "expression-test.c -emit-ast=expression-test.ast",
+           "expression-test.out") ||
+      !Run(MiniCC, "-load-ast=expression-test.ast", "expression-test.ast.s") ||
+      !Run(MiniCC, "expression-test.c -incremental-db=expression-test.db",
+           "expression-test.db.s"))
+    return false;
+
+  auto Assembly = ReadFile("expression-test.s");
+  if (Assembly.empty() || ReadFile("expression-test.ast.s") != Assembly ||
+      ReadFile("expression-test.db.s") != Assembly) {
+    std::printf("the assembly differs between the compilations\n");
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  const unsigned Terms = 100000;
+
+  // the ternaries are only parsed, the passes after the parser still recurse
+  // into them
+  struct {
+    const char *Name;
+    std::string Expr;
+    std::function<Expression *(Expression *)> Next;
+    unsigned ExpectedLength;
+    bool Compiled;
+  } Cases[] = {
+      {"polynomial", GeneratePolynomial(Terms), LeftOperand, Terms - 1, true},
+      {"assignments", GenerateAssignments(Terms), RightOperand, Terms, true},
+      {"ternaries", GenerateTernaries(Terms), FalseOperand, Terms, false},
+  };
+
+  bool Failed = false;
+  for (auto &Case : Cases) {
+    auto Length = Parse(Case.Expr, Case.Next);
+    if (Length != Case.ExpectedLength)
+      std::printf("%s: expected a chain of %u operands, got %u\n", Case.Name,
+                  Case.ExpectedLength, Length);
+    Failed |= Length != Case.ExpectedLength;
+
+    if (argc > 1 && Case.Compiled && !Compile(argv[1], Case.Expr)) {
+      std::printf("%s: the compilation failed\n", Case.Name);
+      Failed = true;
+    }
+  }
+
+  for (auto Path : {"expression-test.c", "expression-test.s",
+                    "expression-test.ast", "expression-test.out",
+                    "expression-test.ast.s", "expression-test.db",
+                    "expression-test.db.s"})
+    std::remove(Path);
+  return Failed ? 1 : 0;
+}
@@ -0,0 +1,79 @@
+// Preprocesses #if conditions with operations which are undefined in C. They
+// have to be reported at their directive, but only if they are evaluated, and
+// the values have to be converted like in C.
+
+#include "../../frontend/preprocessor/PreProcessor.hpp"
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+static const char *Source =
+    "#if 1 << 64\n"
+    "#endif\n"
+    "#if 1 >> -1\n"
+    "#endif\n"
+    "#if (-9223372036854775807 - 1) / -1\n"
+    "#endif\n"
+    "#if (-9223372036854775807 - 1) % -1\n"
+    "#endif\n"
+    "#if 0 && 1 / 0 || 1 || 1 % 0 || (1 ? 1 : 1 << 64)\n"
+    "int evaluated;\n"
+    "#endif\n"
+    "#if -1 > 0u && 18446744073709551615 == -1 && (1 ? -1 : 0u) > 0\n"
+    "int unsigned_compared;\n"
+    "#endif\n"
+    "#if -1 > 0 || -1 >> 1 != -1 || -1u >> 63 != 1\n"
+    "int signed_compared;\n"
+    "#endif\n";
+
+/// The diagnostics expected in the output, in order.
+static const char *Expected[] = {
+    ":1:5: error: shift count is out of range in the condition",
+    ":3:5: error: shift count is out of range in the condition",
+    ":5:5: error: integer overflow in the condition",
+    ":7:5: error: integer overflow in the condition",
+};
+
+int main() {
+  SourceManager SM;
+  PreProcessor PP(SM, SM.AddBuffer(Source, "condition-test.c"),
+                  "condition-test.c");
+
+  std::ostringstream Diagnostics;
+  auto *CoutBuffer = std::cout.rdbuf(Diagnostics.rdbuf());
+  auto Text = PP.Run().GetText(SM);
+  std::cout.rdbuf(CoutBuffer);
+  auto Output = Diagnostics.str();
+
+  bool Failed = false;
+  size_t Position = 0;
+  for (auto Diagnostic : Expected) {
+    Position = Output.find(Diagnostic, Position);
+    if (Position == std::string::npos) {
+      std::printf("missing diagnostic: %s\n", Diagnostic);
+      Failed = true;
+      break;
+    }
+  }
+
+  auto Count = [&Output](const char *Pattern) {
+    size_t N = 0;
+    for (auto P = Output.find(Pattern); P != std::string::npos;
+         P = Output.find(Pattern, P + 1))
+      N++;
+    return N;
+  };
+  if (Count(": error: ") != std::size(Expected)) {
+    std::printf("unexpected diagnostics:\n%s", Output.c_str());
+    Failed = true;
+  }
+
+  if (Text != "int evaluated;\nint unsigned_compared;\n") {
+    std::printf("unexpected output:\n%s", Text.c_str());
+    Failed = true;
+  }
+
+  return Failed ? 1 : 0;
+}